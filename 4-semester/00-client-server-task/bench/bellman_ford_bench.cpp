@@ -0,0 +1,109 @@
+/**
+ * @file bench/bellman_ford_bench.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Измерения производительности вариантов алгоритма Беллмана-Форда.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.hpp"
+#include "bench_core.hpp"
+#include <bellman_ford.hpp>
+#include <dijkstra.hpp>
+#include <graph_builder.hpp>
+#include <weighted_csr_graph.hpp>
+#include <weighted_oriented_graph.hpp>
+
+using std::string;
+using std::vector;
+using std::mt19937_64;
+using std::uniform_int_distribution;
+
+using graph::BellmanFordMode;
+using graph::WeightedCsrGraph;
+using graph::WeightedGraphBuilder;
+using graph::WeightedOrientedGraph;
+
+/**
+ * @brief Измерить один вариант алгоритма.
+ *
+ * @param suite Набор измерений.
+ * @param name Название измерения.
+ * @param snapshot Граф.
+ * @param mode Вариант алгоритма.
+ * @param numThreads Число потоков (для параллельного варианта).
+ */
+static void BenchMode(BenchSuite* suite, const string& name,
+                      const WeightedCsrGraph<int64_t>& snapshot,
+                      BellmanFordMode mode, size_t numThreads) {
+  graph::ShortestPathTree<int64_t> tree;
+  vector<size_t> cycle;
+
+  suite->Run(name, snapshot.NumVertices(), [&]() {
+    switch (mode) {
+      case BellmanFordMode::Classic:
+        graph::BellmanFord(snapshot, 0, &tree, &cycle);
+        break;
+      case BellmanFordMode::Spfa:
+        graph::Spfa(snapshot, 0, &tree, &cycle);
+        break;
+      case BellmanFordMode::Parallel:
+        graph::ParallelBellmanFord(snapshot, 0, numThreads, &tree, &cycle);
+        break;
+    }
+
+    DoNotOptimize(tree.distance.data());
+
+    return BenchCounters{1, snapshot.NumEdges()};
+  });
+}
+
+void BenchBellmanFord(size_t maxSize) {
+  BenchSuite suite("BenchBellmanFord");
+  // Число потоков для параллельного варианта.
+  size_t numThreads = std::thread::hardware_concurrency();
+
+  for (size_t numVertices = 1000; numVertices <= maxSize; numVertices *= 10) {
+    mt19937_64 gen(numVertices);
+    uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+    uniform_int_distribution<int64_t> weight(0, 1000);
+    uniform_int_distribution<int64_t> potential(-10000, 10000);
+    vector<int64_t> p(numVertices);
+    WeightedGraphBuilder<int64_t> builder;
+    WeightedOrientedGraph<int64_t> random;
+
+    for (int64_t& value : p) {
+      value = potential(gen);
+    }
+
+    // Случайный граф со средней степенью 8. Веса сдвинуты потенциалами:
+    // многие рёбра отрицательны, но циклов отрицательного веса нет.
+    for (size_t i = 0; i < 4 * numVertices; i++) {
+      size_t from = vertex(gen);
+      size_t to = vertex(gen);
+
+      builder.AddEdge(from, to, weight(gen) + p[from] - p[to]);
+    }
+
+    builder.Build(&random);
+
+    WeightedCsrGraph<int64_t> snapshot(random);
+
+    BenchMode(&suite, "BellmanFord/classic", snapshot,
+              BellmanFordMode::Classic, 1);
+    BenchMode(&suite, "BellmanFord/spfa", snapshot, BellmanFordMode::Spfa,
+              1);
+    BenchMode(&suite, "BellmanFord/parallel/1", snapshot,
+              BellmanFordMode::Parallel, 1);
+
+    if (numThreads > 1) {
+      BenchMode(&suite, "BellmanFord/parallel/" + std::to_string(numThreads),
+                snapshot, BellmanFordMode::Parallel, numThreads);
+    }
+  }
+}
@@ -0,0 +1,85 @@
+/**
+ * @file bench/bench.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Заголовочный файл для объявлений основных функций измерения
+ * производительности.
+ */
+
+#ifndef BENCH_BENCH_HPP_
+#define BENCH_BENCH_HPP_
+
+#include <cstddef>
+
+/**
+ * @brief Измерения операций AddEdge(), HasEdge() и RemoveVertex() для всех
+ *        четырёх классов графов.
+ *
+ * @param maxSize Максимальное число вершин.
+ */
+void BenchGraphs(size_t maxSize);
+
+/**
+ * @brief Измерения топологической сортировки на цепочках, широких веерах,
+ *        случайных графах и графах со степенным распределением степеней.
+ *
+ * @param maxSize Максимальное число вершин.
+ */
+void BenchTopologicalSort(size_t maxSize);
+
+/**
+ * @brief Измерения алгоритма Дейкстры со всеми очередями с приоритетами
+ *        на случайных графах и решётках.
+ *
+ * @param maxSize Максимальное число вершин.
+ */
+void BenchDijkstra(size_t maxSize);
+
+/**
+ * @brief Измерения вариантов алгоритма Беллмана-Форда на случайных графах
+ *        с отрицательными весами.
+ *
+ * @param maxSize Максимальное число вершин.
+ */
+void BenchBellmanFord(size_t maxSize);
+
+/**
+ * @brief Измерения сортировки рёбер, алгоритмов Краскала и Борувки на
+ *        разреженных и плотных случайных графах.
+ *
+ * @param maxSize Максимальное число вершин.
+ */
+void BenchKruskal(size_t maxSize);
+
+/**
+ * @brief Измерения вариантов алгоритма Прима на графах разной плотности.
+ *
+ * @param maxSize Максимальное число вершин.
+ */
+void BenchPrim(size_t maxSize);
+
+/**
+ * @brief Измерения поиска в ширину в разных направлениях на случайных
+ *        графах с тяжёлым хвостом степеней.
+ *
+ * @param maxSize Максимальное число вершин.
+ */
+void BenchBfs(size_t maxSize);
+
+/**
+ * @brief Измерения алгоритмов Тарьяна и forward-backward на случайных
+ *        графах разной плотности.
+ *
+ * @param maxSize Максимальное число вершин.
+ */
+void BenchScc(size_t maxSize);
+
+/**
+ * @brief Измерения добавления рёбер в поддерживаемый топологический
+ *        порядок по сравнению с пересортировкой после каждого ребра.
+ *
+ * @param maxSize Максимальное число вершин.
+ */
+void BenchDynamicTopologicalOrder(size_t maxSize);
+
+#endif  // BENCH_BENCH_HPP_
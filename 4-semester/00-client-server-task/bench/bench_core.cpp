@@ -0,0 +1,62 @@
+/**
+ * @file bench/bench_core.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Подсчёт выделений памяти для измерений производительности.
+ *
+ * Глобальные операторы new и delete заменяются только в программе
+ * graph_bench: они считают число и объём выделений памяти и передают
+ * вызов функциям std::malloc() и std::free().
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "bench_core.hpp"
+
+//! Число байт, выделенных оператором new.
+static std::atomic<size_t> allocatedBytes(0);
+//! Число вызовов оператора new.
+static std::atomic<size_t> numAllocations(0);
+
+size_t AllocatedBytes() {
+  return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+size_t NumAllocations() {
+  return numAllocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size) {
+  allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  numAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  void* pointer = std::malloc(size == 0 ? 1 : size);
+
+  if (!pointer) {
+    throw std::bad_alloc();
+  }
+
+  return pointer;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
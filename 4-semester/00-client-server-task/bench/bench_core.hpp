@@ -0,0 +1,177 @@
+/**
+ * @file bench/bench_core.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Заголовочный файл для ядра измерения производительности.
+ */
+
+#ifndef BENCH_BENCH_CORE_HPP_
+#define BENCH_BENCH_CORE_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief Функция возвращает число байт, выделенных оператором new с начала
+ *        работы программы.
+ */
+size_t AllocatedBytes();
+
+/**
+ * @brief Функция возвращает число вызовов оператора new с начала работы
+ *        программы.
+ */
+size_t NumAllocations();
+
+/**
+ * @brief Запретить компилятору удалять вычисление значения.
+ *
+ * @param value Значение, которое считается использованным.
+ */
+template<typename T>
+void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const T* sink;
+
+  sink = &value;
+#endif
+}
+
+/**
+ * @brief Результат одного запуска измеряемой функции.
+ */
+struct BenchCounters {
+  //! Число выполненных операций.
+  size_t numOps;
+  //! Число обработанных рёбер.
+  size_t numEdges;
+};
+
+/**
+ * @brief Класс для набора измерений.
+ *
+ * Каждое измерение печатается в стандартный поток вывода одной строкой
+ * в формате JSON:
+ * @code
+ * {"suite":"...","benchmark":"...","size":1000,"iterations":12,
+ *  "ns_per_op":35.2,"bytes_allocated":65536,"allocations":1024,
+ *  "edges_per_sec":1.2e8}
+ * @endcode
+ * Здесь bytes_allocated и allocations --- объём и число выделений памяти
+ * за один запуск измеряемой функции. Ход измерений печатается в стандартный
+ * поток ошибок.
+ */
+class BenchSuite {
+ public:
+  /**
+   * @brief Конструктор набора измерений.
+   *
+   * @param name Название набора.
+   */
+  explicit BenchSuite(const std::string& name) :
+    benchSuiteName(name) {
+    std::cerr << "Starting bench suite " << name << std::endl;
+  }
+
+  /**
+   * @brief Задать минимальное время измерения.
+   *
+   * @param seconds Время в секундах. Измеряемая функция запускается,
+   * пока суммарное время не превысит это значение.
+   */
+  static void SetMinTime(double seconds) {
+    minTime = seconds;
+  }
+
+  /**
+   * @brief Выполнить измерение.
+   *
+   * @tparam Setup Тип функции подготовки.
+   * @tparam Body Тип измеряемой функции.
+   *
+   * @param name Название измерения.
+   * @param size Размер входных данных.
+   * @param setup Функция подготовки. Вызывается перед каждым запуском
+   * и возвращает состояние, которое передаётся в body. Время её работы
+   * и выделения памяти в ней не учитываются.
+   * @param body Измеряемая функция. Принимает ссылку на состояние
+   * и возвращает объект BenchCounters.
+   */
+  template<typename Setup, typename Body>
+  void Run(const std::string& name, size_t size, Setup setup, Body body) {
+    using std::chrono::steady_clock;
+    using std::chrono::duration;
+
+    size_t numIterations = 0;
+    size_t numOps = 0;
+    size_t numEdges = 0;
+    size_t numBytes = 0;
+    size_t numAllocations = 0;
+    double elapsed = 0.0;
+
+    while (numIterations < maxIterations &&
+           (numIterations == 0 || elapsed < minTime)) {
+      auto state = setup();
+
+      size_t bytesBefore = AllocatedBytes();
+      size_t allocationsBefore = NumAllocations();
+      steady_clock::time_point start = steady_clock::now();
+
+      BenchCounters counters = body(state);
+
+      steady_clock::time_point finish = steady_clock::now();
+
+      numBytes += AllocatedBytes() - bytesBefore;
+      numAllocations += NumAllocations() - allocationsBefore;
+      elapsed += duration<double>(finish - start).count();
+      numOps += counters.numOps;
+      numEdges += counters.numEdges;
+      numIterations++;
+    }
+
+    nlohmann::json result;
+
+    result["suite"] = benchSuiteName;
+    result["benchmark"] = name;
+    result["size"] = size;
+    result["iterations"] = numIterations;
+    result["ns_per_op"] = elapsed * 1e9 / std::max<size_t>(numOps, 1);
+    result["bytes_allocated"] = numBytes / numIterations;
+    result["allocations"] = numAllocations / numIterations;
+    result["edges_per_sec"] = elapsed > 0.0 ? numEdges / elapsed : 0.0;
+
+    std::cout << result.dump() << std::endl;
+    std::cerr << "  " << name << "/" << size << ": " << numIterations
+              << " iterations (" << elapsed << "s)" << std::endl;
+  }
+
+  /**
+   * @brief Выполнить измерение без функции подготовки.
+   *
+   * @tparam Body Тип измеряемой функции.
+   *
+   * @param name Название измерения.
+   * @param size Размер входных данных.
+   * @param body Измеряемая функция без аргументов.
+   */
+  template<typename Body>
+  void Run(const std::string& name, size_t size, Body body) {
+    Run(name, size, []() { return 0; }, [&body](int) { return body(); });
+  }
+
+ private:
+  //! Название набора.
+  std::string benchSuiteName;
+  //! Минимальное суммарное время измерения в секундах.
+  static inline double minTime = 0.5;
+  //! Максимальное число запусков измеряемой функции.
+  static constexpr size_t maxIterations = 1000;
+};
+
+#endif  // BENCH_BENCH_CORE_HPP_
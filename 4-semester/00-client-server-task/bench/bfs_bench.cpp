@@ -0,0 +1,151 @@
+/**
+ * @file bench/bfs_bench.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Измерения производительности поиска в ширину.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+#include "bench_core.hpp"
+#include <bfs.hpp>
+#include <csr_graph.hpp>
+#include <dijkstra.hpp>
+#include <graph_builder.hpp>
+#include <oriented_graph.hpp>
+
+using std::string;
+using std::vector;
+using std::mt19937_64;
+using std::uniform_real_distribution;
+
+using graph::BfsDirection;
+using graph::CsrGraph;
+using graph::GraphBuilder;
+using graph::OrientedGraph;
+
+/**
+ * @brief Построить случайный ориентированный граф.
+ *
+ * @param numVertices Число вершин.
+ * @param degree Средняя степень вершины.
+ * @param skew Показатель перекоса: номер конца ребра равен
+ * numVertices * u^skew для равномерного u из [0, 1).
+ * @param graph Указатель на граф.
+ *
+ * При skew = 1 степени вершин распределены равномерно, при больших skew
+ * у вершин с маленькими номерами много рёбер, как у популярных
+ * пользователей социальной сети.
+ */
+static void RandomGraph(size_t numVertices, size_t degree, double skew,
+                        OrientedGraph* graph) {
+  mt19937_64 gen(numVertices * degree);
+  uniform_real_distribution<double> uniform(0.0, 1.0);
+  GraphBuilder builder;
+
+  auto vertex = [&]() {
+    return static_cast<size_t>(numVertices * std::pow(uniform(gen), skew));
+  };
+
+  for (size_t i = 0; i < numVertices; i++) {
+    builder.AddVertex(i);
+  }
+
+  for (size_t i = 0; i < numVertices * degree; i++) {
+    builder.AddEdge(vertex(), vertex());
+  }
+
+  builder.Build(graph);
+}
+
+/**
+ * @brief Измерить поиск в ширину на одном графе.
+ *
+ * @param suite Набор измерений.
+ * @param family Название семейства графов.
+ * @param graph Граф.
+ * @param numThreads Число потоков для параллельного поиска.
+ */
+static void BenchGraph(BenchSuite* suite, const string& family,
+                       const OrientedGraph& graph, size_t numThreads) {
+  CsrGraph snapshot(graph);
+  CsrGraph reverse;
+  graph::ShortestPathTree<size_t> tree;
+
+  reverse.AssignTranspose(snapshot);
+
+  // Последовательный поиск с очередью прямо по хеш-таблицам графа.
+  suite->Run("BFS/oriented-graph/" + family, snapshot.NumVertices(), [&]() {
+    std::unordered_map<size_t, size_t> distance;
+    std::queue<size_t> queue;
+
+    distance[0] = 0;
+    queue.push(0);
+
+    while (!queue.empty()) {
+      size_t vertex = queue.front();
+
+      queue.pop();
+
+      for (size_t neighbour : graph.Edges(vertex)) {
+        if (distance.emplace(neighbour, distance[vertex] + 1).second) {
+          queue.push(neighbour);
+        }
+      }
+    }
+
+    DoNotOptimize(&distance);
+
+    return BenchCounters{1, snapshot.NumEdges()};
+  });
+
+  const std::pair<const char*, BfsDirection> directions[] = {
+    { "top-down", BfsDirection::TopDown },
+    { "bottom-up", BfsDirection::BottomUp },
+    { "auto", BfsDirection::Auto }
+  };
+
+  vector<size_t> threadCounts(1, 1);
+
+  if (numThreads > 1) {
+    threadCounts.push_back(numThreads);
+  }
+
+  for (const auto& direction : directions) {
+    for (size_t threads : threadCounts) {
+      suite->Run("BFS/" + string(direction.first) + "/" +
+                 std::to_string(threads) + "/" + family,
+                 snapshot.NumVertices(), [&]() {
+        graph::BreadthFirstSearch(snapshot, reverse, 0, direction.second,
+                                  threads, &tree);
+        DoNotOptimize(tree.distance.data());
+
+        return BenchCounters{1, snapshot.NumEdges()};
+      });
+    }
+  }
+}
+
+void BenchBfs(size_t maxSize) {
+  BenchSuite suite("BenchBfs");
+  size_t numThreads = std::thread::hardware_concurrency();
+
+  for (size_t numVertices = 1000; numVertices <= maxSize; numVertices *= 10) {
+    OrientedGraph uniform;
+    OrientedGraph skewed;
+
+    RandomGraph(numVertices, 16, 1.0, &uniform);
+    RandomGraph(numVertices, 16, 3.0, &skewed);
+
+    BenchGraph(&suite, "uniform", uniform, numThreads);
+    BenchGraph(&suite, "skewed", skewed, numThreads);
+  }
+}
@@ -0,0 +1,174 @@
+/**
+ * @file bench/dijkstra_bench.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Измерения производительности алгоритма Дейкстры с разными очередями.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.hpp"
+#include "bench_core.hpp"
+#include <delta_stepping.hpp>
+#include <dijkstra.hpp>
+#include <graph_builder.hpp>
+#include <heaps.hpp>
+#include <weighted_csr_graph.hpp>
+#include <weighted_oriented_graph.hpp>
+
+using std::string;
+using std::vector;
+using std::mt19937_64;
+using std::uniform_int_distribution;
+
+using graph::WeightedCsrGraph;
+using graph::WeightedGraphBuilder;
+using graph::WeightedOrientedGraph;
+
+/**
+ * @brief Измерить поиск расстояний от случайных источников с одной очередью.
+ *
+ * @tparam Heap Очередь с приоритетами.
+ *
+ * @param suite Набор измерений.
+ * @param name Название измерения.
+ * @param snapshot Граф.
+ * @param sources Источники (по одному на запуск).
+ */
+template<typename Heap>
+static void BenchHeap(BenchSuite* suite, const string& name,
+                      const WeightedCsrGraph<uint64_t>& snapshot,
+                      const vector<size_t>& sources) {
+  graph::ShortestPathTree<uint64_t> tree;
+  Heap heap;
+  size_t next = 0;
+
+  suite->Run(name, snapshot.NumVertices(), [&]() {
+    graph::Dijkstra(snapshot, sources[next++ % sources.size()],
+                    graph::noVertex, &heap, &tree);
+    DoNotOptimize(tree.distance.data());
+
+    return BenchCounters{1, snapshot.NumEdges()};
+  });
+}
+
+/**
+ * @brief Измерить алгоритм delta-stepping с шириной корзины по умолчанию.
+ *
+ * @param suite Набор измерений.
+ * @param name Название измерения.
+ * @param snapshot Граф.
+ * @param sources Источники (по одному на запуск).
+ * @param numThreads Число потоков.
+ */
+static void BenchDeltaStepping(BenchSuite* suite, const string& name,
+                               const WeightedCsrGraph<uint64_t>& snapshot,
+                               const vector<size_t>& sources,
+                               size_t numThreads) {
+  // Нулевая ширина означает выбор по умолчанию.
+  const uint64_t delta = 0;
+  graph::ShortestPathTree<uint64_t> tree;
+  size_t next = 0;
+
+  suite->Run(name, snapshot.NumVertices(), [&]() {
+    graph::DeltaStepping(snapshot, sources[next++ % sources.size()], delta,
+                         numThreads, &tree);
+    DoNotOptimize(tree.distance.data());
+
+    return BenchCounters{1, snapshot.NumEdges()};
+  });
+}
+
+/**
+ * @brief Измерить все очереди и delta-stepping на одном графе.
+ *
+ * @param suite Набор измерений.
+ * @param family Название семейства графов.
+ * @param graph Граф.
+ * @param gen Генератор случайных чисел.
+ */
+static void BenchGraph(BenchSuite* suite, const string& family,
+                       const WeightedOrientedGraph<uint64_t>& graph,
+                       mt19937_64* gen) {
+  WeightedCsrGraph<uint64_t> snapshot(graph);
+  uniform_int_distribution<size_t> vertex(0, snapshot.NumVertices() - 1);
+  vector<size_t> sources(16);
+
+  for (size_t& source : sources) {
+    source = vertex(*gen);
+  }
+
+  BenchHeap<graph::BinaryHeap<uint64_t>>(suite, "Dijkstra/binary/" + family,
+                                         snapshot, sources);
+  BenchHeap<graph::QuaternaryHeap<uint64_t>>(
+      suite, "Dijkstra/4-ary/" + family, snapshot, sources);
+  BenchHeap<graph::PairingHeap<uint64_t>>(
+      suite, "Dijkstra/pairing/" + family, snapshot, sources);
+  BenchHeap<graph::RadixHeap<uint64_t>>(suite, "Dijkstra/radix/" + family,
+                                        snapshot, sources);
+
+  // Число потоков для параллельного измерения.
+  size_t numThreads = std::thread::hardware_concurrency();
+
+  BenchDeltaStepping(suite, "DeltaStepping/1/" + family, snapshot, sources,
+                     1);
+
+  if (numThreads > 1) {
+    BenchDeltaStepping(suite,
+                       "DeltaStepping/" + std::to_string(numThreads) + "/" +
+                       family, snapshot, sources, numThreads);
+  }
+}
+
+void BenchDijkstra(size_t maxSize) {
+  BenchSuite suite("BenchDijkstra");
+
+  for (size_t numVertices = 1000; numVertices <= maxSize; numVertices *= 10) {
+    mt19937_64 gen(numVertices);
+    uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+    uniform_int_distribution<uint64_t> weight(1, 1000);
+    WeightedGraphBuilder<uint64_t> builder;
+    WeightedOrientedGraph<uint64_t> random;
+    WeightedOrientedGraph<uint64_t> grid;
+
+    // Случайный граф со средней степенью 8.
+    for (size_t i = 0; i < 4 * numVertices; i++) {
+      builder.AddEdge(vertex(gen), vertex(gen), weight(gen));
+    }
+
+    builder.Build(&random);
+
+    // Квадратная решётка с рёбрами в обе стороны: похожа на дорожную сеть
+    // (малая степень, большой диаметр).
+    size_t side = 1;
+
+    while ((side + 1) * (side + 1) <= numVertices) {
+      side++;
+    }
+
+    for (size_t row = 0; row < side; row++) {
+      for (size_t column = 0; column < side; column++) {
+        size_t id = row * side + column;
+
+        if (column + 1 < side) {
+          builder.AddEdge(id, id + 1, weight(gen));
+          builder.AddEdge(id + 1, id, weight(gen));
+        }
+
+        if (row + 1 < side) {
+          builder.AddEdge(id, id + side, weight(gen));
+          builder.AddEdge(id + side, id, weight(gen));
+        }
+      }
+    }
+
+    builder.Build(&grid);
+
+    BenchGraph(&suite, "random", random, &gen);
+    BenchGraph(&suite, "grid", grid, &gen);
+  }
+}
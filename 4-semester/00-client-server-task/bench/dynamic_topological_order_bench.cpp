@@ -0,0 +1,110 @@
+/**
+ * @file bench/dynamic_topological_order_bench.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Измерения производительности поддерживаемого топологического порядка.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+#include "bench_core.hpp"
+#include <dynamic_topological_order.hpp>
+#include <oriented_graph.hpp>
+#include <topological_sort.hpp>
+
+using std::pair;
+using std::vector;
+using std::mt19937_64;
+using std::uniform_int_distribution;
+
+using graph::DynamicTopologicalOrder;
+using graph::OrientedGraph;
+using graph::TopologicalSortWorkspace;
+
+/**
+ * @brief Рёбра случайного ациклического графа в случайном порядке.
+ *
+ * @param numVertices Число вершин.
+ * @param gen Генератор случайных чисел.
+ *
+ * Каждое ребро ведёт из меньшей вершины в большую в перемешанной
+ * нумерации, поэтому граф ацикличен, но порядок номеров не совпадает
+ * с топологическим и рёбра часто идут против текущего порядка.
+ */
+static vector<pair<size_t, size_t>> RandomEdges(size_t numVertices,
+                                                mt19937_64* gen) {
+  uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+  vector<size_t> labels(numVertices);
+  vector<pair<size_t, size_t>> edges(4 * numVertices);
+
+  for (size_t i = 0; i < numVertices; i++) {
+    labels[i] = i;
+  }
+
+  std::shuffle(labels.begin(), labels.end(), *gen);
+
+  for (pair<size_t, size_t>& edge : edges) {
+    size_t start = vertex(*gen);
+    size_t end = vertex(*gen);
+
+    if (start == end) {
+      end = (end + 1) % numVertices;
+    }
+
+    edge = { labels[std::min(start, end)], labels[std::max(start, end)] };
+  }
+
+  return edges;
+}
+
+void BenchDynamicTopologicalOrder(size_t maxSize) {
+  // Пересортировка после каждого ребра стоит O(|V| |E|), поэтому она
+  // измеряется только на маленьких графах.
+  const size_t maxResortSize = 1000;
+  BenchSuite suite("BenchDynamicTopologicalOrder");
+  mt19937_64 gen(19);
+
+  for (size_t numVertices = 100; numVertices <= maxSize; numVertices *= 10) {
+    vector<pair<size_t, size_t>> edges = RandomEdges(numVertices, &gen);
+
+    suite.Run("DynamicTopologicalOrder/insert", numVertices, [&]() {
+      DynamicTopologicalOrder order;
+
+      for (size_t id = 0; id < numVertices; id++) {
+        order.AddVertex(id);
+      }
+
+      for (const pair<size_t, size_t>& edge : edges) {
+        DoNotOptimize(order.AddEdge(edge.first, edge.second));
+      }
+
+      return BenchCounters{edges.size(), edges.size()};
+    });
+
+    if (numVertices > maxResortSize) {
+      continue;
+    }
+
+    suite.Run("DynamicTopologicalOrder/resort", numVertices, [&]() {
+      OrientedGraph graph;
+      TopologicalSortWorkspace workspace;
+      vector<size_t> order;
+
+      for (size_t id = 0; id < numVertices; id++) {
+        graph.AddVertex(id);
+      }
+
+      for (const pair<size_t, size_t>& edge : edges) {
+        graph.AddEdge(edge.first, edge.second);
+        DoNotOptimize(graph::TopologicalSort(graph, &workspace, &order));
+      }
+
+      return BenchCounters{edges.size(), edges.size()};
+    });
+  }
+}
@@ -0,0 +1,186 @@
+/**
+ * @file bench/graph_bench.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Измерения производительности базовых операций классов графов.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+#include "bench_core.hpp"
+#include <graph.hpp>
+#include <oriented_graph.hpp>
+#include <weighted_graph.hpp>
+#include <weighted_oriented_graph.hpp>
+
+using std::pair;
+using std::string;
+using std::vector;
+using std::mt19937_64;
+using std::uniform_int_distribution;
+
+using graph::BasicGraph;
+using graph::BasicOrientedGraph;
+using graph::CompactOrientedGraph;
+using graph::FlatGraph;
+using graph::FlatOrientedGraph;
+using graph::FlatStorage;
+using graph::Graph;
+using graph::HashStorage;
+using graph::OrientedGraph;
+using graph::WeightedGraph;
+using graph::WeightedOrientedGraph;
+
+/**
+ * @brief Добавить ребро в невзвешенный граф.
+ *
+ * @tparam GraphType Тип графа.
+ *
+ * @param graph Граф.
+ * @param id1 Начало ребра.
+ * @param id2 Конец ребра.
+ */
+template<typename GraphType>
+static void Insert(GraphType* graph, size_t id1, size_t id2) {
+  graph->AddEdge(id1, id2);
+}
+
+/**
+ * @brief Добавить ребро во взвешенный неориентированный граф.
+ */
+template<typename Weight, typename Storage>
+static void Insert(WeightedGraph<Weight, Storage>* graph,
+                   size_t id1, size_t id2) {
+  graph->AddEdge(id1, id2, static_cast<Weight>(id1 ^ id2));
+}
+
+/**
+ * @brief Добавить ребро во взвешенный ориентированный граф.
+ */
+template<typename Weight, typename Storage>
+static void Insert(WeightedOrientedGraph<Weight, Storage>* graph,
+                   size_t id1, size_t id2) {
+  graph->AddEdge(id1, id2, static_cast<Weight>(id1 ^ id2));
+}
+
+/**
+ * @brief Измерить операции AddEdge(), HasEdge() и RemoveVertex().
+ *
+ * @tparam GraphType Тип графа.
+ *
+ * @param suite Набор измерений.
+ * @param className Название класса графа.
+ * @param numVertices Число вершин.
+ * @param edges Рёбра графа.
+ * @param queries Пары вершин для HasEdge(). Примерно половина из них
+ * является рёбрами графа.
+ * @param order Порядок удаления вершин.
+ */
+template<typename GraphType>
+static void BenchGraphClass(BenchSuite* suite, const string& className,
+                            size_t numVertices,
+                            const vector<pair<size_t, size_t>>& edges,
+                            const vector<pair<size_t, size_t>>& queries,
+                            const vector<size_t>& order) {
+  GraphType graph;
+
+  for (const pair<size_t, size_t>& edge : edges) {
+    Insert(&graph, edge.first, edge.second);
+  }
+
+  suite->Run("AddEdge/" + className, numVertices,
+             []() { return GraphType(); },
+             [&edges](GraphType& empty) {
+    for (const pair<size_t, size_t>& edge : edges) {
+      Insert(&empty, edge.first, edge.second);
+    }
+
+    return BenchCounters{edges.size(), edges.size()};
+  });
+
+  suite->Run("HasEdge/" + className, numVertices, [&graph, &queries]() {
+    size_t numFound = 0;
+
+    for (const pair<size_t, size_t>& query : queries) {
+      numFound += graph.HasEdge(query.first, query.second);
+    }
+
+    DoNotOptimize(numFound);
+
+    return BenchCounters{queries.size(), queries.size()};
+  });
+
+  suite->Run("RemoveVertex/" + className, numVertices,
+             [&graph]() { return graph; },
+             [&order, &edges](GraphType& copy) {
+    for (size_t id : order) {
+      copy.RemoveVertex(id);
+    }
+
+    return BenchCounters{order.size(), edges.size()};
+  });
+}
+
+void BenchGraphs(size_t maxSize) {
+  BenchSuite suite("BenchGraphs");
+
+  for (size_t numVertices = 1000; numVertices <= maxSize; numVertices *= 10) {
+    // Генератор инициализируется константой, чтобы все запуски программы
+    // измеряли одни и те же графы.
+    mt19937_64 gen(numVertices);
+    uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+    // Средняя степень вершины равна 8.
+    vector<pair<size_t, size_t>> edges(4 * numVertices);
+    vector<pair<size_t, size_t>> queries;
+    vector<size_t> order(numVertices);
+
+    for (pair<size_t, size_t>& edge : edges) {
+      edge = { vertex(gen), vertex(gen) };
+    }
+
+    queries.reserve(edges.size());
+
+    for (size_t i = 0; i < edges.size(); i++) {
+      queries.push_back(i % 2 == 0 ? edges[i] :
+                        pair<size_t, size_t>(vertex(gen), vertex(gen)));
+    }
+
+    for (size_t i = 0; i < numVertices; i++) {
+      order[i] = i;
+    }
+
+    std::shuffle(order.begin(), order.end(), gen);
+
+    BenchGraphClass<Graph>(&suite, "Graph", numVertices, edges, queries,
+                           order);
+    BenchGraphClass<OrientedGraph>(&suite, "OrientedGraph", numVertices,
+                                   edges, queries, order);
+    BenchGraphClass<WeightedGraph<double>>(&suite, "WeightedGraph",
+                                           numVertices, edges, queries,
+                                           order);
+    BenchGraphClass<WeightedOrientedGraph<double>>(
+        &suite, "WeightedOrientedGraph", numVertices, edges, queries, order);
+    BenchGraphClass<BasicGraph<HashStorage>>(&suite, "HashGraph",
+                                             numVertices, edges, queries,
+                                             order);
+    BenchGraphClass<BasicOrientedGraph<HashStorage>>(
+        &suite, "HashOrientedGraph", numVertices, edges, queries, order);
+    BenchGraphClass<FlatGraph>(&suite, "FlatGraph", numVertices, edges,
+                               queries, order);
+    BenchGraphClass<FlatOrientedGraph>(&suite, "FlatOrientedGraph",
+                                       numVertices, edges, queries, order);
+    BenchGraphClass<CompactOrientedGraph>(&suite, "CompactOrientedGraph",
+                                          numVertices, edges, queries,
+                                          order);
+    BenchGraphClass<WeightedGraph<double, FlatStorage>>(
+        &suite, "FlatWeightedGraph", numVertices, edges, queries, order);
+    BenchGraphClass<WeightedOrientedGraph<double, FlatStorage>>(
+        &suite, "FlatWeightedOrientedGraph", numVertices, edges, queries,
+        order);
+  }
+}
@@ -0,0 +1,165 @@
+/**
+ * @file bench/kruskal_bench.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Измерения производительности сортировки рёбер, алгоритма Краскала
+ * и алгоритма Борувки.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.hpp"
+#include "bench_core.hpp"
+#include <boruvka.hpp>
+#include <graph_builder.hpp>
+#include <kruskal.hpp>
+#include <weighted_csr_graph.hpp>
+#include <weighted_graph.hpp>
+
+using std::string;
+using std::vector;
+using std::mt19937_64;
+using std::uniform_int_distribution;
+using std::uniform_real_distribution;
+
+using graph::MstEdge;
+using graph::WeightedCsrGraph;
+using graph::WeightedGraph;
+using graph::WeightedGraphBuilder;
+
+/**
+ * @brief Измерить сортировку рёбер сравнениями и поразрядную сортировку.
+ *
+ * @param suite Набор измерений.
+ * @param edges Рёбра в исходном порядке.
+ * @param numThreads Число потоков для параллельной сортировки.
+ */
+static void BenchSort(BenchSuite* suite, const vector<MstEdge<double>>& edges,
+                      size_t numThreads) {
+  size_t size = edges.size();
+
+  // Каждый запуск сортирует свежую копию рёбер в исходном порядке.
+  auto setup = [&edges]() {
+    return edges;
+  };
+
+  suite->Run("SortEdges/std::sort", size, setup,
+             [size](vector<MstEdge<double>>& sorted) {
+    std::sort(sorted.begin(), sorted.end(),
+              [](const MstEdge<double>& edge1, const MstEdge<double>& edge2) {
+      return edge1.weight < edge2.weight;
+    });
+    DoNotOptimize(sorted.data());
+
+    return BenchCounters{size, 0};
+  });
+
+  suite->Run("SortEdges/radix/1", size, setup,
+             [size](vector<MstEdge<double>>& sorted) {
+    graph::SortEdges(sorted.data(), sorted.data() + size, 1);
+    DoNotOptimize(sorted.data());
+
+    return BenchCounters{size, 0};
+  });
+
+  if (numThreads > 1) {
+    suite->Run("SortEdges/radix/" + std::to_string(numThreads), size, setup,
+               [size, numThreads](vector<MstEdge<double>>& sorted) {
+      graph::SortEdges(sorted.data(), sorted.data() + size, numThreads);
+      DoNotOptimize(sorted.data());
+
+      return BenchCounters{size, 0};
+    });
+  }
+}
+
+/**
+ * @brief Измерить алгоритм Краскала, filter-Kruskal и алгоритм Борувки на
+ *        одном графе.
+ *
+ * @param suite Набор измерений.
+ * @param family Название семейства графов.
+ * @param graph Граф.
+ * @param numThreads Число потоков для сортировки и алгоритма Борувки.
+ */
+static void BenchGraph(BenchSuite* suite, const string& family,
+                       const WeightedGraph<double>& graph,
+                       size_t numThreads) {
+  WeightedCsrGraph<double> snapshot(graph);
+  vector<MstEdge<double>> forest;
+
+  suite->Run("Kruskal/" + family, snapshot.NumVertices(), [&]() {
+    graph::Kruskal(snapshot, numThreads, &forest);
+    DoNotOptimize(forest.data());
+
+    return BenchCounters{1, snapshot.NumEdges() / 2};
+  });
+
+  suite->Run("FilterKruskal/" + family, snapshot.NumVertices(), [&]() {
+    graph::FilterKruskal(snapshot, numThreads, &forest);
+    DoNotOptimize(forest.data());
+
+    return BenchCounters{1, snapshot.NumEdges() / 2};
+  });
+
+  suite->Run("Boruvka/1/" + family, snapshot.NumVertices(), [&]() {
+    graph::Boruvka(snapshot, 1, &forest);
+    DoNotOptimize(forest.data());
+
+    return BenchCounters{1, snapshot.NumEdges() / 2};
+  });
+
+  if (numThreads > 1) {
+    suite->Run("Boruvka/" + std::to_string(numThreads) + "/" + family,
+               snapshot.NumVertices(), [&]() {
+      graph::Boruvka(snapshot, numThreads, &forest);
+      DoNotOptimize(forest.data());
+
+      return BenchCounters{1, snapshot.NumEdges() / 2};
+    });
+  }
+}
+
+void BenchKruskal(size_t maxSize) {
+  BenchSuite suite("BenchKruskal");
+  // Число потоков для параллельной сортировки.
+  size_t numThreads = std::thread::hardware_concurrency();
+
+  for (size_t numVertices = 1000; numVertices <= maxSize; numVertices *= 10) {
+    mt19937_64 gen(numVertices);
+    uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+    uniform_real_distribution<double> weight(0.0, 1.0);
+    WeightedGraphBuilder<double> builder;
+    WeightedGraph<double> sparse;
+    WeightedGraph<double> dense;
+    vector<MstEdge<double>> edges;
+
+    // Разреженный граф со средней степенью 8.
+    for (size_t i = 0; i < 4 * numVertices; i++) {
+      builder.AddEdge(vertex(gen), vertex(gen), weight(gen));
+    }
+
+    builder.Build(&sparse);
+
+    // Плотный граф со средней степенью 64: большая часть рёбер тяжёлая
+    // и отбрасывается алгоритмом filter-Kruskal без сортировки.
+    for (size_t i = 0; i < 32 * numVertices; i++) {
+      size_t start = vertex(gen);
+      size_t end = vertex(gen);
+      double w = weight(gen);
+
+      builder.AddEdge(start, end, w);
+      edges.push_back(MstEdge<double>{start, end, w});
+    }
+
+    builder.Build(&dense);
+
+    BenchSort(&suite, edges, numThreads);
+    BenchGraph(&suite, "sparse", sparse, numThreads);
+    BenchGraph(&suite, "dense", dense, numThreads);
+  }
+}
@@ -0,0 +1,54 @@
+/**
+ * @file bench/main.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Файл с функией main() для измерений производительности.
+ *
+ * Использование:
+ * @code
+ * graph_bench [maxSize [minTime]]
+ * @endcode
+ * Размеры графов перебираются от 1000 вершин до maxSize (по умолчанию
+ * 100000) с шагом в 10 раз, каждое измерение длится не меньше minTime
+ * секунд (по умолчанию 0.5). Результаты печатаются в стандартный поток
+ * вывода в формате JSON, по одному объекту на строку.
+ */
+
+#include <cstdio>
+#include "bench.hpp"
+#include "bench_core.hpp"
+
+int main(int argc, char* argv[]) {
+  // Максимальное число вершин по умолчанию.
+  size_t maxSize = 100'000;
+  // Минимальное время одного измерения по умолчанию.
+  double minTime = 0.5;
+
+  if (argc >= 2) {
+    // Графы до 10^7 вершин измеряются несколько минут и требуют
+    // нескольких гигабайт памяти.
+    if (std::sscanf(argv[1], "%zu", &maxSize) != 1) {
+      return -1;
+    }
+  }
+
+  if (argc >= 3) {
+    if (std::sscanf(argv[2], "%lf", &minTime) != 1) {
+      return -1;
+    }
+  }
+
+  BenchSuite::SetMinTime(minTime);
+
+  BenchGraphs(maxSize);
+  BenchTopologicalSort(maxSize);
+  BenchDijkstra(maxSize);
+  BenchBellmanFord(maxSize);
+  BenchKruskal(maxSize);
+  BenchPrim(maxSize);
+  BenchBfs(maxSize);
+  BenchScc(maxSize);
+  BenchDynamicTopologicalOrder(maxSize);
+
+  return 0;
+}
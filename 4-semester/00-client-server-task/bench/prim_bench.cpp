@@ -0,0 +1,122 @@
+/**
+ * @file bench/prim_bench.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Измерения производительности вариантов алгоритма Прима.
+ */
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include "bench_core.hpp"
+#include <graph_builder.hpp>
+#include <heaps.hpp>
+#include <kruskal.hpp>
+#include <prim.hpp>
+#include <weighted_csr_graph.hpp>
+#include <weighted_graph.hpp>
+
+using std::string;
+using std::vector;
+using std::mt19937_64;
+using std::uniform_int_distribution;
+using std::uniform_real_distribution;
+
+using graph::MstEdge;
+using graph::QuaternaryHeap;
+using graph::WeightedCsrGraph;
+using graph::WeightedGraph;
+using graph::WeightedGraphBuilder;
+
+/**
+ * @brief Построить случайный граф с заданной средней степенью.
+ *
+ * @param numVertices Число вершин.
+ * @param degree Средняя степень вершины.
+ * @param graph Указатель на граф.
+ */
+static void RandomGraph(size_t numVertices, size_t degree,
+                        WeightedGraph<double>* graph) {
+  mt19937_64 gen(numVertices * degree);
+  uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+  uniform_real_distribution<double> weight(0.0, 1.0);
+  WeightedGraphBuilder<double> builder;
+
+  for (size_t i = 0; i < numVertices; i++) {
+    builder.AddVertex(i);
+  }
+
+  for (size_t i = 0; i < numVertices * degree / 2; i++) {
+    builder.AddEdge(vertex(gen), vertex(gen), weight(gen));
+  }
+
+  builder.Build(graph);
+}
+
+/**
+ * @brief Измерить варианты алгоритма Прима на одном графе.
+ *
+ * @param suite Набор измерений.
+ * @param family Название семейства графов.
+ * @param graph Граф.
+ * @param dense Измерять ли вариант за O(|V|^2).
+ */
+static void BenchGraph(BenchSuite* suite, const string& family,
+                       const WeightedGraph<double>& graph, bool dense) {
+  WeightedCsrGraph<double> snapshot(graph);
+  vector<MstEdge<double>> forest;
+  QuaternaryHeap<double> heap;
+  size_t numEdges = snapshot.NumEdges() / 2;
+
+  suite->Run("Prim/indexed/" + family, snapshot.NumVertices(), [&]() {
+    graph::Prim(snapshot, &heap, &forest);
+    DoNotOptimize(forest.data());
+
+    return BenchCounters{1, numEdges};
+  });
+
+  suite->Run("Prim/lazy/" + family, snapshot.NumVertices(), [&]() {
+    graph::LazyPrim(snapshot, &forest);
+    DoNotOptimize(forest.data());
+
+    return BenchCounters{1, numEdges};
+  });
+
+  if (dense) {
+    suite->Run("Prim/dense/" + family, snapshot.NumVertices(), [&]() {
+      graph::DensePrim(snapshot, &forest);
+      DoNotOptimize(forest.data());
+
+      return BenchCounters{1, numEdges};
+    });
+  }
+}
+
+void BenchPrim(size_t maxSize) {
+  BenchSuite suite("BenchPrim");
+  // Число вершин, на котором сравниваются графы разной плотности.
+  const size_t denseSize = 2000;
+  // Вариант за O(|V|^2) на больших разреженных графах не измеряется.
+  const size_t maxDenseSize = 10000;
+
+  // Разреженные графы со средней степенью 8.
+  for (size_t numVertices = 1000; numVertices <= maxSize; numVertices *= 10) {
+    WeightedGraph<double> graph;
+
+    RandomGraph(numVertices, 8, &graph);
+    BenchGraph(&suite, "sparse", graph, numVertices <= maxDenseSize);
+  }
+
+  // Графы одного размера с растущей степенью: по ним выбран порог
+  // в graph::IsDense().
+  if (denseSize <= maxSize) {
+    for (size_t degree = 16; degree <= denseSize; degree *= 4) {
+      WeightedGraph<double> graph;
+
+      RandomGraph(denseSize, degree, &graph);
+      BenchGraph(&suite, "degree-" + std::to_string(degree), graph, true);
+    }
+  }
+}
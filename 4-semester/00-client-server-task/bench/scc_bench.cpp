@@ -0,0 +1,109 @@
+/**
+ * @file bench/scc_bench.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Измерения производительности поиска компонент сильной связности.
+ */
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.hpp"
+#include "bench_core.hpp"
+#include <csr_graph.hpp>
+#include <graph_builder.hpp>
+#include <oriented_graph.hpp>
+#include <scc.hpp>
+
+using std::string;
+using std::vector;
+using std::mt19937_64;
+using std::uniform_int_distribution;
+
+using graph::CsrGraph;
+using graph::GraphBuilder;
+using graph::OrientedGraph;
+
+/**
+ * @brief Построить случайный ориентированный граф.
+ *
+ * @param numVertices Число вершин.
+ * @param numEdges Число рёбер.
+ * @param graph Указатель на граф.
+ *
+ * При средней степени меньше единицы граф состоит из маленьких компонент
+ * и почти целиком удаляется отсечением, при степени больше единицы
+ * появляется одна большая компонента.
+ */
+static void RandomGraph(size_t numVertices, size_t numEdges,
+                        OrientedGraph* graph) {
+  mt19937_64 gen(numVertices + numEdges);
+  uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+  GraphBuilder builder;
+
+  builder.Reserve(numVertices, numEdges);
+
+  for (size_t i = 0; i < numVertices; i++) {
+    builder.AddVertex(i);
+  }
+
+  for (size_t i = 0; i < numEdges; i++) {
+    builder.AddEdge(vertex(gen), vertex(gen));
+  }
+
+  builder.Build(graph);
+}
+
+void BenchScc(size_t maxSize) {
+  BenchSuite suite("BenchScc");
+  size_t numThreads = std::thread::hardware_concurrency();
+  vector<size_t> threadCounts(1, 1);
+
+  if (numThreads > 1) {
+    threadCounts.push_back(numThreads);
+  }
+
+  for (size_t numVertices = 1000; numVertices <= maxSize; numVertices *= 10) {
+    // Средняя степень в десятых долях.
+    for (size_t degree : { 8, 20, 80 }) {
+      OrientedGraph graph;
+
+      RandomGraph(numVertices, numVertices * degree / 10, &graph);
+
+      CsrGraph snapshot(graph);
+      CsrGraph reverse;
+      vector<size_t> component;
+      string family = "degree-" + std::to_string(degree / 10) + "." +
+                      std::to_string(degree % 10);
+
+      reverse.AssignTranspose(snapshot);
+
+      suite.Run("Scc/tarjan/" + family, numVertices, [&]() {
+        DoNotOptimize(graph::TarjanScc(snapshot, &component));
+
+        return BenchCounters{1, snapshot.NumEdges()};
+      });
+
+      for (size_t threads : threadCounts) {
+        suite.Run("Scc/forward-backward/" + std::to_string(threads) + "/" +
+                  family, numVertices, [&]() {
+          DoNotOptimize(graph::ForwardBackwardScc(snapshot, reverse, threads,
+                                                  &component));
+
+          return BenchCounters{1, snapshot.NumEdges()};
+        });
+      }
+
+      size_t numComponents = graph::TarjanScc(snapshot, &component);
+
+      suite.Run("Scc/sort-components/" + family, numVertices, [&]() {
+        graph::SortComponents(snapshot, numComponents, &component);
+        DoNotOptimize(component.data());
+
+        return BenchCounters{1, snapshot.NumEdges()};
+      });
+    }
+  }
+}
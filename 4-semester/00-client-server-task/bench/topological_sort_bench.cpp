@@ -0,0 +1,227 @@
+/**
+ * @file bench/topological_sort_bench.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Измерения производительности топологической сортировки.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+#include "bench_core.hpp"
+#include <csr_graph.hpp>
+#include <graph_builder.hpp>
+#include <oriented_graph.hpp>
+#include <topological_sort.hpp>
+
+using std::pair;
+using std::string;
+using std::vector;
+using std::mt19937_64;
+using std::uniform_int_distribution;
+
+using graph::CsrGraph;
+using graph::GraphBuilder;
+using graph::OrientedGraph;
+using graph::TopologicalSortWorkspace;
+
+/**
+ * @brief Цепочка 0 -> 1 -> ... -> n - 1.
+ *
+ * @param numVertices Число вершин.
+ * @param gen Генератор случайных чисел (не используется).
+ */
+static vector<pair<size_t, size_t>> ChainDag(size_t numVertices,
+                                             mt19937_64*) {
+  vector<pair<size_t, size_t>> edges;
+
+  edges.reserve(numVertices);
+
+  for (size_t i = 0; i + 1 < numVertices; i++) {
+    edges.emplace_back(i, i + 1);
+  }
+
+  return edges;
+}
+
+/**
+ * @brief Широкий веер: из вершины 0 рёбра ведут во все вершины
+ *        1, ..., n - 2, а из них --- в вершину n - 1.
+ *
+ * @param numVertices Число вершин.
+ * @param gen Генератор случайных чисел (не используется).
+ */
+static vector<pair<size_t, size_t>> FanDag(size_t numVertices,
+                                           mt19937_64*) {
+  vector<pair<size_t, size_t>> edges;
+
+  edges.reserve(2 * numVertices);
+
+  for (size_t i = 1; i + 1 < numVertices; i++) {
+    edges.emplace_back(0, i);
+    edges.emplace_back(i, numVertices - 1);
+  }
+
+  return edges;
+}
+
+/**
+ * @brief Случайный ациклический граф со средней степенью 8: каждое ребро
+ *        соединяет две случайные вершины и ведёт из меньшей в большую.
+ *
+ * @param numVertices Число вершин.
+ * @param gen Генератор случайных чисел.
+ */
+static vector<pair<size_t, size_t>> RandomDag(size_t numVertices,
+                                              mt19937_64* gen) {
+  uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+  vector<pair<size_t, size_t>> edges(4 * numVertices);
+
+  for (pair<size_t, size_t>& edge : edges) {
+    edge = { vertex(*gen), vertex(*gen) };
+
+    if (edge.second < edge.first) {
+      std::swap(edge.first, edge.second);
+    }
+
+    // Петли заменяются рёбрами в следующую вершину.
+    if (edge.first == edge.second) {
+      edge.second = (edge.second + 1) % numVertices;
+    }
+  }
+
+  return edges;
+}
+
+/**
+ * @brief Граф со степенным распределением степеней (модель
+ *        предпочтительного присоединения Барабаши --- Альберт).
+ *
+ * @param numVertices Число вершин.
+ * @param gen Генератор случайных чисел.
+ *
+ * Каждая новая вершина получает по 4 ребра из уже имеющихся вершин.
+ * Начало ребра выбирается с вероятностью, пропорциональной степени
+ * вершины: для этого выбирается случайный конец случайного из уже
+ * построенных рёбер. Все рёбра ведут из старых вершин в новые, поэтому
+ * граф ацикличен.
+ */
+static vector<pair<size_t, size_t>> PowerLawDag(size_t numVertices,
+                                                mt19937_64* gen) {
+  const size_t numEdgesPerVertex = 4;
+  vector<pair<size_t, size_t>> edges;
+  vector<size_t> endpoints;
+
+  edges.reserve(numEdgesPerVertex * numVertices);
+  endpoints.reserve(2 * numEdgesPerVertex * numVertices);
+
+  for (size_t id = 1; id < numVertices; id++) {
+    for (size_t i = 0; i < numEdgesPerVertex; i++) {
+      size_t start = 0;
+
+      if (!endpoints.empty()) {
+        uniform_int_distribution<size_t> endpoint(0, endpoints.size() - 1);
+
+        start = endpoints[endpoint(*gen)];
+      }
+
+      edges.emplace_back(start, id);
+    }
+
+    for (size_t i = edges.size() - numEdgesPerVertex; i < edges.size(); i++) {
+      endpoints.push_back(edges[i].first);
+      endpoints.push_back(edges[i].second);
+    }
+  }
+
+  return edges;
+}
+
+/**
+ * @brief Измерить топологическую сортировку на одном графе.
+ *
+ * @param suite Набор измерений.
+ * @param family Название семейства графов.
+ * @param numVertices Число вершин.
+ * @param edges Рёбра графа.
+ * @param gen Генератор случайных чисел.
+ */
+static void BenchDag(BenchSuite* suite, const string& family,
+                     size_t numVertices, vector<pair<size_t, size_t>> edges,
+                     mt19937_64* gen) {
+  // Номера вершин перемешиваются, чтобы порядок номеров не совпадал
+  // с топологическим.
+  vector<size_t> labels(numVertices);
+
+  for (size_t i = 0; i < numVertices; i++) {
+    labels[i] = i;
+  }
+
+  std::shuffle(labels.begin(), labels.end(), *gen);
+
+  for (pair<size_t, size_t>& edge : edges) {
+    edge = { labels[edge.first], labels[edge.second] };
+  }
+
+  OrientedGraph graph;
+  GraphBuilder builder;
+
+  builder.Reserve(numVertices, edges.size());
+
+  for (size_t id : labels) {
+    builder.AddVertex(id);
+  }
+
+  builder.AddEdges(edges.begin(), edges.end());
+  builder.Build(&graph);
+
+  CsrGraph snapshot(graph);
+  TopologicalSortWorkspace workspace;
+  vector<size_t> order;
+  vector<vector<size_t>> levels;
+  size_t numEdges = snapshot.NumEdges();
+  size_t numThreads = std::max<size_t>(std::thread::hardware_concurrency(),
+                                       1);
+
+  // Первый запуск выделяет рабочую память, последующие её переиспользуют.
+  suite->Run("TopologicalSort/" + family, numVertices,
+             [&graph, &workspace, &order, numEdges]() {
+    DoNotOptimize(graph::TopologicalSort(graph, &workspace, &order));
+
+    return BenchCounters{1, numEdges};
+  });
+
+  suite->Run("TopologicalSort/csr/" + family, numVertices,
+             [&snapshot, &workspace, &order, numEdges]() {
+    DoNotOptimize(graph::TopologicalSort(snapshot, &workspace, &order));
+
+    return BenchCounters{1, numEdges};
+  });
+
+  suite->Run("TopologicalLevels/" + family, numVertices,
+             [&snapshot, &levels, numThreads, numEdges]() {
+    DoNotOptimize(graph::TopologicalLevels(snapshot, &levels, numThreads));
+
+    return BenchCounters{1, numEdges};
+  });
+}
+
+void BenchTopologicalSort(size_t maxSize) {
+  BenchSuite suite("BenchTopologicalSort");
+
+  for (size_t numVertices = 1000; numVertices <= maxSize; numVertices *= 10) {
+    mt19937_64 gen(numVertices);
+
+    BenchDag(&suite, "chain", numVertices, ChainDag(numVertices, &gen), &gen);
+    BenchDag(&suite, "fan", numVertices, FanDag(numVertices, &gen), &gen);
+    BenchDag(&suite, "random", numVertices, RandomDag(numVertices, &gen),
+             &gen);
+    BenchDag(&suite, "power_law", numVertices,
+             PowerLawDag(numVertices, &gen), &gen);
+  }
+}
@@ -0,0 +1,89 @@
+/**
+ * @file barrier.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Барьер для синхронизации фаз параллельных алгоритмов.
+ */
+
+#ifndef INCLUDE_BARRIER_HPP_
+#define INCLUDE_BARRIER_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+namespace graph {
+
+/**
+ * @brief Наибольшее число потоков для параллельных алгоритмов.
+ *
+ * @return Функция возвращает число аппаратных потоков (не меньше одного).
+ * Больше потоков алгоритмы не запускают: лишние потоки не ускоряют
+ * вычисления, а их создание может исчерпать ресурсы процесса.
+ */
+inline size_t MaxThreads() {
+  return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+/**
+ * @brief Многоразовый барьер (упрощённый аналог std::barrier из C++20).
+ *
+ * Каждый из numThreads потоков вызывает Wait() в конце фазы. Вызов
+ * возвращается, когда до барьера дошли все потоки, после чего барьер
+ * готов к следующей фазе.
+ */
+class Barrier {
+ public:
+  /**
+   * @brief Конструктор класса Barrier.
+   *
+   * @param numThreads Число потоков, которые синхронизируются барьером.
+   */
+  explicit Barrier(size_t numThreads) :
+    numThreads(numThreads),
+    numWaiting(0),
+    generation(0) {
+  }
+
+  Barrier(const Barrier&) = delete;
+  Barrier& operator=(const Barrier&) = delete;
+
+  /**
+   * @brief Дождаться, пока до барьера дойдут все потоки.
+   *
+   * Все записи в память, сделанные потоками до вызова Wait(), видны всем
+   * потокам после возврата из него.
+   */
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    size_t currentGeneration = generation;
+
+    if (++numWaiting == numThreads) {
+      numWaiting = 0;
+      generation++;
+      lock.unlock();
+      condition.notify_all();
+      return;
+    }
+
+    condition.wait(lock, [&]() { return generation != currentGeneration; });
+  }
+
+ private:
+  //! Число потоков.
+  size_t numThreads;
+  //! Число потоков, дошедших до барьера в текущей фазе.
+  size_t numWaiting;
+  //! Номер текущей фазы.
+  size_t generation;
+  //! Мьютекс для доступа к счётчикам.
+  std::mutex mutex;
+  //! Условная переменная для ожидания остальных потоков.
+  std::condition_variable condition;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_BARRIER_HPP_
@@ -0,0 +1,481 @@
+/**
+ * @file bellman_ford.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация алгоритма Беллмана-Форда и его вариантов: очереди SPFA
+ * и параллельной релаксации рёбер.
+ */
+
+#ifndef INCLUDE_BELLMAN_FORD_HPP_
+#define INCLUDE_BELLMAN_FORD_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <barrier.hpp>
+#include <dijkstra.hpp>
+#include <trace.hpp>
+#include <weighted_csr_graph.hpp>
+
+namespace graph {
+
+/**
+ * @brief Вариант алгоритма Беллмана-Форда.
+ */
+enum class BellmanFordMode {
+  //! Последовательные проходы по всем рёбрам.
+  Classic,
+  //! Очередь вершин (SPFA) с эвристиками SLF и LLL.
+  Spfa,
+  //! Параллельные проходы по массиву входящих рёбер.
+  Parallel
+};
+
+/**
+ * @brief Найти цикл в графе родителей дерева кратчайших путей.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param tree Дерево кратчайших путей.
+ * @param cycle Вектор, в который записываются внутренние номера вершин
+ * цикла в порядке рёбер: cycle[i] -> cycle[i + 1] -> ... -> cycle[0].
+ * @return Функция возвращает true, если цикл найден.
+ *
+ * Оценки расстояний только уменьшаются, поэтому любой цикл в графе
+ * родителей имеет отрицательный вес.
+ */
+template<typename Weight>
+bool FindParentCycle(const ShortestPathTree<Weight>& tree,
+                     std::vector<size_t>* cycle) {
+  const std::vector<size_t>& parent = tree.parent;
+  // Номер обхода, в котором вершина была посещена (0 --- не посещена).
+  std::vector<size_t> walk(parent.size(), 0);
+
+  for (size_t start = 0; start < parent.size(); start++) {
+    size_t vertex = start;
+
+    while (vertex != noVertex && walk[vertex] == 0) {
+      walk[vertex] = start + 1;
+      vertex = parent[vertex];
+    }
+
+    if (vertex == noVertex || walk[vertex] != start + 1) {
+      continue;
+    }
+
+    // Вершина vertex лежит на цикле: обходим его по родителям и
+    // разворачиваем, чтобы вершины шли в направлении рёбер.
+    cycle->clear();
+
+    size_t current = vertex;
+
+    do {
+      cycle->push_back(current);
+      current = parent[current];
+    } while (current != vertex);
+
+    std::reverse(cycle->begin(), cycle->end());
+
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Алгоритм Беллмана-Форда на CSR снимке.
+ *
+ * @tparam Weight Знаковый тип веса.
+ *
+ * @param graph Граф в формате CSR.
+ * @param source Внутренний номер источника.
+ * @param tree Дерево, в которое записываются расстояния и пути.
+ * @param cycle Вектор, в который записывается цикл отрицательного веса
+ * (@sa FindParentCycle()).
+ * @return Функция возвращает false, если из источника достижим цикл
+ * отрицательного веса. В этом случае расстояния в tree не окончательные.
+ *
+ * Каждый проход перебирает массивы targets и weights подряд
+ * и пропускает вершины с бесконечной оценкой. Алгоритм останавливается,
+ * как только проход ничего не изменил. Если оценки меняются и после
+ * |V| проходов, то в графе родителей ищется цикл.
+ */
+template<typename Weight>
+bool BellmanFord(const WeightedCsrGraph<Weight>& graph, size_t source,
+                 ShortestPathTree<Weight>* tree, std::vector<size_t>* cycle) {
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  Span<Weight> weights = graph.Weights();
+  const Weight infinity = ShortestPathTree<Weight>::Infinity();
+  std::vector<Weight>& distance = tree->distance;
+  size_t numVertices = graph.NumVertices();
+  CpuMeter meter(CpuBudget::Current());
+
+  tree->Reset(numVertices);
+  cycle->clear();
+
+  distance[source] = Weight();
+
+  for (size_t round = 1; ; round++) {
+    bool changed = false;
+
+    for (size_t vertex = 0; vertex < numVertices; vertex++) {
+      meter.Tick(offsets[vertex + 1] - offsets[vertex] + 1);
+
+      if (distance[vertex] == infinity) {
+        continue;
+      }
+
+      for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+        Weight candidate = distance[vertex] + weights[k];
+        size_t destination = targets[k];
+
+        if (candidate < distance[destination]) {
+          distance[destination] = candidate;
+          tree->parent[destination] = vertex;
+          changed = true;
+        }
+      }
+    }
+
+    if (!changed) {
+      return true;
+    }
+
+    if (round >= numVertices && FindParentCycle(*tree, cycle)) {
+      return false;
+    }
+  }
+}
+
+/**
+ * @brief Алгоритм SPFA (Shortest Path Faster Algorithm) на CSR снимке.
+ *
+ * @tparam Weight Знаковый тип веса.
+ *
+ * @param graph Граф в формате CSR.
+ * @param source Внутренний номер источника.
+ * @param tree Дерево, в которое записываются расстояния и пути.
+ * @param cycle Вектор, в который записывается цикл отрицательного веса.
+ * @return Функция возвращает false, если из источника достижим цикл
+ * отрицательного веса.
+ *
+ * Рёбра релаксируются только у вершин, оценка которых изменилась: такие
+ * вершины хранятся в очереди. Две эвристики меняют порядок очереди:
+ * - SLF (Small Label First): вершина с оценкой меньше, чем у первой
+ *   вершины очереди, добавляется в начало;
+ * - LLL (Large Label Last): пока оценка первой вершины больше средней
+ *   по очереди, она переносится в конец.
+ *
+ * Отрицательный цикл проверяется после каждых |V| релаксаций поиском
+ * цикла в графе родителей, что в среднем стоит O(1) на релаксацию.
+ */
+template<typename Weight>
+bool Spfa(const WeightedCsrGraph<Weight>& graph, size_t source,
+          ShortestPathTree<Weight>* tree, std::vector<size_t>* cycle) {
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  Span<Weight> weights = graph.Weights();
+  std::vector<Weight>& distance = tree->distance;
+  size_t numVertices = graph.NumVertices();
+  std::vector<bool> queued(numVertices, false);
+  std::deque<size_t> queue;
+  // Сумма оценок вершин в очереди (для эвристики LLL).
+  double sum = 0;
+  size_t numRelaxations = 0;
+  CpuMeter meter(CpuBudget::Current());
+
+  tree->Reset(numVertices);
+  cycle->clear();
+
+  distance[source] = Weight();
+  queue.push_back(source);
+  queued[source] = true;
+
+  while (!queue.empty()) {
+    // Ошибка округления в sum не должна зациклить перенос вершин.
+    for (size_t step = queue.size(); step > 0 &&
+         static_cast<double>(distance[queue.front()]) * queue.size() > sum;
+         step--) {
+      queue.push_back(queue.front());
+      queue.pop_front();
+    }
+
+    size_t vertex = queue.front();
+
+    queue.pop_front();
+    queued[vertex] = false;
+    sum -= static_cast<double>(distance[vertex]);
+    meter.Tick(offsets[vertex + 1] - offsets[vertex] + 1);
+
+    for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+      Weight candidate = distance[vertex] + weights[k];
+      size_t destination = targets[k];
+
+      if (!(candidate < distance[destination])) {
+        continue;
+      }
+
+      if (queued[destination]) {
+        sum -= static_cast<double>(distance[destination]);
+      }
+
+      distance[destination] = candidate;
+      tree->parent[destination] = vertex;
+      sum += static_cast<double>(candidate);
+
+      if (!queued[destination]) {
+        queued[destination] = true;
+
+        if (!queue.empty() && candidate < distance[queue.front()]) {
+          queue.push_front(destination);
+        } else {
+          queue.push_back(destination);
+        }
+      }
+
+      if (++numRelaxations % numVertices == 0 &&
+          FindParentCycle(*tree, cycle)) {
+        return false;
+      }
+    }
+
+    if (queue.empty()) {
+      sum = 0;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Параллельный алгоритм Беллмана-Форда на CSR снимке.
+ *
+ * @tparam Weight Знаковый тип веса.
+ *
+ * @param graph Граф в формате CSR.
+ * @param source Внутренний номер источника.
+ * @param numThreads Число потоков (не больше MaxThreads()).
+ * @param tree Дерево, в которое записываются расстояния и пути.
+ * @param cycle Вектор, в который записывается цикл отрицательного веса.
+ * @return Функция возвращает false, если из источника достижим цикл
+ * отрицательного веса.
+ *
+ * Проходы ведутся по снимку с обращёнными рёбрами: каждый поток владеет
+ * непрерывным диапазоном вершин с примерно одинаковым числом входящих
+ * рёбер, читает их концы и веса подряд и записывает оценки и родителей
+ * только своих вершин. Поэтому записи не требуют блокировок и операций
+ * compare-and-swap, а оценки чужих вершин читаются атомарно без
+ * упорядочивания. Оценка, прочитанная во время прохода, не больше оценки
+ * на начало прохода, поэтому после k проходов оценка каждой вершины не
+ * больше длины кратчайшего пути из k рёбер, как и у последовательного
+ * алгоритма.
+ *
+ * Ограничение процессорного времени (@sa CpuBudget) проверяется между
+ * проходами: при его превышении все потоки завершаются, после чего
+ * выбрасывается исключение graph::BudgetExceeded.
+ */
+template<typename Weight>
+bool ParallelBellmanFord(const WeightedCsrGraph<Weight>& graph,
+                         size_t source, size_t numThreads,
+                         ShortestPathTree<Weight>* tree,
+                         std::vector<size_t>* cycle) {
+  WeightedCsrGraph<Weight> reverse;
+
+  reverse.AssignTranspose(graph);
+
+  Span<size_t> offsets = reverse.Offsets();
+  Span<size_t> targets = reverse.Targets();
+  Span<Weight> weights = reverse.Weights();
+  const Weight infinity = ShortestPathTree<Weight>::Infinity();
+  size_t numVertices = graph.NumVertices();
+
+  numThreads = std::max<size_t>(
+      std::min({ numThreads, MaxThreads(), numVertices }), 1);
+
+  std::vector<std::atomic<Weight>> distance(numVertices);
+  // Границы диапазонов вершин потоков.
+  std::vector<size_t> bounds(numThreads + 1, numVertices);
+  // Номер последнего прохода, в котором изменилась какая-то оценка.
+  std::atomic<size_t> lastChanged(0);
+  Barrier barrier(numThreads);
+  bool found = false;
+  CpuBudget* budget = CpuBudget::Current();
+  // Номер прохода, после которого алгоритм прерван по ограничению времени.
+  std::atomic<size_t> abortedRound(noVertex);
+
+  for (size_t vertex = 0; vertex < numVertices; vertex++) {
+    distance[vertex].store(infinity, std::memory_order_relaxed);
+  }
+
+  for (size_t t = 0; t < numThreads; t++) {
+    bounds[t] = std::lower_bound(offsets.begin(), offsets.end() - 1,
+                                 offsets.back() * t / numThreads) -
+                offsets.begin();
+  }
+
+  tree->Reset(numVertices);
+  cycle->clear();
+
+  distance[source].store(Weight(), std::memory_order_relaxed);
+  tree->distance[source] = Weight();
+
+  auto worker = [&](size_t thread) {
+    CpuMeter meter(budget);
+
+    for (size_t round = 1; ; round++) {
+      bool changed = false;
+
+      for (size_t vertex = bounds[thread]; vertex < bounds[thread + 1];
+           vertex++) {
+        Weight best = distance[vertex].load(std::memory_order_relaxed);
+        size_t bestParent = noVertex;
+
+        for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+          Weight value = distance[targets[k]].load(std::memory_order_relaxed);
+
+          if (value != infinity && value + weights[k] < best) {
+            best = value + weights[k];
+            bestParent = targets[k];
+          }
+        }
+
+        if (bestParent != noVertex) {
+          distance[vertex].store(best, std::memory_order_relaxed);
+          tree->distance[vertex] = best;
+          tree->parent[vertex] = bestParent;
+          changed = true;
+        }
+      }
+
+      if (changed) {
+        lastChanged.store(round, std::memory_order_relaxed);
+      }
+
+      /* Решение о прерывании принимает поток 0 по времени, списанному до
+      барьера. Как и lastChanged, оно записывается номером прохода, чтобы
+      отстающий поток не увидел его на предыдущем проходе. */
+      meter.Charge();
+
+      if (thread == 0 && budget && budget->Exceeded()) {
+        abortedRound.store(round, std::memory_order_relaxed);
+      }
+
+      barrier.Wait();
+
+      // Быстрый поток мог уже записать номер следующего прохода.
+      if (lastChanged.load(std::memory_order_relaxed) < round ||
+          abortedRound.load(std::memory_order_relaxed) <= round) {
+        break;
+      }
+
+      if (round >= numVertices) {
+        if (thread == 0) {
+          found = FindParentCycle(*tree, cycle);
+        }
+
+        barrier.Wait();
+
+        if (found) {
+          break;
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (size_t t = 1; t < numThreads; t++) {
+    threads.emplace_back(worker, t);
+  }
+
+  worker(0);
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Если последний проход ничего не изменил, то оценки уже окончательные.
+  if (abortedRound != noVertex && lastChanged >= abortedRound) {
+    throw BudgetExceeded();
+  }
+
+  return !found;
+}
+
+/**
+ * @brief Расстояния от вершины до всех достижимых вершин графа алгоритмом
+ *        Беллмана-Форда.
+ *
+ * @tparam GraphType Тип графа: graph::WeightedOrientedGraph или любой
+ * другой класс с методами Vertices(), HasVertex(), Edges() и EdgeWeight().
+ *
+ * @param graph Исходный граф.
+ * @param source Номер начальной вершины.
+ * @param mode Вариант алгоритма.
+ * @param numThreads Число потоков (только для BellmanFordMode::Parallel).
+ * @param distances Вектор, в который записываются пары (вершина,
+ * расстояние) для всех достижимых вершин по возрастанию номеров вершин.
+ * @param cycle Вектор, в который записываются номера вершин цикла
+ * отрицательного веса в порядке рёбер.
+ * @return Функция возвращает false, если из источника достижим цикл
+ * отрицательного веса. В этом случае вектор distances пуст.
+ *
+ * Граф один раз переводится в CSR снимок, поэтому хеш-таблица весов
+ * исходного графа во внутреннем цикле не используется. Если вершины
+ * source в графе нет, то функция выбрасывает исключение std::out_of_range.
+ */
+template<typename GraphType>
+bool BellmanFord(
+    const GraphType& graph, size_t source, BellmanFordMode mode,
+    size_t numThreads,
+    std::vector<std::pair<size_t,
+                          typename GraphType::WeightType>>* distances,
+    std::vector<size_t>* cycle) {
+  using Weight = typename GraphType::WeightType;
+
+  WeightedCsrGraph<Weight> snapshot(graph);
+  ShortestPathTree<Weight> tree;
+  size_t sourceIndex = snapshot.InternalId(source);
+  bool result = false;
+
+  switch (mode) {
+    case BellmanFordMode::Classic:
+      result = BellmanFord(snapshot, sourceIndex, &tree, cycle);
+      break;
+    case BellmanFordMode::Spfa:
+      result = Spfa(snapshot, sourceIndex, &tree, cycle);
+      break;
+    case BellmanFordMode::Parallel:
+      result = ParallelBellmanFord(snapshot, sourceIndex, numThreads, &tree,
+                                   cycle);
+      break;
+  }
+
+  distances->clear();
+
+  for (size_t& vertex : *cycle) {
+    vertex = snapshot.ExternalId(vertex);
+  }
+
+  if (!result) {
+    return false;
+  }
+
+  for (size_t index : snapshot.Vertices()) {
+    if (tree.distance[index] != ShortestPathTree<Weight>::Infinity()) {
+      distances->emplace_back(snapshot.ExternalId(index),
+                              tree.distance[index]);
+    }
+  }
+
+  return true;
+}
+
+}  // namespace graph
+
+#endif  // INCLUDE_BELLMAN_FORD_HPP_
@@ -0,0 +1,379 @@
+/**
+ * @file bfs.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация параллельного поиска в ширину с переключением направления.
+ */
+
+#ifndef INCLUDE_BFS_HPP_
+#define INCLUDE_BFS_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <barrier.hpp>
+#include <csr_graph.hpp>
+#include <dijkstra.hpp>
+#include <trace.hpp>
+
+namespace graph {
+
+/**
+ * @brief Направление шагов поиска в ширину.
+ */
+enum class BfsDirection {
+  //! Переключение по размеру фронта (@sa BreadthFirstSearch()).
+  Auto,
+  //! Только шаги сверху вниз: обход рёбер, выходящих из фронта.
+  TopDown,
+  //! Только шаги снизу вверх: поиск родителя во фронте для
+  //! непосещённых вершин.
+  BottomUp
+};
+
+/**
+ * @brief Параллельный поиск в ширину на CSR снимке.
+ *
+ * @param graph Граф в формате CSR.
+ * @param reverse Тот же граф с обращёнными рёбрами
+ * (@sa CsrGraph::AssignTranspose()). Для неориентированного графа можно
+ * передать graph.
+ * @param source Внутренний номер источника.
+ * @param direction Направление шагов.
+ * @param numThreads Число потоков (не больше MaxThreads()).
+ * @param tree Дерево поиска: distance --- число рёбер в кратчайшем пути
+ * (ShortestPathTree::Infinity() для недостижимых вершин), parent ---
+ * предыдущая вершина.
+ *
+ * Шаг сверху вниз просматривает рёбра, выходящие из вершин фронта,
+ * и захватывает непосещённые вершины операцией compare-and-swap над
+ * родителем. Фронт хранится массивом вершин, потоки делят его поровну
+ * и собирают новый фронт по префиксным суммам.
+ *
+ * Шаг снизу вверх перебирает непосещённые вершины и ищет среди входящих
+ * рёбер ребро из фронта, останавливаясь на первом найденном. Фронт
+ * хранится битовой картой, каждый поток отвечает за свои 64-битные слова
+ * новой карты и пишет их без синхронизации. Когда фронт охватывает
+ * большую часть графа, такой шаг проверяет лишь несколько рёбер на
+ * вершину вместо всех рёбер фронта.
+ *
+ * В режиме BfsDirection::Auto используется правило Бимера (Beamer,
+ * Asanović, Patterson, 2012): переход к шагам снизу вверх, когда сумма
+ * исходящих степеней фронта больше 1/15 рёбер непосещённых вершин, и
+ * возврат, когда фронт перестал расти и содержит меньше 1/18 вершин.
+ *
+ * Ограничение процессорного времени (@sa CpuBudget) проверяется после
+ * каждого шага. Если оно превышено, то потоки завершаются и выбрасывается
+ * исключение graph::BudgetExceeded.
+ */
+inline void BreadthFirstSearch(const CsrGraph& graph, const CsrGraph& reverse,
+                               size_t source, BfsDirection direction,
+                               size_t numThreads,
+                               ShortestPathTree<size_t>* tree) {
+  // Параметры правила переключения.
+  const size_t alpha = 15;
+  const size_t beta = 18;
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  Span<size_t> reverseOffsets = reverse.Offsets();
+  Span<size_t> reverseTargets = reverse.Targets();
+  size_t numVertices = graph.NumVertices();
+  size_t numWords = (numVertices + 63) / 64;
+
+  numThreads = std::max<size_t>(
+      std::min({ numThreads, MaxThreads(), numWords }), 1);
+
+  // Родитель вершины; для источника --- сам источник, чтобы он считался
+  // посещённым.
+  std::vector<std::atomic<size_t>> parent(numVertices);
+  // Фронт в виде массива (для шагов сверху вниз).
+  std::vector<size_t> frontier(1, source);
+  // Фронт и новый фронт в виде битовых карт (для шагов снизу вверх).
+  std::vector<std::atomic<uint64_t>> frontierBits(numWords);
+  std::vector<std::atomic<uint64_t>> nextBits(numWords);
+  // Вершины нового фронта, найденные каждым потоком.
+  std::vector<std::vector<size_t>> found(numThreads);
+  // Позиции потоков в новом фронте.
+  std::vector<size_t> positions(numThreads);
+  // Сумма степеней или число вершин нового фронта у каждого потока.
+  std::vector<size_t> counts(numThreads);
+  Barrier barrier(numThreads);
+  // Состояние обхода, которое меняет только поток 0 между барьерами.
+  bool bottomUp = false;
+  bool done = false;
+  // Обход прерван по ограничению процессорного времени.
+  bool aborted = false;
+  CpuBudget* budget = CpuBudget::Current();
+  // Сумма исходящих степеней фронта и рёбер непосещённых вершин.
+  size_t scout = offsets[source + 1] - offsets[source];
+  size_t edgesToCheck = graph.NumEdges();
+  // Число вершин фронта.
+  size_t awake = 1;
+
+  tree->Reset(numVertices);
+  tree->distance[source] = 0;
+
+  // Собрать вершины found всех потоков в массив frontier.
+  auto gather = [&](size_t thread) {
+    barrier.Wait();
+
+    if (thread == 0) {
+      size_t total = 0;
+
+      for (size_t t = 0; t < numThreads; t++) {
+        positions[t] = total;
+        total += found[t].size();
+      }
+
+      frontier.resize(total);
+    }
+
+    barrier.Wait();
+
+    std::copy(found[thread].begin(), found[thread].end(),
+              frontier.begin() + positions[thread]);
+
+    barrier.Wait();
+  };
+
+  // Выбрать направление после шага сверху вниз и при переходе к шагам
+  // снизу вверх записать фронт в битовую карту.
+  auto afterTopDown = [&](size_t thread, size_t firstWord, size_t lastWord) {
+    if (thread == 0) {
+      done = frontier.empty();
+      aborted = !done && budget && budget->Exceeded();
+      done = done || aborted;
+      awake = frontier.size();
+      bottomUp = direction == BfsDirection::BottomUp ||
+                 (direction == BfsDirection::Auto &&
+                  scout > edgesToCheck / alpha);
+    }
+
+    barrier.Wait();
+
+    if (!bottomUp || done) {
+      return;
+    }
+
+    for (size_t word = firstWord; word < lastWord; word++) {
+      frontierBits[word].store(0, std::memory_order_relaxed);
+    }
+
+    barrier.Wait();
+
+    size_t first = frontier.size() * thread / numThreads;
+    size_t last = frontier.size() * (thread + 1) / numThreads;
+
+    for (size_t i = first; i < last; i++) {
+      frontierBits[frontier[i] / 64].fetch_or(
+          uint64_t(1) << (frontier[i] % 64), std::memory_order_relaxed);
+    }
+
+    barrier.Wait();
+  };
+
+  auto worker = [&](size_t thread) {
+    CpuMeter meter(budget);
+    size_t firstWord = numWords * thread / numThreads;
+    size_t lastWord = numWords * (thread + 1) / numThreads;
+    size_t firstVertex = std::min(64 * firstWord, numVertices);
+    size_t lastVertex = std::min(64 * lastWord, numVertices);
+
+    for (size_t vertex = firstVertex; vertex < lastVertex; vertex++) {
+      parent[vertex].store(vertex == source ? source : noVertex,
+                           std::memory_order_relaxed);
+    }
+
+    barrier.Wait();
+
+    afterTopDown(thread, firstWord, lastWord);
+
+    for (size_t depth = 1; !done; depth++) {
+      if (!bottomUp) {
+        size_t first = frontier.size() * thread / numThreads;
+        size_t last = frontier.size() * (thread + 1) / numThreads;
+        size_t degrees = 0;
+
+        found[thread].clear();
+
+        for (size_t i = first; i < last; i++) {
+          size_t vertex = frontier[i];
+
+          for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+            size_t neighbour = targets[k];
+            size_t expected = noVertex;
+
+            // Обычное чтение отсекает посещённые вершины без захвата
+            // строки кеша на запись.
+            if (parent[neighbour].load(std::memory_order_relaxed) ==
+                    noVertex &&
+                parent[neighbour].compare_exchange_strong(
+                    expected, vertex, std::memory_order_relaxed)) {
+              tree->distance[neighbour] = depth;
+              found[thread].push_back(neighbour);
+              degrees += offsets[neighbour + 1] - offsets[neighbour];
+            }
+          }
+        }
+
+        counts[thread] = degrees;
+        meter.Charge();
+
+        gather(thread);
+
+        if (thread == 0) {
+          edgesToCheck -= std::min(scout, edgesToCheck);
+          scout = 0;
+
+          for (size_t count : counts) {
+            scout += count;
+          }
+        }
+
+        afterTopDown(thread, firstWord, lastWord);
+      } else {
+        size_t woken = 0;
+
+        for (size_t word = firstWord; word < lastWord; word++) {
+          uint64_t bits = 0;
+          size_t end = std::min(64 * word + 64, numVertices);
+
+          for (size_t vertex = 64 * word; vertex < end; vertex++) {
+            if (parent[vertex].load(std::memory_order_relaxed) != noVertex) {
+              continue;
+            }
+
+            for (size_t k = reverseOffsets[vertex];
+                 k < reverseOffsets[vertex + 1]; k++) {
+              size_t neighbour = reverseTargets[k];
+              uint64_t mask = uint64_t(1) << (neighbour % 64);
+
+              if (frontierBits[neighbour / 64].load(
+                      std::memory_order_relaxed) & mask) {
+                parent[vertex].store(neighbour, std::memory_order_relaxed);
+                tree->distance[vertex] = depth;
+                bits |= uint64_t(1) << (vertex % 64);
+                woken++;
+                break;
+              }
+            }
+          }
+
+          nextBits[word].store(bits, std::memory_order_relaxed);
+        }
+
+        counts[thread] = woken;
+        meter.Charge();
+
+        barrier.Wait();
+
+        if (thread == 0) {
+          size_t previous = awake;
+
+          awake = 0;
+
+          for (size_t count : counts) {
+            awake += count;
+          }
+
+          std::swap(frontierBits, nextBits);
+          done = awake == 0;
+          aborted = !done && budget && budget->Exceeded();
+          done = done || aborted;
+          bottomUp = direction == BfsDirection::BottomUp ||
+                     (direction == BfsDirection::Auto &&
+                      (awake >= previous || awake > numVertices / beta));
+          scout = 1;
+        }
+
+        barrier.Wait();
+
+        if (!bottomUp && !done) {
+          found[thread].clear();
+
+          for (size_t word = firstWord; word < lastWord; word++) {
+            uint64_t bits = frontierBits[word].load(std::memory_order_relaxed);
+
+            for (; bits != 0; bits &= bits - 1) {
+              found[thread].push_back(64 * word + __builtin_ctzll(bits));
+            }
+          }
+
+          gather(thread);
+        }
+      }
+    }
+
+    for (size_t vertex = firstVertex; vertex < lastVertex; vertex++) {
+      size_t value = parent[vertex].load(std::memory_order_relaxed);
+
+      tree->parent[vertex] = value == vertex ? noVertex : value;
+    }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (size_t t = 1; t < numThreads; t++) {
+    threads.emplace_back(worker, t);
+  }
+
+  worker(0);
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  if (aborted) {
+    throw BudgetExceeded();
+  }
+}
+
+/**
+ * @brief Расстояния от вершины до всех достижимых вершин графа поиском
+ *        в ширину.
+ *
+ * @tparam GraphType Тип графа: graph::OrientedGraph, graph::Graph или любой
+ * другой класс с методами Vertices(), HasVertex() и Edges().
+ *
+ * @param graph Исходный граф.
+ * @param source Номер начальной вершины.
+ * @param direction Направление шагов.
+ * @param numThreads Число потоков.
+ * @param distances Вектор, в который записываются пары (вершина, число
+ * рёбер в кратчайшем пути) для всех достижимых вершин по возрастанию
+ * номеров вершин.
+ *
+ * Если вершины source нет в графе, то функция выбрасывает исключение
+ * std::out_of_range.
+ */
+template<typename GraphType>
+void BreadthFirstSearch(const GraphType& graph, size_t source,
+                        BfsDirection direction, size_t numThreads,
+                        std::vector<std::pair<size_t, size_t>>* distances) {
+  CsrGraph snapshot(graph);
+  CsrGraph reverse;
+  ShortestPathTree<size_t> tree;
+  size_t sourceIndex = snapshot.InternalId(source);
+
+  reverse.AssignTranspose(snapshot);
+
+  BreadthFirstSearch(snapshot, reverse, sourceIndex, direction, numThreads,
+                     &tree);
+
+  distances->clear();
+
+  for (size_t index : snapshot.Vertices()) {
+    if (tree.distance[index] != ShortestPathTree<size_t>::Infinity()) {
+      distances->emplace_back(snapshot.ExternalId(index),
+                              tree.distance[index]);
+    }
+  }
+}
+
+}  // namespace graph
+
+#endif  // INCLUDE_BFS_HPP_
@@ -0,0 +1,395 @@
+/**
+ * @file boruvka.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация параллельного алгоритма Борувки.
+ */
+
+#ifndef INCLUDE_BORUVKA_HPP_
+#define INCLUDE_BORUVKA_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <barrier.hpp>
+#include <disjoint_set.hpp>
+#include <kruskal.hpp>
+#include <trace.hpp>
+#include <weighted_csr_graph.hpp>
+
+namespace graph {
+
+/**
+ * @brief Параллельный алгоритм Борувки на CSR снимке.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param graph Снимок неориентированного графа.
+ * @param numThreads Число потоков (не больше MaxThreads() и числа вершин).
+ * @param forest Вектор, в который записываются рёбра минимального
+ * остовного леса во внутренней нумерации.
+ *
+ * Алгоритм работает раундами. В каждом раунде:
+ * - потоки просматривают свои части массива рёбер, и каждая компонента
+ *   получает самое лёгкое инцидентное ребро (минимум обновляется
+ *   операцией compare-and-swap);
+ * - выбранные рёбра добавляются в лес, а их компоненты объединяются
+ *   в ConcurrentDisjointSet;
+ * - концы рёбер заменяются корнями компонент, рёбра внутри одной
+ *   компоненты выбрасываются (стягивание), и потоки записывают
+ *   оставшиеся рёбра в новый массив по префиксным суммам.
+ *
+ * Веса сравниваются вместе с номером ребра, поэтому при равных весах
+ * выбранные рёбра не образуют циклов. Каждый раунд хотя бы вдвое
+ * уменьшает число компонент, у которых есть рёбра, поэтому раундов не
+ * больше log2 |V|.
+ *
+ * На плотных графах стягивание почти не сокращает массив рёбер: между
+ * компонентами остаются параллельные рёбра. Когда пар компонент меньше,
+ * чем рёбер, для каждой пары оставляется только самое лёгкое ребро: его
+ * выбирает тот же compare-and-swap в таблице пар компонент.
+ *
+ * Ограничение процессорного времени (@sa CpuBudget) проверяется после
+ * каждого раунда. Если оно превышено, то потоки завершаются
+ * и выбрасывается исключение graph::BudgetExceeded.
+ */
+template<typename Weight>
+void Boruvka(const WeightedCsrGraph<Weight>& graph, size_t numThreads,
+             std::vector<MstEdge<Weight>>* forest) {
+  // Ребро между компонентами.
+  struct Edge {
+    //! Корень компоненты первого конца.
+    size_t start;
+    //! Корень компоненты второго конца.
+    size_t end;
+    //! Вес ребра.
+    Weight weight;
+    //! Номер ребра в массиве edges.
+    size_t edge;
+  };
+
+  const size_t noEdge = std::numeric_limits<size_t>::max();
+  // Вес больше любого веса ребра.
+  const Weight heaviest = std::numeric_limits<Weight>::has_infinity ?
+                          std::numeric_limits<Weight>::infinity() :
+                          std::numeric_limits<Weight>::max();
+  size_t numVertices = graph.NumVertices();
+  std::vector<MstEdge<Weight>> edges;
+
+  ExtractEdges(graph, &edges);
+
+  numThreads = std::max<size_t>(
+      std::min({ numThreads, MaxThreads(), numVertices }), 1);
+
+  // Рёбра между разными компонентами.
+  std::vector<Edge> current(edges.size());
+  std::vector<Edge> next;
+  // Корни компонент, у которых есть рёбра.
+  std::vector<size_t> active(numVertices);
+  std::vector<size_t> nextActive;
+  // Номер самого лёгкого ребра компоненты в массиве current.
+  std::vector<std::atomic<size_t>> best(numVertices);
+  // Верхняя оценка веса ребра best: массив компактнее, чем current,
+  // и отсекает большинство рёбер без чтения текущего лучшего ребра.
+  std::vector<std::atomic<Weight>> bestWeight(numVertices);
+  // Номер корня в массиве active (для таблицы пар компонент).
+  std::vector<size_t> rank(numVertices);
+  // Номер самого лёгкого ребра для каждой пары компонент.
+  std::vector<std::atomic<size_t>> pairs;
+  ConcurrentDisjointSet components(numVertices);
+  // Рёбра леса, найденные каждым потоком.
+  std::vector<std::vector<MstEdge<Weight>>> found(numThreads);
+  // Оставшиеся рёбра и корни каждого потока.
+  std::vector<std::vector<Edge>> keptEdges(numThreads);
+  std::vector<std::vector<size_t>> keptVertices(numThreads);
+  // Позиции потоков в массивах next и nextActive.
+  std::vector<std::pair<size_t, size_t>> positions(numThreads);
+  Barrier barrier(numThreads);
+  // Алгоритм прерван по ограничению процессорного времени.
+  bool aborted = false;
+  CpuBudget* budget = CpuBudget::Current();
+
+  // Сравнение рёбер массива current по весу и номеру.
+  auto lighter = [&current](size_t index1, size_t index2) {
+    const Edge& edge1 = current[index1];
+    const Edge& edge2 = current[index2];
+
+    if (edge1.weight < edge2.weight) {
+      return true;
+    }
+
+    return !(edge2.weight < edge1.weight) && edge1.edge < edge2.edge;
+  };
+
+  // Записать в ячейку ребро, если оно легче записанного. Функция
+  // возвращает true, если ребро записано.
+  auto claim = [&](std::atomic<size_t>* slot, size_t index) {
+    size_t value = slot->load(std::memory_order_relaxed);
+
+    while (value == noEdge || lighter(index, value)) {
+      if (slot->compare_exchange_weak(value, index,
+                                      std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+
+    return false;
+  };
+
+  // Предложить ребро в качестве самого лёгкого ребра компоненты.
+  auto offer = [&](size_t root, size_t index) {
+    Weight weight = current[index].weight;
+    Weight bound = bestWeight[root].load(std::memory_order_relaxed);
+
+    if (bound < weight || !claim(&best[root], index)) {
+      return;
+    }
+
+    // Оценка только уменьшается, поэтому она не меньше веса лучшего
+    // ребра при любом порядке записей.
+    while (weight < bound &&
+           !bestWeight[root].compare_exchange_weak(
+               bound, weight, std::memory_order_relaxed)) {
+    }
+  };
+
+  // Собрать рёбра keptEdges (и корни keptVertices) всех потоков в массивы
+  // current (и active).
+  auto gather = [&](size_t thread, bool vertices) {
+    barrier.Wait();
+
+    if (thread == 0) {
+      size_t numEdges = 0;
+      size_t numActive = 0;
+
+      for (size_t t = 0; t < numThreads; t++) {
+        positions[t] = std::make_pair(numEdges, numActive);
+        numEdges += keptEdges[t].size();
+        numActive += keptVertices[t].size();
+      }
+
+      next.resize(numEdges);
+
+      if (vertices) {
+        nextActive.resize(numActive);
+        // Раунд закончен, и потоки списали его время до барьера.
+        aborted = numEdges != 0 && budget && budget->Exceeded();
+      }
+    }
+
+    barrier.Wait();
+
+    std::copy(keptEdges[thread].begin(), keptEdges[thread].end(),
+              next.begin() + positions[thread].first);
+
+    if (vertices) {
+      std::copy(keptVertices[thread].begin(), keptVertices[thread].end(),
+                nextActive.begin() + positions[thread].second);
+    }
+
+    barrier.Wait();
+
+    if (thread == 0) {
+      std::swap(current, next);
+
+      if (vertices) {
+        std::swap(active, nextActive);
+      }
+    }
+
+    barrier.Wait();
+  };
+
+  // Оставить самое лёгкое ребро между каждой парой компонент.
+  auto mergeParallel = [&](size_t thread) {
+    size_t numActive = active.size();
+    size_t numPairs = numActive * numActive;
+
+    if (thread == 0) {
+      pairs = std::vector<std::atomic<size_t>>(numPairs);
+    }
+
+    barrier.Wait();
+
+    size_t first = numPairs * thread / numThreads;
+    size_t last = numPairs * (thread + 1) / numThreads;
+
+    for (size_t i = first; i < last; i++) {
+      pairs[i].store(noEdge, std::memory_order_relaxed);
+    }
+
+    first = numActive * thread / numThreads;
+    last = numActive * (thread + 1) / numThreads;
+
+    for (size_t i = first; i < last; i++) {
+      rank[active[i]] = i;
+    }
+
+    barrier.Wait();
+
+    first = current.size() * thread / numThreads;
+    last = current.size() * (thread + 1) / numThreads;
+
+    for (size_t i = first; i < last; i++) {
+      size_t rank1 = rank[current[i].start];
+      size_t rank2 = rank[current[i].end];
+
+      claim(&pairs[std::min(rank1, rank2) * numActive +
+                   std::max(rank1, rank2)], i);
+    }
+
+    barrier.Wait();
+
+    first = numPairs * thread / numThreads;
+    last = numPairs * (thread + 1) / numThreads;
+    keptEdges[thread].clear();
+
+    for (size_t i = first; i < last; i++) {
+      size_t index = pairs[i].load(std::memory_order_relaxed);
+
+      if (index != noEdge) {
+        keptEdges[thread].push_back(current[index]);
+      }
+    }
+
+    gather(thread, false);
+  };
+
+  auto worker = [&](size_t thread) {
+    CpuMeter meter(budget);
+    size_t first = edges.size() * thread / numThreads;
+    size_t last = edges.size() * (thread + 1) / numThreads;
+
+    for (size_t i = first; i < last; i++) {
+      current[i] = Edge{edges[i].start, edges[i].end, edges[i].weight, i};
+    }
+
+    first = numVertices * thread / numThreads;
+    last = numVertices * (thread + 1) / numThreads;
+
+    for (size_t vertex = first; vertex < last; vertex++) {
+      active[vertex] = vertex;
+    }
+
+    barrier.Wait();
+
+    while (!current.empty() && !aborted) {
+      if (active.size() * active.size() < current.size()) {
+        mergeParallel(thread);
+      }
+
+      size_t firstEdge = current.size() * thread / numThreads;
+      size_t lastEdge = current.size() * (thread + 1) / numThreads;
+      size_t firstVertex = active.size() * thread / numThreads;
+      size_t lastVertex = active.size() * (thread + 1) / numThreads;
+
+      for (size_t i = firstVertex; i < lastVertex; i++) {
+        best[active[i]].store(noEdge, std::memory_order_relaxed);
+        bestWeight[active[i]].store(heaviest, std::memory_order_relaxed);
+      }
+
+      barrier.Wait();
+
+      for (size_t i = firstEdge; i < lastEdge; i++) {
+        offer(current[i].start, i);
+        offer(current[i].end, i);
+      }
+
+      barrier.Wait();
+
+      // Ребро, выбранное обеими компонентами, добавляется один раз.
+      for (size_t i = firstVertex; i < lastVertex; i++) {
+        size_t index = best[active[i]].load(std::memory_order_relaxed);
+
+        if (index != noEdge &&
+            components.Union(current[index].start, current[index].end)) {
+          found[thread].push_back(edges[current[index].edge]);
+        }
+      }
+
+      barrier.Wait();
+
+      keptEdges[thread].clear();
+      keptVertices[thread].clear();
+
+      for (size_t i = firstEdge; i < lastEdge; i++) {
+        size_t start = components.Find(current[i].start);
+        size_t end = components.Find(current[i].end);
+
+        if (start != end) {
+          keptEdges[thread].push_back(Edge{start, end, current[i].weight,
+                                           current[i].edge});
+        }
+      }
+
+      for (size_t i = firstVertex; i < lastVertex; i++) {
+        size_t vertex = active[i];
+
+        if (best[vertex].load(std::memory_order_relaxed) != noEdge &&
+            components.Find(vertex) == vertex) {
+          keptVertices[thread].push_back(vertex);
+        }
+      }
+
+      meter.Charge();
+      gather(thread, true);
+    }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (size_t t = 1; t < numThreads; t++) {
+    threads.emplace_back(worker, t);
+  }
+
+  worker(0);
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  if (aborted) {
+    throw BudgetExceeded();
+  }
+
+  forest->clear();
+
+  for (const std::vector<MstEdge<Weight>>& part : found) {
+    forest->insert(forest->end(), part.begin(), part.end());
+  }
+}
+
+/**
+ * @brief Минимальный остовный лес графа параллельным алгоритмом Борувки.
+ *
+ * @tparam GraphType Тип графа: graph::WeightedGraph или любой другой класс
+ * неориентированного графа с методами Vertices(), HasVertex(), Edges()
+ * и EdgeWeight().
+ *
+ * @param graph Исходный граф.
+ * @param numThreads Число потоков.
+ * @param forest Вектор, в который записываются рёбра минимального
+ * остовного леса с исходными номерами вершин.
+ */
+template<typename GraphType>
+void Boruvka(const GraphType& graph, size_t numThreads,
+             std::vector<MstEdge<typename GraphType::WeightType>>* forest) {
+  using Weight = typename GraphType::WeightType;
+
+  WeightedCsrGraph<Weight> snapshot(graph);
+
+  Boruvka(snapshot, numThreads, forest);
+
+  for (MstEdge<Weight>& edge : *forest) {
+    edge.start = snapshot.ExternalId(edge.start);
+    edge.end = snapshot.ExternalId(edge.end);
+  }
+}
+
+}  // namespace graph
+
+#endif  // INCLUDE_BORUVKA_HPP_
@@ -0,0 +1,631 @@
+/**
+ * @file csr_graph.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация неизменяемого снимка графа в формате CSR (compressed sparse row).
+ */
+
+#ifndef INCLUDE_CSR_GRAPH_HPP_
+#define INCLUDE_CSR_GRAPH_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <iterators.hpp>
+
+namespace graph {
+
+/**
+ * @brief Массив снимка графа.
+ *
+ * @tparam T Тип элементов.
+ *
+ * Массив либо владеет элементами (std::vector), либо указывает на чужую
+ * память, например, на файл, отображённый в память (@sa graph_file.hpp).
+ * Во втором случае массив хранит ссылку на владельца памяти, поэтому
+ * память освобождается только вместе с последним снимком, который на неё
+ * указывает. Копия такого массива указывает на ту же память.
+ *
+ * Функции чтения одинаково работают в обоих случаях. Функции изменения
+ * (в том числе неконстантные begin() и operator[]) сначала копируют чужую
+ * память в собственный вектор.
+ */
+template<typename T>
+class CsrArray {
+ public:
+  /**
+   * @brief Конструктор пустого массива.
+   */
+  CsrArray() :
+    first(nullptr),
+    count(0) {
+  }
+
+  /**
+   * @brief Конструктор массива, владеющего элементами.
+   *
+   * @param count Число элементов.
+   * @param value Значение элементов.
+   */
+  CsrArray(size_t count, const T& value) :
+    values(count, value),
+    first(nullptr),
+    count(0) {
+  }
+
+  /**
+   * @brief Указать на чужую память без копирования.
+   *
+   * @param owner Владелец памяти.
+   * @param elements Элементы массива.
+   */
+  void AssignView(std::shared_ptr<const void> owner, Span<T> elements) {
+    values.clear();
+    values.shrink_to_fit();
+    this->owner = std::move(owner);
+    first = elements.data();
+    count = elements.size();
+  }
+
+  /**
+   * @brief Функция возвращает true, если массив указывает на чужую память.
+   */
+  bool IsView() const {
+    return owner != nullptr;
+  }
+
+  /**
+   * @brief Возвращает указатель на начало данных.
+   */
+  const T* data() const {
+    return owner ? first : values.data();
+  }
+
+  /**
+   * @brief Возвращает количество элементов.
+   */
+  size_t size() const {
+    return owner ? count : values.size();
+  }
+
+  /**
+   * @brief Функция возвращает true, если массив пуст.
+   */
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * @brief Возвращает указатель на первый элемент.
+   */
+  const T* begin() const {
+    return data();
+  }
+
+  /**
+   * @brief Возвращает указатель на элемент "после последнего".
+   */
+  const T* end() const {
+    return data() + size();
+  }
+
+  /**
+   * @brief Доступ к элементу по номеру без проверки границ.
+   * @param i Номер элемента.
+   */
+  const T& operator[](size_t i) const {
+    return data()[i];
+  }
+
+  /**
+   * @brief Доступ к элементу по номеру с проверкой границ.
+   * @param i Номер элемента.
+   *
+   * Если номер не меньше size(), то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  const T& at(size_t i) const {
+    if (i >= size()) {
+      throw std::out_of_range("CsrArray::at(): index out of range");
+    }
+
+    return data()[i];
+  }
+
+  /**
+   * @brief Последний элемент.
+   */
+  const T& back() const {
+    return data()[size() - 1];
+  }
+
+  /**
+   * @brief Функция возвращает отрезок со всеми элементами.
+   */
+  Span<T> All() const {
+    return Span<T>(begin(), end());
+  }
+
+  /**
+   * @brief Возвращает изменяемый указатель на первый элемент.
+   */
+  T* begin() {
+    return Own().data();
+  }
+
+  /**
+   * @brief Возвращает изменяемый указатель на элемент "после последнего".
+   */
+  T* end() {
+    return Own().data() + values.size();
+  }
+
+  /**
+   * @brief Изменяемый доступ к элементу по номеру без проверки границ.
+   * @param i Номер элемента.
+   */
+  T& operator[](size_t i) {
+    return Own()[i];
+  }
+
+  /**
+   * @brief Удалить все элементы.
+   *
+   * Ссылка на чужую память отпускается без копирования.
+   */
+  void clear() {
+    owner.reset();
+    values.clear();
+  }
+
+  /**
+   * @brief Добавить элемент в конец массива.
+   * @param value Значение.
+   */
+  void push_back(const T& value) {
+    Own().push_back(value);
+  }
+
+  /**
+   * @brief Зарезервировать память под элементы.
+   * @param capacity Число элементов.
+   */
+  void reserve(size_t capacity) {
+    Own().reserve(capacity);
+  }
+
+  /**
+   * @brief Изменить число элементов.
+   * @param newSize Новое число элементов.
+   */
+  void resize(size_t newSize) {
+    Own().resize(newSize);
+  }
+
+  /**
+   * @brief Заполнить массив одинаковыми значениями.
+   *
+   * @param newSize Новое число элементов.
+   * @param value Значение элементов.
+   */
+  void assign(size_t newSize, const T& value) {
+    clear();
+    values.assign(newSize, value);
+  }
+
+  /**
+   * @brief Удалить элементы из отрезка [from, to).
+   *
+   * @param from Указатель на первый удаляемый элемент.
+   * @param to Указатель на элемент после последнего удаляемого.
+   *
+   * Указатели должны быть получены неконстантными функциями begin()
+   * и end().
+   */
+  void erase(T* from, T* to) {
+    std::vector<T>& elements = Own();
+
+    elements.erase(elements.begin() + (from - elements.data()),
+                   elements.begin() + (to - elements.data()));
+  }
+
+ private:
+  /**
+   * @brief Скопировать чужую память в собственный вектор.
+   *
+   * @return Функция возвращает собственный вектор элементов.
+   */
+  std::vector<T>& Own() {
+    if (owner) {
+      values.assign(first, first + count);
+      owner.reset();
+      first = nullptr;
+      count = 0;
+    }
+
+    return values;
+  }
+
+  //! Собственные элементы массива.
+  std::vector<T> values;
+  //! Владелец чужой памяти или nullptr, если массив владеет элементами.
+  std::shared_ptr<const void> owner;
+  //! Первый элемент в чужой памяти.
+  const T* first;
+  //! Число элементов в чужой памяти.
+  size_t count;
+};
+
+/**
+ * @brief Неизменяемый ориентированный граф в формате CSR.
+ *
+ * Граф хранится в трёх непрерывных массивах:
+ * - ids     --- отсортированные исходные номера вершин (таблица перенумерации);
+ * - offsets --- для вершины i её рёбра занимают targets[offsets[i]]
+ *               ... targets[offsets[i + 1] - 1];
+ * - targets --- концы рёбер во внутренней нумерации.
+ *
+ * Внутри класса вершины пронумерованы подряд числами 0, 1, ..., N - 1
+ * (внутренние номера). Все методы, повторяющие интерфейс graph::OrientedGraph
+ * (HasVertex(), HasEdge(), Edges(), Vertices()), работают с внутренними
+ * номерами, поэтому шаблонные алгоритмы из include/ работают с обоими
+ * представлениями. Для перевода номеров используются функции ExternalId()
+ * и InternalId().
+ *
+ * Снимок можно построить из любого класса графа, у которого есть методы
+ * Vertices() и Edges(). Для неориентированного графа каждое ребро
+ * записывается дважды, как и в graph::Graph.
+ */
+class CsrGraph {
+ public:
+  /**
+   * @brief Конструктор пустого графа.
+   */
+  CsrGraph() :
+    offsets(1, 0) {
+  }
+
+  /**
+   * @brief Построить снимок графа.
+   *
+   * @tparam GraphType Тип исходного графа.
+   * @param graph Исходный граф.
+   */
+  template<typename GraphType>
+  explicit CsrGraph(const GraphType& graph) {
+    Assign(graph);
+  }
+
+  /**
+   * @brief Перестроить снимок по другому графу.
+   *
+   * @tparam GraphType Тип исходного графа.
+   * @param graph Исходный граф.
+   *
+   * Функция переиспользует уже выделенную память массивов снимка, поэтому
+   * при повторных вызовах на графах не большего размера они не
+   * перевыделяются. Рёбра каждой вершины упорядочиваются по возрастанию.
+   */
+  template<typename GraphType>
+  void Assign(const GraphType& graph) {
+    AssignIds(graph);
+    offsets.push_back(0);
+
+    IdRemap remap(ids.All());
+
+    for (size_t id : ids) {
+      if (!graph.HasVertex(id)) {
+        offsets.push_back(targets.size());
+        continue;
+      }
+
+      for (size_t neighbourId : graph.Edges(id)) {
+        targets.push_back(remap(neighbourId));
+      }
+
+      std::sort(targets.begin() + offsets.back(), targets.end());
+      offsets.push_back(targets.size());
+    }
+  }
+
+  /**
+   * @brief Построить снимок графа с обращёнными рёбрами.
+   *
+   * @param graph Исходный снимок.
+   *
+   * Каждое ребро (U, V) превращается в ребро (V, U). Нумерация вершин
+   * совпадает с нумерацией graph. Рёбра каждой вершины упорядочены по
+   * возрастанию.
+   */
+  void AssignTranspose(const CsrGraph& graph) {
+    ids = graph.ids;
+    offsets.assign(ids.size() + 1, 0);
+    targets.clear();
+    targets.resize(graph.targets.size());
+
+    for (size_t target : graph.targets) {
+      offsets[target + 1]++;
+    }
+
+    for (size_t index = 0; index < ids.size(); index++) {
+      offsets[index + 1] += offsets[index];
+    }
+
+    // Источники перебираются по возрастанию, поэтому рёбра каждой вершины
+    // получаются упорядоченными без сортировки. Счётчики next временно
+    // хранятся в offsets и в конце сдвигаются обратно.
+    for (size_t index = 0; index < ids.size(); index++) {
+      for (size_t k = graph.offsets[index]; k < graph.offsets[index + 1];
+           k++) {
+        targets[offsets[graph.targets[k]]++] = index;
+      }
+    }
+
+    for (size_t index = ids.size(); index > 0; index--) {
+      offsets[index] = offsets[index - 1];
+    }
+
+    offsets[0] = 0;
+  }
+
+  /**
+   * @brief Функция проверяет, есть ли вершина в графе.
+   *
+   * @param index Внутренний номер вершины.
+   */
+  bool HasVertex(size_t index) const {
+    return index < ids.size();
+  }
+
+  /**
+   * @brief Функция проверяет, есть ли ребро в графе.
+   *
+   * @param index1 Внутренний номер вершины, из которой выходит ребро.
+   * @param index2 Внутренний номер вершины, в которую входит ребро.
+   *
+   * Рёбра вершины упорядочены, поэтому используется двоичный поиск.
+   */
+  bool HasEdge(size_t index1, size_t index2) const {
+    if (!HasVertex(index1)) {
+      return false;
+    }
+
+    return std::binary_search(targets.begin() + offsets[index1],
+                              targets.begin() + offsets[index1 + 1], index2);
+  }
+
+  /**
+   * @brief Получить рёбра, выходящие из указанной вершины.
+   *
+   * @param index Внутренний номер вершины.
+   *
+   * Функция возвращает непрерывный отрезок внутренних номеров вершин,
+   * в которые ведут рёбра из вершины index. Если указанной вершины в графе
+   * нет, то функция выбрасывает исключение std::out_of_range.
+   */
+  Span<size_t> Edges(size_t index) const {
+    if (!HasVertex(index)) {
+      throw std::out_of_range("CsrGraph::Edges(): no such vertex");
+    }
+
+    return Span<size_t>(targets.data() + offsets[index],
+                        targets.data() + offsets[index + 1]);
+  }
+
+  /**
+   * @brief Функция для итерирования по вершинам графа.
+   *
+   * Функция возвращает промежуток внутренних номеров 0, 1, ..., N - 1.
+   */
+  IndicesRange Vertices() const {
+    return IndicesRange(0, ids.size());
+  }
+
+  /**
+   * @brief Функция возвращает количество вершин в графе.
+   */
+  size_t NumVertices() const {
+    return ids.size();
+  }
+
+  /**
+   * @brief Функция возвращает количество рёбер в графе.
+   */
+  size_t NumEdges() const {
+    return targets.size();
+  }
+
+  /**
+   * @brief Получить исходный номер вершины.
+   *
+   * @param index Внутренний номер вершины.
+   *
+   * Если указанной вершины в графе нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  size_t ExternalId(size_t index) const {
+    return ids.at(index);
+  }
+
+  /**
+   * @brief Получить внутренний номер вершины.
+   *
+   * @param id Исходный номер вершины.
+   *
+   * Функция ищет номер двоичным поиском в таблице перенумерации. Если
+   * указанной вершины в графе нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  size_t InternalId(size_t id) const {
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+
+    if (it == ids.end() || *it != id) {
+      throw std::out_of_range("CsrGraph::InternalId(): no such vertex");
+    }
+
+    return static_cast<size_t>(it - ids.begin());
+  }
+
+  /**
+   * @brief Функция проверяет, есть ли в графе вершина с исходным номером id.
+   *
+   * @param id Исходный номер вершины.
+   */
+  bool HasExternalId(size_t id) const {
+    return std::binary_search(ids.begin(), ids.end(), id);
+  }
+
+  /**
+   * @brief Массив смещений. Его размер равен NumVertices() + 1.
+   */
+  Span<size_t> Offsets() const {
+    return offsets.All();
+  }
+
+  /**
+   * @brief Массив концов рёбер во внутренней нумерации.
+   */
+  Span<size_t> Targets() const {
+    return targets.All();
+  }
+
+  /**
+   * @brief Таблица перенумерации: исходные номера вершин по возрастанию.
+   */
+  Span<size_t> Ids() const {
+    return ids.All();
+  }
+
+  /**
+   * @brief Построить снимок поверх готовых массивов без копирования.
+   *
+   * @param owner Владелец памяти массивов, например, отображение файла
+   * в память. Снимок и все его копии хранят ссылку на владельца.
+   * @param ids Исходные номера вершин по возрастанию.
+   * @param offsets Смещения, ids.size() + 1 элементов.
+   * @param targets Концы рёбер во внутренней нумерации.
+   *
+   * Массивы не проверяются. Последующие вызовы Assign() и
+   * AssignTranspose() не изменяют чужую память, а строят снимок в
+   * собственных массивах.
+   */
+  void AssignView(const std::shared_ptr<const void>& owner,
+                  Span<size_t> ids, Span<size_t> offsets,
+                  Span<size_t> targets) {
+    this->ids.AssignView(owner, ids);
+    this->offsets.AssignView(owner, offsets);
+    this->targets.AssignView(owner, targets);
+  }
+
+ protected:
+  /**
+   * @brief Очистить снимок и заполнить таблицу перенумерации.
+   *
+   * @tparam GraphType Тип исходного графа.
+   * @param graph Исходный граф.
+   */
+  template<typename GraphType>
+  void AssignIds(const GraphType& graph) {
+    ids.clear();
+    offsets.clear();
+    targets.clear();
+
+    for (size_t id : graph.Vertices()) {
+      ids.push_back(id);
+    }
+
+    // Вершина, в которую только входят рёбра, может отсутствовать
+    // в списке вершин исходного графа (см. OrientedGraph::AddEdge()),
+    // поэтому такие концы рёбер тоже попадают в таблицу перенумерации.
+    // Остальные концы уже есть в ней, и таблица не растёт на число рёбер.
+    for (size_t id : graph.Vertices()) {
+      for (size_t neighbourId : graph.Edges(id)) {
+        if (!graph.HasVertex(neighbourId)) {
+          ids.push_back(neighbourId);
+        }
+      }
+    }
+
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  }
+
+  /**
+   * @brief Перевод исходных номеров вершин во внутренние при построении
+   * снимка.
+   *
+   * Если исходные номера лежат плотно (диапазон не больше чем вдвое шире
+   * числа вершин), то используется таблица по номеру, иначе ---
+   * хеш-таблица. В обоих случаях перевод номера конца ребра выполняется
+   * за O(1) вместо двоичного поиска в InternalId().
+   */
+  class IdRemap {
+   public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param ids Исходные номера вершин по возрастанию.
+     */
+    explicit IdRemap(Span<size_t> ids) :
+      first(ids.empty() ? 0 : ids[0]) {
+      if (ids.empty()) {
+        return;
+      }
+
+      size_t range = ids.back() - first;
+
+      if (range < 2 * ids.size()) {
+        dense.assign(range + 1, 0);
+
+        for (size_t index = 0; index < ids.size(); index++) {
+          dense[ids[index] - first] = index;
+        }
+
+        return;
+      }
+
+      sparse.reserve(ids.size());
+
+      for (size_t index = 0; index < ids.size(); index++) {
+        sparse.emplace(ids[index], index);
+      }
+    }
+
+    /**
+     * @brief Получить внутренний номер вершины.
+     *
+     * @param id Исходный номер вершины, который есть в таблице.
+     */
+    size_t operator()(size_t id) const {
+      if (!dense.empty()) {
+        return dense[id - first];
+      }
+
+      return sparse.at(id);
+    }
+
+   private:
+    //! Наименьший исходный номер.
+    size_t first;
+    //! Внутренние номера по смещению исходного номера от first.
+    std::vector<size_t> dense;
+    //! Внутренние номера по исходному номеру.
+    std::unordered_map<size_t, size_t> sparse;
+  };
+
+  //! Таблица перенумерации: исходные номера вершин по возрастанию.
+  CsrArray<size_t> ids;
+
+  //! Смещения начала списка рёбер каждой вершины в массиве targets.
+  CsrArray<size_t> offsets;
+
+  //! Концы рёбер во внутренней нумерации.
+  CsrArray<size_t> targets;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_CSR_GRAPH_HPP_
@@ -0,0 +1,474 @@
+/**
+ * @file delta_stepping.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация параллельного алгоритма delta-stepping для поиска кратчайших
+ * путей от одной вершины.
+ */
+
+#ifndef INCLUDE_DELTA_STEPPING_HPP_
+#define INCLUDE_DELTA_STEPPING_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <barrier.hpp>
+#include <dijkstra.hpp>
+#include <trace.hpp>
+#include <weighted_csr_graph.hpp>
+
+namespace graph {
+
+/**
+ * @brief Ширина корзины по умолчанию.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param graph Граф в формате CSR.
+ *
+ * @return Функция возвращает максимальный вес ребра, делённый на среднюю
+ * степень вершины (но не меньше минимального положительного значения).
+ * При такой ширине из каждой вершины в среднем выходит около одного
+ * лёгкого ребра.
+ */
+template<typename Weight>
+Weight DefaultDelta(const WeightedCsrGraph<Weight>& graph) {
+  Span<Weight> weights = graph.Weights();
+
+  if (weights.empty()) {
+    return Weight(1);
+  }
+
+  Weight maxWeight = *std::max_element(weights.begin(), weights.end());
+  double averageDegree = static_cast<double>(graph.NumEdges()) /
+                         static_cast<double>(graph.NumVertices());
+  Weight delta = static_cast<Weight>(maxWeight /
+                                     std::max(averageDegree, 1.0));
+
+  if (!(Weight() < delta)) {
+    delta = Weight() < maxWeight ? maxWeight : Weight(1);
+  }
+
+  return delta;
+}
+
+/**
+ * @brief Наименьшая допустимая ширина корзины.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param graph Граф в формате CSR.
+ *
+ * @return Функция возвращает наименьшую ширину delta, при которой число
+ * корзин maxWeight / delta + 2 не превышает число вершин графа (но не
+ * меньше minSlots). Каждый поток хранит свой массив корзин, поэтому при
+ * меньшей ширине память алгоритма определяется весами рёбер, а не размером
+ * графа.
+ */
+template<typename Weight>
+Weight MinDelta(const WeightedCsrGraph<Weight>& graph) {
+  // Число корзин, которое разрешено независимо от размера графа.
+  const size_t minSlots = 64;
+
+  Span<Weight> weights = graph.Weights();
+
+  if (weights.empty()) {
+    return Weight();
+  }
+
+  Weight maxWeight = *std::max_element(weights.begin(), weights.end());
+  Weight maxRatio = static_cast<Weight>(
+      std::max(graph.NumVertices(), minSlots) - 2);
+
+  if constexpr (std::is_integral_v<Weight>) {
+    return (maxWeight + maxRatio - 1) / maxRatio;
+  } else {
+    return maxWeight / maxRatio;
+  }
+}
+
+/**
+ * @brief Алгоритм delta-stepping на CSR снимке.
+ *
+ * @tparam Weight Тип веса. Веса рёбер должны быть положительными.
+ *
+ * @param graph Граф в формате CSR.
+ * @param source Внутренний номер источника.
+ * @param delta Ширина корзины. Если она не положительна, то используется
+ * DefaultDelta(), а если она меньше MinDelta(), то используется MinDelta().
+ * @param numThreads Число потоков (не больше MaxThreads()).
+ * @param tree Дерево, в которое записываются расстояния и пути.
+ *
+ * Вершины с конечной оценкой расстояния d лежат в корзине с номером
+ * floor(d / delta). Рёбра делятся на лёгкие (вес не больше delta)
+ * и тяжёлые. Алгоритм обрабатывает корзины по возрастанию номеров:
+ * - все вершины текущей корзины обрабатываются параллельно, их лёгкие
+ *   рёбра релаксируются, и вершины, попавшие в ту же корзину, обрабатываются
+ *   снова, пока корзина не опустеет;
+ * - затем один раз релаксируются тяжёлые рёбра всех вершин, побывавших
+ *   в корзине: они ведут только в следующие корзины.
+ *
+ * При delta, меньшем минимального веса, алгоритм превращается в алгоритм
+ * Дейкстры, при бесконечном delta --- в алгоритм Беллмана-Форда.
+ *
+ * Оценки расстояний хранятся в атомарных переменных и уменьшаются
+ * операцией compare-and-swap. У каждого потока свой массив корзин, поэтому
+ * добавление вершины в корзину не требует синхронизации. Перед обработкой
+ * корзины потоки забирают свои части, а вершины раздаются через общий
+ * счётчик блоками по chunkSize. Корзины хранятся по кругу: все конечные
+ * оценки отличаются от номера текущей корзины не больше чем на
+ * maxWeight / delta + 1 корзину, поэтому хватает maxWeight / delta + 2
+ * корзин.
+ *
+ * После вычисления расстояний родители выбираются параллельным поиском
+ * в ширину от источника по рёбрам (U, V), для которых d(U) + w(U, V) =
+ * d(V). Родитель вершины всегда лежит на предыдущем уровне поиска, поэтому
+ * пути в дереве конечны, даже если при округлении d(U) + w(U, V) = d(U).
+ *
+ * Ограничение процессорного времени (@sa CpuBudget) проверяется после
+ * каждого прохода по корзине. Если оно превышено, то потоки завершаются,
+ * родители не выбираются и выбрасывается исключение graph::BudgetExceeded.
+ */
+template<typename Weight>
+void DeltaStepping(const WeightedCsrGraph<Weight>& graph, size_t source,
+                   Weight delta, size_t numThreads,
+                   ShortestPathTree<Weight>* tree) {
+  // Число вершин, которое поток забирает из общей корзины за один раз.
+  const size_t chunkSize = 256;
+
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  Span<Weight> weights = graph.Weights();
+  const Weight infinity = ShortestPathTree<Weight>::Infinity();
+  size_t numVertices = graph.NumVertices();
+
+  if (!(Weight() < delta)) {
+    delta = DefaultDelta(graph);
+  }
+
+  if (delta < MinDelta(graph)) {
+    delta = MinDelta(graph);
+  }
+
+  numThreads = std::min(std::max<size_t>(numThreads, 1), MaxThreads());
+
+  Weight maxWeight = weights.empty() ? Weight() :
+      *std::max_element(weights.begin(), weights.end());
+  size_t numSlots = static_cast<size_t>(maxWeight / delta) + 2;
+
+  std::vector<std::atomic<Weight>> distance(numVertices);
+  // Номер корзины (плюс один), в которой вершина последний раз попала
+  // в список для релаксации тяжёлых рёбер.
+  std::vector<std::atomic<size_t>> heavyMark(numVertices);
+  std::vector<std::atomic<size_t>> parent(numVertices);
+
+  for (size_t vertex = 0; vertex < numVertices; vertex++) {
+    distance[vertex].store(infinity, std::memory_order_relaxed);
+    heavyMark[vertex].store(0, std::memory_order_relaxed);
+    parent[vertex].store(noVertex, std::memory_order_relaxed);
+  }
+
+  // buckets[t][slot] --- корзины потока t.
+  std::vector<std::vector<std::vector<size_t>>> buckets(
+      numThreads, std::vector<std::vector<size_t>>(numSlots));
+  // Часть текущей корзины, которую забрал поток.
+  std::vector<std::vector<size_t>> frontiers(numThreads);
+  // Вершины, тяжёлые рёбра которых поток должен релаксировать.
+  std::vector<std::vector<size_t>> settled(numThreads);
+  std::atomic<size_t> nextChunk(0);
+  Barrier barrier(numThreads);
+  size_t current = 0;
+  bool done = false;
+  // Алгоритм прерван по ограничению процессорного времени. Значение
+  // меняет только поток 0 между барьерами.
+  bool aborted = false;
+  CpuBudget* budget = CpuBudget::Current();
+
+  distance[source].store(Weight(), std::memory_order_relaxed);
+  buckets[0][0].push_back(source);
+
+  auto bucketOf = [delta](Weight value) {
+    return static_cast<size_t>(value / delta);
+  };
+
+  auto relax = [&](size_t thread, size_t destination, Weight candidate) {
+    Weight old = distance[destination].load(std::memory_order_relaxed);
+
+    while (candidate < old) {
+      if (distance[destination].compare_exchange_weak(
+              old, candidate, std::memory_order_relaxed)) {
+        buckets[thread][bucketOf(candidate) % numSlots].push_back(
+            destination);
+        return;
+      }
+    }
+  };
+
+  // Функция находит блок номер chunk в объединении частей frontiers.
+  auto locate = [&](size_t chunk, size_t* part, size_t* first) {
+    for (*part = 0; *part < numThreads; (*part)++) {
+      size_t numChunks = (frontiers[*part].size() + chunkSize - 1) /
+                         chunkSize;
+
+      if (chunk < numChunks) {
+        *first = chunk * chunkSize;
+        return;
+      }
+
+      chunk -= numChunks;
+    }
+  };
+
+  auto worker = [&](size_t thread) {
+    CpuMeter meter(budget);
+
+    while (true) {
+      // Поиск следующей непустой корзины.
+      if (thread == 0) {
+        aborted = aborted || (budget && budget->Exceeded());
+        done = true;
+
+        for (size_t step = 0; step < numSlots && done && !aborted; step++) {
+          for (size_t t = 0; t < numThreads; t++) {
+            if (!buckets[t][(current + step) % numSlots].empty()) {
+              current += step;
+              done = false;
+              break;
+            }
+          }
+        }
+
+        nextChunk = 0;
+      }
+
+      barrier.Wait();
+
+      if (done) {
+        break;
+      }
+
+      size_t slot = current % numSlots;
+
+      // Лёгкие рёбра: корзина обрабатывается, пока не опустеет.
+      while (true) {
+        frontiers[thread].clear();
+        std::swap(frontiers[thread], buckets[thread][slot]);
+
+        barrier.Wait();
+
+        size_t numChunks = 0;
+
+        for (const std::vector<size_t>& part : frontiers) {
+          numChunks += (part.size() + chunkSize - 1) / chunkSize;
+        }
+
+        if (numChunks == 0 || aborted) {
+          break;
+        }
+
+        for (size_t chunk = nextChunk++; chunk < numChunks;
+             chunk = nextChunk++) {
+          size_t part = 0;
+          size_t first = 0;
+
+          locate(chunk, &part, &first);
+
+          size_t last = std::min(first + chunkSize, frontiers[part].size());
+
+          for (size_t i = first; i < last; i++) {
+            size_t vertex = frontiers[part][i];
+            Weight value = distance[vertex].load(std::memory_order_relaxed);
+
+            // Устаревшая запись: оценка вершины уменьшилась, и вершина
+            // уже обработана или лежит в другой корзине.
+            if (bucketOf(value) != current) {
+              continue;
+            }
+
+            if (heavyMark[vertex].exchange(current + 1,
+                                           std::memory_order_relaxed) !=
+                current + 1) {
+              settled[thread].push_back(vertex);
+            }
+
+            for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+              if (!(delta < weights[k])) {
+                relax(thread, targets[k], value + weights[k]);
+              }
+            }
+          }
+        }
+
+        meter.Charge();
+        barrier.Wait();
+
+        // Счётчик и признак прерывания читаются только после следующего
+        // барьера.
+        if (thread == 0) {
+          nextChunk = 0;
+          aborted = budget && budget->Exceeded();
+        }
+      }
+
+      // Тяжёлые рёбра ведут в следующие корзины, поэтому каждое из них
+      // релаксируется один раз с окончательной оценкой вершины.
+      for (size_t vertex : settled[thread]) {
+        Weight value = distance[vertex].load(std::memory_order_relaxed);
+
+        for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+          if (delta < weights[k]) {
+            relax(thread, targets[k], value + weights[k]);
+          }
+        }
+      }
+
+      settled[thread].clear();
+      meter.Charge();
+
+      barrier.Wait();
+    }
+
+    if (aborted) {
+      return;
+    }
+
+    // Выбор родителей: поиск в ширину от источника по точным рёбрам
+    // (U, V), для которых d(U) + w == d(V). Точное ребро ведёт в каждую
+    // достижимую вершину, а родитель вершины берётся с предыдущего уровня
+    // поиска, поэтому указатели на родителей не образуют циклов, даже если
+    // маленький вес теряется при округлении и d(U) + w == d(U). Следующий
+    // уровень поток складывает в пустой к этому моменту вектор settled.
+    frontiers[thread].clear();
+
+    if (thread == 0) {
+      frontiers[thread].push_back(source);
+    }
+
+    barrier.Wait();
+
+    while (true) {
+      size_t numChunks = 0;
+
+      for (const std::vector<size_t>& part : frontiers) {
+        numChunks += (part.size() + chunkSize - 1) / chunkSize;
+      }
+
+      if (numChunks == 0) {
+        break;
+      }
+
+      for (size_t chunk = nextChunk++; chunk < numChunks;
+           chunk = nextChunk++) {
+        size_t part = 0;
+        size_t first = 0;
+
+        locate(chunk, &part, &first);
+
+        size_t last = std::min(first + chunkSize, frontiers[part].size());
+
+        for (size_t i = first; i < last; i++) {
+          size_t vertex = frontiers[part][i];
+          Weight value = distance[vertex].load(std::memory_order_relaxed);
+
+          for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+            size_t destination = targets[k];
+            size_t expected = noVertex;
+
+            if (destination != source && value + weights[k] ==
+                distance[destination].load(std::memory_order_relaxed) &&
+                parent[destination].compare_exchange_strong(
+                    expected, vertex, std::memory_order_relaxed)) {
+              settled[thread].push_back(destination);
+            }
+          }
+        }
+      }
+
+      barrier.Wait();
+
+      if (thread == 0) {
+        nextChunk = 0;
+      }
+
+      frontiers[thread].clear();
+      std::swap(frontiers[thread], settled[thread]);
+
+      barrier.Wait();
+    }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (size_t t = 1; t < numThreads; t++) {
+    threads.emplace_back(worker, t);
+  }
+
+  worker(0);
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  if (aborted) {
+    throw BudgetExceeded();
+  }
+
+  tree->distance.resize(numVertices);
+  tree->parent.resize(numVertices);
+
+  for (size_t vertex = 0; vertex < numVertices; vertex++) {
+    tree->distance[vertex] = distance[vertex].load(std::memory_order_relaxed);
+    tree->parent[vertex] = parent[vertex].load(std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Расстояния от вершины до всех достижимых вершин графа алгоритмом
+ *        delta-stepping.
+ *
+ * @tparam GraphType Тип графа: graph::WeightedOrientedGraph,
+ * graph::WeightedGraph или любой другой класс с методами Vertices(),
+ * HasVertex(), Edges() и EdgeWeight().
+ *
+ * @param graph Исходный граф. Веса рёбер должны быть положительными.
+ * @param source Номер начальной вершины.
+ * @param delta Ширина корзины (не положительное значение --- ширина
+ * по умолчанию).
+ * @param numThreads Число потоков.
+ * @param distances Вектор, в который записываются пары (вершина,
+ * расстояние) для всех достижимых вершин по возрастанию номеров вершин.
+ *
+ * Если вершины source в графе нет, то функция выбрасывает исключение
+ * std::out_of_range.
+ */
+template<typename GraphType>
+void DeltaStepping(
+    const GraphType& graph, size_t source,
+    typename GraphType::WeightType delta, size_t numThreads,
+    std::vector<std::pair<size_t,
+                          typename GraphType::WeightType>>* distances) {
+  using Weight = typename GraphType::WeightType;
+
+  WeightedCsrGraph<Weight> snapshot(graph);
+  ShortestPathTree<Weight> tree;
+
+  DeltaStepping(snapshot, snapshot.InternalId(source), delta, numThreads,
+                &tree);
+
+  distances->clear();
+
+  for (size_t index : snapshot.Vertices()) {
+    if (tree.distance[index] != ShortestPathTree<Weight>::Infinity()) {
+      distances->emplace_back(snapshot.ExternalId(index),
+                              tree.distance[index]);
+    }
+  }
+}
+
+}  // namespace graph
+
+#endif  // INCLUDE_DELTA_STEPPING_HPP_
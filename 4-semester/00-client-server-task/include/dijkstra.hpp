@@ -0,0 +1,420 @@
+/**
+ * @file dijkstra.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация алгоритма Дейкстры.
+ */
+
+#ifndef INCLUDE_DIJKSTRA_HPP_
+#define INCLUDE_DIJKSTRA_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <heaps.hpp>
+#include <trace.hpp>
+#include <weighted_csr_graph.hpp>
+
+namespace graph {
+
+//! Номер, обозначающий отсутствие вершины.
+constexpr size_t noVertex = std::numeric_limits<size_t>::max();
+
+/**
+ * @brief Дерево кратчайших путей во внутренней нумерации снимка.
+ *
+ * @tparam Weight Тип веса.
+ */
+template<typename Weight>
+struct ShortestPathTree {
+  //! Расстояния от источника. Для недостижимых вершин --- Infinity().
+  std::vector<Weight> distance;
+  //! Предыдущая вершина на кратчайшем пути (noVertex для источника
+  //! и недостижимых вершин).
+  std::vector<size_t> parent;
+
+  /**
+   * @brief Функция возвращает значение расстояния до недостижимой вершины.
+   */
+  static constexpr Weight Infinity() {
+    return std::numeric_limits<Weight>::max();
+  }
+
+  /**
+   * @brief Подготовить дерево для графа из numVertices вершин.
+   *
+   * @param numVertices Число вершин.
+   */
+  void Reset(size_t numVertices) {
+    distance.assign(numVertices, Infinity());
+    parent.assign(numVertices, noVertex);
+  }
+};
+
+/**
+ * @brief Рабочая память алгоритма Дейкстры.
+ *
+ * @tparam Weight Тип веса.
+ * @tparam Heap Очередь с приоритетами (@sa heaps.hpp).
+ *
+ * Объект можно переиспользовать между запусками, чтобы не выделять
+ * память заново.
+ */
+template<typename Weight, typename Heap = BinaryHeap<Weight>>
+struct DijkstraWorkspace {
+  //! CSR снимок графа.
+  WeightedCsrGraph<Weight> snapshot;
+  //! Снимок с обращёнными рёбрами (только для двустороннего поиска).
+  WeightedCsrGraph<Weight> reverse;
+  //! Дерево прямого поиска.
+  ShortestPathTree<Weight> forward;
+  //! Дерево обратного поиска.
+  ShortestPathTree<Weight> backward;
+  //! Очередь прямого поиска.
+  Heap forwardHeap;
+  //! Очередь обратного поиска.
+  Heap backwardHeap;
+};
+
+/**
+ * @brief Алгоритм Дейкстры на CSR снимке.
+ *
+ * @tparam Weight Тип веса. Веса рёбер должны быть неотрицательными.
+ * @tparam Heap Очередь с приоритетами (@sa heaps.hpp).
+ *
+ * @param graph Граф в формате CSR.
+ * @param source Внутренний номер источника.
+ * @param target Внутренний номер вершины, после извлечения которой поиск
+ * прекращается, или noVertex, чтобы найти расстояния до всех вершин.
+ * @param heap Очередь с приоритетами.
+ * @param tree Дерево, в которое записываются расстояния и пути. При
+ * досрочной остановке расстояния до target и всех извлечённых раньше неё
+ * вершин окончательные, остальные --- верхние оценки.
+ *
+ * Вершина может быть извлечена из очереди с устаревшим ключом (если
+ * очередь не поддерживает уменьшение ключа), такие записи пропускаются.
+ */
+template<typename Weight, typename Heap>
+void Dijkstra(const WeightedCsrGraph<Weight>& graph, size_t source,
+              size_t target, Heap* heap, ShortestPathTree<Weight>* tree) {
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  Span<Weight> weights = graph.Weights();
+  std::vector<Weight>& distance = tree->distance;
+  CpuMeter meter(CpuBudget::Current());
+
+  tree->Reset(graph.NumVertices());
+  heap->Reset(graph.NumVertices());
+
+  distance[source] = Weight();
+  heap->Push(source, Weight());
+
+  while (!heap->Empty()) {
+    std::pair<size_t, Weight> top = heap->Pop();
+    size_t vertex = top.first;
+
+    if (distance[vertex] < top.second) {
+      continue;
+    }
+
+    if (vertex == target) {
+      break;
+    }
+
+    meter.Tick(offsets[vertex + 1] - offsets[vertex] + 1);
+
+    for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+      Weight candidate = top.second + weights[k];
+      size_t destination = targets[k];
+
+      if (candidate < distance[destination]) {
+        distance[destination] = candidate;
+        tree->parent[destination] = vertex;
+        heap->Push(destination, candidate);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Восстановить путь по дереву кратчайших путей.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param tree Дерево кратчайших путей.
+ * @param vertex Внутренний номер последней вершины пути.
+ * @param path Вектор, в конец которого дописываются вершины пути от
+ * вершины vertex до корня дерева.
+ */
+template<typename Weight>
+void AppendTreePath(const ShortestPathTree<Weight>& tree, size_t vertex,
+                    std::vector<size_t>* path) {
+  for (; vertex != noVertex; vertex = tree.parent[vertex]) {
+    path->push_back(vertex);
+  }
+}
+
+/**
+ * @brief Двусторонний алгоритм Дейкстры на CSR снимке.
+ *
+ * @tparam Weight Тип веса. Веса рёбер должны быть неотрицательными.
+ * @tparam Heap Очередь с приоритетами (@sa heaps.hpp).
+ *
+ * @param graph Граф в формате CSR.
+ * @param reverse Тот же граф с обращёнными рёбрами
+ * (@sa WeightedCsrGraph::AssignTranspose()).
+ * @param source Внутренний номер источника.
+ * @param target Внутренний номер цели.
+ * @param workspace Рабочая память (снимки в ней не используются).
+ * @param path Вектор, в который записывается путь от source до target во
+ * внутренней нумерации.
+ * @param length Указатель, по которому записывается длина пути.
+ *
+ * @return Функция возвращает false, если target недостижима из source
+ * (в этом случае вектор path пуст).
+ *
+ * Поиск идёт попеременно из source по графу и из target по обращённому
+ * графу. При просмотре ребра, конец которого уже достигнут встречным
+ * поиском, обновляется длина лучшего найденного пути best. Поиск
+ * останавливается, когда сумма последних извлечённых ключей обеих сторон
+ * не меньше best: более короткий путь должен был бы пройти через вершину,
+ * не извлечённую ни одной из сторон. Обычно обе стороны просматривают
+ * шары вдвое меньшего радиуса, чем односторонний поиск.
+ */
+template<typename Weight, typename Heap>
+bool BidirectionalDijkstra(const WeightedCsrGraph<Weight>& graph,
+                           const WeightedCsrGraph<Weight>& reverse,
+                           size_t source, size_t target,
+                           DijkstraWorkspace<Weight, Heap>* workspace,
+                           std::vector<size_t>* path, Weight* length) {
+  ShortestPathTree<Weight>* trees[2] = { &workspace->forward,
+                                         &workspace->backward };
+  Heap* heaps[2] = { &workspace->forwardHeap, &workspace->backwardHeap };
+  const WeightedCsrGraph<Weight>* graphs[2] = { &graph, &reverse };
+  Weight best = ShortestPathTree<Weight>::Infinity();
+  // Ребро (meeting[0], meeting[1]) лучшего пути в прямом направлении.
+  size_t meeting[2] = { noVertex, noVertex };
+  Weight lastKey[2] = { Weight(), Weight() };
+  CpuMeter meter(CpuBudget::Current());
+
+  path->clear();
+
+  for (size_t side = 0; side < 2; side++) {
+    trees[side]->Reset(graph.NumVertices());
+    heaps[side]->Reset(graph.NumVertices());
+  }
+
+  trees[0]->distance[source] = Weight();
+  trees[1]->distance[target] = Weight();
+  heaps[0]->Push(source, Weight());
+  heaps[1]->Push(target, Weight());
+
+  if (source == target) {
+    best = Weight();
+    meeting[0] = meeting[1] = source;
+  }
+
+  for (size_t side = 0; !heaps[0]->Empty() && !heaps[1]->Empty();
+       side ^= 1) {
+    std::pair<size_t, Weight> top = heaps[side]->Pop();
+    size_t vertex = top.first;
+    std::vector<Weight>& distance = trees[side]->distance;
+    const std::vector<Weight>& other = trees[side ^ 1]->distance;
+
+    if (distance[vertex] < top.second) {
+      continue;
+    }
+
+    lastKey[side] = top.second;
+
+    if (!(lastKey[0] + lastKey[1] < best)) {
+      break;
+    }
+
+    Span<size_t> offsets = graphs[side]->Offsets();
+    Span<size_t> targets = graphs[side]->Targets();
+    Span<Weight> weights = graphs[side]->Weights();
+
+    meter.Tick(offsets[vertex + 1] - offsets[vertex] + 1);
+
+    for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+      Weight candidate = top.second + weights[k];
+      size_t destination = targets[k];
+
+      if (candidate < distance[destination]) {
+        distance[destination] = candidate;
+        trees[side]->parent[destination] = vertex;
+        heaps[side]->Push(destination, candidate);
+      }
+
+      if (other[destination] != ShortestPathTree<Weight>::Infinity() &&
+          candidate + other[destination] < best) {
+        best = candidate + other[destination];
+        meeting[side] = vertex;
+        meeting[side ^ 1] = destination;
+      }
+    }
+  }
+
+  if (meeting[0] == noVertex) {
+    return false;
+  }
+
+  // Путь от source до meeting[0] по прямому дереву и от meeting[1] до
+  // target по обратному.
+  AppendTreePath(*trees[0], meeting[0], path);
+  std::reverse(path->begin(), path->end());
+
+  if (meeting[1] != meeting[0]) {
+    AppendTreePath(*trees[1], meeting[1], path);
+  }
+
+  *length = best;
+
+  return true;
+}
+
+/**
+ * @brief Кратчайший путь между двумя вершинами.
+ *
+ * @tparam GraphType Тип графа: graph::WeightedOrientedGraph,
+ * graph::WeightedGraph или любой другой класс с методами Vertices(),
+ * HasVertex(), Edges() и EdgeWeight().
+ * @tparam Heap Очередь с приоритетами (@sa heaps.hpp).
+ *
+ * @param graph Исходный граф. Веса рёбер должны быть неотрицательными.
+ * @param source Номер начальной вершины.
+ * @param target Номер конечной вершины.
+ * @param bidirectional Использовать ли двусторонний поиск.
+ * @param workspace Рабочая память алгоритма.
+ * @param path Вектор, в который записывается путь в исходной нумерации.
+ * @param length Указатель, по которому записывается длина пути.
+ *
+ * @return Функция возвращает false, если путь не существует (в этом случае
+ * вектор path пуст). Если одной из вершин в графе нет, то функция
+ * выбрасывает исключение std::out_of_range.
+ *
+ * Односторонний поиск останавливается, как только из очереди извлечена
+ * вершина target.
+ */
+template<typename GraphType, typename Heap>
+bool ShortestPath(
+    const GraphType& graph, size_t source, size_t target,
+    bool bidirectional,
+    DijkstraWorkspace<typename GraphType::WeightType, Heap>* workspace,
+    std::vector<size_t>* path, typename GraphType::WeightType* length) {
+  using Weight = typename GraphType::WeightType;
+
+  WeightedCsrGraph<Weight>& snapshot = workspace->snapshot;
+
+  snapshot.Assign(graph);
+
+  size_t sourceIndex = snapshot.InternalId(source);
+  size_t targetIndex = snapshot.InternalId(target);
+
+  if (bidirectional) {
+    workspace->reverse.AssignTranspose(snapshot);
+
+    if (!BidirectionalDijkstra(snapshot, workspace->reverse, sourceIndex,
+                               targetIndex, workspace, path, length)) {
+      return false;
+    }
+  } else {
+    ShortestPathTree<Weight>& tree = workspace->forward;
+
+    path->clear();
+    Dijkstra(snapshot, sourceIndex, targetIndex, &workspace->forwardHeap,
+             &tree);
+
+    if (tree.distance[targetIndex] == ShortestPathTree<Weight>::Infinity()) {
+      return false;
+    }
+
+    AppendTreePath(tree, targetIndex, path);
+    std::reverse(path->begin(), path->end());
+    *length = tree.distance[targetIndex];
+  }
+
+  for (size_t& vertex : *path) {
+    vertex = snapshot.ExternalId(vertex);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Расстояния от вершины до всех достижимых вершин графа.
+ *
+ * @tparam GraphType Тип графа (@sa ShortestPath()).
+ * @tparam Heap Очередь с приоритетами (@sa heaps.hpp).
+ *
+ * @param graph Исходный граф. Веса рёбер должны быть неотрицательными.
+ * @param source Номер начальной вершины.
+ * @param workspace Рабочая память алгоритма.
+ * @param distances Вектор, в который записываются пары (вершина,
+ * расстояние) для всех достижимых вершин по возрастанию номеров вершин.
+ *
+ * Если вершины source в графе нет, то функция выбрасывает исключение
+ * std::out_of_range.
+ */
+template<typename GraphType, typename Heap>
+void Dijkstra(
+    const GraphType& graph, size_t source,
+    DijkstraWorkspace<typename GraphType::WeightType, Heap>* workspace,
+    std::vector<std::pair<size_t,
+                          typename GraphType::WeightType>>* distances) {
+  using Weight = typename GraphType::WeightType;
+
+  WeightedCsrGraph<Weight>& snapshot = workspace->snapshot;
+  ShortestPathTree<Weight>& tree = workspace->forward;
+
+  snapshot.Assign(graph);
+  Dijkstra(snapshot, snapshot.InternalId(source), noVertex,
+           &workspace->forwardHeap, &tree);
+
+  distances->clear();
+
+  for (size_t index : snapshot.Vertices()) {
+    if (tree.distance[index] != ShortestPathTree<Weight>::Infinity()) {
+      distances->emplace_back(snapshot.ExternalId(index),
+                              tree.distance[index]);
+    }
+  }
+}
+
+/**
+ * @brief Алгоритм Дейкстры.
+ *
+ * @tparam GraphType Тип графа (@sa ShortestPath()).
+ *
+ * @param graph Исходный граф. Веса рёбер должны быть неотрицательными.
+ * @param source Номер начальной вершины.
+ * @param target Номер конечной вершины.
+ *
+ * @return Функция возвращает кратчайший путь от source до target (вектор
+ * вершин, начинающийся с source и заканчивающийся target) или пустой
+ * вектор, если пути нет.
+ *
+ * Функция использует двоичную кучу и создаёт временную рабочую память. Для
+ * обработки потока запросов лучше использовать перегрузку
+ * с graph::DijkstraWorkspace.
+ */
+template<typename GraphType>
+std::vector<size_t> ShortestPath(const GraphType& graph, size_t source,
+                                 size_t target) {
+  using Weight = typename GraphType::WeightType;
+
+  DijkstraWorkspace<Weight> workspace;
+  std::vector<size_t> path;
+  Weight length;
+
+  ShortestPath(graph, source, target, false, &workspace, &path, &length);
+
+  return path;
+}
+
+}  // namespace graph
+
+#endif  // INCLUDE_DIJKSTRA_HPP_
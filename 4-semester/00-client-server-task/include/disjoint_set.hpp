@@ -0,0 +1,227 @@
+/**
+ * @file disjoint_set.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация системы непересекающихся множеств.
+ */
+
+#ifndef INCLUDE_DISJOINT_SET_HPP_
+#define INCLUDE_DISJOINT_SET_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Система непересекающихся множеств на элементах 0, ..., size - 1.
+ *
+ * Используются объединение по рангу и сокращение пути вдвое: при поиске
+ * каждая вторая вершина на пути подвешивается к своему деду. Поиск
+ * выполняется за один проход без рекурсии и стоит O(α(n)) в среднем.
+ */
+class DisjointSet {
+ public:
+  /**
+   * @brief Конструктор класса DisjointSet.
+   *
+   * @param size Число элементов. Каждый элемент лежит в своём множестве.
+   */
+  explicit DisjointSet(size_t size = 0) {
+    Reset(size);
+  }
+
+  /**
+   * @brief Разбить элементы 0, ..., size - 1 на одноэлементные множества.
+   *
+   * @param size Число элементов.
+   */
+  void Reset(size_t size) {
+    parent.resize(size);
+    std::iota(parent.begin(), parent.end(), 0);
+    rank.assign(size, 0);
+  }
+
+  /**
+   * @brief Найти представителя множества, в котором лежит элемент.
+   *
+   * @param element Элемент.
+   */
+  size_t Find(size_t element) {
+    while (parent[element] != element) {
+      parent[element] = parent[parent[element]];
+      element = parent[element];
+    }
+
+    return element;
+  }
+
+  /**
+   * @brief Объединить множества, в которых лежат два элемента.
+   *
+   * @param element1 Первый элемент.
+   * @param element2 Второй элемент.
+   *
+   * @return Функция возвращает false, если элементы уже лежат в одном
+   * множестве.
+   */
+  bool Union(size_t element1, size_t element2) {
+    size_t root1 = Find(element1);
+    size_t root2 = Find(element2);
+
+    if (root1 == root2) {
+      return false;
+    }
+
+    if (rank[root1] < rank[root2]) {
+      std::swap(root1, root2);
+    }
+
+    parent[root2] = root1;
+
+    if (rank[root1] == rank[root2]) {
+      rank[root1]++;
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Функция возвращает число элементов.
+   */
+  size_t Size() const {
+    return parent.size();
+  }
+
+ private:
+  //! Родитель элемента в дереве множества (корень указывает сам на себя).
+  std::vector<size_t> parent;
+  //! Верхняя оценка высоты дерева корня (не больше log2(size)).
+  std::vector<uint8_t> rank;
+};
+
+/**
+ * @brief Система непересекающихся множеств для одновременного доступа из
+ *        нескольких потоков без блокировок.
+ *
+ * Корень с меньшим номером подвешивается к корню с большим номером
+ * атомарной операцией compare-and-swap. Родитель элемента всегда имеет
+ * больший номер, поэтому циклы не возникают при любом порядке операций.
+ * Если корень успел получить родителя, операция повторяется с новыми
+ * корнями. Поиск сокращает путь вдвое так же, как DisjointSet::Find(),
+ * но ссылки меняются операцией compare-and-swap, поэтому одновременный
+ * поиск и объединение не теряют изменений друг друга.
+ *
+ * Все операции используют std::memory_order_relaxed: порядок изменений
+ * одного элемента согласован у всех потоков, а видимость изменений
+ * между фазами алгоритма обеспечивают барьеры вызывающего кода.
+ */
+class ConcurrentDisjointSet {
+ public:
+  /**
+   * @brief Конструктор класса ConcurrentDisjointSet.
+   *
+   * @param size Число элементов. Каждый элемент лежит в своём множестве.
+   */
+  explicit ConcurrentDisjointSet(size_t size = 0) {
+    Reset(size);
+  }
+
+  /**
+   * @brief Разбить элементы 0, ..., size - 1 на одноэлементные множества.
+   *
+   * @param size Число элементов.
+   *
+   * Функцию нельзя вызывать одновременно с другими операциями.
+   */
+  void Reset(size_t size) {
+    parent = std::vector<std::atomic<size_t>>(size);
+
+    for (size_t element = 0; element < size; element++) {
+      parent[element].store(element, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Найти представителя множества, в котором лежит элемент.
+   *
+   * @param element Элемент.
+   *
+   * Если одновременно идут объединения, то результат --- корень на момент
+   * одного из чтений.
+   */
+  size_t Find(size_t element) {
+    while (true) {
+      size_t next = parent[element].load(std::memory_order_relaxed);
+
+      if (next == element) {
+        return element;
+      }
+
+      size_t grandparent = parent[next].load(std::memory_order_relaxed);
+
+      // Дед --- предок элемента, поэтому переход к нему безопасен, даже
+      // если другой поток уже изменил ссылку.
+      if (grandparent != next) {
+        parent[element].compare_exchange_weak(next, grandparent,
+                                              std::memory_order_relaxed);
+      }
+
+      element = grandparent;
+    }
+  }
+
+  /**
+   * @brief Объединить множества, в которых лежат два элемента.
+   *
+   * @param element1 Первый элемент.
+   * @param element2 Второй элемент.
+   *
+   * @return Функция возвращает false, если элементы уже лежат в одном
+   * множестве. Если несколько потоков объединяют одни и те же множества,
+   * то true получает ровно один из них.
+   */
+  bool Union(size_t element1, size_t element2) {
+    while (true) {
+      size_t root1 = Find(element1);
+      size_t root2 = Find(element2);
+
+      if (root1 == root2) {
+        return false;
+      }
+
+      if (root1 < root2) {
+        std::swap(root1, root2);
+      }
+
+      size_t expected = root2;
+
+      if (parent[root2].compare_exchange_strong(expected, root1,
+                                                std::memory_order_relaxed)) {
+        return true;
+      }
+
+      element1 = root1;
+      element2 = root2;
+    }
+  }
+
+  /**
+   * @brief Функция возвращает число элементов.
+   */
+  size_t Size() const {
+    return parent.size();
+  }
+
+ private:
+  //! Родитель элемента в дереве множества (корень указывает сам на себя).
+  std::vector<std::atomic<size_t>> parent;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_DISJOINT_SET_HPP_
@@ -0,0 +1,422 @@
+/**
+ * @file dynamic_topological_order.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация топологического порядка, который поддерживается при
+ * добавлении и удалении рёбер (алгоритм Пирса --- Келли).
+ */
+
+#ifndef INCLUDE_DYNAMIC_TOPOLOGICAL_ORDER_HPP_
+#define INCLUDE_DYNAMIC_TOPOLOGICAL_ORDER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <oriented_graph.hpp>
+#include <topological_sort.hpp>
+
+namespace graph {
+
+/**
+ * @brief Ориентированный ациклический граф с поддерживаемым
+ *        топологическим порядком.
+ *
+ * Каждой вершине сопоставлена позиция: для любого ребра (U, V) позиция U
+ * меньше позиции V. При добавлении ребра (U, V), которое уже согласовано
+ * с порядком, ничего не пересчитывается. Иначе алгоритм Пирса --- Келли
+ * (Pearce, Kelly, 2006) ищет затронутую область: вершины, достижимые из V,
+ * с позициями меньше позиции U, и вершины, из которых достижима U,
+ * с позициями больше позиции V. Если прямой поиск дошёл до U, то ребро
+ * замыкает цикл и не добавляется. Иначе вершины области переставляются
+ * на свои же позиции: сначала найденные обратным поиском, затем прямым,
+ * каждая группа в прежнем порядке. Время добавления пропорционально
+ * размеру затронутой области и числу её рёбер, а не размеру графа.
+ *
+ * Удаление ребра не нарушает порядок и стоит O(1). При удалении вершины
+ * её позиция становится пустой; когда пустых позиций больше, чем вершин,
+ * позиции уплотняются за O(|V|).
+ */
+class DynamicTopologicalOrder {
+ public:
+  /**
+   * @brief Конструктор пустого графа.
+   */
+  DynamicTopologicalOrder() :
+    numHoles(0) {
+  }
+
+  /**
+   * @brief Заменить граф копией другого графа.
+   *
+   * @param other Исходный граф.
+   *
+   * @return Функция возвращает true, если граф ацикличен. Если в графе
+   * есть цикл, то функция возвращает false, а объект становится пустым.
+   *
+   * Начальный порядок строится функцией TopologicalSort(). Концы рёбер,
+   * которых нет в списке вершин other, добавляются как вершины.
+   */
+  bool Assign(const OrientedGraph& other) {
+    std::vector<size_t> initialOrder;
+    TopologicalSortWorkspace workspace;
+
+    Clear();
+
+    if (!TopologicalSort(other, &workspace, &initialOrder)) {
+      return false;
+    }
+
+    for (size_t id : initialOrder) {
+      AddVertex(id);
+    }
+
+    for (size_t id : other.Vertices()) {
+      for (size_t neighbourId : other.Edges(id)) {
+        graph.AddEdge(id, neighbourId);
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Удалить все вершины и рёбра.
+   */
+  void Clear() {
+    graph = OrientedGraph();
+    position.clear();
+    order.clear();
+    numHoles = 0;
+  }
+
+  /**
+   * @brief Добавить вершину в конец порядка.
+   *
+   * @param id Номер вершины. Если вершина уже есть, то функция ничего
+   * не делает.
+   */
+  void AddVertex(size_t id) {
+    if (position.emplace(id, order.size()).second) {
+      order.push_back(id);
+      graph.AddVertex(id);
+    }
+  }
+
+  /**
+   * @brief Добавить ребро, сохранив топологический порядок.
+   *
+   * @param id1 Номер вершины, из которой выходит ребро.
+   * @param id2 Номер вершины, в которую входит ребро.
+   * @param cycle Если не нулевой указатель и ребро замыкает цикл, то
+   * в вектор записываются вершины цикла id1, id2, ..., где последняя
+   * вершина соединена ребром с id1.
+   *
+   * @return Функция возвращает false и не добавляет ребро, если оно
+   * замыкает цикл (в том числе для петли), и true в противном случае.
+   * Отсутствующие вершины в обоих случаях добавляются в конец порядка.
+   */
+  bool AddEdge(size_t id1, size_t id2, std::vector<size_t>* cycle = nullptr) {
+    AddVertex(id1);
+    AddVertex(id2);
+
+    if (id1 == id2) {
+      if (cycle) {
+        cycle->assign(1, id1);
+      }
+
+      return false;
+    }
+
+    size_t lower = position[id2];
+    size_t upper = position[id1];
+
+    if (upper > lower && !graph.HasEdge(id1, id2)) {
+      if (!Search(id2, upper, true, &forward)) {
+        if (cycle) {
+          cycle->assign(1, id1);
+
+          for (const Frame& frame : stack) {
+            cycle->push_back(frame.vertex);
+          }
+        }
+
+        stack.clear();
+        return false;
+      }
+
+      Search(id1, lower, false, &backward);
+      Reorder();
+    }
+
+    graph.AddEdge(id1, id2);
+
+    return true;
+  }
+
+  /**
+   * @brief Удалить ребро.
+   *
+   * @param id1 Номер вершины, из которой выходит ребро.
+   * @param id2 Номер вершины, в которую входит ребро.
+   *
+   * Если такого ребра нет, то функция ничего не делает.
+   */
+  void RemoveEdge(size_t id1, size_t id2) {
+    graph.RemoveEdge(id1, id2);
+  }
+
+  /**
+   * @brief Удалить вершину и все её рёбра.
+   *
+   * @param id Номер вершины. Если вершины нет, то функция ничего не делает.
+   */
+  void RemoveVertex(size_t id) {
+    auto it = position.find(id);
+
+    if (it == position.end()) {
+      return;
+    }
+
+    graph.RemoveVertex(id);
+    order[it->second] = hole;
+    position.erase(it);
+    numHoles++;
+
+    if (numHoles > position.size()) {
+      Compact();
+    }
+  }
+
+  /**
+   * @brief Функция проверяет, есть ли вершина в графе.
+   *
+   * @param id Номер вершины.
+   */
+  bool HasVertex(size_t id) const {
+    return position.find(id) != position.end();
+  }
+
+  /**
+   * @brief Функция проверяет, есть ли ребро в графе.
+   *
+   * @param id1 Номер вершины, из которой выходит ребро.
+   * @param id2 Номер вершины, в которую входит ребро.
+   */
+  bool HasEdge(size_t id1, size_t id2) const {
+    return graph.HasEdge(id1, id2);
+  }
+
+  /**
+   * @brief Функция проверяет, стоит ли вершина id1 в порядке раньше id2.
+   *
+   * @param id1 Номер первой вершины.
+   * @param id2 Номер второй вершины.
+   *
+   * Если одной из вершин нет в графе, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  bool Precedes(size_t id1, size_t id2) const {
+    return position.at(id1) < position.at(id2);
+  }
+
+  /**
+   * @brief Функция возвращает вершины в топологическом порядке.
+   *
+   * Время работы O(|V|).
+   */
+  std::vector<size_t> Order() const {
+    std::vector<size_t> result;
+
+    result.reserve(position.size());
+
+    for (size_t id : order) {
+      if (id != hole) {
+        result.push_back(id);
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Функция возвращает количество вершин в графе.
+   */
+  size_t NumVertices() const {
+    return position.size();
+  }
+
+  /**
+   * @brief Функция возвращает граф.
+   *
+   * Граф можно передавать любым алгоритмам, но менять его следует только
+   * через методы этого класса.
+   */
+  const OrientedGraph& Graph() const {
+    return graph;
+  }
+
+ private:
+  /**
+   * @brief Элемент явного стека обхода в глубину.
+   */
+  struct Frame {
+    //! Вершина.
+    size_t vertex;
+    //! Следующий непросмотренный сосед.
+    OrientedGraph::NeighbourSet::const_iterator next;
+    //! Конец множества соседей.
+    OrientedGraph::NeighbourSet::const_iterator end;
+  };
+
+  //! Значение в массиве order для пустой позиции.
+  static constexpr size_t hole = std::numeric_limits<size_t>::max();
+
+  /**
+   * @brief Обход затронутой области.
+   *
+   * @param root Начальная вершина.
+   * @param bound Граница: прямой обход (isForward == true) посещает только
+   * вершины с позициями меньше bound и сообщает о цикле, если дошёл до
+   * вершины с позицией bound; обратный обход по входящим рёбрам посещает
+   * только вершины с позициями больше bound.
+   * @param isForward Направление обхода.
+   * @param visited Вектор, в который записываются посещённые вершины.
+   *
+   * @return Функция возвращает false, если найден цикл. Тогда в stack
+   * остаётся путь от root до вершины, соединённой ребром с вершиной
+   * на позиции bound.
+   */
+  bool Search(size_t root, size_t bound, bool isForward,
+              std::vector<size_t>* visited) {
+    visited->assign(1, root);
+    marked.clear();
+    marked.insert(root);
+    Push(root, isForward);
+
+    while (!stack.empty()) {
+      Frame& frame = stack.back();
+
+      if (frame.next == frame.end) {
+        stack.pop_back();
+        continue;
+      }
+
+      size_t neighbour = *frame.next++;
+      size_t neighbourPosition = position[neighbour];
+
+      if (isForward && neighbourPosition == bound) {
+        return false;
+      }
+
+      if ((isForward ? neighbourPosition < bound :
+                       neighbourPosition > bound) &&
+          marked.insert(neighbour).second) {
+        visited->push_back(neighbour);
+        Push(neighbour, isForward);
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Положить вершину на стек обхода.
+   */
+  void Push(size_t vertex, bool isForward) {
+    const OrientedGraph::NeighbourSet& neighbours =
+        isForward ? graph.Edges(vertex) : graph.IncomingEdges(vertex);
+
+    stack.push_back(Frame{vertex, neighbours.begin(), neighbours.end()});
+  }
+
+  /**
+   * @brief Переставить вершины затронутой области.
+   *
+   * Вершины обратного обхода занимают младшие из освободившихся позиций,
+   * вершины прямого обхода --- старшие. Внутри каждой группы сохраняется
+   * прежний порядок, поэтому рёбра внутри групп остаются согласованными.
+   */
+  void Reorder() {
+    auto byPosition = [this](size_t id1, size_t id2) {
+      return position[id1] < position[id2];
+    };
+
+    std::sort(backward.begin(), backward.end(), byPosition);
+    std::sort(forward.begin(), forward.end(), byPosition);
+
+    positions.clear();
+
+    for (size_t id : backward) {
+      positions.push_back(position[id]);
+    }
+
+    for (size_t id : forward) {
+      positions.push_back(position[id]);
+    }
+
+    std::sort(positions.begin(), positions.end());
+
+    size_t i = 0;
+
+    for (const std::vector<size_t>* group : { &backward, &forward }) {
+      for (size_t id : *group) {
+        position[id] = positions[i];
+        order[positions[i]] = id;
+        i++;
+      }
+    }
+  }
+
+  /**
+   * @brief Убрать пустые позиции.
+   */
+  void Compact() {
+    size_t next = 0;
+
+    for (size_t id : order) {
+      if (id != hole) {
+        position[id] = next;
+        order[next++] = id;
+      }
+    }
+
+    order.resize(next);
+    numHoles = 0;
+  }
+
+  //! Граф.
+  OrientedGraph graph;
+
+  //! Позиции вершин.
+  std::unordered_map<size_t, size_t> position;
+
+  //! Вершины по позициям; пустые позиции равны hole.
+  std::vector<size_t> order;
+
+  //! Число пустых позиций.
+  size_t numHoles;
+
+  //! Явный стек обхода. Рабочая память переиспользуется между вызовами
+  //! AddEdge().
+  std::vector<Frame> stack;
+
+  //! Вершины, посещённые текущим обходом.
+  std::unordered_set<size_t> marked;
+
+  //! Вершины, найденные прямым обходом.
+  std::vector<size_t> forward;
+
+  //! Вершины, найденные обратным обходом.
+  std::vector<size_t> backward;
+
+  //! Позиции затронутой области.
+  std::vector<size_t> positions;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_DYNAMIC_TOPOLOGICAL_ORDER_HPP_
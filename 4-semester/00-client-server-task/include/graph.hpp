@@ -8,23 +8,38 @@
 #ifndef INCLUDE_GRAPH_HPP_
 #define INCLUDE_GRAPH_HPP_
 
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 #include <utility>
+#include <graph_storage.hpp>
 #include <iterators.hpp>
 
 namespace graph {
 
+class GraphBuilder;
+
 /**
  * @brief Простой неориентированный граф.
+ *
+ * @tparam Storage Политика хранения списков смежности: graph::SmallStorage
+ * (по умолчанию), graph::HashStorage, graph::FlatStorage или
+ * graph::CompactStorage (@sa graph_storage.hpp).
  */
-class Graph {
+template<typename Storage = SmallStorage>
+class BasicGraph {
  public:
+  //! Тип, в котором хранятся номера вершин.
+  using Id = typename Storage::Id;
+
+  //! Тип множества соседей вершины.
+  using NeighbourSet = typename Storage::Set;
+
+  //! Тип словаря смежности.
+  using AdjacencyMap = typename Storage::template Map<NeighbourSet>;
+
   /**
-   * @brief Конструктор класса Graph.
+   * @brief Конструктор класса BasicGraph.
    */
-  Graph() { }
+  BasicGraph() { }
 
   /**
    * @brief Добавить вершину в граф.
@@ -48,6 +63,10 @@ class Graph {
    * ребро в графе уже есть, то функция ничего не делает.
    */
   void AddEdge(size_t id1, size_t id2) {
+    // Номера проверяются до изменения графа (@sa CompactStorage).
+    NarrowId<Id>(id1);
+    NarrowId<Id>(id2);
+
     edges[id1].insert(id2);
     edges[id2].insert(id1);
   }
@@ -80,7 +99,7 @@ class Graph {
       return false;
     }
 
-    return it->second.find(id2) != it->second.end();
+    return it->second.count(id2) > 0;
   }
 
   /**
@@ -131,12 +150,12 @@ class Graph {
    *
    * @param id Номер вершины.
    *
-   * Функция возвращает множество вершин в виде хеш-таблицы, с которыми
+   * Функция возвращает множество вершин NeighbourSet, с которыми
    * соединена вершина id, то есть множество таких вершин V, что ребро (id, V)
    * присутствует в графе. Если указанной вершини в графе нет, то функция
    * выбрасывает исключение std::out_of_range.
    */
-  const std::unordered_set<size_t>& Edges(size_t id) const {
+  const NeighbourSet& Edges(size_t id) const {
     return edges.at(id);
   }
 
@@ -145,12 +164,12 @@ class Graph {
    *
    * @param id Номер вершины.
    *
-   * Функция возвращает множество вершин в виде хеш-таблицы, соединённых
+   * Функция возвращает множество вершин NeighbourSet, соединённых
    * с вершиной id, то есть множество таких вершин V, что ребро (V, id)
    * присутствует в графе. Если указанной вершини в графе нет, то функция
    * выбрасывает исключение std::out_of_range.
    */
-  const std::unordered_set<size_t>& IncomingEdges(size_t id) const {
+  const NeighbourSet& IncomingEdges(size_t id) const {
     return edges.at(id);
   }
 
@@ -160,8 +179,21 @@ class Graph {
    * Функция возвращает специальный класс-промежуток, по которому
    * можно проитерироваться при помощи цикла range-base for.
    */
-  VerticesRange Vertices() const {
-    return VerticesRange(edges.begin(), edges.end());
+  VerticesRange<typename AdjacencyMap::const_iterator> Vertices() const {
+    return { edges.begin(), edges.end() };
+  }
+
+  /**
+   * @brief Зарезервировать место для вершин.
+   *
+   * @param numVertices Ожидаемое число вершин.
+   *
+   * Функция заранее выделяет память под словарь вершин, чтобы при
+   * добавлении вершин не происходило перехеширование. Для добавления
+   * большого числа рёбер удобнее использовать graph::GraphBuilder.
+   */
+  void Reserve(size_t numVertices) {
+    edges.reserve(numVertices);
   }
 
   /**
@@ -172,6 +204,9 @@ class Graph {
   }
 
  private:
+  //! Класс для пакетного построения графа.
+  friend class GraphBuilder;
+
   /**
    * @brief Вспомогательная функция для получения идентификатора ребра.
    *
@@ -188,9 +223,18 @@ class Graph {
   }
 
   //! Разреженная матрица связности.
-  std::unordered_map<size_t, std::unordered_set<size_t>> edges;
+  AdjacencyMap edges;
 };
 
+//! Неориентированный граф (@sa SmallStorage).
+using Graph = BasicGraph<SmallStorage>;
+
+//! Неориентированный граф в компактном представлении (@sa FlatStorage).
+using FlatGraph = BasicGraph<FlatStorage>;
+
+//! Неориентированный граф с 32-битными номерами вершин (@sa CompactStorage).
+using CompactGraph = BasicGraph<CompactStorage>;
+
 }  // namespace graph
 
 #endif  // INCLUDE_GRAPH_HPP_
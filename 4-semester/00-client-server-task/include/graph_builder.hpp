@@ -0,0 +1,494 @@
+/**
+ * @file graph_builder.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Классы для пакетного построения графов.
+ */
+
+#ifndef INCLUDE_GRAPH_BUILDER_HPP_
+#define INCLUDE_GRAPH_BUILDER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <graph.hpp>
+#include <oriented_graph.hpp>
+#include <weighted_graph.hpp>
+#include <weighted_oriented_graph.hpp>
+
+namespace graph {
+
+/**
+ * @brief Базовый класс для пакетного построения графов.
+ *
+ * @tparam Edge Тип ребра. Должен иметь поля start и end.
+ *
+ * Класс накапливает вершины и рёбра в массивах, а при построении графа
+ * сортирует их, удаляет повторы и заполняет хеш-таблицы графа за один
+ * проход: каждая таблица заранее получает нужный размер, поэтому
+ * перехеширования не происходит, а словарь вершин графа просматривается
+ * один раз на вершину, а не на каждое ребро.
+ */
+template<typename Edge>
+class GraphBuilderBase {
+ public:
+  /**
+   * @brief Зарезервировать память.
+   *
+   * @param numVertices Ожидаемое число вершин.
+   * @param numEdges Ожидаемое число рёбер.
+   */
+  void Reserve(size_t numVertices, size_t numEdges) {
+    vertices.reserve(numVertices);
+    edges.reserve(numEdges);
+  }
+
+  /**
+   * @brief Добавить вершину.
+   *
+   * @param id Уникальный номер вершины.
+   */
+  void AddVertex(size_t id) {
+    vertices.push_back(id);
+  }
+
+  /**
+   * @brief Функция возвращает число добавленных рёбер (с повторами).
+   */
+  size_t NumEdges() const {
+    return edges.size();
+  }
+
+  /**
+   * @brief Удалить все добавленные вершины и рёбра.
+   *
+   * Зарезервированная память сохраняется.
+   */
+  void Clear() {
+    vertices.clear();
+    edges.clear();
+  }
+
+ protected:
+  /**
+   * @brief Упорядочить концы каждого ребра (для неориентированных графов).
+   */
+  void NormalizeEdges() {
+    for (Edge& edge : edges) {
+      if (edge.end < edge.start) {
+        std::swap(edge.start, edge.end);
+      }
+    }
+  }
+
+  /**
+   * @brief Отсортировать рёбра и удалить повторы.
+   *
+   * Из повторяющихся рёбер остаётся добавленное последним, как если бы
+   * рёбра добавлялись в граф по одному.
+   */
+  void SortEdges() {
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const Edge& left, const Edge& right) {
+      return std::tie(left.start, left.end) < std::tie(right.start, right.end);
+    });
+
+    size_t size = 0;
+
+    for (size_t i = 0; i < edges.size(); i++) {
+      if (i + 1 < edges.size() && edges[i].start == edges[i + 1].start &&
+          edges[i].end == edges[i + 1].end) {
+        continue;
+      }
+
+      edges[size++] = edges[i];
+    }
+
+    edges.resize(size);
+  }
+
+  /**
+   * @brief Проверить, что номера всех вершин помещаются в тип Id.
+   *
+   * @tparam Id Тип, в котором граф хранит номера вершин.
+   *
+   * Если это не так, то функция выбрасывает исключение std::out_of_range
+   * до изменения графа. Для графов с номерами size_t проверки нет.
+   */
+  template<typename Id>
+  void CheckIds() const {
+    if constexpr (!FitsId<Id>(std::numeric_limits<size_t>::max())) {
+      for (size_t id : vertices) {
+        NarrowId<Id>(id);
+      }
+
+      for (const Edge& edge : edges) {
+        NarrowId<Id>(edge.start);
+        NarrowId<Id>(edge.end);
+      }
+    }
+  }
+
+  /**
+   * @brief Функция возвращает добавленные вершины по возрастанию без повторов.
+   */
+  std::vector<size_t> SortedVertices() const {
+    std::vector<size_t> ids = vertices;
+
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    return ids;
+  }
+
+  /**
+   * @brief Добавить соседа в множество соседей вершины.
+   *
+   * @param neighbours Множество соседей.
+   * @param id Номер соседа.
+   */
+  template<typename NeighbourSet>
+  static void AddNeighbour(NeighbourSet* neighbours, size_t id) {
+    neighbours->insert(id);
+  }
+
+  /**
+   * @brief Добавить соседа и вес ребра в словарь соседей вершины.
+   *
+   * @param neighbours Словарь соседей.
+   * @param edge Пара (номер соседа, вес ребра). Вес уже имеющегося ребра
+   * заменяется.
+   */
+  template<typename NeighbourMap, typename Weight>
+  static void AddNeighbour(NeighbourMap* neighbours,
+                           const std::pair<size_t, Weight>& edge) {
+    (*neighbours)[edge.first] = edge.second;
+  }
+
+  /**
+   * @brief Добавить вершины и пары (from, to) в словарь смежности графа.
+   *
+   * @param ids Отсортированные номера вершин без повторов.
+   * @param pairs Массив пар, отсортированный по from. Элемент to --- номер
+   * соседа или пара (номер соседа, вес ребра) (@sa AddNeighbour()).
+   * @param adjacency Словарь смежности.
+   *
+   * @tparam AdjacencyMap Тип словаря смежности графа (@sa graph_storage.hpp).
+   * @tparam Neighbour Тип элемента to.
+   */
+  template<typename AdjacencyMap, typename Neighbour>
+  static void AddAdjacency(
+      const std::vector<size_t>& ids,
+      const std::vector<std::pair<size_t, Neighbour>>& pairs,
+      AdjacencyMap* adjacency) {
+    size_t numKeys = 0;
+
+    for (size_t i = 0; i < pairs.size(); i++) {
+      if (i == 0 || pairs[i].first != pairs[i - 1].first) {
+        numKeys++;
+      }
+    }
+
+    adjacency->reserve(adjacency->size() + ids.size() + numKeys);
+
+    for (size_t id : ids) {
+      (*adjacency)[id];
+    }
+
+    for (size_t first = 0; first < pairs.size();) {
+      size_t last = first;
+
+      while (last < pairs.size() && pairs[last].first == pairs[first].first) {
+        last++;
+      }
+
+      auto& neighbours = (*adjacency)[pairs[first].first];
+
+      neighbours.reserve(neighbours.size() + last - first);
+
+      for (size_t i = first; i < last; i++) {
+        AddNeighbour(&neighbours, pairs[i].second);
+      }
+
+      first = last;
+    }
+  }
+
+  /**
+   * @brief Заполнить словари исходящих и входящих рёбер.
+   *
+   * @param outgoing Словарь исходящих рёбер.
+   * @param incoming Словарь входящих рёбер (может быть не указан). Если
+   * он не указан, то граф считается неориентированным, и каждое ребро
+   * записывается в outgoing в обе стороны.
+   *
+   * Словари заполняются так же, как при добавлении рёбер по одному
+   * функциями AddEdge() графа.
+   *
+   * @tparam AdjacencyMap Тип словаря смежности графа.
+   */
+  template<typename AdjacencyMap>
+  void Fill(AdjacencyMap* outgoing,
+            AdjacencyMap* incoming = nullptr) const {
+    std::vector<size_t> ids = SortedVertices();
+    std::vector<std::pair<size_t, size_t>> pairs;
+
+    pairs.reserve(incoming ? edges.size() : 2 * edges.size());
+
+    for (const Edge& edge : edges) {
+      pairs.emplace_back(edge.start, edge.end);
+
+      if (!incoming && edge.start != edge.end) {
+        pairs.emplace_back(edge.end, edge.start);
+      }
+    }
+
+    if (!incoming) {
+      std::sort(pairs.begin(), pairs.end());
+    }
+
+    AddAdjacency(ids, pairs, outgoing);
+
+    if (incoming) {
+      for (std::pair<size_t, size_t>& pair : pairs) {
+        std::swap(pair.first, pair.second);
+      }
+
+      std::sort(pairs.begin(), pairs.end());
+      AddAdjacency(ids, pairs, incoming);
+    }
+  }
+
+  //! Добавленные вершины.
+  std::vector<size_t> vertices;
+  //! Добавленные рёбра.
+  std::vector<Edge> edges;
+};
+
+/**
+ * @brief Ребро без веса для класса graph::GraphBuilder.
+ */
+struct BuilderEdge {
+  //! Начало ребра.
+  size_t start;
+  //! Конец ребра.
+  size_t end;
+};
+
+/**
+ * @brief Класс для пакетного построения невзвешенных графов.
+ *
+ * Пример использования:
+ * @code
+ * graph::GraphBuilder builder;
+ *
+ * builder.Reserve(numVertices, numEdges);
+ * builder.AddEdges(edges.begin(), edges.end());
+ *
+ * graph::OrientedGraph graph;
+ *
+ * builder.Build(&graph);
+ * @endcode
+ *
+ * Функции Build() добавляют вершины и рёбра к уже имеющимся в графе
+ * и очищают построитель. Одинаковые рёбра добавляются один раз. Если граф
+ * хранит номера вершин в uint32_t (@sa CompactStorage), а какой-то номер
+ * в него не помещается, то Build() выбрасывает исключение std::out_of_range
+ * и не меняет ни граф, ни построитель.
+ */
+class GraphBuilder : public GraphBuilderBase<BuilderEdge> {
+ public:
+  /**
+   * @brief Добавить ребро.
+   *
+   * @param id1 Номер вершины, из которой выходит ребро.
+   * @param id2 Номер вершины, в которую входит ребро.
+   */
+  void AddEdge(size_t id1, size_t id2) {
+    edges.push_back(BuilderEdge{id1, id2});
+  }
+
+  /**
+   * @brief Добавить рёбра из промежутка.
+   *
+   * @tparam Iterator Тип итератора. Элементы промежутка должны иметь вид
+   * std::pair<size_t, size_t> (начало, конец).
+   *
+   * @param first Итератор на первое ребро.
+   * @param last Итератор за последним ребром.
+   */
+  template<typename Iterator>
+  void AddEdges(Iterator first, Iterator last) {
+    for (; first != last; ++first) {
+      AddEdge(first->first, first->second);
+    }
+  }
+
+  /**
+   * @brief Построить неориентированный граф.
+   *
+   * @param graph Граф, в который добавляются вершины и рёбра.
+   */
+  template<typename Storage>
+  void Build(BasicGraph<Storage>* graph) {
+    CheckIds<typename Storage::Id>();
+    NormalizeEdges();
+    SortEdges();
+    Fill(&graph->edges);
+    Clear();
+  }
+
+  /**
+   * @brief Построить ориентированный граф.
+   *
+   * @param graph Граф, в который добавляются вершины и рёбра.
+   */
+  template<typename Storage>
+  void Build(BasicOrientedGraph<Storage>* graph) {
+    CheckIds<typename Storage::Id>();
+    SortEdges();
+    Fill(&graph->edges, &graph->incomingEdges);
+    Clear();
+  }
+};
+
+/**
+ * @brief Взвешенное ребро для класса graph::WeightedGraphBuilder.
+ *
+ * @tparam Weight Тип веса.
+ */
+template<typename Weight>
+struct WeightedBuilderEdge {
+  //! Начало ребра.
+  size_t start;
+  //! Конец ребра.
+  size_t end;
+  //! Вес ребра.
+  Weight weight;
+};
+
+/**
+ * @brief Класс для пакетного построения взвешенных графов.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * Если одно и то же ребро добавлено несколько раз, то в графе остаётся
+ * вес, добавленный последним.
+ */
+template<typename Weight>
+class WeightedGraphBuilder :
+    public GraphBuilderBase<WeightedBuilderEdge<Weight>> {
+ public:
+  /**
+   * @brief Добавить ребро.
+   *
+   * @param id1 Номер вершины, из которой выходит ребро.
+   * @param id2 Номер вершины, в которую входит ребро.
+   * @param weight Вес ребра.
+   */
+  void AddEdge(size_t id1, size_t id2, Weight weight) {
+    this->edges.push_back(WeightedBuilderEdge<Weight>{id1, id2, weight});
+  }
+
+  /**
+   * @brief Добавить рёбра из промежутка.
+   *
+   * @tparam Iterator Тип итератора. Элементы промежутка должны иметь вид
+   * std::tuple<size_t, size_t, Weight> (начало, конец, вес).
+   *
+   * @param first Итератор на первое ребро.
+   * @param last Итератор за последним ребром.
+   */
+  template<typename Iterator>
+  void AddEdges(Iterator first, Iterator last) {
+    for (; first != last; ++first) {
+      AddEdge(std::get<0>(*first), std::get<1>(*first), std::get<2>(*first));
+    }
+  }
+
+  /**
+   * @brief Построить взвешенный неориентированный граф.
+   *
+   * @param graph Граф, в который добавляются вершины и рёбра.
+   */
+  template<typename Storage>
+  void Build(WeightedGraph<Weight, Storage>* graph) {
+    this->template CheckIds<typename Storage::Id>();
+    this->NormalizeEdges();
+    this->SortEdges();
+    this->Fill(&graph->edges);
+    FillWeights(&graph->weights);
+    this->Clear();
+  }
+
+  /**
+   * @brief Построить взвешенный ориентированный граф.
+   *
+   * @param graph Граф, в который добавляются вершины и рёбра.
+   */
+  template<typename Storage>
+  void Build(WeightedOrientedGraph<Weight, Storage>* graph) {
+    this->template CheckIds<typename Storage::Id>();
+    this->SortEdges();
+    FillOriented(&graph->edges, &graph->incomingEdges);
+    this->Clear();
+  }
+
+ private:
+  /**
+   * @brief Заполнить словари исходящих рёбер с весами и входящих рёбер
+   *        ориентированного графа.
+   *
+   * @tparam WeightedAdjacencyMap Тип словаря исходящих рёбер.
+   * @tparam AdjacencyMap Тип словаря входящих рёбер.
+   *
+   * @param outgoing Словарь исходящих рёбер.
+   * @param incoming Словарь входящих рёбер.
+   */
+  template<typename WeightedAdjacencyMap, typename AdjacencyMap>
+  void FillOriented(WeightedAdjacencyMap* outgoing,
+                    AdjacencyMap* incoming) const {
+    std::vector<size_t> ids = this->SortedVertices();
+    std::vector<std::pair<size_t, std::pair<size_t, Weight>>> weighted;
+    std::vector<std::pair<size_t, size_t>> pairs;
+
+    weighted.reserve(this->edges.size());
+    pairs.reserve(this->edges.size());
+
+    // Рёбра уже отсортированы по началу.
+    for (const WeightedBuilderEdge<Weight>& edge : this->edges) {
+      weighted.emplace_back(edge.start,
+                            std::make_pair(edge.end, edge.weight));
+      pairs.emplace_back(edge.end, edge.start);
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+    this->AddAdjacency(ids, weighted, outgoing);
+    this->AddAdjacency(ids, pairs, incoming);
+  }
+
+  /**
+   * @brief Заполнить словарь весов графа.
+   *
+   * @tparam Weights Тип словаря весов.
+   *
+   * @param weights Словарь весов.
+   */
+  template<typename Weights>
+  void FillWeights(Weights* weights) const {
+    weights->reserve(weights->size() + this->edges.size());
+
+    for (const WeightedBuilderEdge<Weight>& edge : this->edges) {
+      (*weights)[std::make_pair(edge.start, edge.end)] = edge.weight;
+    }
+  }
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_GRAPH_BUILDER_HPP_
@@ -0,0 +1,450 @@
+/**
+ * @file graph_file.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Двоичный формат файла со снимком графа в формате CSR. Файл отображается
+ * в память только для чтения, и алгоритмы работают прямо с его страницами.
+ */
+
+#ifndef INCLUDE_GRAPH_FILE_HPP_
+#define INCLUDE_GRAPH_FILE_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <csr_graph.hpp>
+#include <iterators.hpp>
+#include <weighted_csr_graph.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace graph {
+
+/**
+ * @brief Заголовок файла с графом.
+ *
+ * За заголовком без промежутков идут массивы:
+ * - ids[numVertices] --- исходные номера вершин по возрастанию;
+ * - offsets[numVertices + 1] и targets[numEdges] --- граф в формате CSR
+ *   (@sa CsrGraph);
+ * - weights[numEdges] --- веса рёбер типа double, если установлен флаг
+ *   graphFileWeights;
+ * - offsets[numVertices + 1], targets[numEdges] и (при наличии весов)
+ *   weights[numEdges] графа с обращёнными рёбрами, если установлен флаг
+ *   graphFileReverse.
+ *
+ * Номера и смещения занимают 8 байт. Числа записаны в порядке байтов
+ * машины, на которой создан файл (little-endian на x86-64 и AArch64).
+ * На машине с другим порядком байтов не совпадёт номер версии, и файл
+ * будет отвергнут. Заголовок занимает 32 байта, поэтому все массивы
+ * выровнены на 8 байт.
+ */
+struct GraphFileHeader {
+  //! Сигнатура "GRAPHCSR".
+  char magic[8];
+  //! Версия формата.
+  uint32_t version;
+  //! Флаги graphFileWeights и graphFileReverse.
+  uint32_t flags;
+  //! Число вершин.
+  uint64_t numVertices;
+  //! Число рёбер.
+  uint64_t numEdges;
+};
+
+static_assert(sizeof(GraphFileHeader) == 32,
+              "GraphFileHeader must not contain padding");
+static_assert(sizeof(size_t) == sizeof(uint64_t),
+              "graph files are supported only on 64-bit platforms");
+
+//! Сигнатура в начале файла с графом.
+constexpr char graphFileMagic[8] = { 'G', 'R', 'A', 'P', 'H', 'C', 'S', 'R' };
+//! Текущая версия формата файла с графом.
+constexpr uint32_t graphFileVersion = 1;
+//! Флаг заголовка: в файле есть веса рёбер.
+constexpr uint32_t graphFileWeights = 1;
+//! Флаг заголовка: в файле есть граф с обращёнными рёбрами.
+constexpr uint32_t graphFileReverse = 2;
+
+/**
+ * @brief Записать массив в файл с графом.
+ *
+ * @tparam T Тип элементов.
+ *
+ * @param file Файл.
+ * @param elements Элементы массива.
+ */
+template<typename T>
+void WriteGraphFileArray(std::ofstream* file, Span<T> elements) {
+  file->write(reinterpret_cast<const char*>(elements.data()),
+              static_cast<std::streamsize>(elements.size() * sizeof(T)));
+}
+
+/**
+ * @brief Записать заголовок файла с графом.
+ *
+ * @param file Файл.
+ * @param graph Снимок графа.
+ * @param flags Флаги graphFileWeights и graphFileReverse.
+ */
+inline void WriteGraphFileHeader(std::ofstream* file, const CsrGraph& graph,
+                                 uint32_t flags) {
+  GraphFileHeader header;
+
+  std::memcpy(header.magic, graphFileMagic, sizeof(header.magic));
+  header.version = graphFileVersion;
+  header.flags = flags;
+  header.numVertices = graph.NumVertices();
+  header.numEdges = graph.NumEdges();
+
+  file->write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+/**
+ * @brief Записать снимок невзвешенного графа в файл.
+ *
+ * @param path Путь к файлу. Существующий файл перезаписывается.
+ * @param graph Снимок графа.
+ * @param reverse Записать ли в файл граф с обращёнными рёбрами. Он нужен
+ * поиску в ширину (@sa BreadthFirstSearch()).
+ *
+ * Если файл не удалось записать, то функция выбрасывает исключение
+ * std::runtime_error.
+ */
+inline void WriteGraphFile(const std::string& path, const CsrGraph& graph,
+                           bool reverse = true) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  CsrGraph transposed;
+
+  WriteGraphFileHeader(&file, graph, reverse ? graphFileReverse : 0);
+  WriteGraphFileArray(&file, graph.Ids());
+  WriteGraphFileArray(&file, graph.Offsets());
+  WriteGraphFileArray(&file, graph.Targets());
+
+  if (reverse) {
+    transposed.AssignTranspose(graph);
+    WriteGraphFileArray(&file, transposed.Offsets());
+    WriteGraphFileArray(&file, transposed.Targets());
+  }
+
+  file.close();
+
+  if (!file) {
+    throw std::runtime_error("cannot write graph file " + path);
+  }
+}
+
+/**
+ * @brief Записать снимок взвешенного графа в файл.
+ *
+ * @param path Путь к файлу. Существующий файл перезаписывается.
+ * @param graph Снимок графа.
+ * @param reverse Записать ли в файл граф с обращёнными рёбрами. Он нужен
+ * поиску в ширину и двустороннему алгоритму Дейкстры.
+ *
+ * Если файл не удалось записать, то функция выбрасывает исключение
+ * std::runtime_error.
+ */
+inline void WriteGraphFile(const std::string& path,
+                           const WeightedCsrGraph<double>& graph,
+                           bool reverse = true) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  WeightedCsrGraph<double> transposed;
+
+  WriteGraphFileHeader(&file, graph, graphFileWeights |
+                       (reverse ? graphFileReverse : 0));
+  WriteGraphFileArray(&file, graph.Ids());
+  WriteGraphFileArray(&file, graph.Offsets());
+  WriteGraphFileArray(&file, graph.Targets());
+  WriteGraphFileArray(&file, graph.Weights());
+
+  if (reverse) {
+    transposed.AssignTranspose(graph);
+    WriteGraphFileArray(&file, transposed.Offsets());
+    WriteGraphFileArray(&file, transposed.Targets());
+    WriteGraphFileArray(&file, transposed.Weights());
+  }
+
+  file.close();
+
+  if (!file) {
+    throw std::runtime_error("cannot write graph file " + path);
+  }
+}
+
+/**
+ * @brief Граф из файла, отображённого в память.
+ *
+ * Конструктор отображает файл в память только для чтения (mmap с флагом
+ * MAP_SHARED) и строит снимки поверх его страниц без копирования и
+ * разбора, поэтому время загрузки не зависит от размера графа. Страницы
+ * читаются с диска при первом обращении и хранятся в страничном кеше
+ * операционной системы, так что несколько процессов, отобразивших один
+ * файл, используют одну копию графа.
+ *
+ * Снимки Graph() и Reverse() можно копировать: копии хранят ссылку на
+ * отображение, и оно освобождается вместе с последней из них. Если файл
+ * записан без весов, то Weights() снимков пусты и их можно использовать
+ * только как graph::CsrGraph.
+ *
+ * На платформах без mmap файл целиком читается в память.
+ */
+class GraphFile {
+ public:
+  /**
+   * @brief Отобразить файл с графом в память.
+   *
+   * @param path Путь к файлу.
+   *
+   * Проверяются сигнатура, версия, флаги, размер файла и крайние значения
+   * массивов смещений. Содержимое массивов не проверяется
+   * (@sa Verify()). Если файл не удалось открыть или он некорректен, то
+   * конструктор выбрасывает исключение std::runtime_error.
+   */
+  explicit GraphFile(const std::string& path) {
+    size_t size = 0;
+    std::shared_ptr<const void> mapping = Map(path, &size);
+    const size_t* words = static_cast<const size_t*>(mapping.get());
+    GraphFileHeader header;
+
+    std::memcpy(&header, mapping.get(), sizeof(header));
+
+    if (std::memcmp(header.magic, graphFileMagic, sizeof(header.magic))) {
+      throw std::runtime_error(path + " is not a graph file");
+    }
+
+    if (header.version != graphFileVersion ||
+        (header.flags & ~(graphFileWeights | graphFileReverse))) {
+      throw std::runtime_error(path + ": unsupported graph file version");
+    }
+
+    flags = header.flags;
+
+    // Число вершин и рёбер не больше числа 8-байтовых слов файла, поэтому
+    // при вычислении ожидаемого размера переполнения не бывает.
+    size_t numWords = size / sizeof(size_t);
+    size_t numVertices = header.numVertices;
+    size_t numEdges = header.numEdges;
+
+    if (numVertices >= numWords || numEdges >= numWords) {
+      throw std::runtime_error(path + ": graph file is truncated");
+    }
+
+    size_t edgeArrays = HasWeights() ? 2 : 1;
+    size_t sections = HasReverse() ? 2 : 1;
+    size_t expectedWords = sizeof(header) / sizeof(size_t) + numVertices +
+        sections * (numVertices + 1 + edgeArrays * numEdges);
+
+    if (size != expectedWords * sizeof(size_t)) {
+      throw std::runtime_error(path + ": graph file is truncated");
+    }
+
+    const size_t* position = words + sizeof(header) / sizeof(size_t);
+    Span<size_t> ids(position, position + numVertices);
+
+    position += numVertices;
+    position = AssignSection(mapping, ids, position, numEdges, &graph);
+
+    if (HasReverse()) {
+      AssignSection(mapping, ids, position, numEdges, &reverse);
+    }
+
+    if (graph.Offsets()[0] != 0 || graph.Offsets()[numVertices] != numEdges ||
+        reverse.Offsets()[0] != 0 ||
+        reverse.Offsets()[reverse.NumVertices()] != reverse.NumEdges()) {
+      throw std::runtime_error(path + ": graph file is corrupted");
+    }
+  }
+
+  /**
+   * @brief Функция возвращает true, если в файле есть веса рёбер.
+   */
+  bool HasWeights() const {
+    return flags & graphFileWeights;
+  }
+
+  /**
+   * @brief Функция возвращает true, если в файле есть граф с обращёнными
+   * рёбрами.
+   */
+  bool HasReverse() const {
+    return flags & graphFileReverse;
+  }
+
+  /**
+   * @brief Снимок графа.
+   */
+  const WeightedCsrGraph<double>& Graph() const {
+    return graph;
+  }
+
+  /**
+   * @brief Снимок графа с обращёнными рёбрами. Если его нет в файле, то
+   * снимок пуст.
+   */
+  const WeightedCsrGraph<double>& Reverse() const {
+    return reverse;
+  }
+
+  /**
+   * @brief Полная проверка содержимого файла.
+   *
+   * Функция проверяет, что номера вершин возрастают, смещения не убывают,
+   * а концы рёбер --- внутренние номера вершин. Проверка читает весь файл,
+   * поэтому конструктор её не выполняет.
+   */
+  bool Verify() const {
+    Span<size_t> ids = graph.Ids();
+
+    for (size_t index = 1; index < ids.size(); index++) {
+      if (!(ids[index - 1] < ids[index])) {
+        return false;
+      }
+    }
+
+    return VerifySection(graph) && VerifySection(reverse);
+  }
+
+ private:
+  /**
+   * @brief Отобразить файл в память.
+   *
+   * @param path Путь к файлу.
+   * @param size Указатель, по которому записывается размер файла.
+   *
+   * @return Функция возвращает владельца памяти файла. Память освобождается
+   * вместе с последней копией указателя.
+   */
+  static std::shared_ptr<const void> Map(const std::string& path,
+                                         size_t* size) {
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat status;
+
+    if (fd < 0) {
+      throw std::runtime_error("cannot open graph file " + path);
+    }
+
+    if (fstat(fd, &status) != 0) {
+      close(fd);
+      throw std::runtime_error("cannot open graph file " + path);
+    }
+
+    *size = static_cast<size_t>(status.st_size);
+
+    if (*size < sizeof(GraphFileHeader)) {
+      close(fd);
+      throw std::runtime_error(path + " is not a graph file");
+    }
+
+    void* address = mmap(nullptr, *size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // Отображение остаётся корректным и после закрытия дескриптора.
+    close(fd);
+
+    if (address == MAP_FAILED) {
+      throw std::runtime_error("cannot map graph file " + path);
+    }
+
+    size_t length = *size;
+
+    return std::shared_ptr<const void>(address, [length](void* pointer) {
+      munmap(pointer, length);
+    });
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+    if (!file) {
+      throw std::runtime_error("cannot open graph file " + path);
+    }
+
+    *size = static_cast<size_t>(file.tellg());
+
+    if (*size < sizeof(GraphFileHeader)) {
+      throw std::runtime_error(path + " is not a graph file");
+    }
+
+    // Буфер из 8-байтовых слов выровнен так же, как отображение.
+    std::shared_ptr<uint64_t> buffer(new uint64_t[*size / 8 + 1],
+                                     std::default_delete<uint64_t[]>());
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(buffer.get()),
+              static_cast<std::streamsize>(*size));
+
+    if (!file) {
+      throw std::runtime_error("cannot read graph file " + path);
+    }
+
+    return buffer;
+#endif
+  }
+
+  /**
+   * @brief Построить снимок поверх раздела файла.
+   *
+   * @param mapping Владелец памяти файла.
+   * @param ids Исходные номера вершин.
+   * @param position Начало раздела: массива смещений.
+   * @param numEdges Число рёбер.
+   * @param snapshot Снимок, который строится поверх раздела.
+   *
+   * @return Функция возвращает указатель на конец раздела.
+   */
+  const size_t* AssignSection(const std::shared_ptr<const void>& mapping,
+                              Span<size_t> ids, const size_t* position,
+                              size_t numEdges,
+                              WeightedCsrGraph<double>* snapshot) const {
+    Span<size_t> offsets(position, position + ids.size() + 1);
+    Span<size_t> targets(offsets.end(), offsets.end() + numEdges);
+    const double* weights = reinterpret_cast<const double*>(targets.end());
+    size_t numWeights = HasWeights() ? numEdges : 0;
+
+    snapshot->AssignView(mapping, ids, offsets, targets,
+                         Span<double>(weights, weights + numWeights));
+
+    return targets.end() + numWeights;
+  }
+
+  /**
+   * @brief Проверить смещения и концы рёбер снимка.
+   *
+   * @param snapshot Снимок.
+   */
+  static bool VerifySection(const WeightedCsrGraph<double>& snapshot) {
+    Span<size_t> offsets = snapshot.Offsets();
+
+    for (size_t index = 0; index < snapshot.NumVertices(); index++) {
+      if (offsets[index + 1] < offsets[index]) {
+        return false;
+      }
+    }
+
+    for (size_t target : snapshot.Targets()) {
+      if (target >= snapshot.NumVertices()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  //! Снимок графа.
+  WeightedCsrGraph<double> graph;
+  //! Снимок графа с обращёнными рёбрами.
+  WeightedCsrGraph<double> reverse;
+  //! Флаги заголовка файла.
+  uint32_t flags;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_GRAPH_FILE_HPP_
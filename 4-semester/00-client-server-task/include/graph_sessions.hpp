@@ -0,0 +1,630 @@
+/**
+ * @file graph_sessions.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Именованные графы, которые хранятся на сервере между запросами.
+ */
+
+#ifndef INCLUDE_GRAPH_SESSIONS_HPP_
+#define INCLUDE_GRAPH_SESSIONS_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <csr_graph.hpp>
+#include <oriented_graph.hpp>
+
+namespace graph {
+
+/**
+ * @brief Пакет изменений графа сессии.
+ *
+ * Изменения применяются в порядке: удаление рёбер, удаление вершин,
+ * добавление вершин, добавление рёбер.
+ */
+struct GraphDelta {
+  //! Добавляемые вершины.
+  std::vector<size_t> addVertices;
+  //! Удаляемые вершины (вместе со всеми их рёбрами).
+  std::vector<size_t> removeVertices;
+  //! Добавляемые рёбра (начало, конец).
+  std::vector<std::pair<size_t, size_t>> addEdges;
+  //! Удаляемые рёбра (начало, конец).
+  std::vector<std::pair<size_t, size_t>> removeEdges;
+};
+
+/**
+ * @brief Производные структуры графа сессии.
+ *
+ * Снимок неизменяем: после изменения графа сессия строит новый снимок,
+ * а запросы, которые уже получили старый, дорабатывают с ним.
+ */
+struct GraphSnapshot {
+  //! Граф в формате CSR.
+  CsrGraph graph;
+  //! Тот же граф с обращёнными рёбрами.
+  CsrGraph reverse;
+};
+
+/**
+ * @brief Граф сессии.
+ *
+ * Граф можно читать из нескольких потоков одновременно, изменения
+ * выполняются под исключительной блокировкой. Концы всех рёбер всегда
+ * являются вершинами графа.
+ *
+ * Снимок GraphSnapshot строится при первом обращении и переиспользуется
+ * запросами, пока граф не изменится.
+ */
+class GraphSession {
+ public:
+  /**
+   * @brief Конструктор класса GraphSession.
+   *
+   * @param name Имя сессии.
+   * @param graph Исходный граф. Концы всех рёбер должны быть вершинами
+   * графа (@sa GraphBuilder::AddVertex()).
+   */
+  GraphSession(std::string name, OrientedGraph&& graph) :
+    name(std::move(name)),
+    graph(std::move(graph)),
+    numEdges(0),
+    version(0) {
+    for (size_t id : this->graph.Vertices()) {
+      numEdges += this->graph.Edges(id).size();
+    }
+
+    UpdateBytes();
+  }
+
+  GraphSession(const GraphSession&) = delete;
+  GraphSession& operator=(const GraphSession&) = delete;
+
+  /**
+   * @brief Функция возвращает имя сессии.
+   */
+  const std::string& Name() const {
+    return name;
+  }
+
+  /**
+   * @brief Применить пакет изменений.
+   *
+   * @param delta Изменения графа. Удаление отсутствующих вершин и рёбер
+   * ничего не делает, концы добавляемых рёбер добавляются как вершины.
+   *
+   * Функция увеличивает номер версии графа и сбрасывает снимок.
+   */
+  void Apply(const GraphDelta& delta) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    ApplyLocked(delta);
+  }
+
+  /**
+   * @brief Применить пакет изменений, если граф после него поместится
+   *        в ограничение памяти.
+   *
+   * @param delta Изменения графа (@sa Apply()).
+   * @param maxBytes Ограничение оценки памяти графа без снимка.
+   *
+   * @return Функция возвращает false и не меняет граф, если оценка памяти
+   * после изменений больше maxBytes.
+   *
+   * Оценка считается до изменения графа: к текущему графу прибавляются
+   * новые вершины и рёбра, а удаления не учитываются, поэтому оценка
+   * не меньше памяти графа после изменений.
+   */
+  bool Apply(const GraphDelta& delta, size_t maxBytes) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    if (BytesAfter(delta) > maxBytes) {
+      return false;
+    }
+
+    ApplyLocked(delta);
+
+    return true;
+  }
+
+  /**
+   * @brief Удалить снимок графа.
+   *
+   * Запросы, которые уже получили снимок, дорабатывают с ним, а следующий
+   * вызов Snapshot() строит его заново.
+   */
+  void DropSnapshot() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    snapshot.reset();
+    UpdateBytes();
+  }
+
+  /**
+   * @brief Выполнить функцию, читающую граф.
+   *
+   * @tparam Function Тип функции с аргументом const OrientedGraph&.
+   * @param function Функция. Пока она выполняется, граф не меняется.
+   *
+   * @return Функция возвращает результат function.
+   */
+  template<typename Function>
+  decltype(auto) Read(Function function) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    return function(graph);
+  }
+
+  /**
+   * @brief Функция возвращает снимок текущей версии графа.
+   *
+   * Если снимка ещё нет, то он строится за O(|V| log |V| + |E|). Готовый
+   * снимок возвращается под разделяемой блокировкой, поэтому запросы
+   * к неизменному графу не ждут друг друга.
+   */
+  std::shared_ptr<const GraphSnapshot> Snapshot() {
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex);
+
+      if (snapshot) {
+        return snapshot;
+      }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    // Пока блокировка не была взята, снимок мог построить другой поток.
+    if (!snapshot) {
+      std::shared_ptr<GraphSnapshot> result =
+          std::make_shared<GraphSnapshot>();
+
+      result->graph.Assign(graph);
+      result->reverse.AssignTranspose(result->graph);
+      snapshot = std::move(result);
+      UpdateBytes();
+    }
+
+    return snapshot;
+  }
+
+  /**
+   * @brief Функция возвращает количество вершин в графе.
+   */
+  size_t NumVertices() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    return graph.NumVertices();
+  }
+
+  /**
+   * @brief Функция возвращает количество рёбер в графе.
+   */
+  size_t NumEdges() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    return numEdges;
+  }
+
+  /**
+   * @brief Функция возвращает номер версии графа (число применённых
+   *        пакетов изменений).
+   */
+  size_t Version() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    return version;
+  }
+
+  /**
+   * @brief Функция возвращает оценку памяти, занятой графом и снимком,
+   *        в байтах.
+   */
+  size_t Bytes() const {
+    return bytes;
+  }
+
+ private:
+  //! Оценка памяти на вершину графа: по элементу со встроенным буфером
+  //! множества соседей в словарях исходящих и входящих рёбер.
+  static constexpr size_t vertexBytes = 240;
+  //! Оценка памяти на ребро графа сверху: по элементу в двух
+  //! хеш-множествах вершин большой степени.
+  static constexpr size_t edgeBytes = 80;
+  //! Память на вершину снимка: ids и offsets в прямом и обратном графе.
+  static constexpr size_t snapshotVertexBytes = 32;
+  //! Память на ребро снимка: targets в прямом и обратном графе.
+  static constexpr size_t snapshotEdgeBytes = 16;
+  //! Память на саму сессию.
+  static constexpr size_t sessionBytes = 1024;
+
+  /**
+   * @brief Применить пакет изменений под исключительной блокировкой.
+   */
+  void ApplyLocked(const GraphDelta& delta) {
+    for (const std::pair<size_t, size_t>& edge : delta.removeEdges) {
+      if (graph.HasEdge(edge.first, edge.second)) {
+        graph.RemoveEdge(edge.first, edge.second);
+        numEdges--;
+      }
+    }
+
+    for (size_t id : delta.removeVertices) {
+      if (graph.HasVertex(id)) {
+        numEdges -= graph.Edges(id).size() + graph.IncomingEdges(id).size() -
+                    (graph.HasEdge(id, id) ? 1 : 0);
+        graph.RemoveVertex(id);
+      }
+    }
+
+    for (size_t id : delta.addVertices) {
+      graph.AddVertex(id);
+    }
+
+    for (const std::pair<size_t, size_t>& edge : delta.addEdges) {
+      if (!graph.HasEdge(edge.first, edge.second)) {
+        graph.AddVertex(edge.first);
+        graph.AddVertex(edge.second);
+        graph.AddEdge(edge.first, edge.second);
+        numEdges++;
+      }
+    }
+
+    snapshot.reset();
+    version++;
+    UpdateBytes();
+  }
+
+  /**
+   * @brief Оценка памяти графа без снимка.
+   *
+   * @param numVertices Число вершин.
+   * @param numEdges Число рёбер.
+   */
+  size_t GraphBytes(size_t numVertices, size_t numEdges) const {
+    return sessionBytes + name.size() + numVertices * vertexBytes +
+           numEdges * edgeBytes;
+  }
+
+  /**
+   * @brief Оценка памяти графа без снимка после пакета изменений сверху.
+   *
+   * Функция вызывается под блокировкой графа.
+   */
+  size_t BytesAfter(const GraphDelta& delta) const {
+    std::unordered_set<size_t> newVertices;
+    std::vector<std::pair<size_t, size_t>> newEdges;
+
+    for (size_t id : delta.addVertices) {
+      if (!graph.HasVertex(id)) {
+        newVertices.insert(id);
+      }
+    }
+
+    for (const std::pair<size_t, size_t>& edge : delta.addEdges) {
+      if (!graph.HasEdge(edge.first, edge.second)) {
+        newEdges.push_back(edge);
+      }
+
+      for (size_t id : { edge.first, edge.second }) {
+        if (!graph.HasVertex(id)) {
+          newVertices.insert(id);
+        }
+      }
+    }
+
+    std::sort(newEdges.begin(), newEdges.end());
+    newEdges.erase(std::unique(newEdges.begin(), newEdges.end()),
+                   newEdges.end());
+
+    return GraphBytes(graph.NumVertices() + newVertices.size(),
+                      numEdges + newEdges.size());
+  }
+
+  /**
+   * @brief Пересчитать оценку памяти.
+   */
+  void UpdateBytes() {
+    size_t result = GraphBytes(graph.NumVertices(), numEdges);
+
+    if (snapshot) {
+      result += snapshot->graph.NumVertices() * snapshotVertexBytes +
+                snapshot->graph.NumEdges() * snapshotEdgeBytes;
+    }
+
+    bytes = result;
+  }
+
+  //! Имя сессии.
+  const std::string name;
+
+  //! Блокировка графа и снимка.
+  mutable std::shared_mutex mutex;
+
+  //! Граф.
+  OrientedGraph graph;
+
+  //! Число рёбер графа.
+  size_t numEdges;
+
+  //! Номер версии графа.
+  size_t version;
+
+  //! Снимок текущей версии графа или нулевой указатель.
+  std::shared_ptr<const GraphSnapshot> snapshot;
+
+  //! Оценка занятой памяти.
+  std::atomic<size_t> bytes;
+};
+
+/**
+ * @brief Хранилище сессий с вытеснением давно не использованных.
+ *
+ * Сессии упорядочены по времени последнего обращения (LRU). Когда
+ * суммарная оценка памяти превышает maxBytes, вытесняются самые старые
+ * сессии. Сессия, к которой не обращались дольше ttl, считается
+ * истёкшей и удаляется при следующем обращении к хранилищу.
+ *
+ * Функции возвращают std::shared_ptr, поэтому вытесненная сессия
+ * остаётся доступной запросам, которые уже с ней работают, и
+ * освобождается после их завершения.
+ */
+class GraphSessionStore {
+ public:
+  //! Часы для отсчёта времени жизни сессий.
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Конструктор класса GraphSessionStore.
+   *
+   * @param maxBytes Ограничение суммарной оценки памяти сессий.
+   * @param ttl Время жизни сессии без обращений. Нулевое значение снимает
+   * ограничение.
+   */
+  GraphSessionStore(size_t maxBytes, Clock::duration ttl) :
+    maxBytes(maxBytes),
+    ttl(ttl),
+    bytes(0) {
+  }
+
+  GraphSessionStore(const GraphSessionStore&) = delete;
+  GraphSessionStore& operator=(const GraphSessionStore&) = delete;
+
+  /**
+   * @brief Изменить ограничения хранилища.
+   *
+   * @param maxBytes Ограничение суммарной оценки памяти сессий.
+   * @param ttl Время жизни сессии без обращений.
+   *
+   * Лишние сессии вытесняются сразу.
+   */
+  void SetLimits(size_t maxBytes, Clock::duration ttl) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    this->maxBytes = maxBytes;
+    this->ttl = ttl;
+    Evict(Clock::now());
+  }
+
+  /**
+   * @brief Создать сессию.
+   *
+   * @param name Имя сессии. Сессия с тем же именем заменяется.
+   * @param graph Граф сессии (@sa GraphSession::GraphSession()).
+   *
+   * @return Функция возвращает созданную сессию или нулевой указатель,
+   * если граф один превышает ограничение памяти. В этом случае сессия
+   * с тем же именем остаётся в хранилище.
+   */
+  std::shared_ptr<GraphSession> Create(const std::string& name,
+                                       OrientedGraph&& graph) {
+    std::shared_ptr<GraphSession> session =
+        std::make_shared<GraphSession>(name, std::move(graph));
+    std::lock_guard<std::mutex> lock(mutex);
+    Clock::time_point now = Clock::now();
+
+    if (session->Bytes() > maxBytes) {
+      return nullptr;
+    }
+
+    Erase(name);
+    entries.push_front(Entry{session, session->Bytes(), now});
+    index[name] = entries.begin();
+    bytes += session->Bytes();
+    Evict(now);
+
+    return session;
+  }
+
+  /**
+   * @brief Найти сессию и отметить обращение к ней.
+   *
+   * @param name Имя сессии.
+   *
+   * @return Функция возвращает сессию или нулевой указатель, если сессии
+   * нет или она истекла.
+   */
+  std::shared_ptr<GraphSession> Find(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Clock::time_point now = Clock::now();
+
+    Evict(now);
+
+    auto it = index.find(name);
+
+    if (it == index.end()) {
+      return nullptr;
+    }
+
+    Touch(it->second, now);
+
+    return it->second->session;
+  }
+
+  /**
+   * @brief Учесть изменение памяти, занятой сессией.
+   *
+   * @param session Сессия, которая была изменена или построила снимок.
+   *
+   * @return Функция возвращает false, если сессии уже нет в хранилище.
+   * Иначе вытесняются другие сессии, и функция возвращает true.
+   *
+   * Если сессия со снимком превышает ограничение памяти, то снимок
+   * удаляется (@sa GraphSession::DropSnapshot()), а сессия остаётся.
+   * Граф без снимка помещается в ограничение: это проверяют Create() и
+   * GraphSession::Apply(). Только если ограничение уменьшилось после
+   * проверки, сессия удаляется, и функция возвращает false.
+   */
+  bool Account(const std::shared_ptr<GraphSession>& session) {
+    if (session->Bytes() > MaxBytes()) {
+      session->DropSnapshot();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Clock::time_point now = Clock::now();
+    auto it = index.find(session->Name());
+
+    if (it == index.end() || it->second->session != session) {
+      return false;
+    }
+
+    Entry& entry = *it->second;
+
+    bytes -= entry.bytes;
+    entry.bytes = session->Bytes();
+    bytes += entry.bytes;
+
+    if (entry.bytes > maxBytes) {
+      Erase(session->Name());
+      return false;
+    }
+
+    Touch(it->second, now);
+    Evict(now);
+
+    return true;
+  }
+
+  /**
+   * @brief Удалить сессию.
+   *
+   * @param name Имя сессии.
+   *
+   * @return Функция возвращает true, если сессия была в хранилище.
+   */
+  bool Remove(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return Erase(name);
+  }
+
+  /**
+   * @brief Функция возвращает ограничение суммарной оценки памяти сессий.
+   */
+  size_t MaxBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return maxBytes;
+  }
+
+  /**
+   * @brief Функция возвращает количество сессий.
+   */
+  size_t NumSessions() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return entries.size();
+  }
+
+  /**
+   * @brief Функция возвращает суммарную оценку памяти сессий в байтах.
+   */
+  size_t Bytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return bytes;
+  }
+
+ private:
+  /**
+   * @brief Сессия в списке LRU.
+   */
+  struct Entry {
+    //! Сессия.
+    std::shared_ptr<GraphSession> session;
+    //! Учтённая оценка памяти сессии.
+    size_t bytes;
+    //! Время последнего обращения.
+    Clock::time_point lastUse;
+  };
+
+  /**
+   * @brief Переместить сессию в начало списка.
+   */
+  void Touch(std::list<Entry>::iterator it, Clock::time_point now) {
+    it->lastUse = now;
+    entries.splice(entries.begin(), entries, it);
+  }
+
+  /**
+   * @brief Удалить истёкшие сессии, а затем самые старые, пока память
+   *        превышает ограничение.
+   */
+  void Evict(Clock::time_point now) {
+    while (!entries.empty() &&
+           ((ttl != Clock::duration::zero() &&
+             now - entries.back().lastUse > ttl) || bytes > maxBytes)) {
+      Erase(entries.back().session->Name());
+    }
+  }
+
+  /**
+   * @brief Удалить сессию по имени.
+   *
+   * @return Функция возвращает true, если сессия была в хранилище.
+   */
+  bool Erase(const std::string& name) {
+    auto it = index.find(name);
+
+    if (it == index.end()) {
+      return false;
+    }
+
+    bytes -= it->second->bytes;
+    entries.erase(it->second);
+    index.erase(it);
+
+    return true;
+  }
+
+  //! Блокировка списка и словаря.
+  mutable std::mutex mutex;
+
+  //! Ограничение суммарной оценки памяти.
+  size_t maxBytes;
+
+  //! Время жизни сессии без обращений.
+  Clock::duration ttl;
+
+  //! Суммарная оценка памяти.
+  size_t bytes;
+
+  //! Сессии от недавно использованных к давно не использованным.
+  std::list<Entry> entries;
+
+  //! Положение сессий в списке по именам.
+  std::unordered_map<std::string, std::list<Entry>::iterator> index;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_GRAPH_SESSIONS_HPP_
@@ -0,0 +1,1752 @@
+/**
+ * @file graph_storage.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Политики хранения списков смежности для классов графов.
+ */
+
+#ifndef INCLUDE_GRAPH_STORAGE_HPP_
+#define INCLUDE_GRAPH_STORAGE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Проверить, что номер вершины помещается в тип Id.
+ *
+ * @tparam Id Тип, в котором хранятся номера вершин.
+ *
+ * @param id Номер вершины.
+ */
+template<typename Id>
+constexpr bool FitsId(size_t id) {
+  return id <= std::numeric_limits<Id>::max();
+}
+
+/**
+ * @brief Преобразовать номер вершины к типу Id.
+ *
+ * @tparam Id Тип, в котором хранятся номера вершин.
+ *
+ * @param id Номер вершины. Если он не помещается в тип Id, то функция
+ * выбрасывает исключение std::out_of_range.
+ */
+template<typename Id>
+Id NarrowId(size_t id) {
+  if (!FitsId<Id>(id)) {
+    throw std::out_of_range("vertex id does not fit into the id type");
+  }
+
+  return static_cast<Id>(id);
+}
+
+/**
+ * @brief Словарь с целочисленными ключами на открытой адресации (Robin Hood).
+ *
+ * @tparam Value Тип значения. Должен иметь конструктор по умолчанию.
+ * @tparam Key Тип, в котором хранятся ключи. Функции принимают ключи
+ * типа size_t: ключа, который не помещается в Key, в словаре нет, а его
+ * добавление выбрасывает исключение std::out_of_range.
+ *
+ * Элементы хранятся прямо в массиве ячеек, число ячеек --- степень двойки,
+ * заполнено не больше 7/8 ячеек. Для каждой ячейки хранится расстояние от
+ * её позиции до позиции, в которую ключ попадает по хешу (0 --- пустая
+ * ячейка). При вставке элемент с меньшим расстоянием уступает место
+ * элементу с большим (Celis, 1986), поэтому поиск отсутствующего ключа
+ * останавливается, как только расстояние в ячейке стало меньше текущего.
+ * При удалении следующие элементы сдвигаются назад, и пустых меток
+ * (tombstones) не остаётся.
+ *
+ * Интерфейс повторяет нужную графам часть std::unordered_map. Итераторы
+ * и ссылки на элементы становятся некорректными после любой вставки
+ * или удаления.
+ */
+template<typename Value, typename Key = size_t>
+class FlatMap {
+ public:
+  //! Тип элемента: пара (ключ, значение).
+  using value_type = std::pair<Key, Value>;
+
+ private:
+  /**
+   * @brief Итератор по заполненным ячейкам.
+   *
+   * @tparam isConst Итератор только для чтения.
+   */
+  template<bool isConst>
+  class Iterator {
+   public:
+    //! Тип указателя на словарь.
+    using MapPointer = std::conditional_t<isConst, const FlatMap*, FlatMap*>;
+    //! Тип ссылки на элемент.
+    using Reference = std::conditional_t<isConst, const value_type&,
+                                         value_type&>;
+
+    /**
+     * @brief Конструктор итератора.
+     * @param map Словарь.
+     * @param index Номер ячейки (заполненной или равной числу ячеек).
+     */
+    Iterator(MapPointer map, size_t index) :
+      map(map),
+      index(index) {
+    }
+
+    /**
+     * @brief Преобразование итератора в итератор только для чтения.
+     * @param other Исходный итератор.
+     */
+    template<bool otherIsConst,
+             typename = std::enable_if_t<isConst && !otherIsConst>>
+    Iterator(const Iterator<otherIsConst>& other) :
+      map(other.map),
+      index(other.index) {
+    }
+
+    /**
+     * @brief Оператор сравнения == для итератора.
+     * @param other Другой итератор.
+     */
+    bool operator==(const Iterator& other) const {
+      return index == other.index;
+    }
+
+    /**
+     * @brief Оператор сравнения != для итератора.
+     * @param other Другой итератор.
+     */
+    bool operator!=(const Iterator& other) const {
+      return index != other.index;
+    }
+
+    /**
+     * @brief Префиксная операция инкремента для итератора.
+     */
+    Iterator& operator++() {
+      index = map->Next(index + 1);
+      return *this;
+    }
+
+    /**
+     * @brief Постфиксная операция инкремента для итератора.
+     */
+    Iterator operator++(int) {
+      Iterator retval(*this);
+      ++*this;
+      return retval;
+    }
+
+    /**
+     * @brief Функция возвращает элемент, на который указывает итератор.
+     */
+    Reference operator*() const {
+      return map->slots[index];
+    }
+
+    /**
+     * @brief Доступ к полям элемента.
+     */
+    auto operator->() const {
+      return &map->slots[index];
+    }
+
+   private:
+    template<bool> friend class Iterator;
+
+    //! Словарь.
+    MapPointer map;
+    //! Номер ячейки.
+    size_t index;
+  };
+
+ public:
+  //! Итератор.
+  using iterator = Iterator<false>;
+  //! Итератор только для чтения.
+  using const_iterator = Iterator<true>;
+
+  /**
+   * @brief Конструктор пустого словаря.
+   */
+  FlatMap() :
+    numElements(0),
+    shift(64) {
+  }
+
+  FlatMap(const FlatMap&) = default;
+  FlatMap& operator=(const FlatMap&) = default;
+
+  /**
+   * @brief Конструктор перемещения. Исходный словарь становится пустым.
+   */
+  FlatMap(FlatMap&& other) noexcept :
+    slots(std::move(other.slots)),
+    distances(std::move(other.distances)),
+    numElements(std::exchange(other.numElements, 0)),
+    shift(std::exchange(other.shift, 64)) {
+    other.slots.clear();
+    other.distances.clear();
+  }
+
+  /**
+   * @brief Оператор перемещения. Исходный словарь становится пустым.
+   */
+  FlatMap& operator=(FlatMap&& other) noexcept {
+    slots = std::move(other.slots);
+    distances = std::move(other.distances);
+    numElements = std::exchange(other.numElements, 0);
+    shift = std::exchange(other.shift, 64);
+    other.slots.clear();
+    other.distances.clear();
+
+    return *this;
+  }
+
+  /**
+   * @brief Найти элемент по ключу.
+   *
+   * @param key Ключ.
+   * @return Итератор на элемент или end(), если ключа нет.
+   */
+  iterator find(size_t key) {
+    return iterator(this, Find(key));
+  }
+
+  /**
+   * @brief Найти элемент по ключу.
+   *
+   * @param key Ключ.
+   * @return Итератор на элемент или end(), если ключа нет.
+   */
+  const_iterator find(size_t key) const {
+    return const_iterator(this, Find(key));
+  }
+
+  /**
+   * @brief Функция возвращает 1, если ключ есть в словаре, и 0 иначе.
+   *
+   * @param key Ключ.
+   */
+  size_t count(size_t key) const {
+    return Find(key) != slots.size() ? 1 : 0;
+  }
+
+  /**
+   * @brief Доступ к значению по ключу с добавлением.
+   *
+   * @param key Ключ. Если его нет, то добавляется значение по умолчанию.
+   */
+  Value& operator[](size_t key) {
+    size_t index = Find(key);
+
+    if (index != slots.size()) {
+      return slots[index].second;
+    }
+
+    return slots[Insert(key)].second;
+  }
+
+  /**
+   * @brief Доступ к значению по ключу.
+   *
+   * @param key Ключ. Если его нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  Value& at(size_t key) {
+    size_t index = Find(key);
+
+    if (index == slots.size()) {
+      throw std::out_of_range("FlatMap::at(): key not found");
+    }
+
+    return slots[index].second;
+  }
+
+  /**
+   * @brief Доступ к значению по ключу.
+   *
+   * @param key Ключ. Если его нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  const Value& at(size_t key) const {
+    size_t index = Find(key);
+
+    if (index == slots.size()) {
+      throw std::out_of_range("FlatMap::at(): key not found");
+    }
+
+    return slots[index].second;
+  }
+
+  /**
+   * @brief Удалить элемент по ключу.
+   *
+   * @param key Ключ.
+   * @return Функция возвращает число удалённых элементов (0 или 1).
+   */
+  size_t erase(size_t key) {
+    size_t index = Find(key);
+
+    if (index == slots.size()) {
+      return 0;
+    }
+
+    size_t mask = slots.size() - 1;
+    size_t next = (index + 1) & mask;
+
+    // Сдвиг назад: элементы, стоящие не на своих позициях, подвигаются
+    // на освободившуюся ячейку.
+    while (distances[next] > 1) {
+      slots[index] = std::move(slots[next]);
+      distances[index] = distances[next] - 1;
+      index = next;
+      next = (next + 1) & mask;
+    }
+
+    slots[index] = value_type();
+    distances[index] = 0;
+    numElements--;
+
+    return 1;
+  }
+
+  /**
+   * @brief Зарезервировать место для элементов.
+   *
+   * @param count Ожидаемое число элементов.
+   */
+  void reserve(size_t count) {
+    size_t capacity = std::max<size_t>(slots.size(), minCapacity);
+
+    while (count * 8 > capacity * 7) {
+      capacity *= 2;
+    }
+
+    if (capacity != slots.size()) {
+      Rehash(capacity);
+    }
+  }
+
+  /**
+   * @brief Удалить все элементы и освободить память.
+   */
+  void clear() {
+    slots.clear();
+    distances.clear();
+    numElements = 0;
+    shift = 64;
+  }
+
+  /**
+   * @brief Функция возвращает количество элементов.
+   */
+  size_t size() const {
+    return numElements;
+  }
+
+  /**
+   * @brief Функция возвращает true, если словарь пуст.
+   */
+  bool empty() const {
+    return numElements == 0;
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент.
+   */
+  iterator begin() {
+    return iterator(this, Next(0));
+  }
+
+  /**
+   * @brief Возвращает итератор на элемент "после последнего".
+   */
+  iterator end() {
+    return iterator(this, slots.size());
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент.
+   */
+  const_iterator begin() const {
+    return const_iterator(this, Next(0));
+  }
+
+  /**
+   * @brief Возвращает итератор на элемент "после последнего".
+   */
+  const_iterator end() const {
+    return const_iterator(this, slots.size());
+  }
+
+ private:
+  //! Минимальное число ячеек.
+  static constexpr size_t minCapacity = 8;
+
+  /**
+   * @brief Позиция ключа по хешу (хеширование Фибоначчи).
+   */
+  size_t Home(size_t key) const {
+    return static_cast<size_t>(
+        (static_cast<uint64_t>(key) * 11400714819323198485ULL) >> shift);
+  }
+
+  /**
+   * @brief Номер ячейки с ключом или число ячеек, если ключа нет.
+   */
+  size_t Find(size_t key) const {
+    if (numElements == 0 || !FitsId<Key>(key)) {
+      return slots.size();
+    }
+
+    size_t mask = slots.size() - 1;
+    size_t index = Home(key);
+
+    for (uint32_t distance = 1; distances[index] >= distance; distance++) {
+      if (slots[index].first == key) {
+        return index;
+      }
+
+      index = (index + 1) & mask;
+    }
+
+    return slots.size();
+  }
+
+  /**
+   * @brief Первая заполненная ячейка, начиная с index.
+   */
+  size_t Next(size_t index) const {
+    while (index < slots.size() && distances[index] == 0) {
+      index++;
+    }
+
+    return index;
+  }
+
+  /**
+   * @brief Вставить отсутствующий ключ со значением по умолчанию.
+   *
+   * @return Номер ячейки с новым элементом.
+   */
+  size_t Insert(size_t key) {
+    value_type element(NarrowId<Key>(key), Value());
+
+    if ((numElements + 1) * 8 > slots.size() * 7) {
+      Rehash(std::max(minCapacity, 2 * slots.size()));
+    }
+
+    return Place(std::move(element));
+  }
+
+  /**
+   * @brief Положить элемент в таблицу, в которой есть свободная ячейка.
+   *
+   * @return Номер ячейки с элементом.
+   */
+  size_t Place(value_type&& element) {
+    size_t mask = slots.size() - 1;
+    size_t index = Home(element.first);
+    size_t result = slots.size();
+    uint32_t distance = 1;
+
+    numElements++;
+
+    for (;; index = (index + 1) & mask, distance++) {
+      if (distances[index] == 0) {
+        slots[index] = std::move(element);
+        distances[index] = distance;
+
+        return result == slots.size() ? index : result;
+      }
+
+      // Элемент, который дальше от своей позиции, забирает ячейку.
+      if (distances[index] < distance) {
+        std::swap(element, slots[index]);
+        std::swap(distance, distances[index]);
+
+        if (result == slots.size()) {
+          result = index;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Перестроить таблицу с новым числом ячеек.
+   *
+   * @param capacity Число ячеек (степень двойки).
+   */
+  void Rehash(size_t capacity) {
+    std::vector<value_type> oldSlots =
+        std::exchange(slots, std::vector<value_type>(capacity));
+    std::vector<uint32_t> oldDistances =
+        std::exchange(distances, std::vector<uint32_t>(capacity, 0));
+
+    numElements = 0;
+    shift = 64;
+
+    for (size_t size = capacity; size > 1; size /= 2) {
+      shift--;
+    }
+
+    for (size_t i = 0; i < oldSlots.size(); i++) {
+      if (oldDistances[i] != 0) {
+        Place(std::move(oldSlots[i]));
+      }
+    }
+  }
+
+  //! Ячейки таблицы.
+  std::vector<value_type> slots;
+
+  //! Расстояния элементов от их позиций по хешу плюс один (0 --- пусто).
+  std::vector<uint32_t> distances;
+
+  //! Число элементов.
+  size_t numElements;
+
+  //! Сдвиг хеша: позиция занимает старшие 64 - shift бит.
+  unsigned shift;
+};
+
+/**
+ * @brief Множество соседей в виде отсортированного массива.
+ *
+ * @tparam Id Тип, в котором хранятся элементы. Функции принимают элементы
+ * типа size_t: элемента, который не помещается в Id, в множестве нет,
+ * а его добавление выбрасывает исключение std::out_of_range.
+ *
+ * Соседи хранятся подряд, по sizeof(Id) байт на ребро без отдельных
+ * выделений памяти на каждый элемент. Поиск выполняется двоичным поиском
+ * за O(log d), вставка и удаление сдвигают хвост массива за O(d), где
+ * d --- число соседей. Соседи перебираются по возрастанию.
+ */
+template<typename Id = size_t>
+class BasicFlatSet {
+ public:
+  //! Итератор только для чтения.
+  using const_iterator = typename std::vector<Id>::const_iterator;
+  //! Итератор (совпадает с итератором только для чтения).
+  using iterator = const_iterator;
+
+  /**
+   * @brief Добавить элемент.
+   *
+   * @param id Элемент.
+   * @return Итератор на элемент и true, если элемента раньше не было.
+   */
+  std::pair<const_iterator, bool> insert(size_t id) {
+    Id value = NarrowId<Id>(id);
+
+    // Построитель графа добавляет соседей по возрастанию.
+    if (values.empty() || values.back() < value) {
+      Grow();
+      values.push_back(value);
+      return { values.end() - 1, true };
+    }
+
+    auto it = std::lower_bound(values.begin(), values.end(), value);
+
+    if (*it == value) {
+      return { it, false };
+    }
+
+    size_t index = it - values.begin();
+
+    Grow();
+
+    return { values.insert(values.begin() + index, value), true };
+  }
+
+  /**
+   * @brief Удалить элемент.
+   *
+   * @param id Элемент.
+   * @return Функция возвращает число удалённых элементов (0 или 1).
+   */
+  size_t erase(size_t id) {
+    auto it = find(id);
+
+    if (it == values.end()) {
+      return 0;
+    }
+
+    values.erase(it);
+
+    return 1;
+  }
+
+  /**
+   * @brief Найти элемент.
+   *
+   * @param id Элемент.
+   * @return Итератор на элемент или end(), если элемента нет.
+   */
+  const_iterator find(size_t id) const {
+    auto it = std::lower_bound(values.begin(), values.end(), id);
+
+    return it != values.end() && *it == id ? it : values.end();
+  }
+
+  /**
+   * @brief Функция возвращает 1, если элемент есть в множестве, и 0 иначе.
+   *
+   * @param id Элемент.
+   */
+  size_t count(size_t id) const {
+    return std::binary_search(values.begin(), values.end(), id) ? 1 : 0;
+  }
+
+  /**
+   * @brief Зарезервировать место для элементов.
+   *
+   * @param count Ожидаемое число элементов.
+   */
+  void reserve(size_t count) {
+    values.reserve(count);
+  }
+
+  /**
+   * @brief Удалить все элементы.
+   */
+  void clear() {
+    values.clear();
+  }
+
+  /**
+   * @brief Функция возвращает количество элементов.
+   */
+  size_t size() const {
+    return values.size();
+  }
+
+  /**
+   * @brief Функция возвращает true, если множество пусто.
+   */
+  bool empty() const {
+    return values.empty();
+  }
+
+  /**
+   * @brief Возвращает итератор на наименьший элемент.
+   */
+  const_iterator begin() const {
+    return values.begin();
+  }
+
+  /**
+   * @brief Возвращает итератор на элемент "после последнего".
+   */
+  const_iterator end() const {
+    return values.end();
+  }
+
+ private:
+  /**
+   * @brief Подготовить место для ещё одного элемента.
+   *
+   * Массив растёт в 1.5 раза, а не вдвое, как std::vector: у большинства
+   * вершин мало соседей, и незаполненный запас занимает заметную часть
+   * памяти графа.
+   */
+  void Grow() {
+    if (values.size() == values.capacity()) {
+      values.reserve(values.size() + values.size() / 2 + 1);
+    }
+  }
+
+  //! Элементы по возрастанию.
+  std::vector<Id> values;
+};
+
+//! Множество соседей в виде отсортированного массива номеров size_t.
+using FlatSet = BasicFlatSet<size_t>;
+
+/**
+ * @brief Словарь соседей в виде отсортированного массива пар.
+ *
+ * @tparam Value Тип значения, например, вес ребра. Должен иметь
+ * конструктор по умолчанию.
+ * @tparam Key Тип, в котором хранятся ключи. Функции принимают ключи
+ * типа size_t: ключа, который не помещается в Key, в словаре нет, а его
+ * добавление выбрасывает исключение std::out_of_range.
+ *
+ * Пары (сосед, значение) хранятся подряд по возрастанию соседа, поэтому
+ * значение читается из той же строки кеша, что и номер соседа. Сложность
+ * операций такая же, как у graph::BasicFlatSet.
+ */
+template<typename Value, typename Key = size_t>
+class SortedMap {
+ public:
+  //! Тип элемента: пара (ключ, значение).
+  using value_type = std::pair<Key, Value>;
+  //! Итератор только для чтения.
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+  //! Итератор (совпадает с итератором только для чтения).
+  using iterator = const_iterator;
+
+  /**
+   * @brief Доступ к значению по ключу с добавлением.
+   *
+   * @param key Ключ. Если его нет, то добавляется значение по умолчанию.
+   */
+  Value& operator[](size_t key) {
+    Key narrowKey = NarrowId<Key>(key);
+
+    // Построитель графа добавляет соседей по возрастанию.
+    if (elements.empty() || elements.back().first < narrowKey) {
+      Grow();
+      elements.emplace_back(narrowKey, Value());
+      return elements.back().second;
+    }
+
+    size_t index = LowerBound(key);
+
+    if (elements[index].first == narrowKey) {
+      return elements[index].second;
+    }
+
+    Grow();
+
+    return elements.insert(elements.begin() + index,
+                           value_type(narrowKey, Value()))->second;
+  }
+
+  /**
+   * @brief Доступ к значению по ключу.
+   *
+   * @param key Ключ. Если его нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  Value& at(size_t key) {
+    return elements[At(key)].second;
+  }
+
+  /**
+   * @brief Доступ к значению по ключу.
+   *
+   * @param key Ключ. Если его нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  const Value& at(size_t key) const {
+    return elements[At(key)].second;
+  }
+
+  /**
+   * @brief Удалить элемент по ключу.
+   *
+   * @param key Ключ.
+   * @return Функция возвращает число удалённых элементов (0 или 1).
+   */
+  size_t erase(size_t key) {
+    size_t index = Find(key);
+
+    if (index == elements.size()) {
+      return 0;
+    }
+
+    elements.erase(elements.begin() + index);
+
+    return 1;
+  }
+
+  /**
+   * @brief Найти элемент по ключу.
+   *
+   * @param key Ключ.
+   * @return Итератор на элемент или end(), если ключа нет.
+   */
+  const_iterator find(size_t key) const {
+    return elements.begin() + Find(key);
+  }
+
+  /**
+   * @brief Функция возвращает 1, если ключ есть в словаре, и 0 иначе.
+   *
+   * @param key Ключ.
+   */
+  size_t count(size_t key) const {
+    return Find(key) != elements.size() ? 1 : 0;
+  }
+
+  /**
+   * @brief Зарезервировать место для элементов.
+   *
+   * @param count Ожидаемое число элементов.
+   */
+  void reserve(size_t count) {
+    elements.reserve(count);
+  }
+
+  /**
+   * @brief Удалить все элементы.
+   */
+  void clear() {
+    elements.clear();
+  }
+
+  /**
+   * @brief Функция возвращает количество элементов.
+   */
+  size_t size() const {
+    return elements.size();
+  }
+
+  /**
+   * @brief Функция возвращает true, если словарь пуст.
+   */
+  bool empty() const {
+    return elements.empty();
+  }
+
+  /**
+   * @brief Возвращает итератор на элемент с наименьшим ключом.
+   */
+  const_iterator begin() const {
+    return elements.begin();
+  }
+
+  /**
+   * @brief Возвращает итератор на элемент "после последнего".
+   */
+  const_iterator end() const {
+    return elements.end();
+  }
+
+ private:
+  /**
+   * @brief Найти позицию первого элемента с ключом не меньше key.
+   *
+   * @param key Ключ.
+   */
+  size_t LowerBound(size_t key) const {
+    auto it = std::lower_bound(elements.begin(), elements.end(), key,
+                               [](const value_type& element, size_t key) {
+      return element.first < key;
+    });
+
+    return it - elements.begin();
+  }
+
+  /**
+   * @brief Найти позицию элемента по ключу.
+   *
+   * @param key Ключ.
+   * @return Позиция элемента или size(), если ключа нет.
+   */
+  size_t Find(size_t key) const {
+    size_t index = LowerBound(key);
+
+    if (index != elements.size() && elements[index].first == key) {
+      return index;
+    }
+
+    return elements.size();
+  }
+
+  /**
+   * @brief Найти позицию элемента по ключу для функций at().
+   *
+   * @param key Ключ. Если его нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  size_t At(size_t key) const {
+    size_t index = Find(key);
+
+    if (index == elements.size()) {
+      throw std::out_of_range("SortedMap::at(): key not found");
+    }
+
+    return index;
+  }
+
+  /**
+   * @brief Подготовить место для ещё одного элемента.
+   *
+   * Массив растёт в 1.5 раза (@sa BasicFlatSet::Grow()).
+   */
+  void Grow() {
+    if (elements.size() == elements.capacity()) {
+      elements.reserve(elements.size() + elements.size() / 2 + 1);
+    }
+  }
+
+  //! Элементы по возрастанию ключа.
+  std::vector<value_type> elements;
+};
+
+/**
+ * @brief Множество соседей со встроенным буфером.
+ *
+ * @tparam N Число элементов, которые хранятся прямо в объекте.
+ *
+ * Пока в множестве не больше N элементов, они хранятся по возрастанию во
+ * встроенном массиве, и добавление ребра не выделяет память. При
+ * добавлении (N + 1)-го элемента множество переходит на std::unordered_set
+ * и возвращается во встроенный массив, когда в нём остаётся не больше N / 2
+ * элементов. Поиск во встроенном массиве линейный: при небольших N он
+ * быстрее хеширования.
+ *
+ * Итераторы становятся некорректными после любой вставки или удаления.
+ */
+template<size_t N>
+class SmallSet {
+ public:
+  /**
+   * @brief Итератор только для чтения по элементам обеих форм множества.
+   */
+  class const_iterator {
+   public:
+    //! Категория итератора.
+    using iterator_category = std::forward_iterator_tag;
+    //! Тип элемента.
+    using value_type = size_t;
+    //! Тип разности итераторов.
+    using difference_type = std::ptrdiff_t;
+    //! Тип указателя на элемент.
+    using pointer = const size_t*;
+    //! Тип ссылки на элемент.
+    using reference = const size_t&;
+
+    /**
+     * @brief Конструктор итератора.
+     */
+    const_iterator() :
+      value(nullptr),
+      node() {
+    }
+
+    /**
+     * @brief Конструктор итератора по встроенному массиву.
+     * @param value Указатель на элемент массива.
+     */
+    explicit const_iterator(const size_t* value) :
+      value(value),
+      node() {
+    }
+
+    /**
+     * @brief Конструктор итератора по хеш-множеству.
+     * @param node Итератор хеш-множества.
+     */
+    explicit const_iterator(std::unordered_set<size_t>::const_iterator node) :
+      value(nullptr),
+      node(node) {
+    }
+
+    /**
+     * @brief Оператор сравнения == для итератора.
+     * @param other Другой итератор.
+     */
+    bool operator==(const const_iterator& other) const {
+      return value == other.value && node == other.node;
+    }
+
+    /**
+     * @brief Оператор сравнения != для итератора.
+     * @param other Другой итератор.
+     */
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+    /**
+     * @brief Префиксная операция инкремента для итератора.
+     */
+    const_iterator& operator++() {
+      if (value) {
+        ++value;
+      } else {
+        ++node;
+      }
+
+      return *this;
+    }
+
+    /**
+     * @brief Постфиксная операция инкремента для итератора.
+     */
+    const_iterator operator++(int) {
+      const_iterator retval(*this);
+      ++*this;
+      return retval;
+    }
+
+    /**
+     * @brief Функция возвращает элемент, на который указывает итератор.
+     */
+    const size_t& operator*() const {
+      return value ? *value : *node;
+    }
+
+   private:
+    //! Элемент встроенного массива (нулевой для хеш-множества).
+    const size_t* value;
+    //! Элемент хеш-множества.
+    std::unordered_set<size_t>::const_iterator node;
+  };
+
+  //! Итератор (совпадает с итератором только для чтения).
+  using iterator = const_iterator;
+
+  /**
+   * @brief Конструктор пустого множества.
+   */
+  SmallSet() :
+    numInline(0),
+    inlineValues() {
+  }
+
+  /**
+   * @brief Конструктор копирования.
+   * @param other Исходное множество.
+   */
+  SmallSet(const SmallSet& other) :
+    numInline(other.numInline),
+    inlineValues(other.inlineValues) {
+    if (other.large) {
+      large = std::make_unique<std::unordered_set<size_t>>(*other.large);
+    }
+  }
+
+  /**
+   * @brief Оператор присваивания.
+   * @param other Исходное множество.
+   */
+  SmallSet& operator=(const SmallSet& other) {
+    if (this != &other) {
+      SmallSet copy(other);
+      *this = std::move(copy);
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Конструктор перемещения. Исходное множество становится пустым.
+   * @param other Исходное множество.
+   */
+  SmallSet(SmallSet&& other) noexcept :
+    numInline(std::exchange(other.numInline, 0)),
+    inlineValues(other.inlineValues),
+    large(std::move(other.large)) {
+  }
+
+  /**
+   * @brief Перемещающий оператор присваивания.
+   * @param other Исходное множество.
+   */
+  SmallSet& operator=(SmallSet&& other) noexcept {
+    numInline = std::exchange(other.numInline, 0);
+    inlineValues = other.inlineValues;
+    large = std::move(other.large);
+
+    return *this;
+  }
+
+  /**
+   * @brief Добавить элемент.
+   *
+   * @param id Элемент.
+   * @return Итератор на элемент и true, если элемента раньше не было.
+   */
+  std::pair<const_iterator, bool> insert(size_t id) {
+    if (large) {
+      auto [it, isInserted] = large->insert(id);
+      return { const_iterator(it), isInserted };
+    }
+
+    size_t* first = inlineValues.data();
+    size_t* position = std::lower_bound(first, first + numInline, id);
+
+    if (position != first + numInline && *position == id) {
+      return { const_iterator(position), false };
+    }
+
+    if (numInline == N) {
+      Promote(N + 1);
+      return { const_iterator(large->insert(id).first), true };
+    }
+
+    std::copy_backward(position, first + numInline, first + numInline + 1);
+    *position = id;
+    numInline++;
+
+    return { const_iterator(position), true };
+  }
+
+  /**
+   * @brief Удалить элемент.
+   *
+   * @param id Элемент.
+   * @return Функция возвращает число удалённых элементов (0 или 1).
+   */
+  size_t erase(size_t id) {
+    if (large) {
+      size_t numErased = large->erase(id);
+
+      if (large->size() <= N / 2) {
+        Demote();
+      }
+
+      return numErased;
+    }
+
+    size_t* first = inlineValues.data();
+    size_t* last = first + numInline;
+    size_t* position = std::find(first, last, id);
+
+    if (position == last) {
+      return 0;
+    }
+
+    std::copy(position + 1, last, position);
+    numInline--;
+
+    return 1;
+  }
+
+  /**
+   * @brief Найти элемент.
+   *
+   * @param id Элемент.
+   * @return Итератор на элемент или end(), если элемента нет.
+   */
+  const_iterator find(size_t id) const {
+    if (large) {
+      return const_iterator(large->find(id));
+    }
+
+    const size_t* first = inlineValues.data();
+
+    return const_iterator(std::find(first, first + numInline, id));
+  }
+
+  /**
+   * @brief Функция возвращает 1, если элемент есть в множестве, и 0 иначе.
+   *
+   * @param id Элемент.
+   */
+  size_t count(size_t id) const {
+    if (large) {
+      return large->count(id);
+    }
+
+    for (size_t i = 0; i < numInline; i++) {
+      if (inlineValues[i] == id) {
+        return 1;
+      }
+    }
+
+    return 0;
+  }
+
+  /**
+   * @brief Зарезервировать место для элементов.
+   *
+   * @param count Ожидаемое число элементов. Если оно больше N, то множество
+   * сразу переходит на хеш-множество.
+   */
+  void reserve(size_t count) {
+    if (large) {
+      large->reserve(count);
+    } else if (count > N) {
+      Promote(count);
+    }
+  }
+
+  /**
+   * @brief Удалить все элементы.
+   */
+  void clear() {
+    numInline = 0;
+    large.reset();
+  }
+
+  /**
+   * @brief Функция возвращает количество элементов.
+   */
+  size_t size() const {
+    return large ? large->size() : numInline;
+  }
+
+  /**
+   * @brief Функция возвращает true, если множество пусто.
+   */
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент.
+   */
+  const_iterator begin() const {
+    return large ? const_iterator(large->begin()) :
+                   const_iterator(inlineValues.data());
+  }
+
+  /**
+   * @brief Возвращает итератор на элемент "после последнего".
+   */
+  const_iterator end() const {
+    return large ? const_iterator(large->end()) :
+                   const_iterator(inlineValues.data() + numInline);
+  }
+
+ private:
+  /**
+   * @brief Перенести элементы из встроенного массива в хеш-множество.
+   *
+   * @param count Ожидаемое число элементов.
+   */
+  void Promote(size_t count) {
+    large = std::make_unique<std::unordered_set<size_t>>();
+    large->reserve(count);
+    large->insert(inlineValues.begin(), inlineValues.begin() + numInline);
+    numInline = 0;
+  }
+
+  /**
+   * @brief Перенести элементы из хеш-множества во встроенный массив.
+   */
+  void Demote() {
+    // Demote() вызывается, когда в хеш-множестве не больше N / 2
+    // элементов. Явная граница N в локальной переменной нужна компилятору,
+    // иначе он не может доказать, что std::sort не выходит за пределы
+    // массива, и выдаёт -Warray-bounds.
+    const size_t count = std::min(large->size(), N);
+
+    std::copy_n(large->begin(), count, inlineValues.begin());
+    std::sort(inlineValues.begin(), inlineValues.begin() + count);
+    large.reset();
+    numInline = count;
+  }
+
+  //! Число элементов во встроенном массиве (0 для хеш-множества).
+  size_t numInline;
+  //! Встроенный массив элементов по возрастанию.
+  std::array<size_t, N> inlineValues;
+  //! Хеш-множество для вершин большой степени.
+  std::unique_ptr<std::unordered_set<size_t>> large;
+};
+
+/**
+ * @brief Словарь соседей со встроенным буфером.
+ *
+ * @tparam N Число элементов, которые хранятся прямо в объекте.
+ * @tparam Value Тип значения, например, вес ребра. Должен иметь
+ * конструктор по умолчанию.
+ *
+ * Устроен так же, как graph::SmallSet: пока в словаре не больше N пар
+ * (сосед, значение), они хранятся по возрастанию соседа во встроенном
+ * массиве, а у вершин большой степени --- в graph::FlatMap. В обеих формах
+ * элемент имеет тип std::pair<size_t, Value>, поэтому итератор возвращает
+ * ссылку на пару без копирования.
+ *
+ * Итераторы и ссылки на значения становятся некорректными после любой
+ * вставки или удаления.
+ */
+template<size_t N, typename Value>
+class SmallMap {
+ public:
+  //! Тип элемента: пара (ключ, значение).
+  using value_type = std::pair<size_t, Value>;
+
+  /**
+   * @brief Итератор только для чтения по элементам обеих форм словаря.
+   */
+  class const_iterator {
+   public:
+    //! Категория итератора.
+    using iterator_category = std::forward_iterator_tag;
+    //! Тип элемента.
+    using value_type = SmallMap::value_type;
+    //! Тип разности итераторов.
+    using difference_type = std::ptrdiff_t;
+    //! Тип указателя на элемент.
+    using pointer = const value_type*;
+    //! Тип ссылки на элемент.
+    using reference = const value_type&;
+
+    /**
+     * @brief Конструктор итератора по встроенному массиву.
+     * @param value Указатель на элемент массива.
+     */
+    explicit const_iterator(const value_type* value) :
+      value(value),
+      node(nullptr, 0) {
+    }
+
+    /**
+     * @brief Конструктор итератора по словарю на открытой адресации.
+     * @param node Итератор словаря.
+     */
+    explicit const_iterator(typename FlatMap<Value>::const_iterator node) :
+      value(nullptr),
+      node(node) {
+    }
+
+    /**
+     * @brief Оператор сравнения == для итератора.
+     * @param other Другой итератор.
+     */
+    bool operator==(const const_iterator& other) const {
+      return value == other.value && node == other.node;
+    }
+
+    /**
+     * @brief Оператор сравнения != для итератора.
+     * @param other Другой итератор.
+     */
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+    /**
+     * @brief Префиксная операция инкремента для итератора.
+     */
+    const_iterator& operator++() {
+      if (value) {
+        ++value;
+      } else {
+        ++node;
+      }
+
+      return *this;
+    }
+
+    /**
+     * @brief Постфиксная операция инкремента для итератора.
+     */
+    const_iterator operator++(int) {
+      const_iterator retval(*this);
+      ++*this;
+      return retval;
+    }
+
+    /**
+     * @brief Функция возвращает элемент, на который указывает итератор.
+     */
+    const value_type& operator*() const {
+      return value ? *value : *node;
+    }
+
+    /**
+     * @brief Доступ к полям элемента.
+     */
+    const value_type* operator->() const {
+      return &**this;
+    }
+
+   private:
+    //! Элемент встроенного массива (нулевой для словаря).
+    const value_type* value;
+    //! Элемент словаря на открытой адресации.
+    typename FlatMap<Value>::const_iterator node;
+  };
+
+  //! Итератор (совпадает с итератором только для чтения).
+  using iterator = const_iterator;
+
+  /**
+   * @brief Конструктор пустого словаря.
+   */
+  SmallMap() :
+    numInline(0),
+    inlineValues() {
+  }
+
+  /**
+   * @brief Конструктор копирования.
+   * @param other Исходный словарь.
+   */
+  SmallMap(const SmallMap& other) :
+    numInline(other.numInline),
+    inlineValues(other.inlineValues) {
+    if (other.large) {
+      large = std::make_unique<FlatMap<Value>>(*other.large);
+    }
+  }
+
+  /**
+   * @brief Оператор присваивания.
+   * @param other Исходный словарь.
+   */
+  SmallMap& operator=(const SmallMap& other) {
+    if (this != &other) {
+      SmallMap copy(other);
+      *this = std::move(copy);
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Конструктор перемещения. Исходный словарь становится пустым.
+   * @param other Исходный словарь.
+   */
+  SmallMap(SmallMap&& other) noexcept :
+    numInline(std::exchange(other.numInline, 0)),
+    inlineValues(std::move(other.inlineValues)),
+    large(std::move(other.large)) {
+  }
+
+  /**
+   * @brief Перемещающий оператор присваивания.
+   * @param other Исходный словарь.
+   */
+  SmallMap& operator=(SmallMap&& other) noexcept {
+    numInline = std::exchange(other.numInline, 0);
+    inlineValues = std::move(other.inlineValues);
+    large = std::move(other.large);
+
+    return *this;
+  }
+
+  /**
+   * @brief Доступ к значению по ключу с добавлением.
+   *
+   * @param id Ключ. Если его нет, то добавляется значение по умолчанию.
+   */
+  Value& operator[](size_t id) {
+    if (large) {
+      return (*large)[id];
+    }
+
+    value_type* first = inlineValues.data();
+    value_type* position = LowerBound(id);
+
+    if (position != first + numInline && position->first == id) {
+      return position->second;
+    }
+
+    if (numInline == N) {
+      Promote(N + 1);
+      return (*large)[id];
+    }
+
+    std::move_backward(position, first + numInline, first + numInline + 1);
+    *position = value_type(id, Value());
+    numInline++;
+
+    return position->second;
+  }
+
+  /**
+   * @brief Доступ к значению по ключу.
+   *
+   * @param id Ключ. Если его нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  Value& at(size_t id) {
+    const SmallMap& self = *this;
+
+    return const_cast<Value&>(self.at(id));
+  }
+
+  /**
+   * @brief Доступ к значению по ключу.
+   *
+   * @param id Ключ. Если его нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  const Value& at(size_t id) const {
+    const_iterator it = find(id);
+
+    if (it == end()) {
+      throw std::out_of_range("SmallMap::at(): key not found");
+    }
+
+    return it->second;
+  }
+
+  /**
+   * @brief Удалить элемент по ключу.
+   *
+   * @param id Ключ.
+   * @return Функция возвращает число удалённых элементов (0 или 1).
+   */
+  size_t erase(size_t id) {
+    if (large) {
+      size_t numErased = large->erase(id);
+
+      if (large->size() <= N / 2) {
+        Demote();
+      }
+
+      return numErased;
+    }
+
+    value_type* last = inlineValues.data() + numInline;
+    value_type* position = LowerBound(id);
+
+    if (position == last || position->first != id) {
+      return 0;
+    }
+
+    std::move(position + 1, last, position);
+    numInline--;
+
+    return 1;
+  }
+
+  /**
+   * @brief Найти элемент по ключу.
+   *
+   * @param id Ключ.
+   * @return Итератор на элемент или end(), если ключа нет.
+   */
+  const_iterator find(size_t id) const {
+    if (large) {
+      return const_iterator(large->find(id));
+    }
+
+    const value_type* first = inlineValues.data();
+
+    for (size_t i = 0; i < numInline; i++) {
+      if (first[i].first == id) {
+        return const_iterator(first + i);
+      }
+    }
+
+    return const_iterator(first + numInline);
+  }
+
+  /**
+   * @brief Функция возвращает 1, если ключ есть в словаре, и 0 иначе.
+   *
+   * @param id Ключ.
+   */
+  size_t count(size_t id) const {
+    return find(id) != end() ? 1 : 0;
+  }
+
+  /**
+   * @brief Зарезервировать место для элементов.
+   *
+   * @param count Ожидаемое число элементов. Если оно больше N, то словарь
+   * сразу переходит на graph::FlatMap.
+   */
+  void reserve(size_t count) {
+    if (large) {
+      large->reserve(count);
+    } else if (count > N) {
+      Promote(count);
+    }
+  }
+
+  /**
+   * @brief Удалить все элементы.
+   */
+  void clear() {
+    numInline = 0;
+    large.reset();
+  }
+
+  /**
+   * @brief Функция возвращает количество элементов.
+   */
+  size_t size() const {
+    return large ? large->size() : numInline;
+  }
+
+  /**
+   * @brief Функция возвращает true, если словарь пуст.
+   */
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент.
+   */
+  const_iterator begin() const {
+    return large ? const_iterator(large->begin()) :
+                   const_iterator(inlineValues.data());
+  }
+
+  /**
+   * @brief Возвращает итератор на элемент "после последнего".
+   */
+  const_iterator end() const {
+    return large ? const_iterator(large->end()) :
+                   const_iterator(inlineValues.data() + numInline);
+  }
+
+ private:
+  /**
+   * @brief Найти во встроенном массиве первый элемент с ключом не меньше id.
+   *
+   * @param id Ключ.
+   */
+  value_type* LowerBound(size_t id) {
+    return std::lower_bound(inlineValues.data(),
+                            inlineValues.data() + numInline, id,
+                            [](const value_type& element, size_t id) {
+      return element.first < id;
+    });
+  }
+
+  /**
+   * @brief Перенести элементы из встроенного массива в graph::FlatMap.
+   *
+   * @param count Ожидаемое число элементов.
+   */
+  void Promote(size_t count) {
+    large = std::make_unique<FlatMap<Value>>();
+    large->reserve(count);
+
+    for (size_t i = 0; i < numInline; i++) {
+      (*large)[inlineValues[i].first] = std::move(inlineValues[i].second);
+    }
+
+    numInline = 0;
+  }
+
+  /**
+   * @brief Перенести элементы из graph::FlatMap во встроенный массив.
+   */
+  void Demote() {
+    // Как и в graph::SmallSet, граница N нужна только компилятору.
+    size_t count = 0;
+
+    for (const value_type& element : *large) {
+      if (count == N) {
+        break;
+      }
+
+      inlineValues[count++] = element;
+    }
+
+    std::sort(inlineValues.begin(), inlineValues.begin() + count,
+              [](const value_type& left, const value_type& right) {
+      return left.first < right.first;
+    });
+    large.reset();
+    numInline = count;
+  }
+
+  //! Число элементов во встроенном массиве (0 для graph::FlatMap).
+  size_t numInline;
+  //! Встроенный массив элементов по возрастанию ключа.
+  std::array<value_type, N> inlineValues;
+  //! Словарь для вершин большой степени.
+  std::unique_ptr<FlatMap<Value>> large;
+};
+
+/**
+ * @brief Политика хранения на стандартных хеш-таблицах.
+ *
+ * Каждое ребро занимает отдельный узел std::unordered_set (около 40 байт
+ * вместе с корзиной), зато вставка и удаление ребра стоят O(1) при любой
+ * степени вершины.
+ */
+struct HashStorage {
+  //! Тип, в котором хранятся номера вершин.
+  using Id = size_t;
+
+  //! Словарь вершин.
+  template<typename Value>
+  using Map = std::unordered_map<size_t, Value>;
+
+  //! Множество соседей вершины.
+  using Set = std::unordered_set<size_t>;
+
+  //! Словарь соседей вершины, например, с весами рёбер.
+  template<typename Value>
+  using NeighbourMap = std::unordered_map<size_t, Value>;
+};
+
+/**
+ * @brief Политика хранения по умолчанию: хеш-таблица вершин и множества
+ *        соседей со встроенным буфером на 8 элементов.
+ *
+ * У большинства вершин меньше 8 соседей, и для них добавление ребра
+ * не выделяет память, а HasEdge() просматривает несколько соседних ячеек
+ * без хеширования. Вершины большой степени хранят соседей так же, как
+ * в graph::HashStorage.
+ */
+struct SmallStorage {
+  //! Тип, в котором хранятся номера вершин.
+  using Id = size_t;
+
+  //! Словарь вершин.
+  template<typename Value>
+  using Map = std::unordered_map<size_t, Value>;
+
+  //! Множество соседей вершины.
+  using Set = SmallSet<8>;
+
+  //! Словарь соседей вершины, например, с весами рёбер.
+  template<typename Value>
+  using NeighbourMap = SmallMap<8, Value>;
+};
+
+/**
+ * @brief Компактная политика хранения: словарь вершин на открытой
+ *        адресации и отсортированные массивы соседей.
+ *
+ * Ребро занимает 8 байт в массиве соседей (плюс запас при росте массива),
+ * а не отдельный узел, поэтому граф занимает в несколько раз меньше памяти
+ * и перебирается без переходов по указателям. Вставка и удаление ребра
+ * стоят O(d), что подходит для графов с небольшими степенями вершин.
+ */
+struct FlatStorage {
+  //! Тип, в котором хранятся номера вершин.
+  using Id = size_t;
+
+  //! Словарь вершин.
+  template<typename Value>
+  using Map = FlatMap<Value>;
+
+  //! Множество соседей вершины.
+  using Set = FlatSet;
+
+  //! Словарь соседей вершины, например, с весами рёбер.
+  template<typename Value>
+  using NeighbourMap = SortedMap<Value>;
+};
+
+/**
+ * @brief Компактная политика хранения с 32-битными номерами вершин.
+ *
+ * Устроена так же, как graph::FlatStorage, но номера вершин в словаре
+ * и в массивах соседей хранятся в uint32_t: массивы соседей занимают вдвое
+ * меньше памяти, и в строку кеша помещается вдвое больше соседей. Интерфейс
+ * графов не меняется (номера вершин по-прежнему size_t). Номера, которые
+ * не помещаются в uint32_t, нельзя добавить в граф: функции AddVertex()
+ * и AddEdge() выбрасывают исключение std::out_of_range.
+ */
+struct CompactStorage {
+  //! Тип, в котором хранятся номера вершин.
+  using Id = uint32_t;
+
+  //! Словарь вершин.
+  template<typename Value>
+  using Map = FlatMap<Value, Id>;
+
+  //! Множество соседей вершины.
+  using Set = BasicFlatSet<Id>;
+
+  //! Словарь соседей вершины, например, с весами рёбер.
+  template<typename Value>
+  using NeighbourMap = SortedMap<Value, Id>;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_GRAPH_STORAGE_HPP_
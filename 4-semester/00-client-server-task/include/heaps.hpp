@@ -0,0 +1,518 @@
+/**
+ * @file heaps.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Очереди с приоритетами для алгоритмов поиска кратчайших путей.
+ */
+
+#ifndef INCLUDE_HEAPS_HPP_
+#define INCLUDE_HEAPS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Индексированная d-арная куча.
+ *
+ * @tparam Key Тип ключа (приоритета).
+ * @tparam Arity Число потомков у каждого узла.
+ *
+ * Все очереди из этого файла имеют одинаковый интерфейс и хранят вершины
+ * графа (числа 0, 1, ..., N - 1) с ключами:
+ * - Reset(numVertices) --- очистить очередь для графа из numVertices вершин;
+ * - Empty() --- проверить, пуста ли очередь;
+ * - Push(vertex, key) --- добавить вершину или уменьшить её ключ (новый
+ *   ключ не больше текущего);
+ * - Pop() --- извлечь пару (вершина, ключ) с минимальным ключом.
+ *
+ * Куча хранит позицию каждой вершины, поэтому уменьшение ключа выполняется
+ * на месте за O(log_d N). Чем больше Arity, тем ниже дерево и дешевле
+ * уменьшение ключа, но дороже извлечение минимума. Для разреженных графов,
+ * где уменьшений ключа больше, чем извлечений, обычно быстрее 4-арная куча:
+ * кроме того, четыре потомка узла лежат в одной строке кэша.
+ */
+template<typename Key, size_t Arity>
+class DaryHeap {
+ public:
+  static_assert(Arity >= 2, "Arity must be at least 2");
+
+  /**
+   * @brief Очистить очередь.
+   *
+   * @param numVertices Число вершин графа.
+   */
+  void Reset(size_t numVertices) {
+    heap.clear();
+    positions.assign(numVertices, noPosition);
+  }
+
+  /**
+   * @brief Функция возвращает true, если очередь пуста.
+   */
+  bool Empty() const {
+    return heap.empty();
+  }
+
+  /**
+   * @brief Добавить вершину или уменьшить её ключ.
+   *
+   * @param vertex Номер вершины.
+   * @param key Ключ.
+   */
+  void Push(size_t vertex, Key key) {
+    size_t position = positions[vertex];
+
+    if (position == noPosition) {
+      position = heap.size();
+      heap.emplace_back(key, vertex);
+    } else if (!(key < heap[position].first)) {
+      return;
+    } else {
+      heap[position].first = key;
+    }
+
+    SiftUp(position);
+  }
+
+  /**
+   * @brief Извлечь вершину с минимальным ключом.
+   *
+   * @return Пара (вершина, ключ).
+   */
+  std::pair<size_t, Key> Pop() {
+    std::pair<Key, size_t> top = heap.front();
+
+    positions[top.second] = noPosition;
+
+    if (heap.size() > 1) {
+      heap.front() = heap.back();
+      heap.pop_back();
+      SiftDown(0);
+    } else {
+      heap.pop_back();
+    }
+
+    return std::make_pair(top.second, top.first);
+  }
+
+ private:
+  /**
+   * @brief Поднять элемент к корню, пока он меньше родителя.
+   *
+   * @param position Позиция элемента.
+   */
+  void SiftUp(size_t position) {
+    std::pair<Key, size_t> element = heap[position];
+
+    while (position > 0) {
+      size_t parent = (position - 1) / Arity;
+
+      if (!(element.first < heap[parent].first)) {
+        break;
+      }
+
+      heap[position] = heap[parent];
+      positions[heap[position].second] = position;
+      position = parent;
+    }
+
+    heap[position] = element;
+    positions[element.second] = position;
+  }
+
+  /**
+   * @brief Опустить элемент к листьям, пока он больше наименьшего потомка.
+   *
+   * @param position Позиция элемента.
+   */
+  void SiftDown(size_t position) {
+    std::pair<Key, size_t> element = heap[position];
+
+    while (true) {
+      size_t first = Arity * position + 1;
+
+      if (first >= heap.size()) {
+        break;
+      }
+
+      size_t last = first + Arity < heap.size() ? first + Arity : heap.size();
+      size_t smallest = first;
+
+      for (size_t child = first + 1; child < last; child++) {
+        if (heap[child].first < heap[smallest].first) {
+          smallest = child;
+        }
+      }
+
+      if (!(heap[smallest].first < element.first)) {
+        break;
+      }
+
+      heap[position] = heap[smallest];
+      positions[heap[position].second] = position;
+      position = smallest;
+    }
+
+    heap[position] = element;
+    positions[element.second] = position;
+  }
+
+  //! Признак того, что вершины нет в куче.
+  static constexpr size_t noPosition = std::numeric_limits<size_t>::max();
+
+  //! Элементы кучи: пары (ключ, вершина).
+  std::vector<std::pair<Key, size_t>> heap;
+  //! Позиции вершин в массиве heap.
+  std::vector<size_t> positions;
+};
+
+/**
+ * @brief Двоичная куча.
+ *
+ * @tparam Key Тип ключа.
+ */
+template<typename Key>
+using BinaryHeap = DaryHeap<Key, 2>;
+
+/**
+ * @brief 4-арная куча.
+ *
+ * @tparam Key Тип ключа.
+ */
+template<typename Key>
+using QuaternaryHeap = DaryHeap<Key, 4>;
+
+/**
+ * @brief Спаривающаяся куча (pairing heap).
+ *
+ * @tparam Key Тип ключа.
+ *
+ * Интерфейс совпадает с graph::DaryHeap. Куча --- лес деревьев, в котором
+ * каждый узел хранит первого потомка, следующего брата и предыдущий узел
+ * (родителя для первого потомка или предыдущего брата). Узлы хранятся
+ * в массиве по номеру вершины, поэтому куча не выделяет память на каждую
+ * операцию. Добавление и уменьшение ключа выполняются за O(1): узел
+ * отрезается от родителя и сливается с корнем. Извлечение минимума сливает
+ * потомков корня в два прохода за амортизированное O(log N).
+ */
+template<typename Key>
+class PairingHeap {
+ public:
+  /**
+   * @brief Очистить очередь.
+   *
+   * @param numVertices Число вершин графа.
+   */
+  void Reset(size_t numVertices) {
+    nodes.assign(numVertices, Node());
+    root = noNode;
+  }
+
+  /**
+   * @brief Функция возвращает true, если очередь пуста.
+   */
+  bool Empty() const {
+    return root == noNode;
+  }
+
+  /**
+   * @brief Добавить вершину или уменьшить её ключ.
+   *
+   * @param vertex Номер вершины.
+   * @param key Ключ.
+   */
+  void Push(size_t vertex, Key key) {
+    Node& node = nodes[vertex];
+
+    if (node.inHeap) {
+      if (!(key < node.key)) {
+        return;
+      }
+
+      node.key = key;
+
+      if (vertex == root) {
+        return;
+      }
+
+      Cut(vertex);
+    } else {
+      node.key = key;
+      node.inHeap = true;
+    }
+
+    root = Meld(root, vertex);
+  }
+
+  /**
+   * @brief Извлечь вершину с минимальным ключом.
+   *
+   * @return Пара (вершина, ключ).
+   */
+  std::pair<size_t, Key> Pop() {
+    size_t top = root;
+    Node& node = nodes[top];
+
+    children.clear();
+
+    for (size_t child = node.child; child != noNode;) {
+      size_t next = nodes[child].sibling;
+
+      nodes[child].previous = noNode;
+      nodes[child].sibling = noNode;
+      children.push_back(child);
+      child = next;
+    }
+
+    node.child = noNode;
+    node.inHeap = false;
+
+    // Первый проход: слияние соседних пар слева направо.
+    size_t numTrees = 0;
+
+    for (size_t i = 0; i < children.size(); i += 2) {
+      children[numTrees++] = i + 1 < children.size() ?
+          Meld(children[i], children[i + 1]) : children[i];
+    }
+
+    // Второй проход: слияние получившихся деревьев справа налево.
+    root = noNode;
+
+    for (size_t i = numTrees; i > 0; i--) {
+      root = Meld(root, children[i - 1]);
+    }
+
+    return std::make_pair(top, node.key);
+  }
+
+ private:
+  /**
+   * @brief Узел кучи.
+   */
+  struct Node {
+    //! Ключ.
+    Key key{};
+    //! Первый потомок.
+    size_t child = noNode;
+    //! Следующий брат.
+    size_t sibling = noNode;
+    //! Родитель (для первого потомка) или предыдущий брат.
+    size_t previous = noNode;
+    //! Находится ли вершина в куче.
+    bool inHeap = false;
+  };
+
+  /**
+   * @brief Слить два дерева.
+   *
+   * @param first Корень первого дерева (может быть noNode).
+   * @param second Корень второго дерева (может быть noNode).
+   * @return Корень получившегося дерева.
+   */
+  size_t Meld(size_t first, size_t second) {
+    if (first == noNode) {
+      return second;
+    }
+
+    if (second == noNode) {
+      return first;
+    }
+
+    if (nodes[second].key < nodes[first].key) {
+      std::swap(first, second);
+    }
+
+    Node& parent = nodes[first];
+    Node& child = nodes[second];
+
+    child.sibling = parent.child;
+    child.previous = first;
+
+    if (parent.child != noNode) {
+      nodes[parent.child].previous = second;
+    }
+
+    parent.child = second;
+
+    return first;
+  }
+
+  /**
+   * @brief Отрезать поддерево от родителя.
+   *
+   * @param vertex Корень поддерева (не корень кучи).
+   */
+  void Cut(size_t vertex) {
+    Node& node = nodes[vertex];
+    Node& previous = nodes[node.previous];
+
+    if (previous.child == vertex) {
+      previous.child = node.sibling;
+    } else {
+      previous.sibling = node.sibling;
+    }
+
+    if (node.sibling != noNode) {
+      nodes[node.sibling].previous = node.previous;
+    }
+
+    node.sibling = noNode;
+    node.previous = noNode;
+  }
+
+  //! Признак отсутствия узла.
+  static constexpr size_t noNode = std::numeric_limits<size_t>::max();
+
+  //! Узлы кучи по номерам вершин.
+  std::vector<Node> nodes;
+  //! Корень кучи.
+  size_t root = noNode;
+  //! Временный массив для потомков извлекаемого корня.
+  std::vector<size_t> children;
+};
+
+/**
+ * @brief Поразрядная куча (radix heap) для целых неотрицательных ключей.
+ *
+ * @tparam Key Целочисленный тип ключа.
+ *
+ * Интерфейс совпадает с graph::DaryHeap, но куча монотонная: ключ,
+ * передаваемый в Push(), не может быть меньше последнего извлечённого
+ * ключа. Алгоритм Дейкстры это условие выполняет.
+ *
+ * Элемент с ключом key лежит в корзине с номером, равным длине в битах
+ * числа key XOR last, где last --- последний извлечённый ключ. При
+ * извлечении из пустой нулевой корзины находится первая непустая корзина,
+ * её минимум становится новым last, а элементы перераспределяются по
+ * корзинам с меньшими номерами. Каждый элемент перемещается не больше
+ * числа бит ключа раз, а сравнения ключей заменяются битовыми операциями.
+ *
+ * Уменьшение ключа не поддерживается: Push() всегда добавляет новую
+ * запись, а устаревшие записи вершины извлекаются позже с большим ключом.
+ * Алгоритм должен пропускать их, сравнивая ключ с текущим расстоянием.
+ */
+template<typename Key>
+class RadixHeap {
+ public:
+  static_assert(std::is_integral_v<Key>,
+                "RadixHeap requires an integral key type");
+
+  /**
+   * @brief Очистить очередь.
+   *
+   * @param numVertices Число вершин графа (не используется).
+   */
+  void Reset(size_t /*numVertices*/) {
+    for (std::vector<std::pair<Key, size_t>>& bucket : buckets) {
+      bucket.clear();
+    }
+
+    last = 0;
+    size = 0;
+  }
+
+  /**
+   * @brief Функция возвращает true, если очередь пуста.
+   */
+  bool Empty() const {
+    return size == 0;
+  }
+
+  /**
+   * @brief Добавить запись для вершины.
+   *
+   * @param vertex Номер вершины.
+   * @param key Ключ (не меньше последнего извлечённого).
+   */
+  void Push(size_t vertex, Key key) {
+    buckets[Bucket(key)].emplace_back(key, vertex);
+    size++;
+  }
+
+  /**
+   * @brief Извлечь запись с минимальным ключом.
+   *
+   * @return Пара (вершина, ключ).
+   */
+  std::pair<size_t, Key> Pop() {
+    if (buckets[0].empty()) {
+      size_t index = 1;
+
+      while (buckets[index].empty()) {
+        index++;
+      }
+
+      std::vector<std::pair<Key, size_t>>& bucket = buckets[index];
+
+      last = bucket.front().first;
+
+      for (const std::pair<Key, size_t>& element : bucket) {
+        if (element.first < last) {
+          last = element.first;
+        }
+      }
+
+      // Все элементы корзины отличаются от нового last только в младших
+      // битах, поэтому попадают в корзины с меньшими номерами.
+      for (const std::pair<Key, size_t>& element : bucket) {
+        buckets[Bucket(element.first)].push_back(element);
+      }
+
+      bucket.clear();
+    }
+
+    std::pair<Key, size_t> top = buckets[0].back();
+
+    buckets[0].pop_back();
+    size--;
+
+    return std::make_pair(top.second, top.first);
+  }
+
+ private:
+  //! Число бит ключа.
+  static constexpr size_t numBits = std::numeric_limits<Key>::digits;
+
+  /**
+   * @brief Функция возвращает номер корзины для ключа.
+   *
+   * @param key Ключ.
+   */
+  size_t Bucket(Key key) const {
+    uint64_t difference = static_cast<uint64_t>(key) ^
+                          static_cast<uint64_t>(last);
+
+    if (difference == 0) {
+      return 0;
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+    return 64 - static_cast<size_t>(__builtin_clzll(difference));
+#else
+    size_t width = 0;
+
+    for (; difference != 0; difference >>= 1) {
+      width++;
+    }
+
+    return width;
+#endif
+  }
+
+  //! Корзины: пары (ключ, вершина).
+  std::vector<std::pair<Key, size_t>> buckets[numBits + 1];
+  //! Последний извлечённый ключ.
+  Key last = 0;
+  //! Число записей в куче.
+  size_t size = 0;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_HEAPS_HPP_
@@ -8,23 +8,23 @@
 #ifndef INCLUDE_ITERATORS_HPP_
 #define INCLUDE_ITERATORS_HPP_
 
-#include <unordered_set>
-#include <unordered_map>
+#include <cstddef>
 
 namespace graph {
 
 /**
  * @brief Класс позволяет проитерироваться по всем вершинам в графе.
  *
+ * @tparam InternalIteratorType Тип итератора словаря в матрице смежности
+ * графа, например, std::unordered_map::const_iterator или
+ * graph::FlatMap::const_iterator. Элемент словаря должен иметь поле first
+ * с номером вершины.
+ *
  * Этот класс является простой оболочкой над итератором словаря
  * в матрице смежности графа.
  */
+template<typename InternalIteratorType>
 class VertexIterator {
- public:
-  //! Внутренний тип итератора.
-  using InternalIteratorType =
-      std::unordered_map<size_t, std::unordered_set<size_t>>::const_iterator;
-
  private:
   //! Текущая позиция.
   InternalIteratorType pos;
@@ -58,7 +58,7 @@ class VertexIterator {
    * @brief Префиксная операция инкремента для итератора.
    */
   VertexIterator& operator++() {
-    pos++;
+    ++pos;
     return *this;
   }
 
@@ -67,7 +67,7 @@ class VertexIterator {
    */
   VertexIterator operator++(int) {
     VertexIterator retval(*this);
-    pos++;
+    ++pos;
     return retval;
   }
 
@@ -83,19 +83,19 @@ class VertexIterator {
 /**
  * @brief Класс-адаптер, предназначенный для использования в циклах
  *        range-based for.
+ *
+ * @tparam InternalIteratorType Тип итератора словаря в матрице смежности
+ * графа (@sa VertexIterator).
  */
+template<typename InternalIteratorType>
 class VerticesRange {
  private:
   //! Итератор на первую вершину.
-  VertexIterator beginIt;
+  VertexIterator<InternalIteratorType> beginIt;
   //! Итератор на вершину "после последней".
-  VertexIterator endIt;
+  VertexIterator<InternalIteratorType> endIt;
 
  public:
-  //! Внутренний тип итератора.
-  using InternalIteratorType =
-      std::unordered_map<size_t, std::unordered_set<size_t>>::const_iterator;
-
   /**
     * @brief Конструктор класса.
     * @param beginIt Итератор на начало в словаре матрицы смежности.
@@ -109,18 +109,261 @@ class VerticesRange {
   /**
    * @brief Возвращает итератор на первую вершину.
    */
-  VertexIterator begin() const {
+  VertexIterator<InternalIteratorType> begin() const {
+    return beginIt;
+  }
+
+  /**
+   * @brief Возвращает итератор на вершину "после последней".
+   */
+  VertexIterator<InternalIteratorType> end() const {
+    return endIt;
+  }
+};
+
+/**
+ * @brief Класс-адаптер для перебора соседей вершины по словарю соседей.
+ *
+ * @tparam NeighbourMap Тип словаря соседей, элементы которого --- пары
+ * (сосед, значение), например, словаря весов рёбер в
+ * graph::WeightedOrientedGraph.
+ *
+ * Кроме перебора номеров соседей в циклах range-based for, класс
+ * поддерживает функции size(), empty() и count() множества соседей.
+ */
+template<typename NeighbourMap>
+class NeighboursRange {
+ private:
+  //! Итератор словаря соседей.
+  using InternalIteratorType = typename NeighbourMap::const_iterator;
+
+  //! Словарь соседей.
+  const NeighbourMap* neighbours;
+
+ public:
+  /**
+   * @brief Конструктор класса.
+   * @param neighbours Словарь соседей.
+   */
+  explicit NeighboursRange(const NeighbourMap& neighbours) :
+    neighbours(&neighbours) {
+  }
+
+  /**
+   * @brief Возвращает итератор на первого соседа.
+   */
+  VertexIterator<InternalIteratorType> begin() const {
+    return VertexIterator<InternalIteratorType>(neighbours->begin());
+  }
+
+  /**
+   * @brief Возвращает итератор на соседа "после последнего".
+   */
+  VertexIterator<InternalIteratorType> end() const {
+    return VertexIterator<InternalIteratorType>(neighbours->end());
+  }
+
+  /**
+   * @brief Функция возвращает количество соседей.
+   */
+  size_t size() const {
+    return neighbours->size();
+  }
+
+  /**
+   * @brief Функция возвращает true, если соседей нет.
+   */
+  bool empty() const {
+    return neighbours->empty();
+  }
+
+  /**
+   * @brief Функция возвращает 1, если вершина является соседом, и 0 иначе.
+   *
+   * @param id Номер вершины.
+   */
+  size_t count(size_t id) const {
+    return neighbours->count(id);
+  }
+};
+
+/**
+ * @brief Итератор по отрезку номеров вершин [begin, end).
+ *
+ * Используется в графах, в которых вершины пронумерованы подряд числами
+ * от 0 до N - 1, например, в graph::CsrGraph.
+ */
+class IndexIterator {
+ private:
+  //! Текущий номер.
+  size_t pos;
+
+ public:
+  /**
+   * @brief Функция создаёт итератор из текущего номера.
+   * @param pos Текущий номер.
+   */
+  explicit IndexIterator(size_t pos) :
+    pos(pos) {
+  }
+
+  /**
+   * @brief Оператор сравнения == для итератора.
+   * @param other Другой итератор.
+   */
+  bool operator==(const IndexIterator& other) const {
+    return pos == other.pos;
+  }
+
+  /**
+   * @brief Оператор сравнения != для итератора.
+   * @param other Другой итератор.
+   */
+  bool operator!=(const IndexIterator& other) const {
+    return pos != other.pos;
+  }
+
+  /**
+   * @brief Префиксная операция инкремента для итератора.
+   */
+  IndexIterator& operator++() {
+    pos++;
+    return *this;
+  }
+
+  /**
+   * @brief Постфиксная операция инкремента для итератора.
+   */
+  IndexIterator operator++(int) {
+    IndexIterator retval(*this);
+    pos++;
+    return retval;
+  }
+
+  /**
+   * @brief Функция возвращает номер вершины, на которую
+   *        в данный момент указывает итератор.
+   */
+  size_t operator*() const {
+    return pos;
+  }
+};
+
+/**
+ * @brief Класс-адаптер для перебора номеров 0, 1, ..., N - 1 в циклах
+ *        range-based for.
+ */
+class IndicesRange {
+ private:
+  //! Итератор на первую вершину.
+  IndexIterator beginIt;
+  //! Итератор на вершину "после последней".
+  IndexIterator endIt;
+
+ public:
+  /**
+   * @brief Конструктор класса.
+   * @param first Номер первой вершины.
+   * @param last Номер вершины "после последней".
+   */
+  IndicesRange(size_t first, size_t last) :
+    beginIt(first),
+    endIt(last) {
+  }
+
+  /**
+   * @brief Возвращает итератор на первую вершину.
+   */
+  IndexIterator begin() const {
     return beginIt;
   }
 
   /**
    * @brief Возвращает итератор на вершину "после последней".
    */
-  VertexIterator end() const {
+  IndexIterator end() const {
     return endIt;
   }
 };
 
+/**
+ * @brief Непрерывный отрезок памяти, доступный только для чтения.
+ *
+ * @tparam T Тип элементов.
+ *
+ * Упрощённый аналог std::span из C++20. Класс не владеет памятью, поэтому
+ * он остаётся корректным только пока жив объект, которому принадлежат данные.
+ */
+template<typename T>
+class Span {
+ private:
+  //! Указатель на первый элемент.
+  const T* first;
+  //! Указатель на элемент "после последнего".
+  const T* last;
+
+ public:
+  /**
+   * @brief Конструктор класса.
+   * @param first Указатель на первый элемент.
+   * @param last Указатель на элемент "после последнего".
+   */
+  Span(const T* first, const T* last) :
+    first(first),
+    last(last) {
+  }
+
+  /**
+   * @brief Возвращает указатель на первый элемент.
+   */
+  const T* begin() const {
+    return first;
+  }
+
+  /**
+   * @brief Возвращает указатель на элемент "после последнего".
+   */
+  const T* end() const {
+    return last;
+  }
+
+  /**
+   * @brief Возвращает указатель на начало данных.
+   */
+  const T* data() const {
+    return first;
+  }
+
+  /**
+   * @brief Возвращает количество элементов.
+   */
+  size_t size() const {
+    return static_cast<size_t>(last - first);
+  }
+
+  /**
+   * @brief Функция возвращает true, если отрезок пуст.
+   */
+  bool empty() const {
+    return first == last;
+  }
+
+  /**
+   * @brief Доступ к элементу по номеру без проверки границ.
+   * @param i Номер элемента.
+   */
+  const T& operator[](size_t i) const {
+    return first[i];
+  }
+
+  /**
+   * @brief Последний элемент. Отрезок не должен быть пустым.
+   */
+  const T& back() const {
+    return last[-1];
+  }
+};
+
 }  // namespace graph
 
 #endif  // INCLUDE_ITERATORS_HPP_
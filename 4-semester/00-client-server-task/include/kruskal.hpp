@@ -0,0 +1,298 @@
+/**
+ * @file kruskal.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация алгоритма Краскала и его варианта filter-Kruskal.
+ */
+
+#ifndef INCLUDE_KRUSKAL_HPP_
+#define INCLUDE_KRUSKAL_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <disjoint_set.hpp>
+#include <radix_sort.hpp>
+#include <trace.hpp>
+#include <weighted_csr_graph.hpp>
+
+namespace graph {
+
+/**
+ * @brief Ребро остовного леса.
+ *
+ * @tparam Weight Тип веса.
+ */
+template<typename Weight>
+struct MstEdge {
+  //! Первая вершина.
+  size_t start;
+  //! Вторая вершина.
+  size_t end;
+  //! Вес ребра.
+  Weight weight;
+};
+
+/**
+ * @brief Выписать рёбра неориентированного графа в плоский массив.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param graph Снимок неориентированного графа: каждое ребро хранится
+ * в нём дважды.
+ * @param edges Вектор, в который записываются рёбра (U, V) с U < V во
+ * внутренней нумерации. Петли пропускаются.
+ */
+template<typename Weight>
+void ExtractEdges(const WeightedCsrGraph<Weight>& graph,
+                  std::vector<MstEdge<Weight>>* edges) {
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  Span<Weight> weights = graph.Weights();
+
+  edges->clear();
+  edges->reserve(graph.NumEdges() / 2);
+
+  for (size_t vertex = 0; vertex < graph.NumVertices(); vertex++) {
+    // Концы рёбер в снимке упорядочены, поэтому рёбра с targets[k] > vertex
+    // идут в конце списка.
+    size_t k = std::upper_bound(targets.begin() + offsets[vertex],
+                                targets.begin() + offsets[vertex + 1],
+                                vertex) - targets.begin();
+
+    for (; k < offsets[vertex + 1]; k++) {
+      edges->push_back(MstEdge<Weight>{vertex, targets[k], weights[k]});
+    }
+  }
+}
+
+/**
+ * @brief Отсортировать рёбра по возрастанию весов.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param first Указатель на первое ребро.
+ * @param last Указатель за последним ребром.
+ * @param numThreads Число потоков.
+ *
+ * Целые веса и веса типов float и double сортируются параллельной
+ * поразрядной сортировкой (@sa RadixSort()), остальные --- функцией
+ * std::stable_sort(). Обе сортировки устойчивы, поэтому результат не
+ * зависит от выбора.
+ */
+template<typename Weight>
+void SortEdges(MstEdge<Weight>* first, MstEdge<Weight>* last,
+               size_t numThreads) {
+  if constexpr (HasRadixKey<Weight>()) {
+    // Маленькие массивы быстрее сортировать сравнениями.
+    const size_t minRadixSize = 1024;
+
+    if (static_cast<size_t>(last - first) >= minRadixSize) {
+      RadixSort(first, last - first, [](const MstEdge<Weight>& edge) {
+        return RadixKey(edge.weight);
+      }, numThreads);
+
+      return;
+    }
+  }
+
+  std::stable_sort(first, last, [](const MstEdge<Weight>& edge1,
+                                   const MstEdge<Weight>& edge2) {
+    return edge1.weight < edge2.weight;
+  });
+}
+
+/**
+ * @brief Добавить в лес рёбра, соединяющие разные компоненты.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param first Указатель на первое ребро (рёбра упорядочены по весу).
+ * @param last Указатель за последним ребром.
+ * @param components Компоненты связности леса.
+ * @param forest Остовный лес.
+ * @param meter Счётчик процессорного времени алгоритма.
+ */
+template<typename Weight>
+void JoinComponents(const MstEdge<Weight>* first, const MstEdge<Weight>* last,
+                    DisjointSet* components,
+                    std::vector<MstEdge<Weight>>* forest, CpuMeter* meter) {
+  for (; first != last; ++first) {
+    // Остовное дерево уже построено.
+    if (forest->size() + 1 >= components->Size()) {
+      return;
+    }
+
+    meter->Tick();
+
+    if (components->Union(first->start, first->end)) {
+      forest->push_back(*first);
+    }
+  }
+}
+
+/**
+ * @brief Алгоритм Краскала на CSR снимке.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param graph Снимок неориентированного графа.
+ * @param numThreads Число потоков для сортировки рёбер.
+ * @param forest Вектор, в который записываются рёбра минимального
+ * остовного леса во внутренней нумерации по возрастанию весов.
+ *
+ * Рёбра выписываются в плоский массив, сортируются по весу и добавляются
+ * в лес, если соединяют разные компоненты (@sa DisjointSet). Время работы
+ * O(|E| log |E|) для сортировки сравнениями и O(|E|) для поразрядной.
+ */
+template<typename Weight>
+void Kruskal(const WeightedCsrGraph<Weight>& graph, size_t numThreads,
+             std::vector<MstEdge<Weight>>* forest) {
+  std::vector<MstEdge<Weight>> edges;
+  DisjointSet components(graph.NumVertices());
+  CpuMeter meter(CpuBudget::Current());
+
+  ExtractEdges(graph, &edges);
+  SortEdges(edges.data(), edges.data() + edges.size(), numThreads);
+
+  forest->clear();
+  JoinComponents(edges.data(), edges.data() + edges.size(), &components,
+                 forest, &meter);
+}
+
+/**
+ * @brief Шаг алгоритма filter-Kruskal для части массива рёбер.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param first Указатель на первое ребро.
+ * @param last Указатель за последним ребром.
+ * @param numThreads Число потоков для сортировки рёбер.
+ * @param components Компоненты связности леса.
+ * @param forest Остовный лес.
+ * @param meter Счётчик процессорного времени алгоритма.
+ */
+template<typename Weight>
+void FilterKruskalStep(MstEdge<Weight>* first, MstEdge<Weight>* last,
+                       size_t numThreads, DisjointSet* components,
+                       std::vector<MstEdge<Weight>>* forest,
+                       CpuMeter* meter) {
+  // Число рёбер, при котором часть массива просто сортируется.
+  const size_t minSize = std::max<size_t>(components->Size(), 1024);
+  // Число рёбер в выборке для выбора опорного веса.
+  const size_t sampleSize = 63;
+  size_t size = last - first;
+
+  if (forest->size() + 1 >= components->Size()) {
+    return;
+  }
+
+  // Разбиение и сортировка части стоят O(size).
+  meter->Tick(size);
+
+  if (size <= minSize) {
+    SortEdges(first, last, numThreads);
+    JoinComponents(first, last, components, forest, meter);
+    return;
+  }
+
+  // Опорный вес --- медиана равномерной выборки.
+  std::vector<Weight> sample(sampleSize);
+
+  for (size_t i = 0; i < sampleSize; i++) {
+    sample[i] = first[size / sampleSize * i].weight;
+  }
+
+  std::nth_element(sample.begin(), sample.begin() + sampleSize / 2,
+                   sample.end());
+
+  Weight pivot = sample[sampleSize / 2];
+  MstEdge<Weight>* middle = std::partition(
+      first, last, [pivot](const MstEdge<Weight>& edge) {
+        return !(pivot < edge.weight);
+      });
+
+  // Все веса не больше опорного: разбиение ничего не даёт.
+  if (middle == last) {
+    SortEdges(first, last, numThreads);
+    JoinComponents(first, last, components, forest, meter);
+    return;
+  }
+
+  FilterKruskalStep(first, middle, numThreads, components, forest, meter);
+
+  // Тяжёлые рёбра внутри одной компоненты уже не попадут в лес.
+  last = std::remove_if(middle, last,
+                        [components](const MstEdge<Weight>& edge) {
+    return components->Find(edge.start) == components->Find(edge.end);
+  });
+
+  FilterKruskalStep(middle, last, numThreads, components, forest, meter);
+}
+
+/**
+ * @brief Алгоритм filter-Kruskal на CSR снимке.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param graph Снимок неориентированного графа.
+ * @param numThreads Число потоков для сортировки рёбер.
+ * @param forest Вектор, в который записываются рёбра минимального
+ * остовного леса во внутренней нумерации по возрастанию весов.
+ *
+ * Рёбра делятся по опорному весу на лёгкие и тяжёлые, как в быстрой
+ * сортировке. Сначала рекурсивно обрабатываются лёгкие рёбра, затем из
+ * тяжёлых выбрасываются рёбра, концы которых уже в одной компоненте,
+ * и обрабатывается остаток. На плотных графах большая часть тяжёлых рёбер
+ * отбрасывается без сортировки, а когда лес становится деревом, алгоритм
+ * останавливается.
+ */
+template<typename Weight>
+void FilterKruskal(const WeightedCsrGraph<Weight>& graph, size_t numThreads,
+                   std::vector<MstEdge<Weight>>* forest) {
+  std::vector<MstEdge<Weight>> edges;
+  DisjointSet components(graph.NumVertices());
+  CpuMeter meter(CpuBudget::Current());
+
+  ExtractEdges(graph, &edges);
+
+  forest->clear();
+  FilterKruskalStep(edges.data(), edges.data() + edges.size(), numThreads,
+                    &components, forest, &meter);
+}
+
+/**
+ * @brief Минимальный остовный лес графа алгоритмом Краскала.
+ *
+ * @tparam GraphType Тип графа: graph::WeightedGraph или любой другой класс
+ * неориентированного графа с методами Vertices(), HasVertex(), Edges()
+ * и EdgeWeight().
+ *
+ * @param graph Исходный граф.
+ * @param filter Использовать ли вариант filter-Kruskal.
+ * @param numThreads Число потоков для сортировки рёбер.
+ * @param forest Вектор, в который записываются рёбра минимального
+ * остовного леса с исходными номерами вершин по возрастанию весов.
+ */
+template<typename GraphType>
+void Kruskal(const GraphType& graph, bool filter, size_t numThreads,
+             std::vector<MstEdge<typename GraphType::WeightType>>* forest) {
+  using Weight = typename GraphType::WeightType;
+
+  WeightedCsrGraph<Weight> snapshot(graph);
+
+  if (filter) {
+    FilterKruskal(snapshot, numThreads, forest);
+  } else {
+    Kruskal(snapshot, numThreads, forest);
+  }
+
+  for (MstEdge<Weight>& edge : *forest) {
+    edge.start = snapshot.ExternalId(edge.start);
+    edge.end = snapshot.ExternalId(edge.end);
+  }
+}
+
+}  // namespace graph
+
+#endif  // INCLUDE_KRUSKAL_HPP_
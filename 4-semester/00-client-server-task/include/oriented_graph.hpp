@@ -8,21 +8,36 @@
 #ifndef INCLUDE_ORIENTED_GRAPH_HPP_
 #define INCLUDE_ORIENTED_GRAPH_HPP_
 
-#include <unordered_map>
-#include <unordered_set>
+#include <graph_storage.hpp>
 #include <iterators.hpp>
 
 namespace graph {
 
+class GraphBuilder;
+
 /**
  * @brief Простой ориентированный граф.
+ *
+ * @tparam Storage Политика хранения списков смежности: graph::SmallStorage
+ * (по умолчанию), graph::HashStorage, graph::FlatStorage или
+ * graph::CompactStorage (@sa graph_storage.hpp).
  */
-class OrientedGraph {
+template<typename Storage = SmallStorage>
+class BasicOrientedGraph {
  public:
+  //! Тип, в котором хранятся номера вершин.
+  using Id = typename Storage::Id;
+
+  //! Тип множества соседей вершины.
+  using NeighbourSet = typename Storage::Set;
+
+  //! Тип словаря смежности.
+  using AdjacencyMap = typename Storage::template Map<NeighbourSet>;
+
   /**
-   * @brief Конструктор класса OrientedGraph.
+   * @brief Конструктор класса BasicOrientedGraph.
    */
-  OrientedGraph() {
+  BasicOrientedGraph() {
   }
 
   /**
@@ -48,6 +63,10 @@ class OrientedGraph {
    * в граф. Если такое ребро в графе уже есть, то функция ничего не делает.
    */
   void AddEdge(size_t id1, size_t id2) {
+    // Номера проверяются до изменения графа (@sa CompactStorage).
+    NarrowId<Id>(id1);
+    NarrowId<Id>(id2);
+
     edges[id1].insert(id2);
     incomingEdges[id2].insert(id1);
   }
@@ -80,7 +99,7 @@ class OrientedGraph {
       return false;
     }
 
-    return it->second.find(id2) != it->second.end();
+    return it->second.count(id2) > 0;
   }
 
   /**
@@ -141,12 +160,12 @@ class OrientedGraph {
    *
    * @param id Номер вершины.
    *
-   * Функция возвращает множество вершин в виде хеш-таблицы, с которыми
+   * Функция возвращает множество вершин NeighbourSet, с которыми
    * соединена вершина id, то есть множество таких вершин V, что ребро (id, V)
    * присутствует в графе. Если указанной вершини в графе нет, то функция
    * выбрасывает исключение std::out_of_range.
    */
-  const std::unordered_set<size_t>& Edges(size_t id) const {
+  const NeighbourSet& Edges(size_t id) const {
     return edges.at(id);
   }
 
@@ -155,12 +174,12 @@ class OrientedGraph {
    *
    * @param id Номер вершины.
    *
-   * Функция возвращает множество вершин в виде хеш-таблицы, соединённых
+   * Функция возвращает множество вершин NeighbourSet, соединённых
    * с вершиной id, то есть множество таких вершин V, что ребро (V, id)
    * присутствует в графе. Если указанной вершини в графе нет, то функция
    * выбрасывает исключение std::out_of_range.
    */
-  const std::unordered_set<size_t>& IncomingEdges(size_t id) const {
+  const NeighbourSet& IncomingEdges(size_t id) const {
     return incomingEdges.at(id);
   }
 
@@ -170,8 +189,22 @@ class OrientedGraph {
    * Функция возвращает специальный класс-промежуток, по которому
    * можно проитерироваться при помощи цикла range-base for.
    */
-  VerticesRange Vertices() const {
-    return VerticesRange(edges.begin(), edges.end());
+  VerticesRange<typename AdjacencyMap::const_iterator> Vertices() const {
+    return { edges.begin(), edges.end() };
+  }
+
+  /**
+   * @brief Зарезервировать место для вершин.
+   *
+   * @param numVertices Ожидаемое число вершин.
+   *
+   * Функция заранее выделяет память под словарь вершин, чтобы при
+   * добавлении вершин не происходило перехеширование. Для добавления
+   * большого числа рёбер удобнее использовать graph::GraphBuilder.
+   */
+  void Reserve(size_t numVertices) {
+    edges.reserve(numVertices);
+    incomingEdges.reserve(numVertices);
   }
 
   /**
@@ -182,13 +215,25 @@ class OrientedGraph {
   }
 
  private:
+  //! Класс для пакетного построения графа.
+  friend class GraphBuilder;
+
   //! Разреженная матрица связности. Словарь исходящих рёбер.
-  std::unordered_map<size_t, std::unordered_set<size_t>> edges;
+  AdjacencyMap edges;
 
   //! Разреженная матрица связности. Словарь входящих рёбер.
-  std::unordered_map<size_t, std::unordered_set<size_t>> incomingEdges;
+  AdjacencyMap incomingEdges;
 };
 
+//! Ориентированный граф (@sa SmallStorage).
+using OrientedGraph = BasicOrientedGraph<SmallStorage>;
+
+//! Ориентированный граф в компактном представлении (@sa FlatStorage).
+using FlatOrientedGraph = BasicOrientedGraph<FlatStorage>;
+
+//! Ориентированный граф с 32-битными номерами вершин (@sa CompactStorage).
+using CompactOrientedGraph = BasicOrientedGraph<CompactStorage>;
+
 }  // namespace graph
 
 #endif  // INCLUDE_ORIENTED_GRAPH_HPP_
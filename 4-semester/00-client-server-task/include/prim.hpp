@@ -0,0 +1,327 @@
+/**
+ * @file prim.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация алгоритма Прима.
+ */
+
+#ifndef INCLUDE_PRIM_HPP_
+#define INCLUDE_PRIM_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <dijkstra.hpp>
+#include <heaps.hpp>
+#include <kruskal.hpp>
+#include <trace.hpp>
+#include <weighted_csr_graph.hpp>
+
+namespace graph {
+
+/**
+ * @brief Вариант алгоритма Прима.
+ */
+enum class PrimStrategy {
+  //! Выбор между Indexed и Dense по плотности графа (@sa IsDense()).
+  Auto,
+  //! Индексированная куча с уменьшением ключа.
+  Indexed,
+  //! Куча без уменьшения ключа с пропуском устаревших записей.
+  Lazy,
+  //! Массив ключей и поиск минимума перебором за O(|V|).
+  Dense
+};
+
+/**
+ * @brief Функция проверяет, выгоднее ли для графа вариант PrimStrategy::Dense.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param graph Снимок неориентированного графа.
+ *
+ * Вариант с кучей работает за O(|E| log |V|), перебор --- за O(|V|^2 + |E|),
+ * но перебор массива ключей намного дешевле операций с кучей. По
+ * измерениям graph_bench на 2000 вершинах куча быстрее при средней степени
+ * |V| / 8, а перебор --- при |V| / 2, поэтому порог выбран посередине.
+ */
+template<typename Weight>
+bool IsDense(const WeightedCsrGraph<Weight>& graph) {
+  size_t numVertices = graph.NumVertices();
+
+  // Снимок хранит каждое ребро дважды, поэтому NumEdges() равно сумме
+  // степеней.
+  return graph.NumEdges() * 4 > numVertices * numVertices;
+}
+
+/**
+ * @brief Алгоритм Прима с индексированной кучей на CSR снимке.
+ *
+ * @tparam Weight Тип веса.
+ * @tparam Heap Очередь с приоритетами, в которой Push() уменьшает ключ
+ * вершины (graph::DaryHeap или graph::PairingHeap).
+ *
+ * @param graph Снимок неориентированного графа.
+ * @param heap Очередь с приоритетами.
+ * @param forest Вектор, в который записываются рёбра минимального
+ * остовного леса во внутренней нумерации в порядке добавления.
+ *
+ * Дерево растёт от вершины 0. Ключ вершины вне дерева --- вес самого
+ * лёгкого ребра, соединяющего её с деревом. На каждом шаге в дерево
+ * добавляется вершина с минимальным ключом, и ключи её соседей
+ * уменьшаются. Когда очередь пуста, дерево строится заново от следующей
+ * вершины, не попавшей в лес.
+ */
+template<typename Weight, typename Heap>
+void Prim(const WeightedCsrGraph<Weight>& graph, Heap* heap,
+          std::vector<MstEdge<Weight>>* forest) {
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  Span<Weight> weights = graph.Weights();
+  size_t numVertices = graph.NumVertices();
+  std::vector<Weight> key(numVertices,
+                          ShortestPathTree<Weight>::Infinity());
+  std::vector<size_t> parent(numVertices, noVertex);
+  std::vector<bool> inTree(numVertices, false);
+  CpuMeter meter(CpuBudget::Current());
+
+  forest->clear();
+  heap->Reset(numVertices);
+
+  for (size_t root = 0; root < numVertices; root++) {
+    if (inTree[root]) {
+      continue;
+    }
+
+    heap->Push(root, Weight());
+
+    while (!heap->Empty()) {
+      size_t vertex = heap->Pop().first;
+
+      inTree[vertex] = true;
+      meter.Tick(offsets[vertex + 1] - offsets[vertex] + 1);
+
+      if (parent[vertex] != noVertex) {
+        forest->push_back(MstEdge<Weight>{parent[vertex], vertex,
+                                          key[vertex]});
+      }
+
+      for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+        size_t neighbour = targets[k];
+
+        if (!inTree[neighbour] && weights[k] < key[neighbour]) {
+          key[neighbour] = weights[k];
+          parent[neighbour] = vertex;
+          heap->Push(neighbour, weights[k]);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Алгоритм Прима с ленивым удалением на CSR снимке.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param graph Снимок неориентированного графа.
+ * @param forest Вектор, в который записываются рёбра минимального
+ * остовного леса во внутренней нумерации в порядке добавления.
+ *
+ * Вместо уменьшения ключа в двоичную кучу на массиве добавляется новая
+ * запись, а устаревшие записи (вершина уже в дереве или её ключ с тех
+ * пор уменьшился) пропускаются при извлечении. Куча не хранит позиции
+ * вершин, поэтому операции с ней проще, но она может вырасти до O(|E|)
+ * записей.
+ */
+template<typename Weight>
+void LazyPrim(const WeightedCsrGraph<Weight>& graph,
+              std::vector<MstEdge<Weight>>* forest) {
+  using Entry = std::pair<Weight, size_t>;
+
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  Span<Weight> weights = graph.Weights();
+  size_t numVertices = graph.NumVertices();
+  std::vector<Weight> key(numVertices,
+                          ShortestPathTree<Weight>::Infinity());
+  std::vector<size_t> parent(numVertices, noVertex);
+  std::vector<bool> inTree(numVertices, false);
+  std::vector<Entry> heap;
+  // Сравнение для кучи с минимумом в корне.
+  auto greater = [](const Entry& entry1, const Entry& entry2) {
+    return entry2.first < entry1.first;
+  };
+  CpuMeter meter(CpuBudget::Current());
+
+  forest->clear();
+
+  for (size_t root = 0; root < numVertices; root++) {
+    if (inTree[root]) {
+      continue;
+    }
+
+    heap.emplace_back(Weight(), root);
+
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end(), greater);
+
+      Entry top = heap.back();
+      size_t vertex = top.second;
+
+      heap.pop_back();
+
+      if (inTree[vertex] || key[vertex] < top.first) {
+        continue;
+      }
+
+      inTree[vertex] = true;
+      meter.Tick(offsets[vertex + 1] - offsets[vertex] + 1);
+
+      if (parent[vertex] != noVertex) {
+        forest->push_back(MstEdge<Weight>{parent[vertex], vertex,
+                                          key[vertex]});
+      }
+
+      for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+        size_t neighbour = targets[k];
+
+        if (!inTree[neighbour] && weights[k] < key[neighbour]) {
+          key[neighbour] = weights[k];
+          parent[neighbour] = vertex;
+          heap.emplace_back(weights[k], neighbour);
+          std::push_heap(heap.begin(), heap.end(), greater);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Алгоритм Прима для плотных графов на CSR снимке.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param graph Снимок неориентированного графа.
+ * @param forest Вектор, в который записываются рёбра минимального
+ * остовного леса во внутренней нумерации в порядке добавления.
+ *
+ * Ключи вершин хранятся в массиве, и вершина с минимальным ключом
+ * ищется последовательным перебором вершин вне дерева. Вершины дерева
+ * переносятся в конец массива кандидатов, поэтому каждый перебор
+ * короче предыдущего. Время работы O(|V|^2 + |E|) не зависит от числа
+ * уменьшений ключа.
+ */
+template<typename Weight>
+void DensePrim(const WeightedCsrGraph<Weight>& graph,
+               std::vector<MstEdge<Weight>>* forest) {
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  Span<Weight> weights = graph.Weights();
+  const Weight infinity = ShortestPathTree<Weight>::Infinity();
+  size_t numVertices = graph.NumVertices();
+  std::vector<Weight> key(numVertices, infinity);
+  std::vector<size_t> parent(numVertices, noVertex);
+  // Вершины вне дерева занимают первые numCandidates позиций.
+  std::vector<size_t> candidates(numVertices);
+  // Позиции вершин в массиве candidates.
+  std::vector<size_t> positions(numVertices);
+  size_t numCandidates = numVertices;
+  CpuMeter meter(CpuBudget::Current());
+
+  forest->clear();
+
+  for (size_t vertex = 0; vertex < numVertices; vertex++) {
+    candidates[vertex] = vertex;
+    positions[vertex] = vertex;
+  }
+
+  while (numCandidates > 0) {
+    // Если все ключи бесконечны, то дерево достроено, и новое дерево
+    // растёт от первого кандидата.
+    size_t best = 0;
+
+    meter.Tick(numCandidates);
+
+    for (size_t i = 1; i < numCandidates; i++) {
+      if (key[candidates[i]] < key[candidates[best]]) {
+        best = i;
+      }
+    }
+
+    size_t vertex = candidates[best];
+
+    numCandidates--;
+    std::swap(candidates[best], candidates[numCandidates]);
+    positions[candidates[best]] = best;
+    positions[vertex] = numCandidates;
+
+    if (parent[vertex] != noVertex) {
+      forest->push_back(MstEdge<Weight>{parent[vertex], vertex,
+                                        key[vertex]});
+    }
+
+    for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+      size_t neighbour = targets[k];
+
+      if (positions[neighbour] < numCandidates &&
+          weights[k] < key[neighbour]) {
+        key[neighbour] = weights[k];
+        parent[neighbour] = vertex;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Минимальный остовный лес графа алгоритмом Прима.
+ *
+ * @tparam GraphType Тип графа: graph::WeightedGraph или любой другой класс
+ * неориентированного графа с методами Vertices(), HasVertex(), Edges()
+ * и EdgeWeight().
+ *
+ * @param graph Исходный граф.
+ * @param strategy Вариант алгоритма.
+ * @param forest Вектор, в который записываются рёбра минимального
+ * остовного леса с исходными номерами вершин в порядке добавления.
+ *
+ * Вариант PrimStrategy::Indexed использует 4-арную кучу graph::DaryHeap.
+ */
+template<typename GraphType>
+void Prim(const GraphType& graph, PrimStrategy strategy,
+          std::vector<MstEdge<typename GraphType::WeightType>>* forest) {
+  using Weight = typename GraphType::WeightType;
+
+  WeightedCsrGraph<Weight> snapshot(graph);
+
+  if (strategy == PrimStrategy::Auto) {
+    strategy = IsDense(snapshot) ? PrimStrategy::Dense :
+                                   PrimStrategy::Indexed;
+  }
+
+  switch (strategy) {
+    case PrimStrategy::Auto:
+    case PrimStrategy::Indexed: {
+      QuaternaryHeap<Weight> heap;
+
+      Prim(snapshot, &heap, forest);
+      break;
+    }
+    case PrimStrategy::Lazy:
+      LazyPrim(snapshot, forest);
+      break;
+    case PrimStrategy::Dense:
+      DensePrim(snapshot, forest);
+      break;
+  }
+
+  for (MstEdge<Weight>& edge : *forest) {
+    edge.start = snapshot.ExternalId(edge.start);
+    edge.end = snapshot.ExternalId(edge.end);
+  }
+}
+
+}  // namespace graph
+
+#endif  // INCLUDE_PRIM_HPP_
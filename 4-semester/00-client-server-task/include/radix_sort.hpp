@@ -0,0 +1,207 @@
+/**
+ * @file radix_sort.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация параллельной поразрядной сортировки.
+ */
+
+#ifndef INCLUDE_RADIX_SORT_HPP_
+#define INCLUDE_RADIX_SORT_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <barrier.hpp>
+#include <trace.hpp>
+
+namespace graph {
+
+/**
+ * @brief Функция проверяет, можно ли сортировать числа типа Weight
+ *        поразрядно (@sa RadixKey()).
+ */
+template<typename Weight>
+constexpr bool HasRadixKey() {
+  return std::is_integral_v<Weight> || std::is_same_v<Weight, float> ||
+         std::is_same_v<Weight, double>;
+}
+
+/**
+ * @brief Преобразовать число в беззнаковый ключ с тем же порядком.
+ *
+ * @tparam Weight Целый тип, float или double.
+ *
+ * @param value Число.
+ *
+ * У знаковых целых инвертируется старший бит. У чисел с плавающей точкой
+ * в формате IEEE 754 у неотрицательных чисел инвертируется знаковый бит,
+ * у отрицательных --- все биты. Порядок ключей совпадает с порядком чисел
+ * (кроме NaN, а -0.0 оказывается меньше 0.0).
+ */
+template<typename Weight>
+auto RadixKey(Weight value) {
+  static_assert(HasRadixKey<Weight>(), "RadixKey(): unsupported type");
+
+  if constexpr (std::is_integral_v<Weight>) {
+    using Key = std::make_unsigned_t<Weight>;
+
+    if constexpr (std::is_signed_v<Weight>) {
+      return static_cast<Key>(static_cast<Key>(value) ^
+                              (Key(1) << (8 * sizeof(Key) - 1)));
+    } else {
+      return static_cast<Key>(value);
+    }
+  } else {
+    using Key = std::conditional_t<sizeof(Weight) == 4, uint32_t, uint64_t>;
+    const Key sign = Key(1) << (8 * sizeof(Key) - 1);
+    Key key;
+
+    std::memcpy(&key, &value, sizeof(key));
+
+    return (key & sign) ? static_cast<Key>(~key) : key | sign;
+  }
+}
+
+/**
+ * @brief Устойчивая параллельная поразрядная сортировка.
+ *
+ * @tparam T Тип элемента.
+ * @tparam KeyFunction Функция, которая возвращает беззнаковый целый ключ
+ * элемента.
+ *
+ * @param data Указатель на первый элемент.
+ * @param size Число элементов.
+ * @param key Функция ключа.
+ * @param numThreads Число потоков (не больше MaxThreads()).
+ *
+ * Сортировка идёт от младших разрядов к старшим по 8 бит за проход.
+ * Каждый поток считает гистограмму своего непрерывного блока, затем по
+ * гистограммам всех потоков вычисляет позиции своих элементов в выходном
+ * массиве и раскладывает их без синхронизации. Проход пропускается, если
+ * у всех ключей одинаковый разряд (например, старшие байты маленьких
+ * чисел), поэтому число проходов определяется разбросом ключей, а не
+ * шириной типа.
+ *
+ * Один поток считает гистограммы всех разрядов за одно чтение массива:
+ * проход меняет порядок элементов, но не гистограмму всего массива.
+ * У нескольких потоков после прохода в блоках оказываются другие
+ * элементы, поэтому гистограммы считаются заново на каждом проходе.
+ */
+template<typename T, typename KeyFunction>
+void RadixSort(T* data, size_t size, KeyFunction key, size_t numThreads) {
+  using Key = decltype(key(*data));
+  // Число значений одного разряда.
+  const size_t numDigits = 256;
+  // Число проходов (разрядов ключа).
+  const size_t numPasses = sizeof(Key);
+  // Минимальный размер блока одного потока.
+  const size_t minBlock = 1 << 16;
+
+  static_assert(std::is_unsigned_v<Key>, "RadixSort(): key must be unsigned");
+
+  numThreads = std::max<size_t>(
+      std::min({ numThreads, MaxThreads(), size / minBlock }), 1);
+
+  // Буфер не инициализируется: все элементы в него записываются.
+  std::unique_ptr<T[]> buffer(new T[size]);
+  // counts[t][pass] --- гистограмма разряда pass в блоке потока t.
+  std::vector<std::vector<std::array<size_t, numDigits>>> counts(
+      numThreads, std::vector<std::array<size_t, numDigits>>(numPasses));
+  Barrier barrier(numThreads);
+
+  auto worker = [&](size_t thread) {
+    size_t first = size * thread / numThreads;
+    size_t last = size * (thread + 1) / numThreads;
+    T* from = data;
+    T* to = buffer.get();
+    std::array<size_t, numDigits> position;
+
+    for (size_t pass = 0; pass < numPasses; pass++) {
+      if (numThreads > 1 || pass == 0) {
+        size_t lastPass = numThreads > 1 ? pass + 1 : numPasses;
+
+        for (size_t p = pass; p < lastPass; p++) {
+          counts[thread][p].fill(0);
+        }
+
+        for (size_t i = first; i < last; i++) {
+          Key value = key(from[i]);
+
+          for (size_t p = pass; p < lastPass; p++) {
+            counts[thread][p][(value >> (8 * p)) & (numDigits - 1)]++;
+          }
+        }
+
+        barrier.Wait();
+      }
+
+      // Позиция разряда d для потока: все элементы с меньшими разрядами
+      // плюс элементы с разрядом d из блоков предыдущих потоков.
+      size_t total = 0;
+      bool skip = false;
+
+      for (size_t digit = 0; digit < numDigits; digit++) {
+        size_t count = 0;
+
+        for (size_t t = 0; t < numThreads; t++) {
+          if (t == thread) {
+            position[digit] = total + count;
+          }
+
+          count += counts[t][pass][digit];
+        }
+
+        skip = skip || count == size;
+        total += count;
+      }
+
+      if (!skip) {
+        for (size_t i = first; i < last; i++) {
+          size_t digit = (key(from[i]) >> (8 * pass)) & (numDigits - 1);
+
+          to[position[digit]++] = std::move(from[i]);
+        }
+
+        std::swap(from, to);
+      }
+
+      // Гистограммы снова пишутся только после того, как все потоки
+      // прочитали их и разложили свои элементы.
+      barrier.Wait();
+    }
+
+    if (from != data) {
+      std::move(from + first, from + last, data + first);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  CpuBudget* budget = CpuBudget::Current();
+
+  // Сортировка не прерывается, но время дополнительных потоков
+  // списывается с ограничения вызывающего потока (@sa CpuBudget).
+  for (size_t t = 1; t < numThreads; t++) {
+    threads.emplace_back([&worker, budget](size_t thread) {
+      CpuMeter meter(budget);
+
+      worker(thread);
+    }, t);
+  }
+
+  worker(0);
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace graph
+
+#endif  // INCLUDE_RADIX_SORT_HPP_
@@ -0,0 +1,917 @@
+/**
+ * @file scc.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация алгоритмов поиска компонент сильной связности: нерекурсивного
+ * алгоритма Тарьяна и параллельного алгоритма forward-backward.
+ */
+
+#ifndef INCLUDE_SCC_HPP_
+#define INCLUDE_SCC_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <barrier.hpp>
+#include <csr_graph.hpp>
+#include <trace.hpp>
+
+namespace graph {
+
+/**
+ * @brief Алгоритм поиска компонент сильной связности.
+ */
+enum class SccAlgorithm {
+  //! Последовательный алгоритм Тарьяна (@sa TarjanScc()).
+  Tarjan,
+  //! Параллельный алгоритм forward-backward (@sa ForwardBackwardScc()).
+  ForwardBackward
+};
+
+/**
+ * @brief Нерекурсивный обход в глубину алгоритма Тарьяна.
+ *
+ * Массивы номеров вершин в порядке обхода (index) и минимальных номеров,
+ * достижимых из поддерева (lowlink), принадлежат вызывающей стороне:
+ * параллельный алгоритм запускает по объекту на поток над общими
+ * массивами, и потоки обходят непересекающиеся части графа.
+ */
+class TarjanSearch {
+ public:
+  //! Значение index для непосещённой вершины.
+  static constexpr size_t unvisited = std::numeric_limits<size_t>::max();
+
+  //! Значение index для вершины, компонента которой уже найдена.
+  static constexpr size_t finished = unvisited - 1;
+
+  /**
+   * @brief Конструктор класса TarjanSearch.
+   *
+   * @param graph Граф в формате CSR.
+   * @param index Массив из NumVertices() элементов, заполненный значением
+   * unvisited.
+   * @param lowlink Массив из NumVertices() элементов.
+   * @param meter Счётчик процессорного времени или нулевой указатель.
+   * Со счётчиком обход выбрасывает исключение graph::BudgetExceeded, если
+   * ограничение исчерпано.
+   */
+  TarjanSearch(const CsrGraph& graph, size_t* index, size_t* lowlink,
+               CpuMeter* meter = nullptr) :
+    graph(graph),
+    index(index),
+    lowlink(lowlink),
+    meter(meter),
+    counter(0) {
+  }
+
+  /**
+   * @brief Найти компоненты, достижимые из вершины.
+   *
+   * @tparam Inside Тип предиката inside.
+   * @tparam Found Тип функции found.
+   * @tparam Tracer Политика трассировки (@sa trace.hpp).
+   *
+   * @param root Вершина, с которой начинается обход. Если она уже
+   * посещена, то функция ничего не делает.
+   * @param inside Предикат: рёбра в вершины w, для которых inside(w) ложно,
+   * пропускаются. Так алгоритм работает на подграфе.
+   * @param found Функция, которая вызывается для каждой найденной
+   * компоненты с аргументами first и last: вершины компоненты занимают
+   * отрезок [first, last), и *first --- корень компоненты в дереве обхода.
+   * @param tracer Объект политики трассировки.
+   *
+   * Компоненты находятся в порядке, обратном топологическому порядку
+   * конденсации: когда компонента найдена, все компоненты, в которые из
+   * неё ведут рёбра, уже найдены.
+   */
+  template<typename Inside, typename Found, typename Tracer = NullTracer>
+  void Visit(size_t root, Inside inside, Found found,
+             Tracer* tracer = nullptr) {
+    Span<size_t> offsets = graph.Offsets();
+    Span<size_t> targets = graph.Targets();
+
+    if (index[root] != unvisited) {
+      return;
+    }
+
+    Enter(root, tracer);
+
+    while (!stack.empty()) {
+      size_t vertex = stack.back().first;
+      size_t& next = stack.back().second;
+
+      if (meter) {
+        meter->Tick();
+      }
+
+      if (next != offsets[vertex + 1]) {
+        size_t destination = targets[next++];
+
+        Trace(tracer, TraceEvent::ExamineEdge, vertex, destination);
+
+        if (!inside(destination)) {
+          continue;
+        }
+
+        if (index[destination] == unvisited) {
+          Enter(destination, tracer);
+        } else if (index[destination] != finished) {
+          lowlink[vertex] = std::min(lowlink[vertex], index[destination]);
+        }
+
+        continue;
+      }
+
+      stack.pop_back();
+
+      if (!stack.empty()) {
+        size_t parent = stack.back().first;
+
+        lowlink[parent] = std::min(lowlink[parent], lowlink[vertex]);
+      }
+
+      Trace(tracer, TraceEvent::FinishVertex, vertex);
+
+      if (lowlink[vertex] != index[vertex]) {
+        continue;
+      }
+
+      size_t first = path.size();
+
+      do {
+        first--;
+        index[path[first]] = finished;
+      } while (path[first] != vertex);
+
+      found(path.data() + first, path.data() + path.size());
+      path.resize(first);
+    }
+  }
+
+ private:
+  /**
+   * @brief Положить вершину на оба стека.
+   */
+  template<typename Tracer>
+  void Enter(size_t vertex, Tracer* tracer) {
+    index[vertex] = counter;
+    lowlink[vertex] = counter;
+    counter++;
+    stack.emplace_back(vertex, graph.Offsets()[vertex]);
+    path.push_back(vertex);
+    Trace(tracer, TraceEvent::EnterVertex, vertex);
+  }
+
+  //! Граф.
+  const CsrGraph& graph;
+
+  //! Номера вершин в порядке обхода.
+  size_t* index;
+
+  //! Минимальные номера, достижимые из поддеревьев вершин.
+  size_t* lowlink;
+
+  //! Счётчик процессорного времени или нулевой указатель.
+  CpuMeter* meter;
+
+  //! Следующий номер в порядке обхода.
+  size_t counter;
+
+  //! Явный стек обхода: пары (вершина, позиция следующего ребра).
+  std::vector<std::pair<size_t, size_t>> stack;
+
+  //! Вершины, ещё не отнесённые к найденным компонентам.
+  std::vector<size_t> path;
+};
+
+/**
+ * @brief Компоненты сильной связности нерекурсивным алгоритмом Тарьяна.
+ *
+ * @tparam Tracer Политика трассировки (@sa trace.hpp).
+ *
+ * @param graph Граф в формате CSR.
+ * @param component Вектор, в который записывается номер компоненты каждой
+ * вершины.
+ * @param tracer Объект политики трассировки.
+ *
+ * @return Функция возвращает число компонент.
+ *
+ * Компоненты пронумерованы в топологическом порядке конденсации: для
+ * любого ребра (U, V) номер компоненты U не больше номера компоненты V.
+ * Время работы O(|V| + |E|), обход выполняется на явном стеке.
+ */
+template<typename Tracer = NullTracer>
+size_t TarjanScc(const CsrGraph& graph, std::vector<size_t>* component,
+                 Tracer* tracer = nullptr) {
+  std::vector<size_t> index(graph.NumVertices(), TarjanSearch::unvisited);
+  std::vector<size_t> lowlink(graph.NumVertices());
+  CpuMeter meter(CpuBudget::Current());
+  TarjanSearch search(graph, index.data(), lowlink.data(), &meter);
+  size_t numComponents = 0;
+
+  component->resize(graph.NumVertices());
+
+  for (size_t root : graph.Vertices()) {
+    search.Visit(root, [](size_t) { return true; },
+                 [&](const size_t* first, const size_t* last) {
+      for (; first != last; ++first) {
+        (*component)[*first] = numComponents;
+      }
+
+      numComponents++;
+    }, tracer);
+  }
+
+  // Тарьян находит компоненты от стоков к истокам.
+  for (size_t& number : *component) {
+    number = numComponents - 1 - number;
+  }
+
+  return numComponents;
+}
+
+/**
+ * @brief Параллельный поиск компонент сильной связности алгоритмом
+ *        forward-backward.
+ *
+ * @param graph Граф в формате CSR.
+ * @param reverse Тот же граф с обращёнными рёбрами
+ * (@sa CsrGraph::AssignTranspose()).
+ * @param numThreads Число потоков (не больше MaxThreads()).
+ * @param component Вектор, в который записывается номер компоненты каждой
+ * вершины.
+ *
+ * @return Функция возвращает число компонент.
+ *
+ * Номера компонент не упорядочены топологически, для этого используется
+ * функция SortComponents().
+ *
+ * Алгоритм следует схеме Хонга, Родиа и Олукотуна (2013) и состоит из трёх
+ * фаз.
+ * 1. Отсечение: вершина без входящих или без исходящих рёбер внутри
+ *    оставшегося графа образует отдельную компоненту. Потоки делят вершины
+ *    поровну, отсечение повторяется несколько раз.
+ * 2. Большая компонента: из вершины с наибольшим произведением степеней
+ *    запускаются параллельные поиски в ширину по прямым и по обращённым
+ *    рёбрам. Пересечение достигнутых множеств --- компонента этой вершины,
+ *    а остальные вершины делятся на три части (только прямой поиск, только
+ *    обратный, ни один), каждая из которых состоит из целых компонент.
+ * 3. Части обрабатываются пулом задач. Большая часть делится
+ *    последовательным forward-backward на новые части, маленькая или
+ *    плохо поделившаяся (больше 7/8 исходной) передаётся алгоритму Тарьяна
+ *    на подграфе, поэтому общее время остаётся почти линейным.
+ *
+ * Части различаются цветами вершин: компонента каждой части лежит внутри
+ * неё, и потоки не пишут в вершины чужих частей.
+ *
+ * Ограничение процессорного времени (@sa CpuBudget) проверяется после
+ * каждого шага поиска в ширину и каждой задачи третьей фазы. Если оно
+ * превышено, то потоки завершаются и выбрасывается исключение
+ * graph::BudgetExceeded.
+ */
+inline size_t ForwardBackwardScc(const CsrGraph& graph,
+                                 const CsrGraph& reverse, size_t numThreads,
+                                 std::vector<size_t>* component) {
+  // Число раундов отсечения.
+  const size_t numTrimRounds = 3;
+  // Части не больше этого размера сразу передаются алгоритму Тарьяна.
+  const size_t minSplitSize = 1024;
+  // Цвет вершины, компонента которой уже найдена.
+  const size_t assigned = std::numeric_limits<size_t>::max();
+  // Биты массива reached: вершина достигнута прямым или обратным поиском.
+  const unsigned char forwardBit = 1;
+  const unsigned char backwardBit = 2;
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  Span<size_t> reverseOffsets = reverse.Offsets();
+  Span<size_t> reverseTargets = reverse.Targets();
+  size_t numVertices = graph.NumVertices();
+
+  numThreads = std::max<size_t>(
+      std::min({ numThreads, MaxThreads(), numVertices }), 1);
+
+  /**
+   * @brief Часть графа, которая обрабатывается одной задачей.
+   */
+  struct Task {
+    //! Вершины части.
+    std::vector<size_t> vertices;
+    //! Цвет вершин части.
+    size_t color;
+    //! Признак того, что часть можно делить forward-backward.
+    bool split;
+  };
+
+  // Цвет вершины: номер части или assigned. До третьей фазы цвет всех
+  // оставшихся вершин равен нулю, цвета 1, 2 и 3 --- части второй фазы.
+  std::vector<std::atomic<size_t>> color(numVertices);
+  std::atomic<size_t> nextColor(4);
+  std::vector<std::atomic<unsigned char>> reached(numVertices);
+  // Рабочие массивы алгоритма Тарьяна, общие для всех потоков.
+  std::vector<size_t> index(numVertices, TarjanSearch::unvisited);
+  std::vector<size_t> lowlink(numVertices);
+  // Фронт поиска в ширину и вершины нового фронта у каждого потока.
+  std::vector<size_t> frontier;
+  std::vector<std::vector<size_t>> found(numThreads);
+  std::vector<size_t> positions(numThreads);
+  // Счётчики потоков и лучшие кандидаты в опорные вершины.
+  std::vector<size_t> counts(numThreads);
+  std::vector<std::pair<size_t, size_t>> candidates(numThreads);
+  Barrier barrier(numThreads);
+  // Состояние, которое меняет только поток 0 между барьерами.
+  bool stop = false;
+  // Алгоритм прерван по ограничению процессорного времени. В третьей фазе
+  // признак меняется под блокировкой mutex.
+  bool aborted = false;
+  CpuBudget* budget = CpuBudget::Current();
+  size_t pivot = 0;
+  size_t numComponents = 0;
+  // Пул задач третьей фазы. Счётчик pending учитывает задачи в очереди
+  // и задачи, которые выполняются.
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::vector<Task> tasks;
+  size_t pending = 0;
+
+  // Каждая компонента обозначается на время работы одной из своих вершин
+  // (представителем), в конце представители нумеруются подряд.
+  component->resize(numVertices);
+
+  // Проверить, есть ли у вершины ребро в другую оставшуюся вершину.
+  auto hasLiveEdge = [&](Span<size_t> edgeOffsets,
+                         Span<size_t> edgeTargets,
+                         size_t vertex) {
+    for (size_t k = edgeOffsets[vertex]; k < edgeOffsets[vertex + 1]; k++) {
+      size_t neighbour = edgeTargets[k];
+
+      if (neighbour != vertex &&
+          color[neighbour].load(std::memory_order_relaxed) == 0) {
+        return true;
+      }
+    }
+
+    return false;
+  };
+
+  // Собрать вершины found всех потоков в массив frontier.
+  auto gather = [&](size_t thread) {
+    barrier.Wait();
+
+    if (thread == 0) {
+      size_t total = 0;
+
+      for (size_t t = 0; t < numThreads; t++) {
+        positions[t] = total;
+        total += found[t].size();
+      }
+
+      frontier.resize(total);
+      aborted = budget && budget->Exceeded();
+    }
+
+    barrier.Wait();
+
+    std::copy(found[thread].begin(), found[thread].end(),
+              frontier.begin() + positions[thread]);
+
+    barrier.Wait();
+  };
+
+  // Параллельный поиск в ширину из pivot по вершинам цвета 0.
+  auto search = [&](size_t thread, CpuMeter* meter,
+                    Span<size_t> edgeOffsets, Span<size_t> edgeTargets,
+                    unsigned char bit) {
+    // Другие потоки могут ещё проверять фронт предыдущего поиска.
+    barrier.Wait();
+
+    if (thread == 0) {
+      frontier.assign(1, pivot);
+      reached[pivot].fetch_or(bit, std::memory_order_relaxed);
+    }
+
+    barrier.Wait();
+
+    while (!frontier.empty() && !aborted) {
+      size_t first = frontier.size() * thread / numThreads;
+      size_t last = frontier.size() * (thread + 1) / numThreads;
+
+      found[thread].clear();
+
+      for (size_t i = first; i < last; i++) {
+        size_t vertex = frontier[i];
+
+        for (size_t k = edgeOffsets[vertex]; k < edgeOffsets[vertex + 1];
+             k++) {
+          size_t neighbour = edgeTargets[k];
+
+          if (color[neighbour].load(std::memory_order_relaxed) == 0 &&
+              !(reached[neighbour].load(std::memory_order_relaxed) & bit) &&
+              !(reached[neighbour].fetch_or(bit,
+                                            std::memory_order_relaxed) &
+                bit)) {
+            found[thread].push_back(neighbour);
+          }
+        }
+      }
+
+      meter->Charge();
+      gather(thread);
+    }
+  };
+
+  // Выполнить задачу и сложить в created новые задачи.
+  auto process = [&](Task* task, TarjanSearch* tarjan,
+                     std::vector<size_t>* queue,
+                     std::vector<Task>* created) {
+    size_t taskColor = task->color;
+
+    if (!task->split || task->vertices.size() <= minSplitSize) {
+      for (size_t root : task->vertices) {
+        tarjan->Visit(root, [&](size_t vertex) {
+          return color[vertex].load(std::memory_order_relaxed) == taskColor;
+        }, [&](const size_t* first, const size_t* last) {
+          size_t representative = *first;
+
+          for (; first != last; ++first) {
+            color[*first].store(assigned, std::memory_order_relaxed);
+            (*component)[*first] = representative;
+          }
+        });
+      }
+
+      return;
+    }
+
+    size_t forwardColor = nextColor.fetch_add(2, std::memory_order_relaxed);
+    size_t backwardColor = forwardColor + 1;
+    size_t taskPivot = task->vertices[0];
+    size_t bestScore = 0;
+
+    for (size_t vertex : task->vertices) {
+      size_t score = (offsets[vertex + 1] - offsets[vertex]) *
+                     (reverseOffsets[vertex + 1] - reverseOffsets[vertex]);
+
+      if (score > bestScore) {
+        bestScore = score;
+        taskPivot = vertex;
+      }
+    }
+
+    // Прямой поиск перекрашивает достижимые вершины в forwardColor,
+    // обратный относит к компоненте опорной вершины достижимые вершины
+    // цвета forwardColor и перекрашивает остальные в backwardColor.
+    color[taskPivot].store(forwardColor, std::memory_order_relaxed);
+    queue->assign(1, taskPivot);
+
+    for (size_t i = 0; i < queue->size(); i++) {
+      size_t vertex = (*queue)[i];
+
+      for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+        size_t neighbour = targets[k];
+
+        if (color[neighbour].load(std::memory_order_relaxed) == taskColor) {
+          color[neighbour].store(forwardColor, std::memory_order_relaxed);
+          queue->push_back(neighbour);
+        }
+      }
+    }
+
+    color[taskPivot].store(assigned, std::memory_order_relaxed);
+    (*component)[taskPivot] = taskPivot;
+    queue->assign(1, taskPivot);
+
+    for (size_t i = 0; i < queue->size(); i++) {
+      size_t vertex = (*queue)[i];
+
+      for (size_t k = reverseOffsets[vertex]; k < reverseOffsets[vertex + 1];
+           k++) {
+        size_t neighbour = reverseTargets[k];
+        size_t value = color[neighbour].load(std::memory_order_relaxed);
+
+        if (value == forwardColor) {
+          color[neighbour].store(assigned, std::memory_order_relaxed);
+          (*component)[neighbour] = taskPivot;
+          queue->push_back(neighbour);
+        } else if (value == taskColor) {
+          color[neighbour].store(backwardColor, std::memory_order_relaxed);
+          queue->push_back(neighbour);
+        }
+      }
+    }
+
+    const size_t partColors[] = { forwardColor, backwardColor, taskColor };
+
+    for (size_t partColor : partColors) {
+      Task part;
+
+      part.color = partColor;
+
+      for (size_t vertex : task->vertices) {
+        if (color[vertex].load(std::memory_order_relaxed) == partColor) {
+          part.vertices.push_back(vertex);
+        }
+      }
+
+      if (part.vertices.empty()) {
+        continue;
+      }
+
+      part.split = part.vertices.size() * 8 <= task->vertices.size() * 7;
+      created->push_back(std::move(part));
+    }
+  };
+
+  auto worker = [&](size_t thread) {
+    CpuMeter meter(budget);
+    size_t first = numVertices * thread / numThreads;
+    size_t last = numVertices * (thread + 1) / numThreads;
+
+    for (size_t vertex = first; vertex < last; vertex++) {
+      color[vertex].store(0, std::memory_order_relaxed);
+      reached[vertex].store(0, std::memory_order_relaxed);
+    }
+
+    barrier.Wait();
+
+    // Фаза 1: отсечение. Вершины удаляются сразу: удалённый сосед
+    // образует отдельную компоненту, поэтому проверка остаётся верной при
+    // любом порядке удалений в разных потоках.
+    for (size_t round = 0; round < numTrimRounds && !stop; round++) {
+      size_t trimmed = 0;
+
+      for (size_t vertex = first; vertex < last; vertex++) {
+        if (color[vertex].load(std::memory_order_relaxed) != 0) {
+          continue;
+        }
+
+        if (!hasLiveEdge(offsets, targets, vertex) ||
+            !hasLiveEdge(reverseOffsets, reverseTargets, vertex)) {
+          color[vertex].store(assigned, std::memory_order_relaxed);
+          (*component)[vertex] = vertex;
+          trimmed++;
+        }
+      }
+
+      counts[thread] = trimmed;
+
+      barrier.Wait();
+
+      if (thread == 0) {
+        stop = true;
+
+        for (size_t count : counts) {
+          stop = stop && count == 0;
+        }
+      }
+
+      barrier.Wait();
+    }
+
+    // Фаза 2: компонента вершины с наибольшим произведением степеней.
+    candidates[thread] = std::make_pair(0, numVertices);
+
+    for (size_t vertex = first; vertex < last; vertex++) {
+      if (color[vertex].load(std::memory_order_relaxed) != 0) {
+        continue;
+      }
+
+      size_t score = (offsets[vertex + 1] - offsets[vertex]) *
+                     (reverseOffsets[vertex + 1] - reverseOffsets[vertex]);
+
+      if (candidates[thread].second == numVertices ||
+          score > candidates[thread].first) {
+        candidates[thread] = std::make_pair(score, vertex);
+      }
+    }
+
+    barrier.Wait();
+
+    if (thread == 0) {
+      std::pair<size_t, size_t> best(0, numVertices);
+
+      for (const std::pair<size_t, size_t>& candidate : candidates) {
+        if (candidate.second != numVertices &&
+            (best.second == numVertices || candidate.first > best.first)) {
+          best = candidate;
+        }
+      }
+
+      pivot = best.second;
+    }
+
+    barrier.Wait();
+
+    if (pivot != numVertices) {
+      search(thread, &meter, offsets, targets, forwardBit);
+      search(thread, &meter, reverseOffsets, reverseTargets, backwardBit);
+
+      for (size_t vertex = first; vertex < last; vertex++) {
+        if (color[vertex].load(std::memory_order_relaxed) != 0) {
+          continue;
+        }
+
+        unsigned char bits = reached[vertex].load(std::memory_order_relaxed);
+
+        if (bits == (forwardBit | backwardBit)) {
+          color[vertex].store(assigned, std::memory_order_relaxed);
+          (*component)[vertex] = pivot;
+        } else {
+          color[vertex].store(bits == 0 ? 3 : bits,
+                              std::memory_order_relaxed);
+        }
+      }
+
+      barrier.Wait();
+
+      if (thread == 0) {
+        for (size_t partColor = 1; partColor <= 3; partColor++) {
+          Task part;
+
+          part.color = partColor;
+          part.split = true;
+
+          for (size_t vertex = 0; vertex < numVertices; vertex++) {
+            if (color[vertex].load(std::memory_order_relaxed) == partColor) {
+              part.vertices.push_back(vertex);
+            }
+          }
+
+          if (!part.vertices.empty()) {
+            tasks.push_back(std::move(part));
+          }
+        }
+
+        pending = tasks.size();
+      }
+
+      barrier.Wait();
+    }
+
+    // Фаза 3: пул задач.
+    {
+      TarjanSearch tarjan(graph, index.data(), lowlink.data());
+      std::vector<size_t> queue;
+      std::vector<Task> created;
+      std::unique_lock<std::mutex> lock(mutex);
+
+      while (true) {
+        ready.wait(lock, [&]() {
+          return !tasks.empty() || pending == 0 || aborted;
+        });
+
+        if (tasks.empty() || aborted) {
+          break;
+        }
+
+        Task task = std::move(tasks.back());
+
+        tasks.pop_back();
+        lock.unlock();
+
+        created.clear();
+        process(&task, &tarjan, &queue, &created);
+        meter.Charge();
+
+        lock.lock();
+
+        for (Task& part : created) {
+          tasks.push_back(std::move(part));
+        }
+
+        pending += created.size();
+        pending--;
+        aborted = aborted || (budget && budget->Exceeded());
+        ready.notify_all();
+      }
+    }
+
+    barrier.Wait();
+
+    if (aborted) {
+      return;
+    }
+
+    // Нумерация представителей по префиксным суммам.
+    size_t numLocal = 0;
+
+    for (size_t vertex = first; vertex < last; vertex++) {
+      numLocal += (*component)[vertex] == vertex;
+    }
+
+    counts[thread] = numLocal;
+
+    barrier.Wait();
+
+    if (thread == 0) {
+      for (size_t t = 0; t < numThreads; t++) {
+        positions[t] = numComponents;
+        numComponents += counts[t];
+      }
+    }
+
+    barrier.Wait();
+
+    size_t number = positions[thread];
+
+    for (size_t vertex = first; vertex < last; vertex++) {
+      if ((*component)[vertex] == vertex) {
+        index[vertex] = number++;
+      }
+    }
+
+    barrier.Wait();
+
+    for (size_t vertex = first; vertex < last; vertex++) {
+      (*component)[vertex] = index[(*component)[vertex]];
+    }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (size_t t = 1; t < numThreads; t++) {
+    threads.emplace_back(worker, t);
+  }
+
+  worker(0);
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  if (aborted) {
+    throw BudgetExceeded();
+  }
+
+  return numComponents;
+}
+
+/**
+ * @brief Перенумеровать компоненты в топологическом порядке конденсации.
+ *
+ * @param graph Граф в формате CSR.
+ * @param numComponents Число компонент.
+ * @param component Номера компонент вершин. После вызова для любого ребра
+ * (U, V) номер компоненты U не больше номера компоненты V.
+ *
+ * Конденсация сортируется алгоритмом Кана без построения её рёбер:
+ * вершины группируются по компонентам сортировкой подсчётом, а рёбра
+ * компонент перебираются по рёбрам их вершин. Время работы
+ * O(|V| + |E|).
+ */
+inline void SortComponents(const CsrGraph& graph, size_t numComponents,
+                           std::vector<size_t>* component) {
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  std::vector<size_t> starts(numComponents + 1, 0);
+  std::vector<size_t> members(graph.NumVertices());
+  std::vector<size_t> inDegree(numComponents, 0);
+  std::vector<size_t> order;
+
+  for (size_t vertex : graph.Vertices()) {
+    starts[(*component)[vertex] + 1]++;
+
+    for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+      if ((*component)[targets[k]] != (*component)[vertex]) {
+        inDegree[(*component)[targets[k]]]++;
+      }
+    }
+  }
+
+  for (size_t number = 0; number < numComponents; number++) {
+    starts[number + 1] += starts[number];
+
+    if (inDegree[number] == 0) {
+      order.push_back(number);
+    }
+  }
+
+  std::vector<size_t> next(starts.begin(), starts.end() - 1);
+
+  for (size_t vertex : graph.Vertices()) {
+    members[next[(*component)[vertex]]++] = vertex;
+  }
+
+  for (size_t i = 0; i < order.size(); i++) {
+    size_t current = order[i];
+
+    for (size_t j = starts[current]; j < starts[current + 1]; j++) {
+      size_t vertex = members[j];
+
+      for (size_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+        size_t destination = (*component)[targets[k]];
+
+        if (destination != current && --inDegree[destination] == 0) {
+          order.push_back(destination);
+        }
+      }
+    }
+  }
+
+  // Массив next больше не нужен и хранит новые номера компонент.
+  for (size_t i = 0; i < order.size(); i++) {
+    next[order[i]] = i;
+  }
+
+  for (size_t& number : *component) {
+    number = next[number];
+  }
+}
+
+/**
+ * @brief Компоненты сильной связности снимка графа.
+ *
+ * @tparam Tracer Политика трассировки (@sa trace.hpp).
+ *
+ * @param snapshot Граф в формате CSR.
+ * @param reverse Тот же граф с обращёнными рёбрами (@sa
+ * CsrGraph::AssignTranspose()). Нужен только алгоритму
+ * SccAlgorithm::ForwardBackward.
+ * @param algorithm Алгоритм поиска компонент.
+ * @param numThreads Число потоков (для SccAlgorithm::ForwardBackward).
+ * @param components Вектор, в который записываются компоненты в том же
+ * виде, что и у перегрузки для исходного графа, в исходной нумерации
+ * вершин.
+ * @param tracer Объект политики трассировки.
+ *
+ * @return Функция возвращает число компонент.
+ *
+ * Перегрузка для графов, снимок которых уже построен (например, графов
+ * сессий): она не строит ни снимок, ни обращённый граф.
+ */
+template<typename Tracer = NullTracer>
+size_t StronglyConnectedComponents(
+    const CsrGraph& snapshot, const CsrGraph& reverse,
+    SccAlgorithm algorithm, size_t numThreads,
+    std::vector<std::vector<size_t>>* components,
+    Tracer* tracer = nullptr) {
+  std::vector<size_t> component;
+  size_t numComponents;
+
+  if (algorithm == SccAlgorithm::Tarjan) {
+    ExternalIdTracer<Tracer, CsrGraph> externalTracer(tracer, snapshot);
+
+    numComponents = TarjanScc(snapshot, &component, &externalTracer);
+  } else {
+    numComponents = ForwardBackwardScc(snapshot, reverse, numThreads,
+                                       &component);
+    SortComponents(snapshot, numComponents, &component);
+  }
+
+  components->assign(numComponents, std::vector<size_t>());
+
+  for (size_t index : snapshot.Vertices()) {
+    (*components)[component[index]].push_back(snapshot.ExternalId(index));
+  }
+
+  return numComponents;
+}
+
+/**
+ * @brief Компоненты сильной связности графа.
+ *
+ * @tparam GraphType Тип графа: graph::OrientedGraph или любой другой класс
+ * с методами Vertices(), HasVertex() и Edges().
+ * @tparam Tracer Политика трассировки (@sa trace.hpp).
+ *
+ * @param graph Исходный граф.
+ * @param algorithm Алгоритм поиска компонент.
+ * @param numThreads Число потоков (для SccAlgorithm::ForwardBackward).
+ * @param components Вектор, в который записываются компоненты в
+ * топологическом порядке конденсации: для любого ребра (U, V) компонента
+ * U стоит не позже компоненты V. Вершины компоненты записываются в
+ * исходной нумерации по возрастанию.
+ * @param tracer Объект политики трассировки. События обхода записываются
+ * только алгоритмом Тарьяна в исходной нумерации вершин.
+ *
+ * @return Функция возвращает число компонент.
+ *
+ * Граф ацикличен тогда и только тогда, когда все компоненты состоят из
+ * одной вершины без петли. Тогда components задаёт топологический порядок
+ * вершин, а иначе компоненты из нескольких вершин и вершины с петлями
+ * указывают циклы графа.
+ */
+template<typename GraphType, typename Tracer = NullTracer>
+size_t StronglyConnectedComponents(
+    const GraphType& graph, SccAlgorithm algorithm, size_t numThreads,
+    std::vector<std::vector<size_t>>* components,
+    Tracer* tracer = nullptr) {
+  CsrGraph snapshot(graph);
+  CsrGraph reverse;
+
+  if (algorithm == SccAlgorithm::ForwardBackward) {
+    reverse.AssignTranspose(snapshot);
+  }
+
+  return StronglyConnectedComponents(snapshot, reverse, algorithm,
+                                     numThreads, components, tracer);
+}
+
+}  // namespace graph
+
+#endif  // INCLUDE_SCC_HPP_
@@ -2,154 +2,421 @@
  * @file topological_sort.hpp
  * @author Ayzat Rizatdinov (dov4k1n)
  *
- * Реализация алгоритма топологической сортировки ориентированного
- * ациклического графа.
+ * Реализация алгоритмов топологической сортировки ориентированного
+ * ациклического графа: обходом в глубину и алгоритмом Кана.
  */
 
 #ifndef INCLUDE_TOPOLOGICAL_SORT_HPP_
 #define INCLUDE_TOPOLOGICAL_SORT_HPP_
 
-#include <iostream>
-#include <string>
 #include <algorithm>
-#include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <utility>
 #include <vector>
-#include "weighted_oriented_graph.hpp"
+#include "barrier.hpp"
+#include "oriented_graph.hpp"
+#include "csr_graph.hpp"
+#include "trace.hpp"
 
 namespace graph {
 
 /**
- * @brief Перечисление состояний вершины графа при обходе в глубину. 
+ * @brief Перечисление состояний вершины графа при обходе в глубину.
  */
-enum DFSVertexState {
+enum DFSVertexState : unsigned char {
   NotVisited,
   Processing,
   Processed
 };
 
-<template >
-struct TSortOutput {
-  std::vector<size_t> order;
-
-}
-
 /**
  * @brief Массив для печати состояния вершины графа при обходе в глубину
  * в читаемом виде.
  *
- * Пример использования: 
- * std::cout << DFSVertexState_txt[DFXVertexState.NotVisited]; // not visited
+ * Пример использования:
+ * std::cout << DFSVertexState_txt[DFSVertexState::NotVisited]; // not visited
  */
-const char* DFSVertexState_txt[] = {
+const char* const DFSVertexState_txt[] = {
   "not visited",
   "processing",
   "processed"
 };
 
-<template typename Weight>
-void dfs(
-  const OrientedGraph& graph,
-  const size_t& vertex,
-  std::unordered_map<size_t, DFSVertexState>& visited,
-  std::vector<size_t>& result_order,
-  bool& is_cyclic
-);
+/**
+ * @brief Рабочая память алгоритма топологической сортировки.
+ *
+ * Объект принадлежит вызывающей стороне и может переиспользоваться между
+ * вызовами graph::TopologicalSort(). Все массивы только растут, поэтому
+ * после первых запросов сортировка графов не большего размера не выделяет
+ * память.
+ */
+struct TopologicalSortWorkspace {
+  //! Снимок графа во внутренней нумерации (для графов на хеш-таблицах).
+  CsrGraph snapshot;
+
+  //! Состояния вершин, индексируются внутренними номерами.
+  std::vector<DFSVertexState> state;
+
+  /**
+   * @brief Явный стек обхода в глубину.
+   *
+   * Каждый элемент --- пара (вершина, позиция следующего непросмотренного
+   * ребра в массиве CsrGraph::Targets()).
+   */
+  std::vector<std::pair<size_t, size_t>> stack;
+};
+
+/**
+ * @brief Алгоритм топологической сортировки снимка графа.
+ *
+ * @tparam Tracer Политика трассировки (@sa trace.hpp). По умолчанию
+ * используется graph::NullTracer, которая не порождает никакого кода.
+ *
+ * @param graph Граф в формате CSR (@sa csr_graph.hpp).
+ * @param workspace Рабочая память алгоритма.
+ * @param order Вектор, в который записывается результат во внутренней
+ * нумерации графа graph.
+ * @param tracer Объект политики трассировки.
+ *
+ * @return Функция возвращает true, если граф ацикличен. Если в графе есть
+ * цикл, то функция возвращает false, а вектор order остаётся пустым.
+ *
+ * Обход в глубину выполняется без рекурсии на явном стеке, поэтому глубина
+ * графа ограничена только объёмом памяти, а не размером стека потока.
+ * Вершины кладутся в order в порядке выхода из обхода, в конце вектор
+ * разворачивается.
+ */
+template<typename Tracer = NullTracer>
+bool TopologicalSort(const CsrGraph& graph,
+                     TopologicalSortWorkspace* workspace,
+                     std::vector<size_t>* order,
+                     Tracer* tracer = nullptr) {
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  std::vector<DFSVertexState>& state = workspace->state;
+  std::vector<std::pair<size_t, size_t>>& stack = workspace->stack;
+  CpuMeter meter(CpuBudget::Current());
+
+  state.assign(graph.NumVertices(), DFSVertexState::NotVisited);
+  stack.clear();
+  order->clear();
+
+  for (size_t root : graph.Vertices()) {
+    if (state[root] != DFSVertexState::NotVisited) {
+      continue;
+    }
+
+    state[root] = DFSVertexState::Processing;
+    stack.emplace_back(root, offsets[root]);
+    Trace(tracer, TraceEvent::EnterVertex, root);
+
+    while (!stack.empty()) {
+      size_t vertex = stack.back().first;
+      size_t& next = stack.back().second;
+
+      meter.Tick();
+
+      if (next == offsets[vertex + 1]) {
+        state[vertex] = DFSVertexState::Processed;
+        order->push_back(vertex);
+        stack.pop_back();
+        Trace(tracer, TraceEvent::FinishVertex, vertex);
+        continue;
+      }
+
+      size_t destination = targets[next++];
+
+      Trace(tracer, TraceEvent::ExamineEdge, vertex, destination);
+
+      if (state[destination] == DFSVertexState::NotVisited) {
+        state[destination] = DFSVertexState::Processing;
+        stack.emplace_back(destination, offsets[destination]);
+        Trace(tracer, TraceEvent::EnterVertex, destination);
+      } else if (state[destination] == DFSVertexState::Processing) {
+        Trace(tracer, TraceEvent::CycleFound, vertex, destination);
+        stack.clear();
+        order->clear();
+        return false;
+      }
+    }
+  }
+
+  std::reverse(order->begin(), order->end());
+
+  return true;
+}
+
+/**
+ * @brief Алгоритм топологической сортировки с внешней рабочей памятью.
+ *
+ * @tparam GraphType Тип графа: graph::OrientedGraph или любой другой класс
+ * с методами Vertices(), HasVertex() и Edges().
+ * @tparam Tracer Политика трассировки (@sa trace.hpp).
+ *
+ * @param graph Исходный граф.
+ * @param workspace Рабочая память алгоритма.
+ * @param order Вектор, в который записывается результат в исходной
+ * нумерации вершин.
+ * @param tracer Объект политики трассировки. События записываются
+ * в исходной нумерации вершин.
+ *
+ * @return Функция возвращает true, если граф ацикличен, и false, если
+ * в графе есть цикл (в этом случае вектор order пуст).
+ *
+ * Функция строит снимок графа в workspace->snapshot и сортирует его.
+ */
+template<typename GraphType, typename Tracer = NullTracer>
+bool TopologicalSort(const GraphType& graph,
+                     TopologicalSortWorkspace* workspace,
+                     std::vector<size_t>* order,
+                     Tracer* tracer = nullptr) {
+  workspace->snapshot.Assign(graph);
+
+  ExternalIdTracer<Tracer, CsrGraph> externalTracer(tracer,
+                                                    workspace->snapshot);
+
+  if (!TopologicalSort(workspace->snapshot, workspace, order,
+                       &externalTracer)) {
+    return false;
+  }
+
+  for (size_t& vertex : *order) {
+    vertex = workspace->snapshot.ExternalId(vertex);
+  }
+
+  return true;
+}
 
 /**
  * @brief Алгоритм топологической сортировки.
  *
+ * @tparam GraphType Тип графа: graph::OrientedGraph, graph::CsrGraph или
+ * любой другой класс с методами Vertices() и Edges().
+ *
  * @param graph На вход подаётся ссылка на объект типа graph::OrientedGraph,
- * описанный в файле @sa oriented_graph.hpp
+ * описанный в файле @sa oriented_graph.hpp, или на его CSR снимок
+ * graph::CsrGraph (@sa csr_graph.hpp). Во втором случае результат
+ * записывается во внутренней нумерации снимка.
  *
  * @return Алгоритм возвращает вектор вершин такой, что
- * для любого ребра (U, V) вершина U в этом векторе находится раньше 
+ * для любого ребра (U, V) вершина U в этом векторе находится раньше
  * вершины V, или пустой вектор, если в графе есть цикл.
  *
- * Функция инициализирует словарь посещённых вершин, алгоритмом 
- * обхода в глубину проверяет граф на ацикличность и кладёт их в 
- * итоговый вектор, начиная с листьев. В самом конце вектор разворачивается.
+ * Функция создаёт временную рабочую память. Для обработки потока запросов
+ * лучше использовать перегрузку с graph::TopologicalSortWorkspace.
  */
-<template typename Weight>
-std::vector<size_t> TopologicalSort(OrientedGraph& graph) {
-  std::unordered_map<size_t, DFSVertexState> visited;
+template<typename GraphType>
+std::vector<size_t> TopologicalSort(const GraphType& graph) {
+  TopologicalSortWorkspace workspace;
   std::vector<size_t> result_order;
-  bool is_cyclic = false;
 
-  std::cout << std::endl << "in TopologicalSort graph.Vertices():" << std::endl;
+  TopologicalSort(graph, &workspace, &result_order);
+
+  return result_order;
+}
 
-  for (auto vertex : graph.Vertices()) {
-    visited[vertex] = DFSVertexState::NotVisited;
-    std::cout << vertex << " ";
+/**
+ * @brief Разбиение графа на уровни алгоритмом Кана.
+ *
+ * @tparam Tracer Политика трассировки (@sa trace.hpp).
+ *
+ * @param graph Граф в формате CSR (@sa csr_graph.hpp).
+ * @param levels Вектор, в который записываются уровни во внутренней
+ * нумерации графа graph.
+ * @param numThreads Максимальное число потоков.
+ * @param tracer Объект политики трассировки. События записываются только
+ * из вызывающего потока: по одному событию на каждый уровень.
+ *
+ * @return Функция возвращает true, если граф ацикличен. Если в графе есть
+ * цикл, то функция возвращает false, а вектор levels остаётся пустым.
+ *
+ * Нулевой уровень состоит из вершин без входящих рёбер. Уровень k + 1
+ * состоит из вершин, у которых все входящие рёбра ведут из уровней 0, ..., k.
+ * Вершины одного уровня попарно несравнимы (уровень --- антицепь), поэтому
+ * их можно обрабатывать независимо. Внутри уровня вершины упорядочены
+ * по возрастанию.
+ *
+ * Широкие уровни делятся между потоками. Каждый поток уменьшает
+ * атомарные счётчики входящих рёбер у соседей своих вершин и собирает
+ * вершины, счётчик которых обнулился, в свой собственный вектор. Узкие
+ * уровни обрабатываются в вызывающем потоке, так как создание потоков
+ * обходится дороже самой работы.
+ *
+ * Ограничение процессорного времени (@sa CpuBudget) проверяется между
+ * уровнями с учётом времени всех потоков, обработавших уровень.
+ */
+template<typename Tracer = NullTracer>
+bool TopologicalLevels(const CsrGraph& graph,
+                       std::vector<std::vector<size_t>>* levels,
+                       size_t numThreads = 1,
+                       Tracer* tracer = nullptr) {
+  // Минимальное число вершин уровня, приходящееся на один поток.
+  const size_t minVerticesPerThread = 4096;
+
+  Span<size_t> offsets = graph.Offsets();
+  Span<size_t> targets = graph.Targets();
+  std::vector<std::atomic<size_t>> inDegree(graph.NumVertices());
+  CpuBudget* budget = CpuBudget::Current();
+  CpuMeter meter(budget);
+
+  levels->clear();
+
+  for (std::atomic<size_t>& degree : inDegree) {
+    degree.store(0, std::memory_order_relaxed);
+  }
+
+  for (size_t destination : targets) {
+    inDegree[destination].fetch_add(1, std::memory_order_relaxed);
   }
-  std::cout << std::endl;
-  
-  for (auto vertex : graph.Vertices()) {
-    if (is_cyclic) {
-      std::cout << "is cyclic!" << std::endl;
-      return std::vector<size_t>();
+
+  std::vector<size_t> frontier;
+
+  for (size_t vertex : graph.Vertices()) {
+    if (inDegree[vertex].load(std::memory_order_relaxed) == 0) {
+      frontier.push_back(vertex);
     }
-    
-    if (visited[vertex] == DFSVertexState::NotVisited) {
-      dfs(graph, vertex, visited, result_order, is_cyclic);
+  }
+
+  // Функция обрабатывает вершины frontier[first], ..., frontier[last - 1]
+  // и складывает в next вершины, у которых не осталось входящих рёбер.
+  auto relax = [&](const std::vector<size_t>& current, size_t first,
+                   size_t last, std::vector<size_t>* next) {
+    for (size_t i = first; i < last; i++) {
+      size_t vertex = current[i];
+
+      for (size_t j = offsets[vertex]; j < offsets[vertex + 1]; j++) {
+        size_t destination = targets[j];
+
+        if (inDegree[destination].fetch_sub(1,
+                                             std::memory_order_acq_rel) == 1) {
+          next->push_back(destination);
+        }
+      }
+    }
+  };
+
+  size_t numProcessed = 0;
+  std::vector<std::vector<size_t>> local;
+  std::vector<std::thread> threads;
+
+  while (!frontier.empty()) {
+    std::vector<size_t> next;
+    size_t threadsUsed = std::min({ std::max<size_t>(numThreads, 1),
+                                    MaxThreads(),
+                                    frontier.size() / minVerticesPerThread });
+
+    if (threadsUsed <= 1) {
+      relax(frontier, 0, frontier.size(), &next);
+    } else {
+      size_t chunk = (frontier.size() + threadsUsed - 1) / threadsUsed;
+
+      local.assign(threadsUsed, std::vector<size_t>());
+      threads.clear();
+
+      for (size_t t = 0; t < threadsUsed; t++) {
+        size_t first = std::min(t * chunk, frontier.size());
+        size_t last = std::min(first + chunk, frontier.size());
+
+        // Время потоков списывается с того же ограничения, что и время
+        // вызывающего потока.
+        threads.emplace_back([&, first, last, t]() {
+          CpuMeter threadMeter(budget);
+
+          relax(frontier, first, last, &local[t]);
+        });
+      }
+
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+
+      for (const std::vector<size_t>& part : local) {
+        next.insert(next.end(), part.begin(), part.end());
+      }
     }
+
+    std::sort(next.begin(), next.end());
+
+    Trace(tracer, TraceEvent::LevelDone, levels->size(), frontier.size());
+    meter.Tick(frontier.size());
+
+    numProcessed += frontier.size();
+    levels->push_back(std::move(frontier));
+    frontier = std::move(next);
   }
 
-  std::reverse(result_order.begin(), result_order.end());
+  if (numProcessed != graph.NumVertices()) {
+    levels->clear();
+    return false;
+  }
 
-  return result_order;
+  return true;
 }
 
 /**
- * @brief Алгоритм обхода в глубину для топологической сортировки.
- *
- * @param graph Объект типа graph::OrientedGraph, описанный в файле:
- * @sa oriented_graph.hpp
- * @param vertex Итерируемая вершина графа.
- * @param visited Словарь пройденных вершин.
- * @param result_order Вектор, куда будут добавляться вершины по мере сортировки.
- * @param is_cyclic Булевая переменная (по умолчанию false), в которую
- * записывается true, если по ходу работы выяснилось, что граф циклический.
- *
- * Функция отмечает вершину, в которую мы попали, и для всех исходящих из неё
- * рёбер применяет рекурсию, если их ещё не обработали. В конце добавляет
- * в итоговый вектор вершину.
+ * @brief Разбиение графа на уровни алгоритмом Кана.
+ *
+ * @tparam GraphType Тип графа: graph::OrientedGraph или любой другой класс
+ * с методами Vertices(), HasVertex() и Edges().
+ * @tparam Tracer Политика трассировки (@sa trace.hpp).
+ *
+ * @param graph Исходный граф.
+ * @param levels Вектор, в который записываются уровни в исходной
+ * нумерации вершин.
+ * @param numThreads Максимальное число потоков.
+ * @param tracer Объект политики трассировки.
+ *
+ * @return Функция возвращает true, если граф ацикличен, и false, если
+ * в графе есть цикл (в этом случае вектор levels пуст).
  */
-<template typename Weight>
-void dfs(
-  const OrientedGraph& graph,
-  const size_t& vertex,
-  std::unordered_map<size_t, DFSVertexState>& visited,
-  std::vector<size_t>& result_order,
-  bool& is_cyclic
-) {
-  visited[vertex] = DFSVertexState::Processing;
-
-  std::cout << std::endl << "in dfs vertex: " << vertex << std::endl;
-
-  for (auto destination : graph.Edges(vertex)) {
-    std::cout << 
-      "destination " << destination << 
-      " is visited?: " << DFSVertexState_txt[visited[destination]] << 
-      std::endl;
-
-    if (visited[destination] == DFSVertexState::NotVisited)
-      dfs(graph, destination, visited, result_order, is_cyclic);
-    if (visited[destination] == DFSVertexState::Processing) {
-      is_cyclic = true;
-      return;
+template<typename GraphType, typename Tracer = NullTracer>
+bool TopologicalLevels(const GraphType& graph,
+                       std::vector<std::vector<size_t>>* levels,
+                       size_t numThreads = 1,
+                       Tracer* tracer = nullptr) {
+  CsrGraph snapshot(graph);
+
+  if (!TopologicalLevels(snapshot, levels, numThreads, tracer)) {
+    return false;
+  }
+
+  // Перенумерация монотонна, поэтому уровни остаются упорядоченными.
+  for (std::vector<size_t>& level : *levels) {
+    for (size_t& vertex : level) {
+      vertex = snapshot.ExternalId(vertex);
     }
   }
 
-  visited[vertex] = DFSVertexState::Processed;
-  std::cout << 
-    vertex << 
-    " is now " << 
-    DFSVertexState_txt[visited[vertex]] << 
-    std::endl;
+  return true;
+}
+
+/**
+ * @brief Алгоритм топологической сортировки Кана.
+ *
+ * @tparam GraphType Тип графа.
+ *
+ * @param graph Исходный граф.
+ * @param numThreads Максимальное число потоков.
+ *
+ * @return Функция возвращает вершины графа уровень за уровнем
+ * (@sa TopologicalLevels()) или пустой вектор, если в графе есть цикл.
+ */
+template<typename GraphType>
+std::vector<size_t> KahnTopologicalSort(const GraphType& graph,
+                                        size_t numThreads = 1) {
+  std::vector<std::vector<size_t>> levels;
+  std::vector<size_t> result_order;
+
+  TopologicalLevels(graph, &levels, numThreads);
 
-  result_order.push_back(vertex);
+  for (const std::vector<size_t>& level : levels) {
+    result_order.insert(result_order.end(), level.begin(), level.end());
+  }
+
+  return result_order;
 }
 
 }  // namespace graph
 
-#endif  // INCLUDE_BRIDGE_SEARCH_HPP_
\ No newline at end of file
+#endif  // INCLUDE_TOPOLOGICAL_SORT_HPP_
@@ -0,0 +1,449 @@
+/**
+ * @file trace.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Политики трассировки для алгоритмов на графах.
+ */
+
+#ifndef INCLUDE_TRACE_HPP_
+#define INCLUDE_TRACE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <stdexcept>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Тип события трассировки.
+ */
+enum class TraceEvent : unsigned char {
+  //! Алгоритм вошёл в вершину (vertex).
+  EnterVertex,
+  //! Алгоритм просматривает ребро (vertex, other).
+  ExamineEdge,
+  //! Алгоритм закончил обработку вершины (vertex).
+  FinishVertex,
+  //! Найден цикл, замыкающийся ребром (vertex, other).
+  CycleFound,
+  //! Обработан уровень номер vertex, в котором other вершин.
+  LevelDone
+};
+
+/**
+ * @brief Функция возвращает имя события в читаемом виде.
+ *
+ * @param event Тип события.
+ */
+inline const char* TraceEventName(TraceEvent event) {
+  switch (event) {
+    case TraceEvent::EnterVertex:
+      return "enter";
+    case TraceEvent::ExamineEdge:
+      return "edge";
+    case TraceEvent::FinishVertex:
+      return "finish";
+    case TraceEvent::CycleFound:
+      return "cycle";
+    case TraceEvent::LevelDone:
+      return "level";
+  }
+
+  return "unknown";
+}
+
+/**
+ * @brief Запись о событии трассировки.
+ */
+struct TraceRecord {
+  //! Тип события.
+  TraceEvent event;
+  //! Номер вершины (или уровня).
+  size_t vertex;
+  //! Второй конец ребра (или размер уровня).
+  size_t other;
+};
+
+/**
+ * @brief Передать событие политике трассировки.
+ *
+ * @tparam Tracer Политика трассировки.
+ *
+ * @param tracer Указатель на объект политики. Для пустой политики может
+ * быть нулевым.
+ * @param event Тип события.
+ * @param vertex Номер вершины.
+ * @param other Дополнительное значение события.
+ *
+ * Для политик с enabled == false вызов не компилируется в какой-либо код.
+ */
+template<typename Tracer>
+void Trace(Tracer* tracer, TraceEvent event, size_t vertex, size_t other = 0) {
+  if constexpr (Tracer::enabled) {
+    tracer->Record(event, vertex, other);
+  }
+}
+
+/**
+ * @brief Пустая политика трассировки.
+ *
+ * Используется по умолчанию. Все вызовы встраиваются и исчезают при
+ * компиляции, поэтому алгоритм работает так же, как без трассировки.
+ */
+class NullTracer {
+ public:
+  //! Признак того, что политика действительно записывает события.
+  static constexpr bool enabled = false;
+
+  /**
+   * @brief Записать событие (ничего не делает).
+   */
+  void Record(TraceEvent /* event */, size_t /* vertex */,
+              size_t /* other */ = 0) {
+  }
+};
+
+/**
+ * @brief Политика трассировки, записывающая события в кольцевой буфер.
+ *
+ * Буфер фиксированного размера выделяется один раз при создании объекта.
+ * Если событий больше, чем помещается в буфер, то сохраняются последние,
+ * а число потерянных событий можно узнать функцией Dropped(). Объект
+ * предназначен для одного запроса и не является потокобезопасным.
+ */
+class RingBufferTracer {
+ public:
+  //! Признак того, что политика действительно записывает события.
+  static constexpr bool enabled = true;
+
+  /**
+   * @brief Конструктор класса RingBufferTracer.
+   *
+   * @param capacity Максимальное число хранимых событий.
+   */
+  explicit RingBufferTracer(size_t capacity) :
+    buffer(capacity),
+    head(0),
+    count(0),
+    dropped(0) {
+  }
+
+  /**
+   * @brief Записать событие.
+   *
+   * @param event Тип события.
+   * @param vertex Номер вершины.
+   * @param other Дополнительное значение события.
+   */
+  void Record(TraceEvent event, size_t vertex, size_t other = 0) {
+    if (buffer.empty()) {
+      dropped++;
+      return;
+    }
+
+    buffer[head] = TraceRecord{event, vertex, other};
+    head = (head + 1) % buffer.size();
+
+    if (count < buffer.size()) {
+      count++;
+    } else {
+      dropped++;
+    }
+  }
+
+  /**
+   * @brief Функция возвращает сохранённые события от старых к новым.
+   */
+  std::vector<TraceRecord> Events() const {
+    std::vector<TraceRecord> events;
+
+    if (buffer.empty()) {
+      return events;
+    }
+
+    size_t first = (head + buffer.size() - count) % buffer.size();
+
+    events.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+      events.push_back(buffer[(first + i) % buffer.size()]);
+    }
+
+    return events;
+  }
+
+  /**
+   * @brief Функция возвращает число событий, вытесненных из буфера.
+   */
+  size_t Dropped() const {
+    return dropped;
+  }
+
+ private:
+  //! Кольцевой буфер событий.
+  std::vector<TraceRecord> buffer;
+  //! Позиция для следующей записи.
+  size_t head;
+  //! Число сохранённых событий.
+  size_t count;
+  //! Число вытесненных событий.
+  size_t dropped;
+};
+
+/**
+ * @brief Исключение, которое выбрасывается, если алгоритм превысил
+ *        отведённое ему процессорное время.
+ */
+class BudgetExceeded : public std::runtime_error {
+ public:
+  BudgetExceeded() :
+    std::runtime_error("cpu budget exceeded") {
+  }
+};
+
+/**
+ * @brief Функция возвращает процессорное время текущего потока.
+ *
+ * На платформах без часов CLOCK_THREAD_CPUTIME_ID используется время
+ * std::chrono::steady_clock.
+ */
+inline std::chrono::nanoseconds ThreadCpuTime() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  timespec time;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+
+  return std::chrono::seconds(time.tv_sec) +
+         std::chrono::nanoseconds(time.tv_nsec);
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch());
+#endif
+}
+
+/**
+ * @brief Ограничение процессорного времени одного запроса.
+ *
+ * Пока объект жив, он задаёт ограничение для потока, который его создал
+ * (@sa Current()). Алгоритмы запоминают ограничение до запуска своих
+ * потоков и списывают с него время каждого потока через graph::CpuMeter,
+ * поэтому учитывается работа всех потоков запроса. Однопоточные алгоритмы
+ * при исчерпании ограничения выбрасывают исключение graph::BudgetExceeded,
+ * а параллельные сначала останавливают все потоки в ближайшей точке
+ * синхронизации. Рабочая память алгоритмов после этого остаётся пригодной
+ * для следующего запуска.
+ */
+class CpuBudget {
+ public:
+  /**
+   * @brief Конструктор класса CpuBudget.
+   *
+   * @param limit Допустимое процессорное время. Нулевое значение снимает
+   * ограничение, в том числе заданное объемлющим объектом.
+   */
+  explicit CpuBudget(std::chrono::nanoseconds limit) :
+    limit(limit),
+    remaining(limit.count()),
+    previous(Slot()) {
+    Slot() = limit == std::chrono::nanoseconds::zero() ? nullptr : this;
+  }
+
+  //! Деструктор восстанавливает предыдущее ограничение потока.
+  ~CpuBudget() {
+    Slot() = previous;
+  }
+
+  CpuBudget(const CpuBudget&) = delete;
+  CpuBudget& operator=(const CpuBudget&) = delete;
+
+  /**
+   * @brief Функция возвращает ограничение текущего потока или нулевой
+   * указатель, если ограничения нет.
+   */
+  static CpuBudget* Current() {
+    return Slot();
+  }
+
+  /**
+   * @brief Функция возвращает допустимое процессорное время.
+   */
+  std::chrono::nanoseconds Limit() const {
+    return limit;
+  }
+
+  /**
+   * @brief Списать процессорное время.
+   *
+   * @param time Время, потраченное одним из потоков.
+   */
+  void Charge(std::chrono::nanoseconds time) {
+    remaining.fetch_sub(time.count(), std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Функция возвращает true, если списано больше допустимого.
+   */
+  bool Exceeded() const {
+    return remaining.load(std::memory_order_relaxed) < 0;
+  }
+
+ private:
+  //! Ограничение текущего потока.
+  static CpuBudget*& Slot() {
+    static thread_local CpuBudget* current = nullptr;
+
+    return current;
+  }
+
+  //! Допустимое процессорное время.
+  const std::chrono::nanoseconds limit;
+  //! Оставшееся процессорное время в наносекундах.
+  std::atomic<std::chrono::nanoseconds::rep> remaining;
+  //! Ограничение, которое действовало до создания объекта.
+  CpuBudget* const previous;
+};
+
+/**
+ * @brief Счётчик процессорного времени одного потока алгоритма.
+ *
+ * Счётчик списывает с ограничения время своего потока, прошедшее после
+ * предыдущего списания: при вызове Charge(), раз в checkInterval шагов
+ * в Tick() и в деструкторе. На потоке одновременно должен работать только
+ * один счётчик, иначе время будет списано дважды. Без ограничения счётчик
+ * ничего не делает.
+ */
+class CpuMeter {
+ public:
+  /**
+   * @brief Конструктор класса CpuMeter.
+   *
+   * @param budget Ограничение или нулевой указатель.
+   */
+  explicit CpuMeter(CpuBudget* budget) :
+    budget(budget),
+    last(budget ? ThreadCpuTime() : std::chrono::nanoseconds::zero()),
+    count(0) {
+  }
+
+  ~CpuMeter() {
+    Charge();
+  }
+
+  CpuMeter(const CpuMeter&) = delete;
+  CpuMeter& operator=(const CpuMeter&) = delete;
+
+  /**
+   * @brief Списать время потока, прошедшее после предыдущего списания.
+   */
+  void Charge() {
+    if (budget) {
+      std::chrono::nanoseconds now = ThreadCpuTime();
+
+      budget->Charge(now - last);
+      last = now;
+    }
+  }
+
+  /**
+   * @brief Учесть шаги однопоточного алгоритма.
+   *
+   * @param steps Число шагов.
+   *
+   * Время списывается раз в checkInterval шагов. Если ограничение
+   * исчерпано, то выбрасывается исключение graph::BudgetExceeded.
+   */
+  void Tick(size_t steps = 1) {
+    if (!budget) {
+      return;
+    }
+
+    count += steps;
+
+    if (count < checkInterval) {
+      return;
+    }
+
+    count = 0;
+    Charge();
+
+    if (budget->Exceeded()) {
+      throw BudgetExceeded();
+    }
+  }
+
+ private:
+  //! Число шагов между списаниями времени.
+  static constexpr size_t checkInterval = 4096;
+  //! Ограничение или нулевой указатель.
+  CpuBudget* budget;
+  //! Процессорное время потока при предыдущем списании.
+  std::chrono::nanoseconds last;
+  //! Число шагов после предыдущего списания.
+  size_t count;
+};
+
+/**
+ * @brief Обёртка над политикой трассировки, переводящая внутренние номера
+ *        снимка графа в исходные.
+ *
+ * @tparam Tracer Исходная политика трассировки.
+ * @tparam GraphType Тип снимка графа (например, graph::CsrGraph).
+ *
+ * Для пустой политики перевод номеров не выполняется.
+ */
+template<typename Tracer, typename GraphType>
+class ExternalIdTracer {
+ public:
+  //! Признак того, что политика действительно записывает события.
+  static constexpr bool enabled = Tracer::enabled;
+
+  /**
+   * @brief Конструктор класса ExternalIdTracer.
+   *
+   * @param tracer Исходная политика трассировки.
+   * @param graph Снимок графа.
+   */
+  ExternalIdTracer(Tracer* tracer, const GraphType& graph) :
+    tracer(tracer),
+    graph(graph) {
+  }
+
+  /**
+   * @brief Записать событие, переведя номера вершин.
+   *
+   * @param event Тип события.
+   * @param vertex Внутренний номер вершины.
+   * @param other Дополнительное значение события.
+   */
+  void Record(TraceEvent event, size_t vertex, size_t other = 0) {
+    if constexpr (Tracer::enabled) {
+      switch (event) {
+        case TraceEvent::ExamineEdge:
+        case TraceEvent::CycleFound:
+          tracer->Record(event, graph.ExternalId(vertex),
+                         graph.ExternalId(other));
+          break;
+        case TraceEvent::EnterVertex:
+        case TraceEvent::FinishVertex:
+          tracer->Record(event, graph.ExternalId(vertex), other);
+          break;
+        case TraceEvent::LevelDone:
+          tracer->Record(event, vertex, other);
+          break;
+      }
+    }
+  }
+
+ private:
+  //! Исходная политика трассировки.
+  Tracer* tracer;
+  //! Снимок графа.
+  const GraphType& graph;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_TRACE_HPP_
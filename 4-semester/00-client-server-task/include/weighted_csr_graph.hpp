@@ -0,0 +1,247 @@
+/**
+ * @file weighted_csr_graph.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация неизменяемого снимка взвешенного графа в формате CSR.
+ */
+
+#ifndef INCLUDE_WEIGHTED_CSR_GRAPH_HPP_
+#define INCLUDE_WEIGHTED_CSR_GRAPH_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <csr_graph.hpp>
+#include <iterators.hpp>
+
+namespace graph {
+
+/**
+ * @brief Проверить, есть ли у класса графа функция WeightedEdges().
+ *
+ * @tparam GraphType Тип графа.
+ */
+template<typename GraphType, typename = void>
+struct HasWeightedEdges : std::false_type {
+};
+
+/**
+ * @brief Проверить, есть ли у класса графа функция WeightedEdges().
+ *
+ * @tparam GraphType Тип графа, например, graph::WeightedOrientedGraph.
+ */
+template<typename GraphType>
+struct HasWeightedEdges<GraphType, std::void_t<decltype(
+    std::declval<const GraphType&>().WeightedEdges(size_t()))>> :
+    std::true_type {
+};
+
+/**
+ * @brief Неизменяемый взвешенный ориентированный граф в формате CSR.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * К трём массивам graph::CsrGraph добавляется массив weights той же длины,
+ * что и targets: вес ребра targets[k] хранится в weights[k]. Поэтому
+ * алгоритмы поиска кратчайших путей читают вес ребра подряд с его концом
+ * и не обращаются к хеш-таблице весов исходного графа.
+ *
+ * Снимок можно построить из любого класса графа, у которого есть методы
+ * Vertices(), Edges() и EdgeWeight(): graph::WeightedOrientedGraph или
+ * graph::WeightedGraph.
+ */
+template<typename Weight>
+class WeightedCsrGraph : public CsrGraph {
+ public:
+  //! Тип данных для веса ребра.
+  using WeightType = Weight;
+
+  /**
+   * @brief Конструктор пустого графа.
+   */
+  WeightedCsrGraph() {
+  }
+
+  /**
+   * @brief Построить снимок графа.
+   *
+   * @tparam GraphType Тип исходного графа.
+   * @param graph Исходный граф.
+   */
+  template<typename GraphType>
+  explicit WeightedCsrGraph(const GraphType& graph) {
+    Assign(graph);
+  }
+
+  /**
+   * @brief Перестроить снимок по другому графу.
+   *
+   * @tparam GraphType Тип исходного графа.
+   * @param graph Исходный граф.
+   *
+   * Веса читаются из исходного графа один раз на ребро. Если у графа есть
+   * функция WeightedEdges() (graph::WeightedOrientedGraph), то веса
+   * читаются вместе с концами рёбер, иначе --- функцией EdgeWeight().
+   * Память, выделенная при предыдущих вызовах, переиспользуется.
+   */
+  template<typename GraphType>
+  void Assign(const GraphType& graph) {
+    if constexpr (HasWeightedEdges<GraphType>::value) {
+      AssignWeightedEdges(graph);
+      return;
+    }
+
+    CsrGraph::Assign(graph);
+
+    weights.clear();
+    weights.reserve(targets.size());
+
+    for (size_t index = 0; index < ids.size(); index++) {
+      for (size_t k = offsets[index]; k < offsets[index + 1]; k++) {
+        weights.push_back(graph.EdgeWeight(ids[index], ids[targets[k]]));
+      }
+    }
+  }
+
+  /**
+   * @brief Построить снимок графа с обращёнными рёбрами.
+   *
+   * @param graph Исходный снимок.
+   *
+   * Каждое ребро (U, V) с весом W превращается в ребро (V, U) с тем же
+   * весом. Нумерация вершин совпадает с нумерацией graph. Рёбра каждой
+   * вершины упорядочены по возрастанию.
+   */
+  void AssignTranspose(const WeightedCsrGraph& graph) {
+    ids = graph.ids;
+    offsets.assign(ids.size() + 1, 0);
+    targets.clear();
+    targets.resize(graph.targets.size());
+    weights.clear();
+    weights.resize(graph.weights.size());
+
+    for (size_t target : graph.targets) {
+      offsets[target + 1]++;
+    }
+
+    for (size_t index = 0; index < ids.size(); index++) {
+      offsets[index + 1] += offsets[index];
+    }
+
+    // Источники перебираются по возрастанию, поэтому рёбра каждой вершины
+    // получаются упорядоченными без сортировки. Счётчики next временно
+    // хранятся в offsets и в конце сдвигаются обратно.
+    for (size_t index = 0; index < ids.size(); index++) {
+      for (size_t k = graph.offsets[index]; k < graph.offsets[index + 1];
+           k++) {
+        size_t position = offsets[graph.targets[k]]++;
+
+        targets[position] = index;
+        weights[position] = graph.weights[k];
+      }
+    }
+
+    for (size_t index = ids.size(); index > 0; index--) {
+      offsets[index] = offsets[index - 1];
+    }
+
+    offsets[0] = 0;
+  }
+
+  /**
+   * @brief Получить веса рёбер, выходящих из указанной вершины.
+   *
+   * @param index Внутренний номер вершины.
+   *
+   * Веса идут в том же порядке, что и концы рёбер в Edges(index). Если
+   * указанной вершины в графе нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  Span<Weight> EdgeWeights(size_t index) const {
+    if (!HasVertex(index)) {
+      throw std::out_of_range(
+          "WeightedCsrGraph::EdgeWeights(): no such vertex");
+    }
+
+    return Span<Weight>(weights.data() + offsets[index],
+                        weights.data() + offsets[index + 1]);
+  }
+
+  /**
+   * @brief Массив весов рёбер. Вес ребра Targets()[k] равен Weights()[k].
+   */
+  Span<Weight> Weights() const {
+    return weights.All();
+  }
+
+  /**
+   * @brief Построить снимок поверх готовых массивов без копирования.
+   *
+   * @param owner Владелец памяти массивов (@sa CsrGraph::AssignView()).
+   * @param ids Исходные номера вершин по возрастанию.
+   * @param offsets Смещения, ids.size() + 1 элементов.
+   * @param targets Концы рёбер во внутренней нумерации.
+   * @param weights Веса рёбер в порядке массива targets.
+   */
+  void AssignView(const std::shared_ptr<const void>& owner,
+                  Span<size_t> ids, Span<size_t> offsets,
+                  Span<size_t> targets, Span<Weight> weights) {
+    CsrGraph::AssignView(owner, ids, offsets, targets);
+    this->weights.AssignView(owner, weights);
+  }
+
+ protected:
+  //! Веса рёбер в порядке массива targets.
+  CsrArray<Weight> weights;
+
+ private:
+  /**
+   * @brief Перестроить снимок по графу с функцией WeightedEdges().
+   *
+   * @tparam GraphType Тип исходного графа.
+   * @param graph Исходный граф.
+   *
+   * Рёбра каждой вершины перебираются парами (конец, вес) один раз, без
+   * поиска веса по каждому ребру.
+   */
+  template<typename GraphType>
+  void AssignWeightedEdges(const GraphType& graph) {
+    // Пары (внутренний номер конца, вес) рёбер текущей вершины.
+    std::vector<std::pair<size_t, Weight>> neighbours;
+
+    AssignIds(graph);
+    weights.clear();
+    offsets.push_back(0);
+
+    IdRemap remap(ids.All());
+
+    for (size_t id : ids) {
+      if (!graph.HasVertex(id)) {
+        offsets.push_back(targets.size());
+        continue;
+      }
+
+      neighbours.clear();
+
+      for (const auto& edge : graph.WeightedEdges(id)) {
+        neighbours.emplace_back(remap(edge.first), edge.second);
+      }
+
+      std::sort(neighbours.begin(), neighbours.end());
+
+      for (const std::pair<size_t, Weight>& edge : neighbours) {
+        targets.push_back(edge.first);
+        weights.push_back(edge.second);
+      }
+
+      offsets.push_back(targets.size());
+    }
+  }
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_WEIGHTED_CSR_GRAPH_HPP_
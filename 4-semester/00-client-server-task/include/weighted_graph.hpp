@@ -9,23 +9,38 @@
 #define INCLUDE_WEIGHTED_GRAPH_HPP_
 
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
+#include <graph_storage.hpp>
 #include <iterators.hpp>
 
 namespace graph {
 
+template<typename Weight>
+class WeightedGraphBuilder;
+
 /**
  * @brief Взвешенный неориентированный граф.
  *
  * @tparam Weight Тип веса графа.
+ * @tparam Storage Политика хранения списков смежности: graph::SmallStorage
+ * (по умолчанию), graph::HashStorage, graph::FlatStorage или
+ * graph::CompactStorage (@sa graph_storage.hpp).
  */
-template<typename Weight>
+template<typename Weight, typename Storage = SmallStorage>
 class WeightedGraph {
  public:
   //! Тип данных для веса ребра.
   using WeightType = Weight;
 
+  //! Тип, в котором хранятся номера вершин.
+  using Id = typename Storage::Id;
+
+  //! Тип множества соседей вершины.
+  using NeighbourSet = typename Storage::Set;
+
+  //! Тип словаря смежности.
+  using AdjacencyMap = typename Storage::template Map<NeighbourSet>;
+
   /**
    * @brief Конструктор класса WeightedGraph.
    */
@@ -56,6 +71,10 @@ class WeightedGraph {
    * в граф. Если такое ребро в графе уже есть, то функция ничего не делает.
    */
   void AddEdge(size_t id1, size_t id2, Weight weight) {
+    // Номера проверяются до изменения графа (@sa CompactStorage).
+    NarrowId<Id>(id1);
+    NarrowId<Id>(id2);
+
     edges[id1].insert(id2);
     edges[id2].insert(id1);
     weights[MakeEdgeId(id1, id2)] = weight;
@@ -89,7 +108,7 @@ class WeightedGraph {
       return false;
     }
 
-    return it->second.find(id2) != it->second.end();
+    return it->second.count(id2) > 0;
   }
 
   /**
@@ -144,12 +163,12 @@ class WeightedGraph {
    *
    * @param id Номер вершины.
    *
-   * Функция возвращает множество вершин в виде хеш-таблицы, с которыми
+   * Функция возвращает множество вершин NeighbourSet, с которыми
    * соединена вершина id, то есть множество таких вершин V, что ребро (id, V)
    * присутствует в графе. Если указанной вершини в графе нет, то функция
    * выбрасывает исключение std::out_of_range.
    */
-  const std::unordered_set<size_t>& Edges(size_t id) const {
+  const NeighbourSet& Edges(size_t id) const {
     return edges.at(id);
   }
 
@@ -158,12 +177,12 @@ class WeightedGraph {
    *
    * @param id Номер вершины.
    *
-   * Функция возвращает множество вершин в виде хеш-таблицы, соединённых
+   * Функция возвращает множество вершин NeighbourSet, соединённых
    * с вершиной id, то есть множество таких вершин V, что ребро (V, id)
    * присутствует в графе. Если указанной вершини в графе нет, то функция
    * выбрасывает исключение std::out_of_range.
    */
-  const std::unordered_set<size_t>& IncomingEdges(size_t id) const {
+  const NeighbourSet& IncomingEdges(size_t id) const {
     return edges.at(id);
   }
 
@@ -200,8 +219,23 @@ class WeightedGraph {
    * Функция возвращает специальный класс-промежуток, по которому
    * можно проитерироваться при помощи цикла range-base for.
    */
-  VerticesRange Vertices() const {
-    return VerticesRange(edges.begin(), edges.end());
+  VerticesRange<typename AdjacencyMap::const_iterator> Vertices() const {
+    return { edges.begin(), edges.end() };
+  }
+
+  /**
+   * @brief Зарезервировать место для вершин и рёбер.
+   *
+   * @param numVertices Ожидаемое число вершин.
+   * @param numEdges Ожидаемое число рёбер.
+   *
+   * Функция заранее выделяет память под словари вершин и весов, чтобы при
+   * добавлении не происходило перехеширование. Для добавления большого
+   * числа рёбер удобнее использовать graph::WeightedGraphBuilder.
+   */
+  void Reserve(size_t numVertices, size_t numEdges) {
+    edges.reserve(numVertices);
+    weights.reserve(numEdges);
   }
 
   /**
@@ -212,6 +246,9 @@ class WeightedGraph {
   }
 
  private:
+  //! Класс для пакетного построения графа.
+  friend class WeightedGraphBuilder<Weight>;
+
   /**
    * @brief Вспомогательная функция для получения идентификатора ребра.
    *
@@ -245,7 +282,7 @@ class WeightedGraph {
   };
 
   //! Разреженная матрица связности.
-  std::unordered_map<size_t, std::unordered_set<size_t>> edges;
+  AdjacencyMap edges;
 
   //! Словарь весов рёбер.
   std::unordered_map<std::pair<size_t, size_t>, Weight, Hash> weights;
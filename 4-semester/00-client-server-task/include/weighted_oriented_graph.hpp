@@ -8,29 +8,52 @@
 #ifndef INCLUDE_WEIGHTED_ORIENTED_GRAPH_HPP_
 #define INCLUDE_WEIGHTED_ORIENTED_GRAPH_HPP_
 
-#include <unordered_map>
-#include <unordered_set>
-#include <utility>
+#include <graph_storage.hpp>
 #include <iterators.hpp>
 
 namespace graph {
 
+template<typename Weight>
+class WeightedGraphBuilder;
+
 /**
  * @brief Взвешенный ориентированный граф.
  *
  * @tparam Weight Тип веса графа.
+ * @tparam Storage Политика хранения списков смежности: graph::SmallStorage
+ * (по умолчанию), graph::HashStorage, graph::FlatStorage или
+ * graph::CompactStorage (@sa graph_storage.hpp).
+ *
+ * Вес ребра хранится рядом с его концом в словаре соседей вершины, поэтому
+ * перебор рёбер функцией WeightedEdges() и функция EdgeWeight() читают вес
+ * из той же памяти, что и номер соседа, без отдельной таблицы весов.
  */
-template<typename Weight>
+template<typename Weight, typename Storage = SmallStorage>
 class WeightedOrientedGraph {
  public:
   //! Тип данных для веса ребра.
   using WeightType = Weight;
 
+  //! Тип, в котором хранятся номера вершин.
+  using Id = typename Storage::Id;
+
+  //! Тип множества соседей вершины (для входящих рёбер).
+  using NeighbourSet = typename Storage::Set;
+
+  //! Тип словаря соседей вершины с весами исходящих рёбер.
+  using NeighbourWeights = typename Storage::template NeighbourMap<Weight>;
+
+  //! Тип словаря смежности для входящих рёбер.
+  using AdjacencyMap = typename Storage::template Map<NeighbourSet>;
+
+  //! Тип словаря смежности для исходящих рёбер.
+  using WeightedAdjacencyMap =
+      typename Storage::template Map<NeighbourWeights>;
+
   /**
    * @brief Конструктор класса WeightedOrientedGraph.
    */
-  WeightedOrientedGraph() :
-    weights() {
+  WeightedOrientedGraph() {
   }
 
   /**
@@ -60,13 +83,16 @@ class WeightedOrientedGraph {
    * @param weight Вес ребра.
    *
    * Функция добавляет ребро с весом weight, выходящее из вершины id1 и входящее
-   * в вершину id2 в граф. Если такое ребро в графе уже есть, то функция ничего
-   * не делает.
+   * в вершину id2 в граф. Если такое ребро в графе уже есть, то функция
+   * заменяет его вес на weight.
    */
   void AddEdge(size_t id1, size_t id2, Weight weight) {
-    edges[id1].insert(id2);
+    // Номера проверяются до изменения графа (@sa CompactStorage).
+    NarrowId<Id>(id1);
+    NarrowId<Id>(id2);
+
+    edges[id1][id2] = weight;
     incomingEdges[id2].insert(id1);
-    weights[std::make_pair(id1, id2)] = weight;
   }
 
   /**
@@ -97,7 +123,7 @@ class WeightedOrientedGraph {
       return false;
     }
 
-    return it->second.find(id2) != it->second.end();
+    return it->second.count(id2) > 0;
   }
 
   /**
@@ -112,12 +138,10 @@ class WeightedOrientedGraph {
     auto it = edges.find(id);
 
     if (it != edges.end()) {
-      for (size_t neighbourId : it->second) {
-        if (id != neighbourId) {
-          incomingEdges[neighbourId].erase(id);
+      for (const auto& edge : it->second) {
+        if (id != edge.first) {
+          incomingEdges[edge.first].erase(id);
         }
-
-        weights.erase(std::make_pair(id, neighbourId));
       }
 
       edges.erase(id);
@@ -130,8 +154,6 @@ class WeightedOrientedGraph {
         if (id != neighbourId) {
           edges[neighbourId].erase(id);
         }
-
-        weights.erase(std::make_pair(neighbourId, id));
       }
 
       incomingEdges.erase(id);
@@ -148,8 +170,6 @@ class WeightedOrientedGraph {
    * из графа. Если такого ребра в графе нет, то функция ничего не делает.
    */
   void RemoveEdge(size_t id1, size_t id2) {
-    weights.erase(std::make_pair(id1, id2));
-
     if (edges.find(id1) != edges.end()) {
       edges[id1].erase(id2);
     }
@@ -164,12 +184,32 @@ class WeightedOrientedGraph {
    *
    * @param id Номер вершины.
    *
-   * Функция возвращает множество вершин в виде хеш-таблицы, с которыми
-   * соединена вершина id, то есть множество таких вершин V, что ребро (id, V)
-   * присутствует в графе. Если указанной вершини в графе нет, то функция
-   * выбрасывает исключение std::out_of_range.
+   * Функция возвращает множество вершин, с которыми соединена вершина id,
+   * то есть множество таких вершин V, что ребро (id, V) присутствует
+   * в графе. Множество поддерживает перебор, size(), empty() и count().
+   * Если указанной вершини в графе нет, то функция выбрасывает исключение
+   * std::out_of_range.
    */
-  const std::unordered_set<size_t>& Edges(size_t id) const {
+  NeighboursRange<NeighbourWeights> Edges(size_t id) const {
+    return NeighboursRange<NeighbourWeights>(edges.at(id));
+  }
+
+  /**
+   * @brief Получить исходящие рёбра указанной вершины вместе с весами.
+   *
+   * @param id Номер вершины.
+   *
+   * Функция возвращает словарь NeighbourWeights, элементы которого ---
+   * пары (V, W) для всех рёбер (id, V) с весом W. Пример использования:
+   * @code
+   * for (const auto& [neighbourId, weight] : graph.WeightedEdges(id)) {
+   *   ...
+   * }
+   * @endcode
+   * Если указанной вершины в графе нет, то функция выбрасывает исключение
+   * std::out_of_range.
+   */
+  const NeighbourWeights& WeightedEdges(size_t id) const {
     return edges.at(id);
   }
 
@@ -178,12 +218,12 @@ class WeightedOrientedGraph {
    *
    * @param id Номер вершины.
    *
-   * Функция возвращает множество вершин в виде хеш-таблицы, соединённых
+   * Функция возвращает множество вершин NeighbourSet, соединённых
    * с вершиной id, то есть множество таких вершин V, что ребро (V, id)
    * присутствует в графе. Если указанной вершини в графе нет, то функция
    * выбрасывает исключение std::out_of_range.
    */
-  const std::unordered_set<size_t>& IncomingEdges(size_t id) const {
+  const NeighbourSet& IncomingEdges(size_t id) const {
     return incomingEdges.at(id);
   }
 
@@ -198,7 +238,7 @@ class WeightedOrientedGraph {
    * исключение std::out_of_range.
    */
   const Weight& EdgeWeight(size_t id1, size_t id2) const {
-    return weights.at(std::make_pair(id1, id2));
+    return edges.at(id1).at(id2);
   }
 
   /**
@@ -212,7 +252,7 @@ class WeightedOrientedGraph {
    * std::out_of_range.
    */
   Weight& EdgeWeight(size_t id1, size_t id2) {
-    return weights.at(std::make_pair(id1, id2));
+    return edges.at(id1).at(id2);
   }
 
   /**
@@ -221,8 +261,23 @@ class WeightedOrientedGraph {
    * Функция возвращает специальный класс-промежуток, по которому
    * можно проитерироваться при помощи цикла range-base for.
    */
-  VerticesRange Vertices() const {
-    return VerticesRange(edges.begin(), edges.end());
+  VerticesRange<typename WeightedAdjacencyMap::const_iterator>
+  Vertices() const {
+    return { edges.begin(), edges.end() };
+  }
+
+  /**
+   * @brief Зарезервировать место для вершин.
+   *
+   * @param numVertices Ожидаемое число вершин.
+   *
+   * Функция заранее выделяет память под словари вершин, чтобы при
+   * добавлении вершин не происходило перехеширование. Для добавления
+   * большого числа рёбер удобнее использовать graph::WeightedGraphBuilder.
+   */
+  void Reserve(size_t numVertices) {
+    edges.reserve(numVertices);
+    incomingEdges.reserve(numVertices);
   }
 
   /**
@@ -233,31 +288,14 @@ class WeightedOrientedGraph {
   }
 
  private:
-  /**
-   * @brief Класс для вычисления хеш кода ребра.
-   */
-  class Hash {
-    /**
-     * @brief Функция, вычисляющая хеш код ребра.
-     *
-     * @param id Уникальный идентификатор ребра.
-     */
-   public:
-    size_t operator()(std::pair<size_t, size_t> id) const noexcept {
-      const size_t prime = 479001599;
-
-      return id.first * prime + id.second;
-    }
-  };
+  //! Класс для пакетного построения графа.
+  friend class WeightedGraphBuilder<Weight>;
 
-  //! Разреженная матрица связности. Словарь исходящих рёбер.
-  std::unordered_map<size_t, std::unordered_set<size_t>> edges;
+  //! Разреженная матрица связности. Словарь исходящих рёбер с весами.
+  WeightedAdjacencyMap edges;
 
   //! Разреженная матрица связности. Словарь входящих рёбер.
-  std::unordered_map<size_t, std::unordered_set<size_t>> incomingEdges;
-
-  //! Словарь весов рёбер.
-  std::unordered_map<std::pair<size_t, size_t>, Weight, Hash> weights;
+  AdjacencyMap incomingEdges;
 };
 
 }  // namespace graph
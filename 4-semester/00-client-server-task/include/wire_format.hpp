@@ -0,0 +1,400 @@
+/**
+ * @file wire_format.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Компактный двоичный формат для передачи графов между клиентом и сервером.
+ */
+
+#ifndef INCLUDE_WIRE_FORMAT_HPP_
+#define INCLUDE_WIRE_FORMAT_HPP_
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Способ кодирования чисел в двоичном формате.
+ *
+ * Сообщение состоит из чисел, строк и массивов, записанных подряд без
+ * разделителей. Строка и массив начинаются с числа элементов.
+ */
+enum class WireEncoding {
+  //! Каждое число занимает 8 байт в порядке little-endian.
+  Fixed,
+  /**
+   * Числа записываются в формате LEB128 (7 бит на байт). Элементы массивов
+   * записываются как разность с предыдущим элементом (zigzag), поэтому
+   * близкие номера вершин занимают 1-2 байта.
+   */
+  Varint
+};
+
+/**
+ * @brief Функция возвращает MIME тип для способа кодирования.
+ *
+ * @param encoding Способ кодирования.
+ */
+inline const char* WireContentType(WireEncoding encoding) {
+  return encoding == WireEncoding::Fixed ? "application/x-graph" :
+                                           "application/x-graph-varint";
+}
+
+/**
+ * @brief Получить тип носителя из значения заголовка Content-Type.
+ *
+ * @param contentType Значение заголовка Content-Type.
+ *
+ * Функция отбрасывает параметры после ';' (например, charset) и пробельные
+ * символы по краям и приводит тип к нижнему регистру, так как типы
+ * носителей не зависят от регистра.
+ */
+inline std::string WireMediaType(const std::string& contentType) {
+  size_t first = 0;
+  size_t last = std::min(contentType.find(';'), contentType.size());
+
+  while (first < last &&
+         std::isspace(static_cast<unsigned char>(contentType[first]))) {
+    first++;
+  }
+
+  while (last > first &&
+         std::isspace(static_cast<unsigned char>(contentType[last - 1]))) {
+    last--;
+  }
+
+  std::string mediaType = contentType.substr(first, last - first);
+
+  for (char& symbol : mediaType) {
+    symbol = static_cast<char>(
+        std::tolower(static_cast<unsigned char>(symbol)));
+  }
+
+  return mediaType;
+}
+
+/**
+ * @brief Определить способ кодирования по MIME типу.
+ *
+ * @param contentType MIME тип (значение заголовка Content-Type).
+ * @param encoding Указатель, по которому записывается способ кодирования.
+ * @return Функция возвращает false, если MIME тип не относится
+ * к двоичному формату.
+ *
+ * Сравнивается только тип носителя (@sa WireMediaType()), поэтому
+ * параметры вроде "; charset=binary" и регистр букв не учитываются.
+ */
+inline bool WireEncodingFromContentType(const std::string& contentType,
+                                        WireEncoding* encoding) {
+  std::string mediaType = WireMediaType(contentType);
+
+  if (mediaType == WireContentType(WireEncoding::Fixed)) {
+    *encoding = WireEncoding::Fixed;
+    return true;
+  }
+
+  if (mediaType == WireContentType(WireEncoding::Varint)) {
+    *encoding = WireEncoding::Varint;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Класс для записи сообщения в двоичном формате.
+ */
+class WireWriter {
+ public:
+  /**
+   * @brief Конструктор класса WireWriter.
+   *
+   * @param encoding Способ кодирования.
+   */
+  explicit WireWriter(WireEncoding encoding) :
+    encoding(encoding) {
+  }
+
+  /**
+   * @brief Записать число.
+   *
+   * @param value Значение.
+   */
+  void WriteNumber(uint64_t value) {
+    if (encoding == WireEncoding::Fixed) {
+      for (size_t i = 0; i < sizeof(value); i++) {
+        data.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+      }
+
+      return;
+    }
+
+    while (value >= 0x80) {
+      data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+
+    data.push_back(static_cast<char>(value));
+  }
+
+  /**
+   * @brief Записать строку.
+   *
+   * @param value Строка.
+   */
+  void WriteString(const std::string& value) {
+    WriteNumber(value.size());
+    data.append(value);
+  }
+
+  /**
+   * @brief Записать массив чисел.
+   *
+   * @param values Массив.
+   */
+  void WriteArray(const std::vector<size_t>& values) {
+    uint64_t previous = 0;
+
+    WriteNumber(values.size());
+
+    for (size_t value : values) {
+      WriteElement(value, previous);
+      previous = value;
+    }
+  }
+
+  /**
+   * @brief Записать массив рёбер.
+   *
+   * @param edges Массив пар (начало, конец).
+   *
+   * Начало ребра записывается относительно начала предыдущего ребра,
+   * а конец относительно начала этого же ребра.
+   */
+  void WriteEdges(const std::vector<std::pair<size_t, size_t>>& edges) {
+    uint64_t previous = 0;
+
+    WriteNumber(edges.size());
+
+    for (const std::pair<size_t, size_t>& edge : edges) {
+      WriteElement(edge.first, previous);
+      WriteElement(edge.second, edge.first);
+      previous = edge.first;
+    }
+  }
+
+  /**
+   * @brief Функция возвращает записанное сообщение.
+   */
+  const std::string& Data() const {
+    return data;
+  }
+
+ private:
+  /**
+   * @brief Записать элемент массива.
+   *
+   * @param value Значение.
+   * @param base Значение, относительно которого записывается разность.
+   */
+  void WriteElement(uint64_t value, uint64_t base) {
+    if (encoding == WireEncoding::Fixed) {
+      WriteNumber(value);
+      return;
+    }
+
+    // Разность по модулю 2^64 как знаковое число, закодированное zigzag.
+    uint64_t delta = value - base;
+
+    WriteNumber((delta << 1) ^ (0 - (delta >> 63)));
+  }
+
+  //! Способ кодирования.
+  WireEncoding encoding;
+  //! Записанное сообщение.
+  std::string data;
+};
+
+/**
+ * @brief Класс для чтения сообщения в двоичном формате.
+ *
+ * Все функции возвращают false, если сообщение закончилось раньше времени
+ * или число не помещается в 64 бита.
+ */
+class WireReader {
+ public:
+  /**
+   * @brief Конструктор класса WireReader.
+   *
+   * @param data Сообщение. Должно существовать всё время чтения.
+   * @param encoding Способ кодирования.
+   */
+  WireReader(const std::string& data, WireEncoding encoding) :
+    data(data),
+    encoding(encoding),
+    position(0) {
+  }
+
+  /**
+   * @brief Прочитать число.
+   *
+   * @param value Указатель, по которому записывается значение.
+   */
+  bool ReadNumber(uint64_t* value) {
+    *value = 0;
+
+    if (encoding == WireEncoding::Fixed) {
+      if (data.size() - position < sizeof(*value)) {
+        return false;
+      }
+
+      for (size_t i = 0; i < sizeof(*value); i++) {
+        *value |= static_cast<uint64_t>(
+            static_cast<unsigned char>(data[position++])) << (8 * i);
+      }
+
+      return true;
+    }
+
+    for (size_t shift = 0; shift < 64; shift += 7) {
+      if (position == data.size()) {
+        return false;
+      }
+
+      uint64_t byte = static_cast<unsigned char>(data[position++]);
+
+      *value |= (byte & 0x7F) << shift;
+
+      if ((byte & 0x80) == 0) {
+        return shift < 63 || byte <= 1;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Прочитать строку.
+   *
+   * @param value Указатель, по которому записывается строка.
+   */
+  bool ReadString(std::string* value) {
+    uint64_t size;
+
+    if (!ReadNumber(&size) || size > data.size() - position) {
+      return false;
+    }
+
+    value->assign(data, position, size);
+    position += size;
+
+    return true;
+  }
+
+  /**
+   * @brief Прочитать массив чисел.
+   *
+   * @tparam Callback Тип функции, которая вызывается для каждого элемента.
+   *
+   * @param callback Функция вида void(size_t).
+   */
+  template<typename Callback>
+  bool ReadArray(Callback callback) {
+    uint64_t size;
+    uint64_t previous = 0;
+
+    if (!ReadNumber(&size)) {
+      return false;
+    }
+
+    for (uint64_t i = 0; i < size; i++) {
+      uint64_t value;
+
+      if (!ReadElement(previous, &value)) {
+        return false;
+      }
+
+      callback(static_cast<size_t>(value));
+      previous = value;
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Прочитать массив рёбер.
+   *
+   * @tparam Callback Тип функции, которая вызывается для каждого ребра.
+   *
+   * @param callback Функция вида void(size_t, size_t).
+   */
+  template<typename Callback>
+  bool ReadEdges(Callback callback) {
+    uint64_t size;
+    uint64_t previous = 0;
+
+    if (!ReadNumber(&size)) {
+      return false;
+    }
+
+    for (uint64_t i = 0; i < size; i++) {
+      uint64_t start;
+      uint64_t end;
+
+      if (!ReadElement(previous, &start) || !ReadElement(start, &end)) {
+        return false;
+      }
+
+      callback(static_cast<size_t>(start), static_cast<size_t>(end));
+      previous = start;
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Функция возвращает true, если сообщение прочитано полностью.
+   */
+  bool AtEnd() const {
+    return position == data.size();
+  }
+
+ private:
+  /**
+   * @brief Прочитать элемент массива.
+   *
+   * @param base Значение, относительно которого записана разность.
+   * @param value Указатель, по которому записывается значение.
+   */
+  bool ReadElement(uint64_t base, uint64_t* value) {
+    if (encoding == WireEncoding::Fixed) {
+      return ReadNumber(value);
+    }
+
+    uint64_t zigzag;
+
+    if (!ReadNumber(&zigzag)) {
+      return false;
+    }
+
+    *value = base + ((zigzag >> 1) ^ (0 - (zigzag & 1)));
+
+    return true;
+  }
+
+  //! Сообщение.
+  const std::string& data;
+  //! Способ кодирования.
+  WireEncoding encoding;
+  //! Позиция следующего непрочитанного байта.
+  size_t position;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_WIRE_FORMAT_HPP_
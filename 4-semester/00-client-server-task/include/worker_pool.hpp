@@ -0,0 +1,265 @@
+/**
+ * @file worker_pool.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Пул рабочих потоков сервера с ограниченной очередью.
+ */
+
+#ifndef INCLUDE_WORKER_POOL_HPP_
+#define INCLUDE_WORKER_POOL_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <httplib.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace graph {
+
+/**
+ * @brief Пул рабочих потоков для httplib::Server.
+ *
+ * Объект подключается к серверу через поле httplib::Server::new_task_queue
+ * и заменяет стандартную очередь задач, размер которой не ограничен.
+ *
+ * Задачи (соединения с клиентами) выполняются numWorkers потоками, а ждать
+ * своей очереди могут не более queueLimit задач. Если очередь заполнена,
+ * то новая задача передаётся отдельному потоку сброса нагрузки. Во время
+ * её выполнения функция Shedding() возвращает true, и обработчики запросов
+ * должны сразу отвечать кодом 503 с заголовком Retry-After, не выполняя
+ * алгоритм. Так под пиковой нагрузкой не растут ни потребление памяти, ни
+ * время ожидания в очереди.
+ *
+ * Если заполнена и очередь сброса нагрузки (не более queueLimit задач),
+ * то enqueue() ждёт, пока в одной из очередей освободится место. Задача
+ * никогда не выполняется в вызывающем потоке: иначе медленный клиент или
+ * соединение keep-alive задержали бы accept() для всех. Пока поток
+ * httplib ждёт, новые соединения копятся в очереди ядра (backlog).
+ *
+ * На Linux рабочие потоки могут быть закреплены за ядрами процессора:
+ * поток номер i выполняется на ядре i по модулю числа ядер.
+ */
+class WorkerPool : public httplib::TaskQueue {
+ public:
+  /**
+   * @brief Конструктор класса WorkerPool.
+   *
+   * @param numWorkers Число рабочих потоков (не меньше одного).
+   * @param queueLimit Максимальное число задач, ожидающих в очереди (не
+   * меньше одной).
+   * @param pinWorkers Закреплять ли рабочие потоки за ядрами процессора.
+   */
+  WorkerPool(size_t numWorkers, size_t queueLimit, bool pinWorkers) :
+    queueLimit(std::max<size_t>(queueLimit, 1)),
+    stopping(false) {
+    size_t numCores = std::thread::hardware_concurrency();
+
+    numWorkers = std::max<size_t>(numWorkers, 1);
+
+    for (size_t i = 0; i < numWorkers; i++) {
+      workers.emplace_back([this]() { Work(&tasks, false); });
+
+      if (pinWorkers && numCores > 0) {
+        Pin(&workers.back(), i % numCores);
+      }
+    }
+
+    shedder = std::thread([this]() { Work(&overflow, true); });
+  }
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * @brief Деструктор класса WorkerPool.
+   *
+   * Дожидается выполнения всех поставленных задач.
+   */
+  ~WorkerPool() override {
+    shutdown();
+  }
+
+  /**
+   * @brief Поставить задачу в очередь.
+   *
+   * @param fn Задача.
+   */
+  void enqueue(std::function<void()> fn) override {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if (tasks.size() < queueLimit) {
+      tasks.push_back(std::move(fn));
+      lock.unlock();
+      condition.notify_all();
+      return;
+    }
+
+    if (overflow.size() < queueLimit) {
+      overflow.push_back(std::move(fn));
+      lock.unlock();
+      condition.notify_all();
+      return;
+    }
+
+    // Переполнена даже очередь сброса нагрузки. Поток сброса быстро
+    // отвечает 503 и освобождает место, а до тех пор соединения ждут
+    // в очереди ядра.
+    space.wait(lock, [this]() {
+      return stopping || tasks.size() < queueLimit ||
+             overflow.size() < queueLimit;
+    });
+
+    if (tasks.size() < queueLimit || stopping) {
+      tasks.push_back(std::move(fn));
+    } else {
+      overflow.push_back(std::move(fn));
+    }
+
+    lock.unlock();
+    condition.notify_all();
+  }
+
+  /**
+   * @brief Дождаться выполнения всех задач и остановить потоки.
+   */
+  void shutdown() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      if (stopping) {
+        return;
+      }
+
+      stopping = true;
+    }
+
+    condition.notify_all();
+    space.notify_all();
+
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+
+    shedder.join();
+  }
+
+  /**
+   * @brief Функция возвращает true, если текущий поток выполняет задачу,
+   *        для которой не хватило места в очереди.
+   */
+  static bool Shedding() {
+    return shedding;
+  }
+
+  /**
+   * @brief Функция возвращает число задач, ожидающих в очереди.
+   */
+  size_t QueueSize() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return tasks.size();
+  }
+
+ private:
+  /**
+   * @brief Основной цикл потока пула.
+   *
+   * @param queue Очередь, из которой поток берёт задачи.
+   * @param shed Выполнять ли задачи в режиме сброса нагрузки.
+   */
+  void Work(std::deque<std::function<void()>>* queue, bool shed) {
+    while (true) {
+      std::function<void()> fn;
+
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        condition.wait(lock, [&]() { return stopping || !queue->empty(); });
+
+        if (queue->empty()) {
+          return;
+        }
+
+        fn = std::move(queue->front());
+        queue->pop_front();
+      }
+
+      space.notify_one();
+
+      if (shed) {
+        RunShedding(fn);
+      } else {
+        fn();
+      }
+    }
+  }
+
+  /**
+   * @brief Выполнить задачу в режиме сброса нагрузки.
+   *
+   * @param fn Задача.
+   */
+  static void RunShedding(const std::function<void()>& fn) {
+    shedding = true;
+    fn();
+    shedding = false;
+  }
+
+  /**
+   * @brief Закрепить поток за ядром процессора.
+   *
+   * @param thread Поток.
+   * @param core Номер ядра.
+   *
+   * На платформах, отличных от Linux, функция ничего не делает.
+   */
+  static void Pin(std::thread* thread, size_t core) {
+#ifdef __linux__
+    cpu_set_t cpuSet;
+
+    CPU_ZERO(&cpuSet);
+    CPU_SET(core, &cpuSet);
+    // Ошибка не критична: поток просто останется незакреплённым.
+    pthread_setaffinity_np(thread->native_handle(), sizeof(cpuSet), &cpuSet);
+#else
+    (void) thread;
+    (void) core;
+#endif
+  }
+
+  //! Выполняет ли текущий поток задачу в режиме сброса нагрузки.
+  static inline thread_local bool shedding = false;
+
+  //! Максимальное число задач, ожидающих в очереди.
+  size_t queueLimit;
+  //! Очередь задач.
+  std::deque<std::function<void()>> tasks;
+  //! Задачи, для которых не хватило места в очереди.
+  std::deque<std::function<void()>> overflow;
+  //! Рабочие потоки.
+  std::vector<std::thread> workers;
+  //! Поток сброса нагрузки.
+  std::thread shedder;
+  //! Мьютекс для доступа к очередям.
+  std::mutex mutex;
+  //! Условная переменная для ожидания задач.
+  std::condition_variable condition;
+  //! Условная переменная для ожидания места в очередях.
+  std::condition_variable space;
+  //! Признак остановки пула.
+  bool stopping;
+};
+
+}  // namespace graph
+
+#endif  // INCLUDE_WORKER_POOL_HPP_
@@ -0,0 +1,134 @@
+/**
+ * @file methods/bellman_ford_method.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Файл содержит функцию, которая вызывает алгоритм Беллмана-Форда.
+ * Функция принимает и возвращает данные в JSON формате.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "bellman_ford.hpp"
+#include "dijkstra.hpp"
+#include "graph_builder.hpp"
+#include "weighted_csr_graph.hpp"
+#include "weighted_oriented_graph.hpp"
+#include "methods.hpp"
+
+namespace graph {
+
+int BellmanFordMethod(const nlohmann::json& input, nlohmann::json* output) {
+  (*output)["id"] = input.at("id");
+
+  /* Рёбра сначала собираются в массив, а граф строится за один проход
+  без перехеширования. Веса могут быть отрицательными. */
+  static thread_local WeightedGraphBuilder<double> builder;
+  WeightedOrientedGraph<double> graph;
+  size_t source = input.at("source");
+  /* Необязательное поле mode выбирает вариант алгоритма: "classic"
+  (по умолчанию), "spfa" или "parallel" с числом потоков threads (не
+  больше числа аппаратных потоков). */
+  std::string mode = input.value("mode", "classic");
+  size_t numThreads = std::min(input.value("threads", MaxThreads()),
+                               MaxThreads());
+  const nlohmann::json& vertices = input.at("vertices");
+  const nlohmann::json& edges = input.at("edges");
+
+  builder.Clear();
+  builder.Reserve(vertices.size(), edges.size());
+
+  for (auto vertex : vertices) {
+    builder.AddVertex(vertex);
+  }
+
+  for (auto edge : edges) {
+    const nlohmann::json& weight = edge.at("weight");
+
+    if (!weight.is_number()) {
+      return -1;
+    }
+
+    builder.AddEdge(edge.at("start"), edge.at("end"),
+                    weight.get<double>());
+  }
+
+  builder.Build(&graph);
+
+  WeightedCsrGraph<double> snapshot(graph);
+  ShortestPathTree<double> tree;
+  std::vector<size_t> cycle;
+  bool result;
+
+  try {
+    size_t sourceIndex = snapshot.InternalId(source);
+    size_t targetIndex = noVertex;
+
+    if (input.contains("target")) {
+      targetIndex = snapshot.InternalId(input.at("target"));
+    }
+
+    if (mode == "classic") {
+      result = BellmanFord(snapshot, sourceIndex, &tree, &cycle);
+    } else if (mode == "spfa") {
+      result = Spfa(snapshot, sourceIndex, &tree, &cycle);
+    } else if (mode == "parallel") {
+      result = ParallelBellmanFord(snapshot, sourceIndex, numThreads, &tree,
+                                   &cycle);
+    } else {
+      return -1;
+    }
+
+    /* Если из источника достижим цикл отрицательного веса, то кратчайших
+    путей нет, и в ответ записывается этот цикл. */
+    if (!result) {
+      for (size_t& vertex : cycle) {
+        vertex = snapshot.ExternalId(vertex);
+      }
+
+      (*output)["cycle"] = cycle;
+
+      return 0;
+    }
+
+    if (targetIndex == noVertex) {
+      (*output)["distances"] = nlohmann::json::array();
+
+      for (size_t index : snapshot.Vertices()) {
+        if (tree.distance[index] != ShortestPathTree<double>::Infinity()) {
+          (*output)["distances"].push_back({
+            { "vertex", snapshot.ExternalId(index) },
+            { "distance", tree.distance[index] }
+          });
+        }
+      }
+
+      return 0;
+    }
+
+    std::vector<size_t> path;
+
+    if (tree.distance[targetIndex] == ShortestPathTree<double>::Infinity()) {
+      (*output)["distance"] = nullptr;
+    } else {
+      (*output)["distance"] = tree.distance[targetIndex];
+      AppendTreePath(tree, targetIndex, &path);
+      std::reverse(path.begin(), path.end());
+    }
+
+    for (size_t& vertex : path) {
+      vertex = snapshot.ExternalId(vertex);
+    }
+
+    (*output)["path"] = path;
+  } catch (const std::out_of_range&) {
+    /* Вершин source или target нет в графе. */
+    return -1;
+  }
+
+  return 0;
+}
+
+}  // namespace graph
@@ -0,0 +1,126 @@
+/**
+ * @file methods/bfs_method.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Файл содержит функцию, которая вызывает поиск в ширину.
+ * Функция принимает и возвращает данные в JSON формате.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "bfs.hpp"
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+#include "graph_builder.hpp"
+#include "oriented_graph.hpp"
+#include "methods.hpp"
+
+namespace graph {
+
+int BfsMethod(const nlohmann::json& input, nlohmann::json* output) {
+  /* Рёбра сначала собираются в массив, а граф строится за один проход
+  без перехеширования. */
+  static thread_local GraphBuilder builder;
+  OrientedGraph graph;
+  const nlohmann::json& vertices = input.at("vertices");
+  const nlohmann::json& edges = input.at("edges");
+
+  builder.Clear();
+  builder.Reserve(vertices.size(), edges.size());
+
+  for (auto vertex : vertices) {
+    builder.AddVertex(vertex);
+  }
+
+  for (auto edge : edges) {
+    builder.AddEdge(edge.at("start"), edge.at("end"));
+  }
+
+  builder.Build(&graph);
+
+  CsrGraph snapshot(graph);
+  CsrGraph reverse;
+
+  reverse.AssignTranspose(snapshot);
+
+  return BfsGraphMethod(snapshot, reverse, input, output);
+}
+
+int BfsGraphMethod(const CsrGraph& snapshot, const CsrGraph& reverse,
+                   const nlohmann::json& input, nlohmann::json* output) {
+  (*output)["id"] = input.at("id");
+
+  size_t source = input.at("source");
+  /* Необязательное поле direction выбирает направление шагов: "auto" (по
+  умолчанию), "top-down" или "bottom-up". Поле threads задаёт число
+  потоков (не больше числа аппаратных потоков). */
+  std::string name = input.value("direction", "auto");
+  size_t numThreads = std::min(input.value("threads", MaxThreads()),
+                               MaxThreads());
+  BfsDirection direction;
+
+  if (name == "auto") {
+    direction = BfsDirection::Auto;
+  } else if (name == "top-down") {
+    direction = BfsDirection::TopDown;
+  } else if (name == "bottom-up") {
+    direction = BfsDirection::BottomUp;
+  } else {
+    return -1;
+  }
+
+  ShortestPathTree<size_t> tree;
+
+  try {
+    size_t sourceIndex = snapshot.InternalId(source);
+    size_t targetIndex = noVertex;
+
+    if (input.contains("target")) {
+      targetIndex = snapshot.InternalId(input.at("target"));
+    }
+
+    BreadthFirstSearch(snapshot, reverse, sourceIndex, direction,
+                       numThreads, &tree);
+
+    if (targetIndex == noVertex) {
+      (*output)["distances"] = nlohmann::json::array();
+
+      for (size_t index : snapshot.Vertices()) {
+        if (tree.distance[index] != ShortestPathTree<size_t>::Infinity()) {
+          (*output)["distances"].push_back({
+            { "vertex", snapshot.ExternalId(index) },
+            { "distance", tree.distance[index] }
+          });
+        }
+      }
+
+      return 0;
+    }
+
+    std::vector<size_t> path;
+
+    if (tree.distance[targetIndex] == ShortestPathTree<size_t>::Infinity()) {
+      (*output)["distance"] = nullptr;
+    } else {
+      (*output)["distance"] = tree.distance[targetIndex];
+      AppendTreePath(tree, targetIndex, &path);
+      std::reverse(path.begin(), path.end());
+    }
+
+    for (size_t& vertex : path) {
+      vertex = snapshot.ExternalId(vertex);
+    }
+
+    (*output)["path"] = path;
+  } catch (const std::out_of_range&) {
+    /* Вершин source или target нет в графе. */
+    return -1;
+  }
+
+  return 0;
+}
+
+}  // namespace graph
@@ -0,0 +1,329 @@
+/**
+ * @file methods/dijkstra_method.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Файл содержит функцию, которая вызывает алгоритм Дейкстры.
+ * Функция принимает и возвращает данные в JSON формате.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "delta_stepping.hpp"
+#include "dijkstra.hpp"
+#include "graph_builder.hpp"
+#include "heaps.hpp"
+#include "weighted_csr_graph.hpp"
+#include "weighted_oriented_graph.hpp"
+#include "methods.hpp"
+
+namespace graph {
+
+template<typename Weight, typename Heap>
+static int DijkstraMethodHelper(const nlohmann::json& input,
+                                nlohmann::json* output);
+
+static int DeltaSteppingMethodHelper(const nlohmann::json& input,
+                                     nlohmann::json* output);
+
+template<typename Weight>
+static bool BuildGraph(const nlohmann::json& input, bool positive,
+                       WeightedOrientedGraph<Weight>* graph);
+
+template<typename Weight>
+static bool ReadWeight(const nlohmann::json& value, Weight* weight);
+
+template<typename Weight>
+static void WriteDistances(
+    const std::vector<std::pair<size_t, Weight>>& distances,
+    nlohmann::json* output);
+
+int DijkstraMethod(const nlohmann::json& input, nlohmann::json* output) {
+  (*output)["id"] = input.at("id");
+
+  /* Необязательное поле algorithm выбирает алгоритм: "dijkstra" (по
+  умолчанию) или параллельный "delta-stepping". */
+  std::string algorithm = input.value("algorithm", "dijkstra");
+
+  if (algorithm == "delta-stepping") {
+    return DeltaSteppingMethodHelper(input, output);
+  } else if (algorithm != "dijkstra") {
+    return -1;
+  }
+
+  /* Необязательное поле heap выбирает очередь с приоритетами: "binary"
+  (по умолчанию), "4-ary", "pairing" или "radix". Поразрядная куча
+  работает только с целыми неотрицательными весами, сумма которых не
+  больше половины UINT64_MAX. */
+  std::string heap = input.value("heap", "binary");
+
+  if (heap == "binary") {
+    return DijkstraMethodHelper<double, BinaryHeap<double>>(input, output);
+  } else if (heap == "4-ary") {
+    return DijkstraMethodHelper<double, QuaternaryHeap<double>>(input,
+                                                                output);
+  } else if (heap == "pairing") {
+    return DijkstraMethodHelper<double, PairingHeap<double>>(input, output);
+  } else if (heap == "radix") {
+    return DijkstraMethodHelper<uint64_t, RadixHeap<uint64_t>>(input,
+                                                               output);
+  }
+
+  return -1;
+}
+
+/**
+ * @brief Построение графа и запуск алгоритма Дейкстры.
+ *
+ * @tparam Weight Тип веса.
+ * @tparam Heap Очередь с приоритетами.
+ *
+ * @param input Входные данные в формате JSON.
+ * @param output Выходные данные в формате JSON.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+template<typename Weight, typename Heap>
+static int DijkstraMethodHelper(const nlohmann::json& input,
+                                nlohmann::json* output) {
+  /* Рабочая память алгоритма переиспользуется между запросами, которые
+  обрабатывает один и тот же поток сервера. */
+  static thread_local DijkstraWorkspace<Weight, Heap> workspace;
+  WeightedOrientedGraph<Weight> graph;
+  size_t source = input.at("source");
+  bool bidirectional = input.value("bidirectional", false);
+
+  if (!BuildGraph(input, false, &graph)) {
+    return -1;
+  }
+
+  try {
+    if (!input.contains("target")) {
+      /* Без поля target возвращаются расстояния до всех достижимых
+      вершин. Двусторонний поиск без цели невозможен. */
+      if (bidirectional) {
+        return -1;
+      }
+
+      std::vector<std::pair<size_t, Weight>> distances;
+
+      Dijkstra(graph, source, &workspace, &distances);
+      WriteDistances(distances, output);
+
+      return 0;
+    }
+
+    size_t target = input.at("target");
+    std::vector<size_t> path;
+    Weight length;
+
+    if (ShortestPath(graph, source, target, bidirectional, &workspace,
+                     &path, &length)) {
+      (*output)["distance"] = length;
+    } else {
+      (*output)["distance"] = nullptr;
+    }
+
+    (*output)["path"] = path;
+  } catch (const std::out_of_range&) {
+    /* Вершин source или target нет в графе. */
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Построение графа и запуск алгоритма delta-stepping.
+ *
+ * @param input Входные данные в формате JSON.
+ * @param output Выходные данные в формате JSON.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+static int DeltaSteppingMethodHelper(const nlohmann::json& input,
+                                     nlohmann::json* output) {
+  WeightedOrientedGraph<double> graph;
+  size_t source = input.at("source");
+  /* Необязательные поля: ширина корзины delta (по умолчанию выбирается
+  по графу) и число потоков threads (не больше числа аппаратных
+  потоков). */
+  double delta = input.value("delta", 0.0);
+  size_t numThreads = input.value("threads", MaxThreads());
+
+  if (input.value("bidirectional", false) || delta < 0 ||
+      numThreads > MaxThreads() || !BuildGraph(input, true, &graph)) {
+    return -1;
+  }
+
+  WeightedCsrGraph<double> snapshot(graph);
+  ShortestPathTree<double> tree;
+
+  /* Слишком узкие корзины не помещаются в память: их число растёт как
+  maxWeight / delta. */
+  if (0 < delta && delta < MinDelta(snapshot)) {
+    return -1;
+  }
+
+  try {
+    size_t sourceIndex = snapshot.InternalId(source);
+    size_t targetIndex = noVertex;
+
+    if (input.contains("target")) {
+      targetIndex = snapshot.InternalId(input.at("target"));
+    }
+
+    DeltaStepping(snapshot, sourceIndex, delta, numThreads, &tree);
+
+    if (targetIndex == noVertex) {
+      std::vector<std::pair<size_t, double>> distances;
+
+      for (size_t index : snapshot.Vertices()) {
+        if (tree.distance[index] != ShortestPathTree<double>::Infinity()) {
+          distances.emplace_back(snapshot.ExternalId(index),
+                                 tree.distance[index]);
+        }
+      }
+
+      WriteDistances(distances, output);
+
+      return 0;
+    }
+
+    std::vector<size_t> path;
+
+    if (tree.distance[targetIndex] == ShortestPathTree<double>::Infinity()) {
+      (*output)["distance"] = nullptr;
+    } else {
+      (*output)["distance"] = tree.distance[targetIndex];
+      AppendTreePath(tree, targetIndex, &path);
+      std::reverse(path.begin(), path.end());
+    }
+
+    for (size_t& vertex : path) {
+      vertex = snapshot.ExternalId(vertex);
+    }
+
+    (*output)["path"] = path;
+  } catch (const std::out_of_range&) {
+    /* Вершин source или target нет в графе. */
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Построить граф по входным данным.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param input Входные данные в формате JSON.
+ * @param positive Должны ли веса быть строго положительными.
+ * @param graph Граф, в который добавляются вершины и рёбра.
+ * @return Функция возвращает false, если вес какого-то ребра некорректен.
+ *
+ * Для целых весов функция также возвращает false, если сумма весов всех
+ * рёбер больше половины наибольшего значения Weight. Длина простого пути
+ * вместе с ещё одним ребром не больше этой суммы, а в двустороннем поиске
+ * складываются две такие длины, поэтому расстояния не переполняются.
+ */
+template<typename Weight>
+static bool BuildGraph(const nlohmann::json& input, bool positive,
+                       WeightedOrientedGraph<Weight>* graph) {
+  /* Рёбра сначала собираются в массив, а граф строится за один проход
+  без перехеширования. */
+  static thread_local WeightedGraphBuilder<Weight> builder;
+  const nlohmann::json& vertices = input.at("vertices");
+  const nlohmann::json& edges = input.at("edges");
+
+  // Сумма весов рёбер (для целых весов).
+  Weight total = Weight();
+
+  builder.Clear();
+  builder.Reserve(vertices.size(), edges.size());
+
+  for (auto vertex : vertices) {
+    builder.AddVertex(vertex);
+  }
+
+  for (auto edge : edges) {
+    Weight weight;
+
+    if (!ReadWeight(edge.at("weight"), &weight) ||
+        (positive && !(Weight() < weight))) {
+      return false;
+    }
+
+    if constexpr (std::is_integral_v<Weight>) {
+      if (weight > std::numeric_limits<Weight>::max() / 2 - total) {
+        return false;
+      }
+
+      total += weight;
+    }
+
+    builder.AddEdge(edge.at("start"), edge.at("end"), weight);
+  }
+
+  builder.Build(graph);
+
+  return true;
+}
+
+/**
+ * @brief Записать расстояния до всех достижимых вершин в ответ.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param distances Пары (вершина, расстояние).
+ * @param output Выходные данные в формате JSON.
+ */
+template<typename Weight>
+static void WriteDistances(
+    const std::vector<std::pair<size_t, Weight>>& distances,
+    nlohmann::json* output) {
+  (*output)["distances"] = nlohmann::json::array();
+
+  for (const std::pair<size_t, Weight>& distance : distances) {
+    (*output)["distances"].push_back({
+      { "vertex", distance.first },
+      { "distance", distance.second }
+    });
+  }
+}
+
+/**
+ * @brief Прочитать вес ребра.
+ *
+ * @tparam Weight Тип веса.
+ *
+ * @param value Вес в формате JSON.
+ * @param weight Указатель, по которому записывается вес.
+ * @return Функция возвращает false, если вес отрицательный или не
+ * представим типом Weight.
+ */
+template<typename Weight>
+static bool ReadWeight(const nlohmann::json& value, Weight* weight) {
+  if constexpr (std::is_integral_v<Weight>) {
+    if (!value.is_number_unsigned()) {
+      return false;
+    }
+  } else {
+    if (!value.is_number() || value.template get<double>() < 0) {
+      return false;
+    }
+  }
+
+  *weight = value.template get<Weight>();
+
+  return true;
+}
+
+}  // namespace graph
@@ -0,0 +1,201 @@
+/**
+ * @file methods/graph_file_method.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Файл содержит функции для запуска алгоритмов на графах из файлов,
+ * которые сервер отображает в память при запуске. Функции принимают
+ * и возвращают данные в JSON формате.
+ */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "dijkstra.hpp"
+#include "graph_file.hpp"
+#include "methods.hpp"
+
+namespace graph {
+
+//! Графы из файлов по именам. Словарь заполняется до запуска сервера,
+//! а затем только читается, поэтому блокировка не нужна.
+static std::map<std::string, std::shared_ptr<const GraphFile>> graphFiles;
+
+static int DijkstraFileMethod(const GraphFile& file,
+                              const nlohmann::json& input,
+                              nlohmann::json* output);
+
+/**
+ * @brief Проверить, что веса рёбер файла неотрицательны.
+ *
+ * @param snapshot Снимок графа из файла.
+ * @return Функция возвращает false, если какой-то вес отрицателен или
+ * равен NaN.
+ */
+static bool NonNegativeWeights(const WeightedCsrGraph<double>& snapshot) {
+  for (double weight : snapshot.Weights()) {
+    if (!(weight >= 0)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void LoadGraphFile(const std::string& name, const std::string& path) {
+  std::shared_ptr<const GraphFile> file =
+      std::make_shared<const GraphFile>(path);
+
+  /* Файл мог быть записан не graph_convert, а другой программой, поэтому
+  содержимое проверяется целиком один раз при загрузке. Алгоритм Дейкстры
+  на файле полагается на неотрицательные веса. */
+  if (!file->Verify()) {
+    throw std::runtime_error(path + ": graph file is corrupted");
+  }
+
+  if (!NonNegativeWeights(file->Graph()) ||
+      !NonNegativeWeights(file->Reverse())) {
+    throw std::runtime_error(path + ": graph file has negative weights");
+  }
+
+  graphFiles[name] = std::move(file);
+}
+
+int GraphFileRunMethod(const nlohmann::json& input, nlohmann::json* output) {
+  std::string name = input.at("graph");
+  std::string method = input.at("method");
+  auto it = graphFiles.find(name);
+
+  if (it == graphFiles.end()) {
+    (*output)["graph"] = name;
+    (*output)["error"] = "unknown graph";
+    return -1;
+  }
+
+  const GraphFile& file = *it->second;
+
+  if (method == "BFS") {
+    if (!file.HasReverse()) {
+      (*output)["error"] = "graph file has no reverse edges";
+      return -1;
+    }
+
+    return BfsGraphMethod(file.Graph(), file.Reverse(), input, output);
+  }
+
+  if (method == "Dijkstra") {
+    return DijkstraFileMethod(file, input, output);
+  }
+
+  (*output)["graph"] = name;
+  (*output)["error"] = "unknown method";
+  return -1;
+}
+
+/**
+ * @brief Запуск алгоритма Дейкстры на графе из файла.
+ *
+ * @param file Граф из файла.
+ * @param input Поля запроса в формате JSON: id, source и необязательные
+ * поля target и bidirectional, как у DijkstraMethod().
+ * @param output Выходные данные в формате JSON в том же виде, что и у
+ * DijkstraMethod().
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+static int DijkstraFileMethod(const GraphFile& file,
+                              const nlohmann::json& input,
+                              nlohmann::json* output) {
+  /* Снимки рабочей памяти не используются: алгоритм работает прямо со
+  страницами файла. */
+  static thread_local DijkstraWorkspace<double> workspace;
+  const WeightedCsrGraph<double>& graph = file.Graph();
+  ShortestPathTree<double>& tree = workspace.forward;
+
+  (*output)["id"] = input.at("id");
+
+  size_t source = input.at("source");
+  bool bidirectional = input.value("bidirectional", false);
+
+  if (!file.HasWeights()) {
+    (*output)["error"] = "graph file has no weights";
+    return -1;
+  }
+
+  /* Двусторонний поиск возможен только до заданной цели и только если
+  в файле есть граф с обращёнными рёбрами. */
+  if (bidirectional && !input.contains("target")) {
+    (*output)["error"] = "bidirectional search needs a target";
+    return -1;
+  }
+
+  if (bidirectional && !file.HasReverse()) {
+    (*output)["error"] = "graph file has no reverse edges";
+    return -1;
+  }
+
+  try {
+    size_t sourceIndex = graph.InternalId(source);
+
+    if (!input.contains("target")) {
+      Dijkstra(graph, sourceIndex, noVertex, &workspace.forwardHeap, &tree);
+
+      (*output)["distances"] = nlohmann::json::array();
+
+      for (size_t index : graph.Vertices()) {
+        if (tree.distance[index] != ShortestPathTree<double>::Infinity()) {
+          (*output)["distances"].push_back({
+            { "vertex", graph.ExternalId(index) },
+            { "distance", tree.distance[index] }
+          });
+        }
+      }
+
+      return 0;
+    }
+
+    size_t targetIndex = graph.InternalId(input.at("target"));
+    std::vector<size_t> path;
+    double length = 0;
+    bool found;
+
+    if (bidirectional) {
+      found = BidirectionalDijkstra(graph, file.Reverse(), sourceIndex,
+                                    targetIndex, &workspace, &path, &length);
+    } else {
+      Dijkstra(graph, sourceIndex, targetIndex, &workspace.forwardHeap,
+               &tree);
+      found = tree.distance[targetIndex] !=
+              ShortestPathTree<double>::Infinity();
+
+      if (found) {
+        length = tree.distance[targetIndex];
+        AppendTreePath(tree, targetIndex, &path);
+        std::reverse(path.begin(), path.end());
+      }
+    }
+
+    if (found) {
+      (*output)["distance"] = length;
+    } else {
+      (*output)["distance"] = nullptr;
+    }
+
+    for (size_t& vertex : path) {
+      vertex = graph.ExternalId(vertex);
+    }
+
+    (*output)["path"] = path;
+  } catch (const std::out_of_range&) {
+    /* Вершин source или target нет в графе. */
+    return -1;
+  }
+
+  return 0;
+}
+
+}  // namespace graph
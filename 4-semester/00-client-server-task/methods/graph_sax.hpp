@@ -0,0 +1,378 @@
+/**
+ * @file methods/graph_sax.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Потоковый (SAX) разбор JSON запроса с графом без построения дерева
+ * nlohmann::json.
+ */
+
+#ifndef METHODS_GRAPH_SAX_HPP_
+#define METHODS_GRAPH_SAX_HPP_
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <nlohmann/json.hpp>
+
+namespace graph {
+
+/**
+ * @brief Проверить, принимает ли объект рёбра с весом.
+ *
+ * @tparam Builder Тип объекта, в который складывается граф.
+ */
+template<typename Builder, typename = void>
+struct AcceptsEdgeWeight : std::false_type {
+};
+
+/**
+ * @brief Проверить, принимает ли объект рёбра с весом.
+ *
+ * @tparam Builder Тип объекта с методом AddEdge(size_t, size_t, double).
+ */
+template<typename Builder>
+struct AcceptsEdgeWeight<Builder, std::void_t<decltype(
+    std::declval<Builder&>().AddEdge(size_t(), size_t(), double()))>> :
+    std::true_type {
+};
+
+/**
+ * @brief Обработчик событий SAX разбора запроса с графом.
+ *
+ * @tparam Builder Тип объекта, в который складывается граф. Должен иметь
+ * методы AddVertex(size_t) и AddEdge(size_t, size_t), например,
+ * graph::GraphBuilder или graph::OrientedGraph.
+ *
+ * Запрос имеет вид
+ * @code
+ * { "id": ..., "vertices": [ 1, 2, ... ],
+ *   "edges": [ { "start": 1, "end": 2 }, ... ], ... }
+ * @endcode
+ * Вершины и рёбра передаются в builder по мере чтения текста, поэтому
+ * копия графа в виде nlohmann::json не создаётся. Остальные поля верхнего
+ * уровня со скалярными значениями (id, algorithm и т.д.) складываются
+ * в объект fields, а вложенные значения неизвестных полей пропускаются.
+ *
+ * Если номер вершины не является неотрицательным целым числом или у ребра
+ * нет поля start или end, то разбор прерывается с ошибкой.
+ *
+ * Если у Builder есть метод AddEdge(size_t, size_t, double), то ребро
+ * с числовым полем weight передаётся в него вместе с весом. Иначе поле
+ * weight, как и другие посторонние поля ребра, пропускается. Значения
+ * посторонних полей ребра могут быть вложенными объектами и массивами.
+ */
+template<typename Builder>
+class GraphSaxHandler : public nlohmann::json_sax<nlohmann::json> {
+ public:
+  /**
+   * @brief Конструктор класса GraphSaxHandler.
+   *
+   * @param builder Объект, в который складывается граф.
+   * @param fields Объект для скалярных полей верхнего уровня.
+   */
+  GraphSaxHandler(Builder* builder, nlohmann::json* fields) :
+    builder(builder),
+    fields(fields),
+    depth(0),
+    section(Section::None),
+    start(0),
+    end(0),
+    weight(0),
+    hasStart(false),
+    hasEnd(false),
+    hasWeight(false) {
+  }
+
+  bool null() override {
+    return Scalar(nullptr);
+  }
+
+  bool boolean(bool val) override {
+    return Scalar(val);
+  }
+
+  bool number_integer(number_integer_t val) override {
+    if (val < 0) {
+      return EdgeWeight(static_cast<double>(val)) || Scalar(val);
+    }
+
+    return Number(static_cast<number_unsigned_t>(val));
+  }
+
+  bool number_unsigned(number_unsigned_t val) override {
+    return Number(val);
+  }
+
+  bool number_float(number_float_t val,
+                    const string_t& /* s */) override {
+    return EdgeWeight(val) || Scalar(val);
+  }
+
+  bool string(string_t& val) override {
+    return Scalar(val);
+  }
+
+  bool binary(binary_t& /* val */) override {
+    return section == Section::Skip || InEdgeField();
+  }
+
+  bool start_object(std::size_t /* elements */) override {
+    depth++;
+
+    if (depth == 2) {
+      section = Section::Skip;
+      return true;
+    }
+
+    if (section == Section::Edges && depth == 3) {
+      hasStart = false;
+      hasEnd = false;
+      hasWeight = false;
+      return true;
+    }
+
+    if (InEdgeField()) {
+      return NestedEdgeField();
+    }
+
+    return depth == 1 || section == Section::Skip;
+  }
+
+  bool key(string_t& val) override {
+    if (depth == 1) {
+      currentKey = val;
+      section = Section::None;
+    } else if (depth == 3 && section == Section::Edges) {
+      edgeKey = val;
+    }
+
+    return true;
+  }
+
+  bool end_object() override {
+    if (section == Section::Edges && depth == 3) {
+      if (!hasStart || !hasEnd) {
+        return false;
+      }
+
+      AddEdge();
+    }
+
+    if (depth == 2) {
+      section = Section::None;
+    }
+
+    depth--;
+
+    return true;
+  }
+
+  bool start_array(std::size_t /* elements */) override {
+    depth++;
+
+    if (depth == 2) {
+      if (currentKey == "vertices") {
+        section = Section::Vertices;
+      } else if (currentKey == "edges") {
+        section = Section::Edges;
+      } else {
+        section = Section::Skip;
+      }
+
+      return true;
+    }
+
+    if (InEdgeField()) {
+      return NestedEdgeField();
+    }
+
+    return section == Section::Skip;
+  }
+
+  bool end_array() override {
+    if (depth == 2) {
+      section = Section::None;
+    }
+
+    depth--;
+
+    return true;
+  }
+
+  bool parse_error(std::size_t /* position */,
+                   const std::string& /* last_token */,
+                   const nlohmann::detail::exception& /* ex */) override {
+    return false;
+  }
+
+ private:
+  /**
+   * @brief Раздел запроса, который читается в данный момент.
+   */
+  enum class Section {
+    //! Поле верхнего уровня со скалярным значением.
+    None,
+    //! Массив vertices.
+    Vertices,
+    //! Массив edges.
+    Edges,
+    //! Вложенное значение неизвестного поля.
+    Skip
+  };
+
+  /**
+   * @brief Находится ли разбор внутри вложенного значения поля ребра.
+   *
+   * Рёбра лежат на глубине 3, поэтому всё, что глубже, относится
+   * к значению какого-то поля ребра и пропускается, пока разбор не
+   * вернётся на глубину ребра.
+   */
+  bool InEdgeField() const {
+    return section == Section::Edges && depth > 3;
+  }
+
+  /**
+   * @brief Обработка начала вложенного объекта или массива в ребре.
+   *
+   * Функция возвращает false, если вложенное значение записано в поле
+   * start или end: там допустим только номер вершины.
+   */
+  bool NestedEdgeField() const {
+    return depth > 4 || (edgeKey != "start" && edgeKey != "end");
+  }
+
+  /**
+   * @brief Обработка неотрицательного целого числа.
+   *
+   * @param val Значение.
+   */
+  bool Number(number_unsigned_t val) {
+    if (section == Section::Vertices && depth == 2) {
+      builder->AddVertex(static_cast<size_t>(val));
+      return true;
+    }
+
+    if (section == Section::Edges && depth == 3) {
+      if (edgeKey == "start") {
+        start = static_cast<size_t>(val);
+        hasStart = true;
+      } else if (edgeKey == "end") {
+        end = static_cast<size_t>(val);
+        hasEnd = true;
+      } else if (edgeKey == "weight") {
+        EdgeWeight(static_cast<double>(val));
+      }
+
+      return true;
+    }
+
+    return Scalar(val);
+  }
+
+  /**
+   * @brief Обработка числа, которое может быть весом ребра.
+   *
+   * @param val Значение.
+   *
+   * Функция возвращает false, если значение не является полем weight
+   * текущего ребра.
+   */
+  bool EdgeWeight(double val) {
+    if (section != Section::Edges || depth != 3 || edgeKey != "weight") {
+      return false;
+    }
+
+    weight = val;
+    hasWeight = true;
+
+    return true;
+  }
+
+  /**
+   * @brief Передать прочитанное ребро в builder.
+   */
+  void AddEdge() {
+    if constexpr (AcceptsEdgeWeight<Builder>::value) {
+      if (hasWeight) {
+        builder->AddEdge(start, end, weight);
+        return;
+      }
+    }
+
+    builder->AddEdge(start, end);
+  }
+
+  /**
+   * @brief Обработка скалярного значения, не являющегося номером вершины.
+   *
+   * @param value Значение.
+   *
+   * Функция возвращает false, если такое значение недопустимо в текущем
+   * месте запроса.
+   */
+  bool Scalar(const nlohmann::json& value) {
+    if (depth == 1 && section == Section::None) {
+      (*fields)[currentKey] = value;
+      return true;
+    }
+
+    if (section == Section::Edges && depth == 3) {
+      // Нечисловые значения допустимы только в посторонних полях ребра.
+      return edgeKey != "start" && edgeKey != "end";
+    }
+
+    return section == Section::Skip || InEdgeField();
+  }
+
+  //! Объект, в который складывается граф.
+  Builder* builder;
+  //! Скалярные поля верхнего уровня.
+  nlohmann::json* fields;
+  //! Текущая глубина вложенности.
+  size_t depth;
+  //! Текущий раздел запроса.
+  Section section;
+  //! Текущий ключ верхнего уровня.
+  std::string currentKey;
+  //! Текущий ключ внутри описания ребра.
+  std::string edgeKey;
+  //! Начало текущего ребра.
+  size_t start;
+  //! Конец текущего ребра.
+  size_t end;
+  //! Вес текущего ребра.
+  double weight;
+  //! Было ли прочитано начало текущего ребра.
+  bool hasStart;
+  //! Был ли прочитан конец текущего ребра.
+  bool hasEnd;
+  //! Был ли прочитан вес текущего ребра.
+  bool hasWeight;
+};
+
+/**
+ * @brief Потоковый разбор запроса с графом.
+ *
+ * @tparam Builder Тип объекта, в который складывается граф.
+ *
+ * @param body Текст запроса.
+ * @param builder Объект, в который складывается граф.
+ * @param fields Объект для скалярных полей верхнего уровня.
+ *
+ * @return Функция возвращает true в случае успеха и false, если текст
+ * запроса не является корректным JSON или не соответствует формату.
+ */
+template<typename Builder>
+bool ParseGraph(const std::string& body, Builder* builder,
+                nlohmann::json* fields) {
+  GraphSaxHandler<Builder> handler(builder, fields);
+
+  *fields = nlohmann::json::object();
+
+  return nlohmann::json::sax_parse(body, &handler);
+}
+
+}  // namespace graph
+
+#endif  // METHODS_GRAPH_SAX_HPP_
@@ -0,0 +1,189 @@
+/**
+ * @file methods/graph_session_method.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Файл содержит функции для работы с графами, которые хранятся на сервере
+ * между запросами. Функции принимают и возвращают данные в JSON формате.
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "graph_builder.hpp"
+#include "graph_sessions.hpp"
+#include "oriented_graph.hpp"
+#include "methods.hpp"
+
+namespace graph {
+
+//! Хранилище сессий. По умолчанию графы сессий занимают не больше 1 ГиБ,
+//! а сессия живёт 10 минут после последнего обращения.
+static GraphSessionStore sessions(size_t(1) << 30, std::chrono::minutes(10));
+
+/**
+ * @brief Записать в ответ размер и версию графа сессии.
+ *
+ * @param session Сессия.
+ * @param output Выходные данные в формате JSON.
+ */
+static void Describe(const GraphSession& session, nlohmann::json* output) {
+  (*output)["vertices"] = session.NumVertices();
+  (*output)["edges"] = session.NumEdges();
+  (*output)["version"] = session.Version();
+}
+
+/**
+ * @brief Прочитать вершины и рёбра части пакета изменений.
+ *
+ * @param part Объект JSON с необязательными массивами vertices и edges.
+ * @param vertices Вектор, в который добавляются вершины.
+ * @param edges Вектор, в который добавляются рёбра.
+ */
+static void ReadDelta(const nlohmann::json& part,
+                      std::vector<size_t>* vertices,
+                      std::vector<std::pair<size_t, size_t>>* edges) {
+  if (part.contains("vertices")) {
+    for (const nlohmann::json& vertex : part.at("vertices")) {
+      vertices->push_back(vertex);
+    }
+  }
+
+  if (part.contains("edges")) {
+    for (const nlohmann::json& edge : part.at("edges")) {
+      edges->emplace_back(edge.at("start"), edge.at("end"));
+    }
+  }
+}
+
+void SetSessionLimits(size_t maxBytes, std::chrono::nanoseconds ttl) {
+  sessions.SetLimits(maxBytes, std::chrono::duration_cast<
+      GraphSessionStore::Clock::duration>(ttl));
+}
+
+int SessionCreateMethod(const nlohmann::json& input, nlohmann::json* output) {
+  std::string name = input.at("session");
+  const nlohmann::json& vertices = input.at("vertices");
+  const nlohmann::json& edges = input.at("edges");
+  static thread_local GraphBuilder builder;
+  OrientedGraph graph;
+
+  (*output)["session"] = name;
+
+  builder.Clear();
+  builder.Reserve(vertices.size(), edges.size());
+
+  for (auto vertex : vertices) {
+    builder.AddVertex(vertex);
+  }
+
+  /* Концы рёбер тоже добавляются как вершины, чтобы у каждой вершины
+  графа сессии были оба словаря рёбер. */
+  for (auto edge : edges) {
+    size_t start = edge.at("start");
+    size_t end = edge.at("end");
+
+    builder.AddVertex(start);
+    builder.AddVertex(end);
+    builder.AddEdge(start, end);
+  }
+
+  builder.Build(&graph);
+
+  std::shared_ptr<GraphSession> session =
+      sessions.Create(name, std::move(graph));
+
+  if (!session) {
+    (*output)["error"] = "session is too large";
+    return -1;
+  }
+
+  Describe(*session, output);
+
+  return 0;
+}
+
+int SessionUpdateMethod(const nlohmann::json& input, nlohmann::json* output) {
+  std::string name = input.at("session");
+  GraphDelta delta;
+
+  (*output)["session"] = name;
+
+  if (input.contains("remove")) {
+    ReadDelta(input.at("remove"), &delta.removeVertices, &delta.removeEdges);
+  }
+
+  if (input.contains("add")) {
+    ReadDelta(input.at("add"), &delta.addVertices, &delta.addEdges);
+  }
+
+  std::shared_ptr<GraphSession> session = sessions.Find(name);
+
+  if (!session) {
+    (*output)["error"] = "unknown session";
+    return -1;
+  }
+
+  /* Пакет, после которого граф не помещается в ограничение памяти,
+  отклоняется, а сессия остаётся без изменений. */
+  if (!session->Apply(delta, sessions.MaxBytes())) {
+    (*output)["error"] = "session is too large";
+    return -1;
+  }
+
+  if (!sessions.Account(session)) {
+    (*output)["error"] = "unknown session";
+    return -1;
+  }
+
+  Describe(*session, output);
+
+  return 0;
+}
+
+int SessionRunMethod(const nlohmann::json& input, nlohmann::json* output) {
+  std::string name = input.at("session");
+  std::string method = input.at("method");
+  std::shared_ptr<GraphSession> session = sessions.Find(name);
+
+  if (!session) {
+    (*output)["session"] = name;
+    (*output)["error"] = "unknown session";
+    return -1;
+  }
+
+  if (method != "TopologicalSort" && method != "BFS") {
+    (*output)["session"] = name;
+    (*output)["error"] = "unknown method";
+    return -1;
+  }
+
+  /* Оба алгоритма работают на снимке сессии, который строится один раз
+  и переиспользуется, пока граф не изменится. */
+  std::shared_ptr<const GraphSnapshot> snapshot = session->Snapshot();
+
+  /* Снимок увеличивает память сессии. Если с ним сессия не помещается
+  в ограничение, то хранилище удаляет только снимок, а текущий запрос
+  всё равно выполняется на нём. */
+  sessions.Account(session);
+
+  if (method == "TopologicalSort") {
+    return TopologicalSortSnapshotMethod(snapshot->graph, snapshot->reverse,
+                                         input, output);
+  }
+
+  return BfsGraphMethod(snapshot->graph, snapshot->reverse, input, output);
+}
+
+int SessionDeleteMethod(const nlohmann::json& input, nlohmann::json* output) {
+  std::string name = input.at("session");
+
+  (*output)["session"] = name;
+  (*output)["deleted"] = sessions.Remove(name);
+
+  return 0;
+}
+
+}  // namespace graph
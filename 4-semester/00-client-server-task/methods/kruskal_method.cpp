@@ -0,0 +1,111 @@
+/**
+ * @file methods/kruskal_method.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Файл содержит функцию, которая вызывает алгоритм Краскала, Прима или
+ * Борувки.
+ * Функция принимает и возвращает данные в JSON формате.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "boruvka.hpp"
+#include "graph_builder.hpp"
+#include "kruskal.hpp"
+#include "prim.hpp"
+#include "weighted_graph.hpp"
+#include "methods.hpp"
+
+namespace graph {
+
+int KruskalMethod(const nlohmann::json& input, nlohmann::json* output) {
+  (*output)["id"] = input.at("id");
+
+  /* Рёбра сначала собираются в массив, а граф строится за один проход
+  без перехеширования. */
+  static thread_local WeightedGraphBuilder<double> builder;
+  WeightedGraph<double> graph;
+  /* Необязательное поле algorithm выбирает алгоритм: "kruskal" (по
+  умолчанию), "filter-kruskal", "prim" или "boruvka". Поле threads задаёт
+  число потоков для сортировки рёбер и алгоритма Борувки (не больше числа
+  аппаратных потоков и числа вершин). Для алгоритма
+  Прима поле heap выбирает вариант: "auto" (по умолчанию), "indexed",
+  "lazy" или "dense". */
+  std::string algorithm = input.value("algorithm", "kruskal");
+  std::string heap = input.value("heap", "auto");
+  size_t numThreads = input.value("threads", MaxThreads());
+  const nlohmann::json& vertices = input.at("vertices");
+  const nlohmann::json& edges = input.at("edges");
+  PrimStrategy strategy;
+
+  if (heap == "auto") {
+    strategy = PrimStrategy::Auto;
+  } else if (heap == "indexed") {
+    strategy = PrimStrategy::Indexed;
+  } else if (heap == "lazy") {
+    strategy = PrimStrategy::Lazy;
+  } else if (heap == "dense") {
+    strategy = PrimStrategy::Dense;
+  } else {
+    return -1;
+  }
+
+  if (algorithm != "kruskal" && algorithm != "filter-kruskal" &&
+      algorithm != "prim" && algorithm != "boruvka") {
+    return -1;
+  }
+
+  builder.Clear();
+  builder.Reserve(vertices.size(), edges.size());
+
+  for (auto vertex : vertices) {
+    builder.AddVertex(vertex);
+  }
+
+  for (auto edge : edges) {
+    const nlohmann::json& weight = edge.at("weight");
+
+    if (!weight.is_number()) {
+      return -1;
+    }
+
+    builder.AddEdge(edge.at("start"), edge.at("end"),
+                    weight.get<double>());
+  }
+
+  builder.Build(&graph);
+
+  numThreads = std::max<size_t>(
+      std::min({ numThreads, MaxThreads(), graph.NumVertices() }), 1);
+
+  std::vector<MstEdge<double>> forest;
+  double total = 0;
+
+  if (algorithm == "prim") {
+    Prim(graph, strategy, &forest);
+  } else if (algorithm == "boruvka") {
+    Boruvka(graph, numThreads, &forest);
+  } else {
+    Kruskal(graph, algorithm == "filter-kruskal", numThreads, &forest);
+  }
+
+  (*output)["edges"] = nlohmann::json::array();
+
+  for (const MstEdge<double>& edge : forest) {
+    (*output)["edges"].push_back({
+      { "start", edge.start },
+      { "end", edge.end },
+      { "weight", edge.weight }
+    });
+
+    total += edge.weight;
+  }
+
+  (*output)["weight"] = total;
+
+  return 0;
+}
+
+}  // namespace graph
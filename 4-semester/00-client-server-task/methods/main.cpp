@@ -6,15 +6,65 @@
  */
 
 #include <httplib.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 #include <nlohmann/json.hpp>
 #include "methods.hpp"
+#include "trace.hpp"
+#include "worker_pool.hpp"
 
-using graph::TopologicalSortMethod;
+using graph::BellmanFordMethod;
+using graph::BfsMethod;
+using graph::BudgetExceeded;
+using graph::CpuBudget;
+using graph::DijkstraMethod;
+using graph::GraphFileRunMethod;
+using graph::KruskalMethod;
+using graph::LoadGraphFile;
+using graph::SessionCreateMethod;
+using graph::SessionDeleteMethod;
+using graph::SessionRunMethod;
+using graph::SessionUpdateMethod;
+using graph::SetSessionLimits;
+using graph::TopologicalSortBatchMethod;
+using graph::TopologicalSortBinaryMethod;
+using graph::TopologicalSortStreamMethod;
+using graph::WireContentType;
+using graph::WireEncoding;
+using graph::WireEncodingFromContentType;
+using graph::WorkerPool;
+
+//! Тип обработчика запроса.
+using Handler = std::function<void(const httplib::Request&,
+                                   httplib::Response&)>;
+
+static Handler Limited(Handler handler);
+
+//! Ограничение процессорного времени на один запрос (0 --- без
+//! ограничения). Задаётся до запуска сервера и затем только читается.
+static std::chrono::nanoseconds cpuBudget = std::chrono::nanoseconds::zero();
 
 int main(int argc, char* argv[]) {
   // Порт по-умолчанию.
   int port = 8080;
+  // Число рабочих потоков по умолчанию.
+  unsigned numWorkers = std::max(std::thread::hardware_concurrency(), 1U);
+  // Максимальное число соединений, ожидающих в очереди, по умолчанию.
+  unsigned queueLimit = 8 * numWorkers;
+  // Ограничение процессорного времени на запрос в миллисекундах (0 ---
+  // без ограничения). В /TopologicalSort/batch оно действует на каждый
+  // граф отдельно.
+  unsigned cpuBudgetMs = 0;
+  // Ограничение памяти графов сессий в мегабайтах.
+  unsigned sessionMemory = 1024;
+  // Время жизни сессии без обращений в секундах (0 --- без ограничения).
+  unsigned sessionTtl = 600;
 
   if (argc >= 2) {
     // Меняем порт по умолчанию, если предоставлен соответствующий
@@ -24,10 +74,63 @@ int main(int argc, char* argv[]) {
     }
   }
 
-  std::cerr << "Listening on port " << port << "..." << std::endl;
+  // Остальные необязательные аргументы: число рабочих потоков, длина
+  // очереди, ограничение процессорного времени на запрос, ограничение
+  // памяти сессий и время жизни сессии.
+  if (argc >= 3 && std::sscanf(argv[2], "%u", &numWorkers) != 1) {
+    return -1;
+  }
+
+  if (argc >= 4 && std::sscanf(argv[3], "%u", &queueLimit) != 1) {
+    return -1;
+  }
+
+  if (argc >= 5 && std::sscanf(argv[4], "%u", &cpuBudgetMs) != 1) {
+    return -1;
+  }
+
+  if (argc >= 6 && std::sscanf(argv[5], "%u", &sessionMemory) != 1) {
+    return -1;
+  }
+
+  if (argc >= 7 && std::sscanf(argv[6], "%u", &sessionTtl) != 1) {
+    return -1;
+  }
+
+  // Аргументы вида имя=путь задают файлы с графами, которые отображаются
+  // в память и доступны по адресу /GraphFile/run.
+  for (int i = 7; i < argc; i++) {
+    std::string argument = argv[i];
+    size_t separator = argument.find('=');
+
+    if (separator == std::string::npos) {
+      return -1;
+    }
+
+    try {
+      LoadGraphFile(argument.substr(0, separator),
+                    argument.substr(separator + 1));
+    } catch (const std::runtime_error& error) {
+      std::cerr << error.what() << std::endl;
+      return -1;
+    }
+  }
+
+  cpuBudget = std::chrono::milliseconds(cpuBudgetMs);
+  SetSessionLimits(static_cast<size_t>(sessionMemory) << 20,
+                   std::chrono::seconds(sessionTtl));
+
+  std::cerr << "Listening on port " << port << " with " << numWorkers
+            << " workers..." << std::endl;
 
   httplib::Server svr;
 
+  // Вместо стандартной очереди задач используется пул с ограниченной
+  // очередью и закреплением потоков за ядрами.
+  svr.new_task_queue = [numWorkers, queueLimit]() {
+    return new WorkerPool(numWorkers, queueLimit, true);
+  };
+
   // Обработчик для GET запроса по адресу /stop. Этот обработчик
   // останавливает сервер.
   svr.Get("/stop", [&](const httplib::Request& /*unused*/,
@@ -41,22 +144,46 @@ int main(int argc, char* argv[]) {
   на сервере. */
   svr.Post(
     "/TopologicalSort",
-    [&](
+    Limited([&](
       const httplib::Request& request, 
       httplib::Response& response
     ) {
+      /*
+      Формат запроса определяется заголовком Content-Type. Для двоичного
+      формата (application/x-graph и application/x-graph-varint) ответ
+      кодируется так же, как запрос.
+      */
+      WireEncoding encoding;
+
+      if (WireEncodingFromContentType(
+            request.get_header_value("Content-Type"), &encoding)) {
+        std::string output;
+
+        if (TopologicalSortBinaryMethod(request.body, encoding, &output) < 0)
+          response.status = 400;
+
+        response.set_content(output, WireContentType(encoding));
+        return;
+      }
+
       /*
       Поле body структуры httplib::Request содержит текст запроса.
-      Функция nlohmann::json::parse() используется для того,
-      чтобы преобразовать текст в объект типа nlohmann::json.
+      Запрос с графом может быть очень большим, поэтому он не
+      преобразуется в объект nlohmann::json целиком: функция
+      TopologicalSortStreamMethod() разбирает текст потоково
+      и складывает вершины и рёбра сразу в граф.
       */
-      const nlohmann::json input = nlohmann::json::parse(request.body);
       nlohmann::json output;
-      
-      /* Если метод завершился с ошибкой, то выставляем статус 400. */
-      if (TopologicalSortMethod(input, &output) < 0)
+
+      /* Если в запросе нет обязательных полей или метод завершился
+      с ошибкой, то выставляем статус 400. */
+      try {
+        if (TopologicalSortStreamMethod(request.body, &output) < 0)
+          response.status = 400;
+      } catch (const nlohmann::json::exception&) {
         response.status = 400;
-      
+      }
+
       /*
       Метод nlohmann::json::dump() используется для сериализации
       объекта типа nlohmann::json в строку. Метод set_content()
@@ -64,9 +191,169 @@ int main(int argc, char* argv[]) {
       JSON данные, то MIME тип следует выставить application/json.
       */
       response.set_content(output.dump(), "application/json");
-    }
+    })
+  );
+
+  /* /TopologicalSort/batch принимает сразу много графов, чтобы накладные
+  расходы на соединение и разбор запроса делились между ними. */
+  svr.Post(
+    "/TopologicalSort/batch",
+    Limited([&](
+      const httplib::Request& request,
+      httplib::Response& response
+    ) {
+      nlohmann::json input = nlohmann::json::parse(request.body, nullptr,
+                                                    false);
+      nlohmann::json output;
+
+      /* Если тело запроса не является JSON или метод завершился
+      с ошибкой, то выставляем статус 400. */
+      if (input.is_discarded() ||
+          TopologicalSortBatchMethod(input, &output) < 0)
+        response.status = 400;
+
+      response.set_content(output.dump(), "application/json");
+    })
+  );
+
+  /* /Dijkstra это адрес для запросов на поиск кратчайших путей. */
+  svr.Post(
+    "/Dijkstra",
+    Limited([&](
+      const httplib::Request& request,
+      httplib::Response& response
+    ) {
+      nlohmann::json input = nlohmann::json::parse(request.body, nullptr,
+                                                    false);
+      nlohmann::json output;
+
+      /* Если тело запроса не является JSON, в нём нет обязательных полей
+      или метод завершился с ошибкой, то выставляем статус 400. */
+      try {
+        if (input.is_discarded() || DijkstraMethod(input, &output) < 0)
+          response.status = 400;
+      } catch (const nlohmann::json::exception&) {
+        response.status = 400;
+      }
+
+      response.set_content(output.dump(), "application/json");
+    })
+  );
+
+  /* /BellmanFord это адрес для запросов на поиск кратчайших путей в графах
+  с отрицательными весами. */
+  svr.Post(
+    "/BellmanFord",
+    Limited([&](
+      const httplib::Request& request,
+      httplib::Response& response
+    ) {
+      nlohmann::json input = nlohmann::json::parse(request.body, nullptr,
+                                                    false);
+      nlohmann::json output;
+
+      /* Если тело запроса не является JSON, в нём нет обязательных полей
+      или метод завершился с ошибкой, то выставляем статус 400. */
+      try {
+        if (input.is_discarded() || BellmanFordMethod(input, &output) < 0)
+          response.status = 400;
+      } catch (const nlohmann::json::exception&) {
+        response.status = 400;
+      }
+
+      response.set_content(output.dump(), "application/json");
+    })
+  );
+
+  /* /Kruskal это адрес для запросов на построение минимального остовного
+  леса. */
+  svr.Post(
+    "/Kruskal",
+    Limited([&](
+      const httplib::Request& request,
+      httplib::Response& response
+    ) {
+      nlohmann::json input = nlohmann::json::parse(request.body, nullptr,
+                                                    false);
+      nlohmann::json output;
+
+      /* Если тело запроса не является JSON, в нём нет обязательных полей
+      или метод завершился с ошибкой, то выставляем статус 400. */
+      try {
+        if (input.is_discarded() || KruskalMethod(input, &output) < 0)
+          response.status = 400;
+      } catch (const nlohmann::json::exception&) {
+        response.status = 400;
+      }
+
+      response.set_content(output.dump(), "application/json");
+    })
   );
 
+  /* /BFS это адрес для запросов на поиск в ширину. */
+  svr.Post(
+    "/BFS",
+    Limited([&](
+      const httplib::Request& request,
+      httplib::Response& response
+    ) {
+      nlohmann::json input = nlohmann::json::parse(request.body, nullptr,
+                                                    false);
+      nlohmann::json output;
+
+      /* Если тело запроса не является JSON, в нём нет обязательных полей
+      или метод завершился с ошибкой, то выставляем статус 400. */
+      try {
+        if (input.is_discarded() || BfsMethod(input, &output) < 0)
+          response.status = 400;
+      } catch (const nlohmann::json::exception&) {
+        response.status = 400;
+      }
+
+      response.set_content(output.dump(), "application/json");
+    })
+  );
+
+  /* Адреса /Session/... работают с графами, которые хранятся на сервере
+  между запросами: клиент один раз загружает граф, затем присылает только
+  изменения и запросы на запуск алгоритмов. Адрес /GraphFile/run так же
+  запускает алгоритмы на графах из файлов, отображённых в память. */
+  const std::pair<const char*, int (*)(const nlohmann::json&,
+                                       nlohmann::json*)> sessionMethods[] = {
+    { "/Session/create", SessionCreateMethod },
+    { "/Session/update", SessionUpdateMethod },
+    { "/Session/run", SessionRunMethod },
+    { "/Session/delete", SessionDeleteMethod },
+    { "/GraphFile/run", GraphFileRunMethod }
+  };
+
+  for (const auto& sessionMethod : sessionMethods) {
+    auto method = sessionMethod.second;
+
+    svr.Post(
+      sessionMethod.first,
+      Limited([method](
+        const httplib::Request& request,
+        httplib::Response& response
+      ) {
+        nlohmann::json input = nlohmann::json::parse(request.body, nullptr,
+                                                      false);
+        nlohmann::json output;
+
+        /* Если тело запроса не является JSON, в нём нет обязательных
+        полей или метод завершился с ошибкой, то выставляем статус 400. */
+        try {
+          if (input.is_discarded() || method(input, &output) < 0)
+            response.status = 400;
+        } catch (const nlohmann::json::exception&) {
+          response.status = 400;
+        }
+
+        response.set_content(output.dump(), "application/json");
+      })
+    );
+  }
+
   /* Конец вставки. */
 
   // Эта функция запускает сервер на указанном порту. Программа не завершится
@@ -75,3 +362,33 @@ int main(int argc, char* argv[]) {
 
   return 0;
 }
+
+/**
+ * @brief Обёртка над обработчиком запроса, реализующая сброс нагрузки.
+ *
+ * @param handler Исходный обработчик.
+ * @return Обработчик, который отвечает кодом 503 с заголовком Retry-After,
+ * если для запроса не хватило места в очереди пула или алгоритм превысил
+ * ограничение процессорного времени.
+ */
+static Handler Limited(Handler handler) {
+  return [handler](const httplib::Request& request,
+                   httplib::Response& response) {
+    if (!WorkerPool::Shedding()) {
+      try {
+        // Алгоритмы списывают с ограничения время всех своих потоков.
+        CpuBudget budget(cpuBudget);
+
+        handler(request, response);
+        return;
+      } catch (const BudgetExceeded&) {
+        // Алгоритм прерван, ниже отправляется ответ 503.
+      }
+    }
+
+    response.status = 503;
+    response.set_header("Retry-After", "1");
+    response.set_content("{\"error\":\"server overloaded\"}",
+                         "application/json");
+  };
+}
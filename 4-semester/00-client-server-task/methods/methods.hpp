@@ -10,12 +10,259 @@
 #ifndef METHODS_METHODS_HPP_
 #define METHODS_METHODS_HPP_
 
+#include <chrono>
+#include <string>
+#include "csr_graph.hpp"
+#include "wire_format.hpp"
+
 namespace graph {
 
 /* Сюда нужно вставить объявление серверной части алгоритма. */
 
 int TopologicalSortMethod(const nlohmann::json& input, nlohmann::json* output);
 
+/**
+ * @brief Метод топологической сортировки для набора графов.
+ *
+ * @param input Входные данные в формате JSON: поле graphs содержит массив
+ * запросов того же вида, что и для TopologicalSortMethod(), а необязательное
+ * поле threads --- максимальное число потоков.
+ * @param output Выходные данные в формате JSON: поле results содержит
+ * ответы в том же порядке, что и графы запроса.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ *
+ * Графы сортируются параллельно. Ошибка в одном графе не прерывает
+ * обработку остальных: в его ответ записывается поле error.
+ */
+int TopologicalSortBatchMethod(const nlohmann::json& input,
+                               nlohmann::json* output);
+
+/**
+ * @brief Метод топологической сортировки с потоковым разбором запроса.
+ *
+ * @param input Текст запроса в формате JSON.
+ * @param output Выходные данные в формате JSON.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ *
+ * В отличие от TopologicalSortMethod() функция не строит дерево
+ * nlohmann::json для запроса: вершины и рёбра складываются в граф прямо
+ * во время разбора текста.
+ */
+int TopologicalSortStreamMethod(const std::string& input,
+                                nlohmann::json* output);
+
+/**
+ * @brief Метод топологической сортировки для запросов в двоичном формате.
+ *
+ * @param input Текст запроса в двоичном формате (@sa wire_format.hpp).
+ * @param encoding Способ кодирования чисел в запросе и ответе.
+ * @param output Указатель, по которому записывается ответ в двоичном
+ * формате.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ *
+ * Запрос содержит id, имя алгоритма, число потоков (0 означает значение
+ * по умолчанию), массив вершин и массив рёбер. Ответ содержит id, порядок
+ * вершин и массив размеров уровней (пустой для алгоритма "dfs"). Для
+ * алгоритмов "tarjan" и "forward-backward" вместо уровней записываются
+ * размеры компонент сильной связности в порядке конденсации.
+ */
+int TopologicalSortBinaryMethod(const std::string& input,
+                                WireEncoding encoding,
+                                std::string* output);
+
+/**
+ * @brief Метод топологической сортировки готового снимка графа.
+ *
+ * @param graph Граф в формате CSR.
+ * @param reverse Тот же граф с обращёнными рёбрами.
+ * @param input Поля запроса в формате JSON: id и необязательные поля
+ * algorithm, threads и trace, как у TopologicalSortMethod().
+ * @param output Выходные данные в формате JSON. Вершины записываются
+ * в исходной нумерации.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ *
+ * Снимок не перестраивается, поэтому повторные запросы к неизменному
+ * графу (например, графу сессии) не тратят время на построение CSR.
+ */
+int TopologicalSortSnapshotMethod(const CsrGraph& graph,
+                                  const CsrGraph& reverse,
+                                  const nlohmann::json& input,
+                                  nlohmann::json* output);
+
+/**
+ * @brief Метод поиска кратчайших путей алгоритмом Дейкстры.
+ *
+ * @param input Входные данные в формате JSON: вершины, рёбра с весами,
+ * источник source, необязательные поля target, heap и bidirectional.
+ * Поле algorithm со значением "delta-stepping" включает параллельный
+ * алгоритм delta-stepping с шириной корзины delta и числом потоков threads
+ * (веса рёбер должны быть положительными).
+ * @param output Выходные данные в формате JSON. Если поле target задано,
+ * то ответ содержит путь path и его длину distance (null, если пути нет),
+ * иначе --- массив distances с расстояниями до всех достижимых вершин.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+int DijkstraMethod(const nlohmann::json& input, nlohmann::json* output);
+
+/**
+ * @brief Метод поиска кратчайших путей алгоритмом Беллмана-Форда.
+ *
+ * @param input Входные данные в формате JSON: вершины, рёбра с весами
+ * (возможно, отрицательными), источник source, необязательные поля target,
+ * mode ("classic", "spfa" или "parallel") и threads.
+ * @param output Выходные данные в формате JSON. Если из источника
+ * достижим цикл отрицательного веса, то ответ содержит массив cycle
+ * с вершинами цикла в порядке рёбер. Иначе ответ такой же, как
+ * у DijkstraMethod().
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+int BellmanFordMethod(const nlohmann::json& input, nlohmann::json* output);
+
+/**
+ * @brief Метод построения минимального остовного леса.
+ *
+ * @param input Входные данные в формате JSON: вершины и рёбра с весами
+ * неориентированного графа, необязательные поля algorithm ("kruskal",
+ * "filter-kruskal", "prim" или "boruvka"), threads и heap (вариант
+ * алгоритма Прима: "auto", "indexed", "lazy" или "dense").
+ * @param output Выходные данные в формате JSON: массив edges с рёбрами
+ * леса и их суммарный вес weight. Алгоритм Краскала выдаёт рёбра по
+ * возрастанию весов, алгоритм Прима --- в порядке добавления.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+int KruskalMethod(const nlohmann::json& input, nlohmann::json* output);
+
+/**
+ * @brief Метод поиска в ширину.
+ *
+ * @param input Входные данные в формате JSON: вершины, рёбра
+ * ориентированного графа, источник source, необязательные поля target,
+ * direction ("auto", "top-down" или "bottom-up") и threads.
+ * @param output Выходные данные в формате JSON. Если поле target задано,
+ * то ответ содержит путь path и число рёбер в нём distance (null, если
+ * пути нет), иначе --- массив distances с расстояниями до всех достижимых
+ * вершин.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+int BfsMethod(const nlohmann::json& input, nlohmann::json* output);
+
+/**
+ * @brief Метод поиска в ширину на уже построенном снимке графа.
+ *
+ * @param snapshot Граф в формате CSR.
+ * @param reverse Тот же граф с обращёнными рёбрами.
+ * @param input Поля запроса в формате JSON: id, source и необязательные
+ * поля target, direction и threads, как у BfsMethod().
+ * @param output Выходные данные в формате JSON.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+int BfsGraphMethod(const CsrGraph& snapshot, const CsrGraph& reverse,
+                   const nlohmann::json& input, nlohmann::json* output);
+
+/**
+ * @brief Метод создания сессии с графом.
+ *
+ * @param input Входные данные в формате JSON: имя сессии session, вершины
+ * и рёбра ориентированного графа.
+ * @param output Выходные данные в формате JSON: имя сессии session, число
+ * вершин vertices, число рёбер edges и номер версии графа version.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число,
+ * если граф не помещается в ограничение памяти сессий.
+ *
+ * Сессия с тем же именем заменяется. Граф хранится на сервере, пока его
+ * не удалят, не вытеснят более новые сессии или не истечёт время жизни
+ * (@sa SetSessionLimits()).
+ */
+int SessionCreateMethod(const nlohmann::json& input, nlohmann::json* output);
+
+/**
+ * @brief Метод изменения графа сессии.
+ *
+ * @param input Входные данные в формате JSON: имя сессии session,
+ * необязательные поля remove и add с массивами vertices и edges того же
+ * вида, что и при создании сессии. Сначала удаляются рёбра и вершины,
+ * затем добавляются вершины и рёбра.
+ * @param output Выходные данные в формате JSON, как у
+ * SessionCreateMethod().
+ * @return Функция возвращает 0 в случае успеха и отрицательное число,
+ * если сессии нет или граф после изменений не поместится в ограничение
+ * памяти. Во втором случае изменения не применяются, и сессия остаётся
+ * прежней.
+ */
+int SessionUpdateMethod(const nlohmann::json& input, nlohmann::json* output);
+
+/**
+ * @brief Метод запуска алгоритма на графе сессии.
+ *
+ * @param input Входные данные в формате JSON: имя сессии session, имя
+ * метода method ("TopologicalSort" или "BFS") и поля запроса этого метода
+ * без вершин и рёбер.
+ * @param output Выходные данные в формате JSON, как у выбранного метода.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если сессии нет или входные данные заданы некорректно.
+ *
+ * Снимок графа в формате CSR строится при первом запросе после изменения
+ * графа и переиспользуется следующими запросами. Если со снимком сессия
+ * не помещается в ограничение памяти, то снимок не сохраняется.
+ */
+int SessionRunMethod(const nlohmann::json& input, nlohmann::json* output);
+
+/**
+ * @brief Метод удаления сессии.
+ *
+ * @param input Входные данные в формате JSON: имя сессии session.
+ * @param output Выходные данные в формате JSON: имя сессии session и поле
+ * deleted, равное false, если такой сессии не было.
+ * @return Функция возвращает 0.
+ */
+int SessionDeleteMethod(const nlohmann::json& input, nlohmann::json* output);
+
+/**
+ * @brief Задать ограничения хранилища сессий.
+ *
+ * @param maxBytes Ограничение суммарной оценки памяти графов сессий.
+ * При превышении вытесняются давно не использованные сессии.
+ * @param ttl Время жизни сессии без обращений. Нулевое значение снимает
+ * ограничение.
+ */
+void SetSessionLimits(size_t maxBytes, std::chrono::nanoseconds ttl);
+
+/**
+ * @brief Отобразить в память файл с графом (@sa graph::GraphFile).
+ *
+ * @param name Имя графа в запросах GraphFileRunMethod(). Граф с тем же
+ * именем заменяется.
+ * @param path Путь к файлу.
+ *
+ * Функцию нужно вызывать до запуска сервера. Содержимое файла проверяется
+ * целиком (@sa graph::GraphFile::Verify()), веса рёбер должны быть
+ * неотрицательными. Если файл не удалось открыть или он некорректен, то
+ * функция выбрасывает исключение std::runtime_error с путём к файлу.
+ */
+void LoadGraphFile(const std::string& name, const std::string& path);
+
+/**
+ * @brief Метод запуска алгоритма на графе из файла.
+ *
+ * @param input Входные данные в формате JSON: имя графа graph, имя метода
+ * method ("BFS" или "Dijkstra") и поля запроса этого метода без вершин
+ * и рёбер.
+ * @param output Выходные данные в формате JSON, как у выбранного метода.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число,
+ * если графа нет, в файле нет нужных методу данных (весов или обращённых
+ * рёбер) или входные данные заданы некорректно.
+ */
+int GraphFileRunMethod(const nlohmann::json& input, nlohmann::json* output);
+
 /* Конец вставки. */
 
 }  // namespace graph
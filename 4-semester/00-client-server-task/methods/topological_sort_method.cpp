@@ -6,45 +6,521 @@
  * Функция принимает и возвращает данные в JSON формате.
  */
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include "topological_sort.hpp"
 #include "oriented_graph.hpp"
+#include "graph_builder.hpp"
+#include "barrier.hpp"
+#include "scc.hpp"
+#include "trace.hpp"
+#include "wire_format.hpp"
+#include "graph_sax.hpp"
 #include "methods.hpp"
 
 namespace graph {
 
+//! Максимальный размер буфера трассировки в запросе.
+static const size_t maxTraceEvents = 4096;
+
+template<typename GraphType>
+static int SortGraph(const GraphType& graph,
+                     const nlohmann::json& input,
+                     nlohmann::json* output);
+
+template<typename Tracer, typename GraphType>
+static int TopologicalSortMethodHelper(const GraphType& graph,
+                                       const nlohmann::json& input,
+                                       nlohmann::json* output,
+                                       Tracer* tracer);
+
+template<typename Tracer, typename GraphType>
+static int RunAlgorithm(const GraphType& graph,
+                        const std::string& algorithm,
+                        size_t numThreads,
+                        std::vector<size_t>* order,
+                        std::vector<std::vector<size_t>>* levels,
+                        Tracer* tracer);
+
+/**
+ * @brief Готовый снимок графа вместе с обращённым графом.
+ *
+ * Алгоритмы запускаются прямо на снимке, без построения нового CSR,
+ * а вершины ответа переводятся в исходную нумерацию.
+ */
+struct SnapshotGraph {
+  //! Граф в формате CSR.
+  const CsrGraph& graph;
+  //! Тот же граф с обращёнными рёбрами.
+  const CsrGraph& reverse;
+
+  /**
+   * @brief Проверить наличие ребра по исходным номерам вершин.
+   */
+  bool HasEdge(size_t id1, size_t id2) const {
+    return graph.HasEdge(graph.InternalId(id1), graph.InternalId(id2));
+  }
+};
+
+template<typename Tracer>
+static int RunAlgorithm(const SnapshotGraph& snapshot,
+                        const std::string& algorithm,
+                        size_t numThreads,
+                        std::vector<size_t>* order,
+                        std::vector<std::vector<size_t>>* levels,
+                        Tracer* tracer);
+
+/**
+ * @brief Построить граф запроса.
+ *
+ * @param builder Построитель с вершинами и рёбрами запроса.
+ * @param graph Граф, в который добавляются вершины и рёбра.
+ * @return Функция возвращает false, если номер какой-то вершины
+ * не помещается в 32 бита.
+ *
+ * Граф запроса хранит номера вершин в uint32_t (@sa CompactStorage):
+ * он вдвое меньше и строится без перехеширования соседей.
+ */
+static bool BuildGraph(GraphBuilder* builder, CompactOrientedGraph* graph) {
+  try {
+    builder->Build(graph);
+  } catch (const std::out_of_range&) {
+    return false;
+  }
+
+  return true;
+}
+
 int TopologicalSortMethod(
   const nlohmann::json& input,
   nlohmann::json* output
 ) {
+  const nlohmann::json& vertices = input.at("vertices");
+  const nlohmann::json& edges = input.at("edges");
+  /* Рёбра сначала собираются в массив, а граф строится за один проход
+  без перехеширования. */
+  static thread_local GraphBuilder builder;
+  CompactOrientedGraph graph;
+
+  builder.Clear();
+  builder.Reserve(vertices.size(), edges.size());
+
+  for (auto vertex : vertices) {
+    builder.AddVertex(vertex);
+  }
+
+  for (auto edge : edges) {
+    builder.AddEdge(edge.at("start"), edge.at("end"));
+  }
+
+  if (!BuildGraph(&builder, &graph)) {
+    (*output)["error"] = "vertex id out of range";
+    return -1;
+  }
+
+  return SortGraph(graph, input, output);
+}
+
+int TopologicalSortBatchMethod(const nlohmann::json& input,
+                               nlohmann::json* output) {
+  // Минимальное число графов на один поток: запуск потока дороже, чем
+  // сортировка маленького графа.
+  const size_t minGraphsPerThread = 64;
+
+  if (!input.is_object() || !input.contains("graphs") ||
+      !input.at("graphs").is_array()) {
+    return -1;
+  }
+
+  const nlohmann::json& graphs = input.at("graphs");
+  size_t numThreads = input.value("threads", MaxThreads());
+
+  numThreads = std::min({ numThreads, MaxThreads(),
+                          graphs.size() / minGraphsPerThread });
+  numThreads = std::max<size_t>(numThreads, 1);
+
+  std::vector<nlohmann::json> results(graphs.size());
+  std::atomic<size_t> nextGraph(0);
+  // Исключение, которое не удалось записать в ответ одного графа.
+  std::exception_ptr failure;
+  std::mutex failureMutex;
+  // Ограничение процессорного времени запроса.
+  CpuBudget* budget = CpuBudget::Current();
+
+  /* Графы раздаются потокам по одному через общий счётчик, поэтому
+  большие графы не задерживают остальные. Каждый результат записывается
+  на место своего графа, и порядок ответов совпадает с порядком запроса.
+  Исключение не должно покидать поток: иначе вызывается std::terminate(). */
+  auto worker = [&]() {
+    try {
+      for (size_t i = nextGraph++; i < graphs.size(); i = nextGraph++) {
+        nlohmann::json& result = results[i];
+        /* Ограничение запроса действует на каждый граф отдельно: долгий
+        граф получает ошибку, а остальные сортируются. */
+        CpuBudget scope(budget ? budget->Limit()
+                               : std::chrono::nanoseconds::zero());
+
+        try {
+          if (TopologicalSortMethod(graphs[i], &result) < 0) {
+            result["error"] = "invalid graph";
+          }
+        } catch (const nlohmann::json::exception&) {
+          result["error"] = "malformed graph";
+        } catch (const BudgetExceeded&) {
+          result["error"] = "cpu budget exceeded";
+        } catch (const std::exception& error) {
+          result["error"] = error.what();
+        }
+
+        if (!result.contains("id") && graphs[i].is_object() &&
+            graphs[i].contains("id")) {
+          result["id"] = graphs[i].at("id");
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(failureMutex);
+
+      if (!failure) {
+        failure = std::current_exception();
+      }
+
+      // Остальные потоки больше не берут новые графы.
+      nextGraph = graphs.size();
+    }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (size_t t = 1; t < numThreads; t++) {
+    threads.emplace_back(worker);
+  }
+
+  worker();
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  /* Исключение пробрасывается только после того, как завершились все
+  потоки, которые обращаются к results. */
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+
+  (*output)["results"] = std::move(results);
+
+  return 0;
+}
+
+int TopologicalSortStreamMethod(const std::string& input,
+                                nlohmann::json* output) {
+  static thread_local GraphBuilder builder;
+  CompactOrientedGraph graph;
+  nlohmann::json fields;
+
+  /* Вершины и рёбра попадают в построитель графа прямо во время разбора
+  текста, в fields остаются только скалярные поля запроса (id, algorithm
+  и т.д.). */
+  builder.Clear();
+
+  if (!ParseGraph(input, &builder, &fields)) {
+    (*output)["error"] = "malformed graph";
+    return -1;
+  }
+
+  if (!BuildGraph(&builder, &graph)) {
+    (*output)["error"] = "vertex id out of range";
+    return -1;
+  }
+
+  return SortGraph(graph, fields, output);
+}
+
+int TopologicalSortBinaryMethod(const std::string& input,
+                                WireEncoding encoding,
+                                std::string* output) {
+  static thread_local GraphBuilder builder;
+  CompactOrientedGraph graph;
+  WireReader reader(input, encoding);
+  uint64_t id;
+  std::string algorithm;
+  uint64_t numThreads;
+
+  /* Запрос: id, algorithm, threads (0 означает значение по умолчанию),
+  массив вершин и массив рёбер. */
+  if (!reader.ReadNumber(&id) || !reader.ReadString(&algorithm) ||
+      !reader.ReadNumber(&numThreads)) {
+    return -1;
+  }
+
+  builder.Clear();
+
+  bool success = reader.ReadArray([](size_t vertex) {
+    builder.AddVertex(vertex);
+  });
+
+  success = success && reader.ReadEdges([](size_t start, size_t end) {
+    builder.AddEdge(start, end);
+  });
+
+  if (!success || !reader.AtEnd() || !BuildGraph(&builder, &graph)) {
+    return -1;
+  }
+
+  if (numThreads == 0 || numThreads > MaxThreads()) {
+    numThreads = MaxThreads();
+  }
+
+  std::vector<size_t> order;
+  std::vector<std::vector<size_t>> levels;
+
+  if (RunAlgorithm<NullTracer>(graph, algorithm, numThreads, &order,
+                               &levels, nullptr) < 0) {
+    return -1;
+  }
+
+  /* Ответ: id, порядок вершин и размеры уровней (для алгоритма Кана). */
+  WireWriter writer(encoding);
+  std::vector<size_t> levelSizes;
+
+  for (const std::vector<size_t>& level : levels) {
+    levelSizes.push_back(level.size());
+  }
+
+  writer.WriteNumber(id);
+  writer.WriteArray(order);
+  writer.WriteArray(levelSizes);
+
+  *output = writer.Data();
+
+  return 0;
+}
+
+int TopologicalSortSnapshotMethod(const CsrGraph& graph,
+                                  const CsrGraph& reverse,
+                                  const nlohmann::json& input,
+                                  nlohmann::json* output) {
+  return SortGraph(SnapshotGraph{graph, reverse}, input, output);
+}
+
+/**
+ * @brief Топологическая сортировка уже построенного графа.
+ *
+ * @tparam GraphType Тип графа.
+ *
+ * @param graph Граф.
+ * @param input Входные данные в формате JSON (без вершин и рёбер).
+ * @param output Выходные данные в формате JSON.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+template<typename GraphType>
+static int SortGraph(const GraphType& graph,
+                     const nlohmann::json& input,
+                     nlohmann::json* output) {
   (*output)["id"] = input.at("id");
 
-  graph::OrientedGraph graph;
+  /* Трассировка включается только по запросу клиента: необязательное поле
+  trace задаёт размер кольцевого буфера событий. Без него алгоритм
+  компилируется с пустой политикой трассировки и ничего не записывает. */
+  if (!input.contains("trace")) {
+    return TopologicalSortMethodHelper<NullTracer>(graph, input, output,
+                                                   nullptr);
+  }
+
+  /* Буфер выделяется целиком до запуска алгоритма, поэтому его размер
+  ограничен. */
+  const nlohmann::json& capacity = input.at("trace");
 
-  std::cout << std::endl << "input:" << std::endl;
-  for (auto vertex : input.at("vertices")) {
-    graph.AddVertex(vertex);
-    std::cout << vertex << " ";
+  if (!capacity.is_number_unsigned() ||
+      capacity.get<size_t>() > maxTraceEvents) {
+    (*output)["error"] = "invalid trace size";
+    return -1;
   }
-  std::cout << std::endl;
 
-  for (auto edge : input.at("edges")) {
-    graph.AddEdge(edge.at("start"), edge.at("end"));
-    std::cout << edge << std::endl;
+  RingBufferTracer tracer(capacity.get<size_t>());
+  int status = TopologicalSortMethodHelper(graph, input, output, &tracer);
+
+  for (const TraceRecord& record : tracer.Events()) {
+    (*output)["trace"]["events"].push_back({
+      { "event", TraceEventName(record.event) },
+      { "vertex", record.vertex },
+      { "other", record.other }
+    });
   }
 
-  std::vector<size_t> result_order = TopologicalSort(graph);
+  (*output)["trace"]["dropped"] = tracer.Dropped();
+
+  return status;
+}
 
-  std::cout <<std::endl << "result: " << std::endl;
-  for (auto vertex : result_order) {
-    std::cout << vertex << " ";
+/**
+ * @brief Запуск выбранного варианта топологической сортировки.
+ *
+ * @tparam Tracer Политика трассировки (@sa trace.hpp).
+ * @tparam GraphType Тип графа.
+ *
+ * @param graph Граф, построенный по входным данным.
+ * @param input Входные данные в формате JSON.
+ * @param output Выходные данные в формате JSON.
+ * @param tracer Объект политики трассировки.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+template<typename Tracer, typename GraphType>
+static int TopologicalSortMethodHelper(const GraphType& graph,
+                                       const nlohmann::json& input,
+                                       nlohmann::json* output,
+                                       Tracer* tracer) {
+  /* Необязательное поле algorithm выбирает вариант алгоритма:
+  "dfs" (по умолчанию) или "kahn". Алгоритм Кана дополнительно возвращает
+  разбиение графа на уровни. Варианты "tarjan" и "forward-backward" ищут
+  компоненты сильной связности и вместо пустого ответа для графа с циклом
+  возвращают порядок конденсации и компоненты, образующие циклы. */
+  std::string algorithm = input.value("algorithm", "dfs");
+  size_t numThreads = std::min(input.value("threads", MaxThreads()),
+                               MaxThreads());
+  std::vector<size_t> result_order;
+  std::vector<std::vector<size_t>> levels;
+
+  if (RunAlgorithm(graph, algorithm, numThreads, &result_order, &levels,
+                   tracer) < 0) {
+    return -1;
+  }
+
+  if (algorithm == "kahn") {
+    (*output)["levels"] = levels;
+  } else if (algorithm == "tarjan" || algorithm == "forward-backward") {
+    (*output)["components"] = levels;
+    (*output)["cycles"] = nlohmann::json::array();
+
+    /* Цикл образует компонента из нескольких вершин или вершина
+    с петлёй. */
+    for (const std::vector<size_t>& component : levels) {
+      if (component.size() > 1 ||
+          graph.HasEdge(component[0], component[0])) {
+        (*output)["cycles"].push_back(component);
+      }
+    }
   }
-  std::cout << std::endl;
 
   (*output)["result"] = result_order;
 
   return 0;
 }
 
-} // namespace graph
\ No newline at end of file
+/**
+ * @brief Запуск варианта топологической сортировки по его имени.
+ *
+ * @tparam Tracer Политика трассировки (@sa trace.hpp).
+ * @tparam GraphType Тип графа.
+ *
+ * @param graph Граф, построенный по входным данным.
+ * @param algorithm Имя алгоритма: "dfs", "kahn", "tarjan" или
+ * "forward-backward".
+ * @param numThreads Максимальное число потоков для алгоритма Кана
+ * и алгоритма forward-backward.
+ * @param order Указатель, по которому записывается порядок вершин.
+ * @param levels Указатель, по которому записываются уровни графа
+ * (для алгоритма Кана) или компоненты сильной связности в порядке
+ * конденсации (для алгоритмов "tarjan" и "forward-backward").
+ * @param tracer Объект политики трассировки.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если имя алгоритма неизвестно.
+ */
+template<typename Tracer, typename GraphType>
+static int RunAlgorithm(const GraphType& graph,
+                        const std::string& algorithm,
+                        size_t numThreads,
+                        std::vector<size_t>* order,
+                        std::vector<std::vector<size_t>>* levels,
+                        Tracer* tracer) {
+  if (algorithm == "dfs") {
+    /* Рабочая память алгоритма переиспользуется между запросами, которые
+    обрабатывает один и тот же поток сервера. */
+    static thread_local TopologicalSortWorkspace workspace;
+
+    TopologicalSort(graph, &workspace, order, tracer);
+  } else if (algorithm == "kahn") {
+    TopologicalLevels(graph, levels, numThreads, tracer);
+
+    for (const std::vector<size_t>& level : *levels) {
+      order->insert(order->end(), level.begin(), level.end());
+    }
+  } else if (algorithm == "tarjan" || algorithm == "forward-backward") {
+    StronglyConnectedComponents(graph, algorithm == "tarjan" ?
+                                    SccAlgorithm::Tarjan :
+                                    SccAlgorithm::ForwardBackward,
+                                numThreads, levels, tracer);
+
+    for (const std::vector<size_t>& component : *levels) {
+      order->insert(order->end(), component.begin(), component.end());
+    }
+  } else {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Запуск варианта топологической сортировки на готовом снимке.
+ *
+ * Параметры и результат такие же, как у перегрузки для исходного графа:
+ * вершины записываются в исходной нумерации.
+ */
+template<typename Tracer>
+static int RunAlgorithm(const SnapshotGraph& snapshot,
+                        const std::string& algorithm,
+                        size_t numThreads,
+                        std::vector<size_t>* order,
+                        std::vector<std::vector<size_t>>* levels,
+                        Tracer* tracer) {
+  const CsrGraph& graph = snapshot.graph;
+
+  if (algorithm == "dfs") {
+    static thread_local TopologicalSortWorkspace workspace;
+    ExternalIdTracer<Tracer, CsrGraph> externalTracer(tracer, graph);
+
+    TopologicalSort(graph, &workspace, order, &externalTracer);
+
+    for (size_t& vertex : *order) {
+      vertex = graph.ExternalId(vertex);
+    }
+  } else if (algorithm == "kahn") {
+    TopologicalLevels(graph, levels, numThreads, tracer);
+
+    for (std::vector<size_t>& level : *levels) {
+      for (size_t& vertex : level) {
+        vertex = graph.ExternalId(vertex);
+      }
+
+      order->insert(order->end(), level.begin(), level.end());
+    }
+  } else if (algorithm == "tarjan" || algorithm == "forward-backward") {
+    StronglyConnectedComponents(graph, snapshot.reverse,
+                                algorithm == "tarjan" ?
+                                    SccAlgorithm::Tarjan :
+                                    SccAlgorithm::ForwardBackward,
+                                numThreads, levels, tracer);
+
+    for (const std::vector<size_t>& component : *levels) {
+      order->insert(order->end(), component.begin(), component.end());
+    }
+  } else {
+    return -1;
+  }
+
+  return 0;
+}
+
+}  // namespace graph
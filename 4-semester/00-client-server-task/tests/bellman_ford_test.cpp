@@ -0,0 +1,443 @@
+/**
+ * @file bellman_ford_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация набора тестов для алгоритма Беллмана-Форда.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include "bellman_ford.hpp"
+#include "dijkstra.hpp"
+#include "trace.hpp"
+#include "weighted_csr_graph.hpp"
+#include "weighted_oriented_graph.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+static void SimpleTest(httplib::Client* client);
+static void NegativeCycleTest(httplib::Client* client);
+static void InvalidTest(httplib::Client* client);
+static void PotentialTest();
+static void CpuBudgetTest();
+static void RandomTest();
+
+void TestBellmanFord(httplib::Client* client) {
+  TestSuite suite("TestBellmanFord");
+
+  RUN_TEST_REMOTE(suite, client, SimpleTest);
+  RUN_TEST_REMOTE(suite, client, NegativeCycleTest);
+  RUN_TEST_REMOTE(suite, client, InvalidTest);
+  RUN_TEST(suite, PotentialTest);
+  RUN_TEST(suite, CpuBudgetTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+//! Варианты алгоритма на сервере.
+static const char* modes[] = { "classic", "spfa", "parallel" };
+
+/**
+ * @brief Простой статический тест с отрицательными весами.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void SimpleTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 1,
+  "threads": 3,
+  "vertices": [ 1, 2, 3, 4, 5 ],
+  "edges": [
+    { "start": 1, "end": 2, "weight": 4 },
+    { "start": 1, "end": 3, "weight": 5 },
+    { "start": 3, "end": 2, "weight": -3 },
+    { "start": 2, "end": 4, "weight": 2 },
+    { "start": 4, "end": 3, "weight": 1 }
+  ],
+  "source": 1
+}
+)"_json;
+
+  nlohmann::json expected = R"([
+    { "vertex": 1, "distance": 0 },
+    { "vertex": 2, "distance": 2 },
+    { "vertex": 3, "distance": 5 },
+    { "vertex": 4, "distance": 4 }
+  ])"_json;
+
+  for (const char* mode : modes) {
+    input["mode"] = mode;
+    input.erase("target");
+
+    httplib::Result result = client->Post(
+      "/BellmanFord",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+
+    REQUIRE_EQUAL(result->status, 200);
+    REQUIRE_EQUAL(1, output["id"]);
+    REQUIRE_EQUAL(output["distances"], expected);
+    REQUIRE(!output.contains("cycle"));
+
+    input["target"] = 4;
+    result = client->Post("/BellmanFord", input.dump(), "application/json");
+    output = nlohmann::json::parse(result->body);
+
+    REQUIRE_EQUAL(output["distance"], 4);
+    REQUIRE_EQUAL(output["path"], nlohmann::json({ 1, 3, 2, 4 }));
+
+    input["target"] = 5;
+    result = client->Post("/BellmanFord", input.dump(), "application/json");
+    output = nlohmann::json::parse(result->body);
+
+    REQUIRE(output["distance"].is_null());
+    REQUIRE(output["path"].empty());
+  }
+}
+
+/**
+ * @brief Тест с достижимым циклом отрицательного веса.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void NegativeCycleTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 2,
+  "vertices": [ 1, 2, 3, 4, 5, 6 ],
+  "edges": [
+    { "start": 1, "end": 2, "weight": 1 },
+    { "start": 2, "end": 3, "weight": 2 },
+    { "start": 3, "end": 4, "weight": -4 },
+    { "start": 4, "end": 2, "weight": 1 },
+    { "start": 4, "end": 5, "weight": 3 },
+    { "start": 6, "end": 6, "weight": -1 }
+  ],
+  "source": 1
+}
+)"_json;
+
+  for (const char* mode : modes) {
+    input["mode"] = mode;
+
+    httplib::Result result = client->Post(
+      "/BellmanFord",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+    std::vector<size_t> cycle = output.at("cycle");
+
+    REQUIRE_EQUAL(result->status, 200);
+    REQUIRE_EQUAL(2, output["id"]);
+    REQUIRE(!output.contains("distances"));
+    REQUIRE_EQUAL(cycle.size(), 3U);
+
+    // Цикл 2 -> 3 -> 4 -> 2 может начинаться с любой своей вершины.
+    while (cycle[0] != 2) {
+      cycle.push_back(cycle[0]);
+      cycle.erase(cycle.begin());
+    }
+
+    REQUIRE_EQUAL(cycle, std::vector<size_t>({ 2, 3, 4 }));
+  }
+
+  // Цикл из вершины 6 недостижим из вершины 1.
+  input["source"] = 5;
+  input["mode"] = "spfa";
+
+  httplib::Result result = client->Post(
+    "/BellmanFord",
+    input.dump(),
+    "application/json"
+  );
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+
+  REQUIRE_EQUAL(output["distances"].size(), 1U);
+  REQUIRE(!output.contains("cycle"));
+}
+
+/**
+ * @brief Тест для некорректных запросов.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void InvalidTest(httplib::Client* client) {
+  const char* inputs[] = {
+    // Нет источника в графе.
+    R"({ "id": 3, "vertices": [ 1 ], "edges": [ ], "source": 2 })",
+    // Неизвестный вариант алгоритма.
+    R"({ "id": 4, "vertices": [ 1 ], "edges": [ ], "source": 1,
+         "mode": "dial" })",
+    // Вес не является числом.
+    R"({ "id": 5, "vertices": [ 1, 2 ], "source": 1,
+         "edges": [ { "start": 1, "end": 2, "weight": "1" } ] })",
+    // Нет поля source.
+    R"({ "id": 6, "vertices": [ 1 ], "edges": [ ] })"
+  };
+
+  for (const char* input : inputs) {
+    httplib::Result result = client->Post(
+      "/BellmanFord",
+      input,
+      "application/json"
+    );
+
+    REQUIRE_EQUAL(result->status, 400);
+  }
+}
+
+/**
+ * @brief Запустить все варианты алгоритма и сравнить результаты.
+ *
+ * @param snapshot Граф.
+ * @param source Внутренний номер источника.
+ * @param numThreads Число потоков параллельного варианта.
+ * @param trees Деревья путей, найденные вариантами Classic, Spfa
+ * и Parallel.
+ * @return Функция возвращает true, если циклов отрицательного веса нет.
+ *
+ * Найденные циклы проверяются: это должны быть циклы графа
+ * отрицательного веса.
+ */
+static bool RunAll(const graph::WeightedCsrGraph<int64_t>& snapshot,
+                   size_t source, size_t numThreads,
+                   graph::ShortestPathTree<int64_t> trees[3]) {
+  std::vector<size_t> cycles[3];
+  bool results[3] = {
+    graph::BellmanFord(snapshot, source, &trees[0], &cycles[0]),
+    graph::Spfa(snapshot, source, &trees[1], &cycles[1]),
+    graph::ParallelBellmanFord(snapshot, source, numThreads, &trees[2],
+                               &cycles[2])
+  };
+
+  for (int i = 0; i < 3; i++) {
+    REQUIRE_EQUAL(results[i], results[0]);
+    REQUIRE_EQUAL(cycles[i].empty(), results[i]);
+
+    int64_t weight = 0;
+
+    for (size_t j = 0; j < cycles[i].size(); j++) {
+      size_t from = cycles[i][j];
+      size_t to = cycles[i][(j + 1) % cycles[i].size()];
+      int64_t edgeWeight = 0;
+      bool found = false;
+
+      // Между вершинами снимка нет кратных рёбер.
+      for (size_t k = snapshot.Offsets()[from];
+           k < snapshot.Offsets()[from + 1]; k++) {
+        if (snapshot.Targets()[k] == to) {
+          edgeWeight = snapshot.Weights()[k];
+          found = true;
+        }
+      }
+
+      REQUIRE(found);
+      weight += edgeWeight;
+    }
+
+    REQUIRE(weight < 0 || results[i]);
+  }
+
+  return results[0];
+}
+
+/**
+ * @brief Случайные графы с отрицательными весами без отрицательных циклов.
+ *
+ * Вес ребра (U, V) равен w + p(U) - p(V), где w неотрицателен, а p ---
+ * случайный потенциал. Вес любого цикла равен сумме w, поэтому циклов
+ * отрицательного веса нет, а кратчайшие пути совпадают с путями алгоритма
+ * Дейкстры для весов w.
+ */
+static void PotentialTest() {
+  // Число попыток.
+  const int numTries = 20;
+  // Число вершин.
+  const size_t numVertices = 1000;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для номеров вершин.
+  std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+  // Распределение для весов.
+  std::uniform_int_distribution<int64_t> weight(0, 100);
+  // Распределение для потенциалов.
+  std::uniform_int_distribution<int64_t> potential(-1000, 1000);
+  // Распределение для числа потоков.
+  std::uniform_int_distribution<size_t> threads(1, 8);
+
+  for (int it = 0; it < numTries; it++) {
+    graph::WeightedOrientedGraph<int64_t> original;
+    graph::WeightedOrientedGraph<int64_t> shifted;
+    std::vector<int64_t> p(numVertices);
+
+    for (size_t i = 0; i < numVertices; i++) {
+      original.AddVertex(i);
+      shifted.AddVertex(i);
+      p[i] = potential(gen);
+    }
+
+    for (size_t i = 0; i < 4 * numVertices; i++) {
+      size_t from = vertex(gen);
+      size_t to = vertex(gen);
+
+      if (original.HasEdge(from, to)) {
+        continue;
+      }
+
+      int64_t w = weight(gen);
+
+      original.AddEdge(from, to, w);
+      shifted.AddEdge(from, to, w + p[from] - p[to]);
+    }
+
+    graph::WeightedCsrGraph<int64_t> base(original);
+    graph::WeightedCsrGraph<int64_t> snapshot(shifted);
+    graph::ShortestPathTree<int64_t> expected;
+    graph::ShortestPathTree<int64_t> trees[3];
+    graph::BinaryHeap<int64_t> heap;
+    size_t source = vertex(gen);
+
+    graph::Dijkstra(base, base.InternalId(source), graph::noVertex, &heap,
+                    &expected);
+
+    REQUIRE(RunAll(snapshot, snapshot.InternalId(source), threads(gen),
+                   trees));
+
+    for (size_t i = 0; i < numVertices; i++) {
+      int64_t distance = expected.distance[base.InternalId(i)];
+
+      for (const graph::ShortestPathTree<int64_t>& tree : trees) {
+        int64_t actual = tree.distance[snapshot.InternalId(i)];
+
+        if (distance == graph::ShortestPathTree<int64_t>::Infinity()) {
+          REQUIRE_EQUAL(actual, distance);
+        } else {
+          REQUIRE_EQUAL(actual, distance + p[source] - p[i]);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Случайные графы, в которых могут быть циклы отрицательного веса.
+ *
+ * Все варианты алгоритма должны одинаково определять наличие цикла,
+ * а при его отсутствии находить одинаковые расстояния и корректные
+ * деревья путей.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 100;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для числа вершин.
+  std::uniform_int_distribution<size_t> size(1, 300);
+  // Распределение для весов.
+  std::uniform_int_distribution<int64_t> weight(-10, 100);
+  // Распределение для числа потоков.
+  std::uniform_int_distribution<size_t> threads(1, 8);
+  int numCycles = 0;
+
+  for (int it = 0; it < numTries; it++) {
+    size_t numVertices = size(gen);
+    std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+    graph::WeightedOrientedGraph<int64_t> graph;
+
+    for (size_t i = 0; i < numVertices; i++) {
+      graph.AddVertex(i);
+    }
+
+    for (size_t i = 0; i < 2 * numVertices; i++) {
+      graph.AddEdge(vertex(gen), vertex(gen), weight(gen));
+    }
+
+    graph::WeightedCsrGraph<int64_t> snapshot(graph);
+    graph::ShortestPathTree<int64_t> trees[3];
+    size_t source = vertex(gen);
+
+    if (!RunAll(snapshot, source, threads(gen), trees)) {
+      numCycles++;
+      continue;
+    }
+
+    for (size_t index = 0; index < numVertices; index++) {
+      for (const graph::ShortestPathTree<int64_t>& tree : trees) {
+        REQUIRE_EQUAL(tree.distance[index], trees[0].distance[index]);
+
+        size_t parent = tree.parent[index];
+
+        if (parent == graph::noVertex) {
+          REQUIRE(index == source || tree.distance[index] ==
+                  graph::ShortestPathTree<int64_t>::Infinity());
+          continue;
+        }
+
+        REQUIRE(snapshot.HasEdge(parent, index));
+        REQUIRE_EQUAL(tree.distance[parent] + graph.EdgeWeight(
+                          snapshot.ExternalId(parent),
+                          snapshot.ExternalId(index)),
+                      tree.distance[index]);
+      }
+    }
+  }
+
+  // Веса подобраны так, чтобы встречались оба исхода.
+  REQUIRE(numCycles > 0);
+  REQUIRE(numCycles < numTries);
+}
+
+/**
+ * @brief Тест для ограничения процессорного времени.
+ *
+ * Все варианты алгоритма на длинной цепочке прерываются исключением,
+ * параллельный --- после того, как завершились все его потоки.
+ */
+static void CpuBudgetTest() {
+  const size_t length = 20'000;
+
+  graph::WeightedOrientedGraph<int64_t> graph;
+
+  for (size_t i = 0; i < length; i++) {
+    graph.AddVertex(i);
+  }
+
+  for (size_t i = 0; i + 1 < length; i++) {
+    graph.AddEdge(i, i + 1, -1);
+  }
+
+  graph::WeightedCsrGraph<int64_t> snapshot(graph);
+  graph::ShortestPathTree<int64_t> tree;
+  std::vector<size_t> cycle;
+  size_t source = snapshot.InternalId(0);
+
+  {
+    graph::CpuBudget budget(std::chrono::nanoseconds(1));
+
+    REQUIRE_THROW(graph::BellmanFord(snapshot, source, &tree, &cycle),
+                  graph::BudgetExceeded);
+    REQUIRE_THROW(graph::Spfa(snapshot, source, &tree, &cycle),
+                  graph::BudgetExceeded);
+    REQUIRE_THROW(graph::ParallelBellmanFord(snapshot, source, 4, &tree,
+                                             &cycle),
+                  graph::BudgetExceeded);
+  }
+
+  REQUIRE(graph::ParallelBellmanFord(snapshot, source, 4, &tree, &cycle));
+  REQUIRE_EQUAL(tree.distance[snapshot.InternalId(length - 1)],
+                1 - static_cast<int64_t>(length));
+}
@@ -0,0 +1,325 @@
+/**
+ * @file bfs_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация набора тестов для поиска в ширину.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include "bfs.hpp"
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+#include "oriented_graph.hpp"
+#include "trace.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+static void SimpleTest(httplib::Client* client);
+static void PathTest(httplib::Client* client);
+static void InvalidTest(httplib::Client* client);
+static void TransposeTest();
+static void CpuBudgetTest();
+static void RandomTest();
+
+void TestBfs(httplib::Client* client) {
+  TestSuite suite("TestBfs");
+
+  RUN_TEST_REMOTE(suite, client, SimpleTest);
+  RUN_TEST_REMOTE(suite, client, PathTest);
+  RUN_TEST_REMOTE(suite, client, InvalidTest);
+  RUN_TEST(suite, TransposeTest);
+  RUN_TEST(suite, CpuBudgetTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Простой статический тест.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void SimpleTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 1,
+  "vertices": [ 1, 2, 3, 4, 5, 6 ],
+  "edges": [
+    { "start": 1, "end": 2 },
+    { "start": 1, "end": 3 },
+    { "start": 2, "end": 4 },
+    { "start": 3, "end": 4 },
+    { "start": 4, "end": 5 },
+    { "start": 6, "end": 1 }
+  ],
+  "source": 1
+}
+)"_json;
+
+  nlohmann::json expected = R"([
+    { "vertex": 1, "distance": 0 },
+    { "vertex": 2, "distance": 1 },
+    { "vertex": 3, "distance": 1 },
+    { "vertex": 4, "distance": 2 },
+    { "vertex": 5, "distance": 3 }
+  ])"_json;
+
+  for (const char* direction : { "auto", "top-down", "bottom-up" }) {
+    input["direction"] = direction;
+
+    httplib::Result result = client->Post(
+      "/BFS",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+
+    REQUIRE_EQUAL(result->status, 200);
+    REQUIRE_EQUAL(1, output["id"]);
+    REQUIRE_EQUAL(output["distances"], expected);
+  }
+}
+
+/**
+ * @brief Тест поиска пути до заданной вершины.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void PathTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 2,
+  "vertices": [ 1, 2, 3, 4, 5 ],
+  "edges": [
+    { "start": 1, "end": 2 },
+    { "start": 2, "end": 3 },
+    { "start": 3, "end": 4 },
+    { "start": 1, "end": 4 }
+  ],
+  "source": 1,
+  "target": 4
+}
+)"_json;
+
+  httplib::Result result = client->Post(
+    "/BFS",
+    input.dump(),
+    "application/json"
+  );
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+
+  REQUIRE_EQUAL(result->status, 200);
+  REQUIRE_EQUAL(output["distance"], 1);
+  REQUIRE_EQUAL(output["path"], nlohmann::json::array({ 1, 4 }));
+
+  input["target"] = 5;
+  result = client->Post("/BFS", input.dump(), "application/json");
+  output = nlohmann::json::parse(result->body);
+
+  REQUIRE_EQUAL(result->status, 200);
+  REQUIRE(output["distance"].is_null());
+  REQUIRE_EQUAL(output["path"], nlohmann::json::array());
+}
+
+/**
+ * @brief Тест для некорректных запросов.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void InvalidTest(httplib::Client* client) {
+  const char* inputs[] = {
+    // Неизвестное направление.
+    R"({ "id": 3, "vertices": [ 1 ], "edges": [ ], "source": 1,
+         "direction": "sideways" })",
+    // Источника нет в графе.
+    R"({ "id": 4, "vertices": [ 1 ], "edges": [ ], "source": 2 })",
+    // Цели нет в графе.
+    R"({ "id": 5, "vertices": [ 1 ], "edges": [ ], "source": 1,
+         "target": 2 })",
+    // Нет поля source.
+    R"({ "id": 6, "vertices": [ 1 ], "edges": [ ] })"
+  };
+
+  for (const char* input : inputs) {
+    httplib::Result result = client->Post(
+      "/BFS",
+      input,
+      "application/json"
+    );
+
+    REQUIRE_EQUAL(result->status, 400);
+  }
+}
+
+/**
+ * @brief Проверка снимка с обращёнными рёбрами.
+ */
+static void TransposeTest() {
+  graph::OrientedGraph graph;
+
+  graph.AddVertex(10);
+  graph.AddEdge(10, 20);
+  graph.AddEdge(10, 30);
+  graph.AddEdge(30, 20);
+  graph.AddEdge(40, 10);
+
+  graph::CsrGraph snapshot(graph);
+  graph::CsrGraph reverse;
+
+  reverse.AssignTranspose(snapshot);
+
+  REQUIRE_EQUAL(reverse.NumVertices(), snapshot.NumVertices());
+  REQUIRE_EQUAL(reverse.NumEdges(), snapshot.NumEdges());
+
+  for (size_t index1 : snapshot.Vertices()) {
+    REQUIRE_EQUAL(reverse.ExternalId(index1), snapshot.ExternalId(index1));
+
+    for (size_t index2 : snapshot.Vertices()) {
+      REQUIRE_EQUAL(reverse.HasEdge(index2, index1),
+                    snapshot.HasEdge(index1, index2));
+    }
+  }
+}
+
+/**
+ * @brief Случайный тест: расстояния сравниваются с последовательным
+ *        поиском в ширину с очередью, проверяется дерево поиска.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 60;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для числа вершин.
+  std::uniform_int_distribution<size_t> size(1, 2000);
+  // Распределение для средней степени.
+  std::uniform_int_distribution<size_t> degree(0, 20);
+  // Распределение для числа потоков.
+  std::uniform_int_distribution<size_t> threads(1, 8);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t numVertices = size(gen);
+    std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+    size_t numEdges = numVertices * degree(gen);
+    graph::OrientedGraph graph;
+
+    for (size_t i = 0; i < numVertices; i++) {
+      graph.AddVertex(i);
+    }
+
+    for (size_t i = 0; i < numEdges; i++) {
+      graph.AddEdge(vertex(gen), vertex(gen));
+    }
+
+    graph::CsrGraph snapshot(graph);
+    graph::CsrGraph reverse;
+    size_t source = vertex(gen);
+    std::vector<size_t> expected(numVertices,
+                                 graph::ShortestPathTree<size_t>::Infinity());
+    std::queue<size_t> queue;
+
+    reverse.AssignTranspose(snapshot);
+
+    expected[source] = 0;
+    queue.push(source);
+
+    while (!queue.empty()) {
+      size_t current = queue.front();
+
+      queue.pop();
+
+      for (size_t neighbour : snapshot.Edges(current)) {
+        if (expected[neighbour] ==
+            graph::ShortestPathTree<size_t>::Infinity()) {
+          expected[neighbour] = expected[current] + 1;
+          queue.push(neighbour);
+        }
+      }
+    }
+
+    for (graph::BfsDirection direction : { graph::BfsDirection::Auto,
+                                           graph::BfsDirection::TopDown,
+                                           graph::BfsDirection::BottomUp }) {
+      graph::ShortestPathTree<size_t> tree;
+
+      graph::BreadthFirstSearch(snapshot, reverse, source, direction,
+                                threads(gen), &tree);
+
+      REQUIRE(tree.distance == expected);
+      REQUIRE_EQUAL(tree.parent[source], graph::noVertex);
+
+      for (size_t index = 0; index < numVertices; index++) {
+        size_t parent = tree.parent[index];
+
+        if (index == source || parent == graph::noVertex) {
+          continue;
+        }
+
+        REQUIRE(snapshot.HasEdge(parent, index));
+        REQUIRE_EQUAL(tree.distance[parent] + 1, tree.distance[index]);
+      }
+    }
+
+    std::vector<std::pair<size_t, size_t>> distances;
+
+    graph::BreadthFirstSearch(graph, source, graph::BfsDirection::Auto,
+                              threads(gen), &distances);
+
+    size_t numReachable = numVertices -
+        std::count(expected.begin(), expected.end(),
+                   graph::ShortestPathTree<size_t>::Infinity());
+
+    REQUIRE_EQUAL(distances.size(), numReachable);
+
+    for (const std::pair<size_t, size_t>& distance : distances) {
+      REQUIRE_EQUAL(expected[distance.first], distance.second);
+    }
+  }
+}
+
+/**
+ * @brief Тест для ограничения процессорного времени.
+ *
+ * Поиск на длинной цепочке прерывается исключением при любом направлении
+ * шагов, а без ограничения выполняется до конца.
+ */
+static void CpuBudgetTest() {
+  const size_t length = 20'000;
+
+  graph::OrientedGraph graph;
+
+  for (size_t i = 0; i + 1 < length; i++) {
+    graph.AddEdge(i, i + 1);
+  }
+
+  graph::CsrGraph snapshot(graph);
+  graph::CsrGraph reverse;
+  graph::ShortestPathTree<size_t> tree;
+  size_t source = snapshot.InternalId(0);
+
+  reverse.AssignTranspose(snapshot);
+
+  for (graph::BfsDirection direction : { graph::BfsDirection::Auto,
+                                         graph::BfsDirection::TopDown,
+                                         graph::BfsDirection::BottomUp }) {
+    graph::CpuBudget budget(std::chrono::nanoseconds(1));
+
+    REQUIRE_THROW(graph::BreadthFirstSearch(snapshot, reverse, source,
+                                            direction, 4, &tree),
+                  graph::BudgetExceeded);
+  }
+
+  graph::BreadthFirstSearch(snapshot, reverse, source,
+                            graph::BfsDirection::Auto, 4, &tree);
+
+  REQUIRE_EQUAL(tree.distance[snapshot.InternalId(length - 1)], length - 1);
+}
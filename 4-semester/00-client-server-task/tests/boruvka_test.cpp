@@ -0,0 +1,245 @@
+/**
+ * @file boruvka_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация набора тестов для алгоритма Борувки.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include "boruvka.hpp"
+#include "disjoint_set.hpp"
+#include "kruskal.hpp"
+#include "weighted_graph.hpp"
+#include "trace.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+static void SimpleTest(httplib::Client* client);
+static void ConcurrentDisjointSetTest();
+static void CpuBudgetTest();
+static void RandomTest();
+
+void TestBoruvka(httplib::Client* client) {
+  TestSuite suite("TestBoruvka");
+
+  RUN_TEST_REMOTE(suite, client, SimpleTest);
+  RUN_TEST(suite, ConcurrentDisjointSetTest);
+  RUN_TEST(suite, CpuBudgetTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Простой статический тест.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void SimpleTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 1,
+  "algorithm": "boruvka",
+  "vertices": [ 1, 2, 3, 4, 5, 6 ],
+  "edges": [
+    { "start": 1, "end": 2, "weight": 3 },
+    { "start": 1, "end": 3, "weight": 1 },
+    { "start": 2, "end": 3, "weight": 7 },
+    { "start": 2, "end": 4, "weight": 5 },
+    { "start": 3, "end": 4, "weight": 2 },
+    { "start": 4, "end": 4, "weight": -9 },
+    { "start": 5, "end": 6, "weight": -1 }
+  ]
+}
+)"_json;
+
+  for (size_t numThreads : { 1, 4, 60000 }) {
+    input["threads"] = numThreads;
+
+    httplib::Result result = client->Post(
+      "/Kruskal",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+    std::vector<double> weights;
+
+    REQUIRE_EQUAL(result->status, 200);
+    REQUIRE_EQUAL(1, output["id"]);
+    REQUIRE_EQUAL(output["weight"], 5);
+
+    for (const nlohmann::json& edge : output["edges"]) {
+      weights.push_back(edge["weight"]);
+    }
+
+    std::sort(weights.begin(), weights.end());
+
+    REQUIRE(weights == std::vector<double>({ -1, 1, 2, 3 }));
+  }
+}
+
+/**
+ * @brief Потоки одновременно объединяют случайные пары, результат
+ *        сравнивается с последовательной системой множеств.
+ */
+static void ConcurrentDisjointSetTest() {
+  // Число элементов.
+  const size_t size = 10000;
+  // Число потоков.
+  const size_t numThreads = 4;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для элементов.
+  std::uniform_int_distribution<size_t> element(0, size - 1);
+  std::vector<std::pair<size_t, size_t>> pairs(size);
+  graph::ConcurrentDisjointSet concurrent(size);
+  graph::DisjointSet expected(size);
+  // Число успешных объединений каждого потока.
+  std::vector<size_t> merged(numThreads, 0);
+  size_t expectedMerged = 0;
+
+  for (std::pair<size_t, size_t>& pair : pairs) {
+    pair = std::make_pair(element(gen), element(gen));
+    expectedMerged += expected.Union(pair.first, pair.second);
+  }
+
+  std::vector<std::thread> threads;
+
+  for (size_t t = 0; t < numThreads; t++) {
+    // Каждый поток объединяет все пары в своём порядке.
+    threads.emplace_back([&, t]() {
+      for (size_t i = 0; i < size; i++) {
+        const std::pair<size_t, size_t>& pair = pairs[(i * (t + 1)) % size];
+
+        merged[t] += concurrent.Union(pair.first, pair.second);
+      }
+    });
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  size_t actualMerged = 0;
+
+  for (size_t count : merged) {
+    actualMerged += count;
+  }
+
+  REQUIRE_EQUAL(actualMerged, expectedMerged);
+
+  for (size_t i = 0; i < size; i++) {
+    size_t other = element(gen);
+
+    REQUIRE_EQUAL(concurrent.Find(i) == concurrent.Find(other),
+                  expected.Find(i) == expected.Find(other));
+  }
+}
+
+/**
+ * @brief Случайный тест: вес леса сравнивается с алгоритмом Краскала,
+ *        проверяется, что лес остовный.
+ *
+ * Веса выбираются из маленького диапазона, чтобы проверить выбор рёбер
+ * с равными весами.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 30;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для числа вершин.
+  std::uniform_int_distribution<size_t> size(1, 600);
+  // Распределение для весов.
+  std::uniform_int_distribution<int64_t> weight(-5, 5);
+  // Распределение для числа потоков.
+  std::uniform_int_distribution<size_t> threads(1, 8);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t numVertices = size(gen);
+    std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+    // Редкие графы несвязны.
+    size_t numEdges = it % 2 == 0 ? numVertices : 20 * numVertices;
+    graph::WeightedGraph<int64_t> graph;
+
+    for (size_t i = 0; i < numVertices; i++) {
+      graph.AddVertex(i);
+    }
+
+    for (size_t i = 0; i < numEdges; i++) {
+      graph.AddEdge(vertex(gen), vertex(gen), weight(gen));
+    }
+
+    std::vector<graph::MstEdge<int64_t>> expected;
+    std::vector<graph::MstEdge<int64_t>> forest;
+    int64_t expectedWeight = 0;
+    int64_t actualWeight = 0;
+    graph::DisjointSet components(numVertices);
+
+    graph::Kruskal(graph, false, 1, &expected);
+    graph::Boruvka(graph, threads(gen), &forest);
+
+    for (const graph::MstEdge<int64_t>& edge : expected) {
+      expectedWeight += edge.weight;
+    }
+
+    REQUIRE_EQUAL(forest.size(), expected.size());
+
+    for (const graph::MstEdge<int64_t>& edge : forest) {
+      REQUIRE(graph.HasEdge(edge.start, edge.end));
+      REQUIRE_EQUAL(graph.EdgeWeight(edge.start, edge.end), edge.weight);
+      REQUIRE(components.Union(edge.start, edge.end));
+
+      actualWeight += edge.weight;
+    }
+
+    REQUIRE_EQUAL(actualWeight, expectedWeight);
+  }
+}
+
+/**
+ * @brief Тест для ограничения процессорного времени.
+ *
+ * Алгоритмы Борувки и Краскала на длинном пути прерываются исключением.
+ * Веса рёбер перемешаны, чтобы путь не стянулся за один раунд Борувки.
+ */
+static void CpuBudgetTest() {
+  const size_t length = 100'000;
+
+  graph::WeightedGraph<int64_t> graph;
+
+  for (size_t i = 0; i < length; i++) {
+    graph.AddVertex(i);
+  }
+
+  for (size_t i = 0; i + 1 < length; i++) {
+    graph.AddEdge(i, i + 1, static_cast<int64_t>(i * 7919 % 1000));
+  }
+
+  std::vector<graph::MstEdge<int64_t>> forest;
+
+  {
+    graph::CpuBudget budget(std::chrono::nanoseconds(1));
+
+    REQUIRE_THROW(graph::Boruvka(graph, 4, &forest), graph::BudgetExceeded);
+
+    for (bool filter : { false, true }) {
+      REQUIRE_THROW(graph::Kruskal(graph, filter, 1, &forest),
+                    graph::BudgetExceeded);
+    }
+  }
+
+  graph::Boruvka(graph, 4, &forest);
+
+  REQUIRE_EQUAL(forest.size(), length - 1);
+}
@@ -0,0 +1,266 @@
+/**
+ * @file csr_graph_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Тесты для класса graph::CsrGraph.
+ */
+
+#include <vector>
+#include <random>
+#include <stdexcept>
+#include "test_core.hpp"
+#include <csr_graph.hpp>
+#include <graph.hpp>
+#include <oriented_graph.hpp>
+#include <topological_sort.hpp>
+
+using std::vector;
+using std::out_of_range;
+using std::random_device;
+using std::mt19937;
+using std::uniform_int_distribution;
+
+using graph::CsrGraph;
+using graph::Graph;
+using graph::OrientedGraph;
+
+static void EmptyTest();
+static void SimpleTest();
+static void UndirectedTest();
+static void ReassignTest();
+static void SparseIdsTest();
+static void TopologicalSortTest();
+static void RandomTest();
+
+/**
+ * @brief Основная функция для тестирования класса graph::CsrGraph.
+ */
+void TestCsrGraph() {
+  TestSuite suite("TestCsrGraph");
+
+  RUN_TEST(suite, EmptyTest);
+  RUN_TEST(suite, SimpleTest);
+  RUN_TEST(suite, UndirectedTest);
+  RUN_TEST(suite, ReassignTest);
+  RUN_TEST(suite, SparseIdsTest);
+  RUN_TEST(suite, TopologicalSortTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Снимок пустого графа.
+ */
+static void EmptyTest() {
+  CsrGraph csr;
+
+  REQUIRE_EQUAL(csr.NumVertices(), 0UL);
+  REQUIRE_EQUAL(csr.NumEdges(), 0UL);
+  REQUIRE_EQUAL(csr.HasVertex(0), false);
+  REQUIRE_THROW(csr.Edges(0), out_of_range);
+  REQUIRE_THROW(csr.InternalId(1), out_of_range);
+
+  OrientedGraph graph;
+  CsrGraph csr2(graph);
+
+  REQUIRE_EQUAL(csr2.NumVertices(), 0UL);
+  REQUIRE_EQUAL(csr2.Offsets().size(), 1UL);
+}
+
+/**
+ * @brief Перенумерация вершин и рёбра ориентированного графа.
+ */
+static void SimpleTest() {
+  OrientedGraph graph;
+
+  graph.AddVertex(30);
+  graph.AddVertex(10);
+  graph.AddVertex(20);
+  graph.AddEdge(30, 10);
+  graph.AddEdge(30, 20);
+  graph.AddEdge(10, 20);
+
+  CsrGraph csr(graph);
+
+  REQUIRE_EQUAL(csr.NumVertices(), 3UL);
+  REQUIRE_EQUAL(csr.NumEdges(), 3UL);
+
+  REQUIRE_EQUAL(csr.InternalId(10), 0UL);
+  REQUIRE_EQUAL(csr.InternalId(20), 1UL);
+  REQUIRE_EQUAL(csr.InternalId(30), 2UL);
+  REQUIRE_EQUAL(csr.ExternalId(2), 30UL);
+  REQUIRE(csr.HasExternalId(20));
+  REQUIRE_EQUAL(csr.HasExternalId(25), false);
+  REQUIRE_THROW(csr.ExternalId(3), out_of_range);
+
+  REQUIRE(csr.HasEdge(2, 0));
+  REQUIRE(csr.HasEdge(2, 1));
+  REQUIRE(csr.HasEdge(0, 1));
+  REQUIRE_EQUAL(csr.HasEdge(1, 0), false);
+  REQUIRE_EQUAL(csr.HasEdge(5, 0), false);
+
+  REQUIRE_EQUAL(csr.Edges(1).size(), 0UL);
+  REQUIRE(csr.Edges(1).empty());
+  REQUIRE_EQUAL(csr.Edges(2).size(), 2UL);
+  REQUIRE_EQUAL(csr.Edges(2)[0], 0UL);
+  REQUIRE_EQUAL(csr.Edges(2)[1], 1UL);
+
+  size_t numVertices = 0;
+
+  for (size_t index : csr.Vertices()) {
+    REQUIRE_EQUAL(index, numVertices);
+    numVertices++;
+  }
+
+  REQUIRE_EQUAL(numVertices, 3UL);
+}
+
+/**
+ * @brief Снимок неориентированного графа содержит рёбра в обе стороны.
+ */
+static void UndirectedTest() {
+  Graph graph;
+
+  graph.AddEdge(1, 2);
+  graph.AddEdge(2, 3);
+
+  CsrGraph csr(graph);
+
+  REQUIRE_EQUAL(csr.NumVertices(), 3UL);
+  REQUIRE_EQUAL(csr.NumEdges(), 4UL);
+  REQUIRE(csr.HasEdge(0, 1));
+  REQUIRE(csr.HasEdge(1, 0));
+  REQUIRE(csr.HasEdge(1, 2));
+  REQUIRE(csr.HasEdge(2, 1));
+  REQUIRE_EQUAL(csr.HasEdge(0, 2), false);
+}
+
+/**
+ * @brief Повторное построение снимка по другому графу.
+ */
+static void ReassignTest() {
+  OrientedGraph big;
+
+  for (size_t i = 0; i < 100; i++) {
+    big.AddEdge(i, i + 1);
+  }
+
+  OrientedGraph small;
+
+  small.AddEdge(7, 5);
+
+  CsrGraph csr(big);
+
+  REQUIRE_EQUAL(csr.NumVertices(), 101UL);
+  REQUIRE_EQUAL(csr.NumEdges(), 100UL);
+
+  csr.Assign(small);
+
+  REQUIRE_EQUAL(csr.NumVertices(), 2UL);
+  REQUIRE_EQUAL(csr.NumEdges(), 1UL);
+  REQUIRE_EQUAL(csr.Offsets().size(), 3UL);
+  REQUIRE(csr.HasEdge(csr.InternalId(7), csr.InternalId(5)));
+  REQUIRE(csr.Edges(csr.InternalId(5)).empty());
+}
+
+/**
+ * @brief Перенумерация далеко отстоящих исходных номеров.
+ *
+ * Номера вершин не лежат плотно, поэтому при построении снимка они
+ * переводятся во внутренние через хеш-таблицу.
+ */
+static void SparseIdsTest() {
+  OrientedGraph graph;
+  const size_t big = size_t(1) << 62;
+
+  graph.AddVertex(big);
+  graph.AddVertex(5);
+  graph.AddVertex(big + 7);
+  graph.AddEdge(big, 5);
+  graph.AddEdge(5, big + 7);
+  graph.AddEdge(big + 7, big);
+
+  CsrGraph csr(graph);
+
+  REQUIRE_EQUAL(csr.NumVertices(), 3UL);
+  REQUIRE_EQUAL(csr.NumEdges(), 3UL);
+  REQUIRE_EQUAL(csr.InternalId(5), 0UL);
+  REQUIRE_EQUAL(csr.InternalId(big), 1UL);
+  REQUIRE_EQUAL(csr.InternalId(big + 7), 2UL);
+  REQUIRE(csr.HasEdge(1, 0));
+  REQUIRE(csr.HasEdge(0, 2));
+  REQUIRE(csr.HasEdge(2, 1));
+  REQUIRE_EQUAL(csr.HasEdge(0, 1), false);
+}
+
+/**
+ * @brief Алгоритм топологической сортировки на снимке графа.
+ */
+static void TopologicalSortTest() {
+  OrientedGraph graph;
+
+  graph.AddVertex(1);
+  graph.AddVertex(2);
+  graph.AddVertex(3);
+  graph.AddEdge(2, 1);
+  graph.AddEdge(1, 3);
+
+  CsrGraph csr(graph);
+
+  vector<size_t> order = graph::TopologicalSort(csr);
+
+  REQUIRE_EQUAL(order.size(), 3UL);
+  REQUIRE_EQUAL(csr.ExternalId(order[0]), 2UL);
+  REQUIRE_EQUAL(csr.ExternalId(order[1]), 1UL);
+  REQUIRE_EQUAL(csr.ExternalId(order[2]), 3UL);
+}
+
+/**
+ * @brief Случайный тест: снимок совпадает с исходным графом.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 20;
+  // Используется для инициализации генератора случайных чисел.
+  random_device rd;
+  // Генератор случайных чисел.
+  mt19937 gen(rd());
+  // Распределение для номеров вершин.
+  uniform_int_distribution<size_t> vertex(0, 1000);
+  // Распределение для количества рёбер.
+  uniform_int_distribution<size_t> numEdges(0, 2000);
+
+  for (int it = 0; it < numTries; it++) {
+    OrientedGraph graph;
+    size_t count = numEdges(gen);
+
+    for (size_t i = 0; i < count; i++) {
+      size_t id1 = vertex(gen);
+      size_t id2 = vertex(gen);
+
+      graph.AddVertex(id1);
+      graph.AddVertex(id2);
+      graph.AddEdge(id1, id2);
+    }
+
+    CsrGraph csr(graph);
+
+    REQUIRE_EQUAL(csr.NumVertices(), graph.NumVertices());
+
+    size_t totalEdges = 0;
+
+    for (size_t id : graph.Vertices()) {
+      size_t index = csr.InternalId(id);
+
+      REQUIRE_EQUAL(csr.ExternalId(index), id);
+      REQUIRE_EQUAL(csr.Edges(index).size(), graph.Edges(id).size());
+
+      for (size_t neighbourId : graph.Edges(id)) {
+        REQUIRE(csr.HasEdge(index, csr.InternalId(neighbourId)));
+      }
+
+      totalEdges += graph.Edges(id).size();
+    }
+
+    REQUIRE_EQUAL(csr.NumEdges(), totalEdges);
+  }
+}
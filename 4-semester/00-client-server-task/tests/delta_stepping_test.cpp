@@ -0,0 +1,324 @@
+/**
+ * @file delta_stepping_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация набора тестов для алгоритма delta-stepping.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include "delta_stepping.hpp"
+#include "dijkstra.hpp"
+#include "trace.hpp"
+#include "weighted_csr_graph.hpp"
+#include "weighted_oriented_graph.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+static void SimpleTest(httplib::Client* client);
+static void InvalidTest(httplib::Client* client);
+static void RoundingTest(httplib::Client* client);
+static void DeltaTest();
+static void CpuBudgetTest();
+static void RandomTest();
+
+void TestDeltaStepping(httplib::Client* client) {
+  TestSuite suite("TestDeltaStepping");
+
+  RUN_TEST_REMOTE(suite, client, SimpleTest);
+  RUN_TEST_REMOTE(suite, client, InvalidTest);
+  RUN_TEST_REMOTE(suite, client, RoundingTest);
+  RUN_TEST(suite, DeltaTest);
+  RUN_TEST(suite, CpuBudgetTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Простой статический тест.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void SimpleTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 1,
+  "algorithm": "delta-stepping",
+  "delta": 2,
+  "vertices": [ 1, 2, 3, 4, 5 ],
+  "edges": [
+    { "start": 1, "end": 2, "weight": 7 },
+    { "start": 1, "end": 3, "weight": 2 },
+    { "start": 3, "end": 2, "weight": 3 },
+    { "start": 2, "end": 4, "weight": 1 },
+    { "start": 3, "end": 4, "weight": 8 }
+  ],
+  "source": 1
+}
+)"_json;
+
+  // Сервер не запускает больше потоков, чем есть у процессора.
+  input["threads"] = std::min<size_t>(2, graph::MaxThreads());
+
+  httplib::Result result = client->Post(
+    "/Dijkstra",
+    input.dump(),
+    "application/json"
+  );
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+  nlohmann::json expected = R"([
+    { "vertex": 1, "distance": 0 },
+    { "vertex": 2, "distance": 5 },
+    { "vertex": 3, "distance": 2 },
+    { "vertex": 4, "distance": 6 }
+  ])"_json;
+
+  REQUIRE_EQUAL(result->status, 200);
+  REQUIRE_EQUAL(1, output["id"]);
+  REQUIRE_EQUAL(output["distances"], expected);
+
+  input["target"] = 4;
+  result = client->Post("/Dijkstra", input.dump(), "application/json");
+  output = nlohmann::json::parse(result->body);
+
+  REQUIRE_EQUAL(output["distance"], 6);
+  REQUIRE_EQUAL(output["path"], nlohmann::json({ 1, 3, 2, 4 }));
+
+  input["target"] = 5;
+  result = client->Post("/Dijkstra", input.dump(), "application/json");
+  output = nlohmann::json::parse(result->body);
+
+  REQUIRE(output["distance"].is_null());
+  REQUIRE(output["path"].empty());
+}
+
+/**
+ * @brief Тест для некорректных запросов.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void InvalidTest(httplib::Client* client) {
+  const char* inputs[] = {
+    // Нулевой вес.
+    R"({ "id": 2, "algorithm": "delta-stepping", "vertices": [ 1, 2 ],
+         "source": 1, "edges": [ { "start": 1, "end": 2, "weight": 0 } ] })",
+    // Отрицательная ширина корзины.
+    R"({ "id": 3, "algorithm": "delta-stepping", "vertices": [ 1 ],
+         "edges": [ ], "source": 1, "delta": -1 })",
+    // Число потоков больше числа ядер процессора.
+    R"({ "id": 5, "algorithm": "delta-stepping", "vertices": [ 1, 2 ],
+         "source": 1, "threads": 1000000,
+         "edges": [ { "start": 1, "end": 2, "weight": 1 } ] })",
+    // Слишком узкие корзины.
+    R"({ "id": 6, "algorithm": "delta-stepping", "vertices": [ 1, 2 ],
+         "source": 1, "delta": 1e-12,
+         "edges": [ { "start": 1, "end": 2, "weight": 1e6 } ] })",
+    // Неизвестный алгоритм.
+    R"({ "id": 4, "algorithm": "a-star", "vertices": [ 1 ], "edges": [ ],
+         "source": 1 })"
+  };
+
+  for (const char* input : inputs) {
+    httplib::Result result = client->Post(
+      "/Dijkstra",
+      input,
+      "application/json"
+    );
+
+    REQUIRE_EQUAL(result->status, 400);
+  }
+}
+
+/**
+ * @brief Тест для веса, который теряется при округлении.
+ *
+ * Расстояния до вершин 0 и 1 равны 1, а 1 + 1e-20 == 1, поэтому ребро
+ * между ними выглядит точным в обе стороны. Путь до цели всё равно должен
+ * идти через источник, а не по циклу 0 -> 1 -> 0.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void RoundingTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 7,
+  "algorithm": "delta-stepping",
+  "vertices": [ 0, 1, 2 ],
+  "edges": [
+    { "start": 2, "end": 0, "weight": 1 },
+    { "start": 2, "end": 1, "weight": 1 },
+    { "start": 0, "end": 1, "weight": 1e-20 },
+    { "start": 1, "end": 0, "weight": 1e-20 }
+  ],
+  "source": 2,
+  "target": 0
+}
+)"_json;
+
+  for (size_t numThreads = 1; numThreads <= graph::MaxThreads();
+       numThreads++) {
+    input["threads"] = numThreads;
+
+    httplib::Result result = client->Post(
+      "/Dijkstra",
+      input.dump(),
+      "application/json"
+    );
+
+    REQUIRE_EQUAL(result->status, 200);
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+
+    REQUIRE_EQUAL(output["distance"], 1.0);
+    REQUIRE_EQUAL(output["path"], nlohmann::json({ 2, 0 }));
+  }
+}
+
+/**
+ * @brief Крайние значения ширины корзины на цепочке.
+ *
+ * Очень маленькая ширина превращает алгоритм в алгоритм Дейкстры, очень
+ * большая --- в алгоритм Беллмана-Форда. Длинная цепочка проверяет
+ * круговое хранение корзин.
+ */
+static void DeltaTest() {
+  // Число вершин.
+  const size_t numVertices = 5000;
+  graph::WeightedOrientedGraph<uint64_t> graph;
+
+  for (size_t i = 0; i + 1 < numVertices; i++) {
+    graph.AddEdge(i, i + 1, 1 + i % 7);
+    graph.AddEdge(i + 1, i, 100);
+  }
+
+  graph::WeightedCsrGraph<uint64_t> snapshot(graph);
+
+  for (uint64_t delta : { 0, 1, 3, 50, 1000000 }) {
+    for (size_t numThreads : { 1, 4 }) {
+      graph::ShortestPathTree<uint64_t> tree;
+      uint64_t expected = 0;
+
+      graph::DeltaStepping(snapshot, snapshot.InternalId(0), delta,
+                           numThreads, &tree);
+
+      for (size_t i = 0; i < numVertices; i++) {
+        size_t index = snapshot.InternalId(i);
+
+        REQUIRE_EQUAL(tree.distance[index], expected);
+
+        if (i > 0) {
+          REQUIRE_EQUAL(tree.parent[index], snapshot.InternalId(i - 1));
+        }
+
+        expected += 1 + i % 7;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Случайный тест: расстояния и деревья путей сравниваются
+ *        с алгоритмом Дейкстры.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 20;
+  // Число вершин.
+  const size_t numVertices = 2000;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для номеров вершин.
+  std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+  // Распределение для весов.
+  std::uniform_real_distribution<double> weight(0.5, 100.0);
+  // Распределение для ширины корзины.
+  std::uniform_real_distribution<double> delta(0.1, 200.0);
+  // Распределение для числа потоков.
+  std::uniform_int_distribution<size_t> threads(1, 8);
+
+  for (int it = 0; it < numTries; it++) {
+    graph::WeightedOrientedGraph<double> graph;
+
+    for (size_t i = 0; i < numVertices; i++) {
+      graph.AddVertex(i);
+    }
+
+    for (size_t i = 0; i < 4 * numVertices; i++) {
+      graph.AddEdge(vertex(gen), vertex(gen), weight(gen));
+    }
+
+    graph::WeightedCsrGraph<double> snapshot(graph);
+    graph::ShortestPathTree<double> expected;
+    graph::ShortestPathTree<double> tree;
+    graph::BinaryHeap<double> heap;
+    size_t source = snapshot.InternalId(vertex(gen));
+
+    graph::Dijkstra(snapshot, source, graph::noVertex, &heap, &expected);
+    graph::DeltaStepping(snapshot, source, it % 4 == 0 ? 0.0 : delta(gen),
+                         threads(gen), &tree);
+
+    for (size_t index = 0; index < numVertices; index++) {
+      REQUIRE_EQUAL(tree.distance[index], expected.distance[index]);
+
+      size_t parent = tree.parent[index];
+
+      if (index == source || tree.distance[index] ==
+          graph::ShortestPathTree<double>::Infinity()) {
+        REQUIRE_EQUAL(parent, graph::noVertex);
+        continue;
+      }
+
+      // Родитель лежит на кратчайшем пути.
+      REQUIRE(snapshot.HasEdge(parent, index));
+      REQUIRE_EQUAL(tree.distance[parent] + graph.EdgeWeight(
+                        snapshot.ExternalId(parent),
+                        snapshot.ExternalId(index)),
+                    tree.distance[index]);
+    }
+  }
+}
+
+/**
+ * @brief Тест для ограничения процессорного времени.
+ *
+ * На длинной цепочке каждая вершина лежит в своей корзине, и алгоритм
+ * прерывается исключением после первых корзин.
+ */
+static void CpuBudgetTest() {
+  const size_t length = 20'000;
+
+  graph::WeightedOrientedGraph<double> graph;
+
+  for (size_t i = 0; i < length; i++) {
+    graph.AddVertex(i);
+  }
+
+  for (size_t i = 0; i + 1 < length; i++) {
+    graph.AddEdge(i, i + 1, 1.0);
+  }
+
+  graph::WeightedCsrGraph<double> snapshot(graph);
+  graph::ShortestPathTree<double> tree;
+  size_t source = snapshot.InternalId(0);
+
+  {
+    graph::CpuBudget budget(std::chrono::nanoseconds(1));
+
+    REQUIRE_THROW(graph::DeltaStepping(snapshot, source, 0.5, 4, &tree),
+                  graph::BudgetExceeded);
+  }
+
+  graph::DeltaStepping(snapshot, source, 0.5, 4, &tree);
+
+  REQUIRE_EQUAL(tree.distance[snapshot.InternalId(length - 1)],
+                static_cast<double>(length - 1));
+}
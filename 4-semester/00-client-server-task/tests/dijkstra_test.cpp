@@ -0,0 +1,533 @@
+/**
+ * @file dijkstra_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация набора тестов для алгоритма Дейкстры.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include "dijkstra.hpp"
+#include "heaps.hpp"
+#include "trace.hpp"
+#include "weighted_csr_graph.hpp"
+#include "weighted_oriented_graph.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+static void SimpleTest(httplib::Client* client);
+static void PathTest(httplib::Client* client);
+static void UnreachableTest(httplib::Client* client);
+static void InvalidTest(httplib::Client* client);
+static void HeapsTest();
+static void TransposeTest();
+static void CpuBudgetTest();
+static void RandomTest(httplib::Client* client);
+
+void TestDijkstra(httplib::Client* client) {
+  TestSuite suite("TestDijkstra");
+
+  RUN_TEST_REMOTE(suite, client, SimpleTest);
+  RUN_TEST_REMOTE(suite, client, PathTest);
+  RUN_TEST_REMOTE(suite, client, UnreachableTest);
+  RUN_TEST_REMOTE(suite, client, InvalidTest);
+  RUN_TEST(suite, HeapsTest);
+  RUN_TEST(suite, TransposeTest);
+  RUN_TEST(suite, CpuBudgetTest);
+  RUN_TEST_REMOTE(suite, client, RandomTest);
+}
+
+//! Очереди с приоритетами, которые поддерживает сервер.
+static const char* heapNames[] = { "binary", "4-ary", "pairing", "radix" };
+
+/**
+ * @brief Простой статический тест: расстояния до всех вершин.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void SimpleTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 1,
+  "vertices": [ 1, 2, 3, 4, 5 ],
+  "edges": [
+    { "start": 1, "end": 2, "weight": 7 },
+    { "start": 1, "end": 3, "weight": 2 },
+    { "start": 3, "end": 2, "weight": 3 },
+    { "start": 2, "end": 4, "weight": 1 },
+    { "start": 3, "end": 4, "weight": 8 }
+  ],
+  "source": 1
+}
+)"_json;
+
+  for (const char* heap : heapNames) {
+    input["heap"] = heap;
+
+    httplib::Result result = client->Post(
+      "/Dijkstra",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+
+    REQUIRE_EQUAL(result->status, 200);
+    REQUIRE_EQUAL(1, output["id"]);
+
+    // Вершина 5 недостижима и в ответ не попадает.
+    nlohmann::json expected = R"([
+      { "vertex": 1, "distance": 0 },
+      { "vertex": 2, "distance": 5 },
+      { "vertex": 3, "distance": 2 },
+      { "vertex": 4, "distance": 6 }
+    ])"_json;
+
+    REQUIRE_EQUAL(output["distances"], expected);
+  }
+}
+
+/**
+ * @brief Тест для поиска пути между двумя вершинами.
+ *
+ * @param cli Указатель на HTTP клиент.
+ *
+ * Все очереди и оба направления поиска должны находить один и тот же путь.
+ */
+static void PathTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 2,
+  "vertices": [ 1, 2, 3, 4, 5, 6 ],
+  "edges": [
+    { "start": 1, "end": 2, "weight": 1 },
+    { "start": 2, "end": 3, "weight": 1 },
+    { "start": 3, "end": 6, "weight": 1 },
+    { "start": 1, "end": 4, "weight": 1 },
+    { "start": 4, "end": 5, "weight": 5 },
+    { "start": 5, "end": 6, "weight": 1 },
+    { "start": 6, "end": 1, "weight": 1 }
+  ],
+  "source": 1,
+  "target": 6
+}
+)"_json;
+
+  for (const char* heap : heapNames) {
+    for (bool bidirectional : { false, true }) {
+      input["heap"] = heap;
+      input["bidirectional"] = bidirectional;
+
+      httplib::Result result = client->Post(
+        "/Dijkstra",
+        input.dump(),
+        "application/json"
+      );
+
+      nlohmann::json output = nlohmann::json::parse(result->body);
+
+      REQUIRE_EQUAL(result->status, 200);
+      REQUIRE_EQUAL(output["distance"], 3);
+      REQUIRE_EQUAL(output["path"], nlohmann::json({ 1, 2, 3, 6 }));
+    }
+  }
+
+  input["target"] = 1;
+
+  httplib::Result result = client->Post(
+    "/Dijkstra",
+    input.dump(),
+    "application/json"
+  );
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+
+  REQUIRE_EQUAL(output["distance"], 0);
+  REQUIRE_EQUAL(output["path"], nlohmann::json({ 1 }));
+}
+
+/**
+ * @brief Тест для недостижимой цели.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void UnreachableTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 3,
+  "vertices": [ 1, 2, 3 ],
+  "edges": [
+    { "start": 1, "end": 2, "weight": 1.5 },
+    { "start": 3, "end": 1, "weight": 2.5 }
+  ],
+  "source": 1,
+  "target": 3
+}
+)"_json;
+
+  for (bool bidirectional : { false, true }) {
+    input["bidirectional"] = bidirectional;
+
+    httplib::Result result = client->Post(
+      "/Dijkstra",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+
+    REQUIRE_EQUAL(result->status, 200);
+    REQUIRE(output["distance"].is_null());
+    REQUIRE(output["path"].empty());
+  }
+}
+
+/**
+ * @brief Тест для некорректных запросов.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void InvalidTest(httplib::Client* client) {
+  const char* inputs[] = {
+    // Отрицательный вес.
+    R"({ "id": 4, "vertices": [ 1, 2 ], "source": 1,
+         "edges": [ { "start": 1, "end": 2, "weight": -1 } ] })",
+    // Дробный вес для поразрядной кучи.
+    R"({ "id": 5, "vertices": [ 1, 2 ], "source": 1, "heap": "radix",
+         "edges": [ { "start": 1, "end": 2, "weight": 0.5 } ] })",
+    // Сумма весов для поразрядной кучи переполняет 64 бита.
+    R"({ "id": 12, "vertices": [ 0, 1, 2 ], "source": 0, "target": 2,
+         "heap": "radix",
+         "edges": [ { "start": 0, "end": 1, "weight": 9223372036854775808 },
+                    { "start": 1, "end": 2, "weight": 9223372036854775808 } ]
+       })",
+    // Неизвестная очередь.
+    R"({ "id": 6, "vertices": [ 1 ], "edges": [ ], "source": 1,
+         "heap": "fibonacci" })",
+    // Двусторонний поиск без цели.
+    R"({ "id": 7, "vertices": [ 1 ], "edges": [ ], "source": 1,
+         "bidirectional": true })",
+    // Источника нет в графе.
+    R"({ "id": 8, "vertices": [ 1 ], "edges": [ ], "source": 2 })",
+    // Нет поля source.
+    R"({ "id": 9, "vertices": [ 1 ], "edges": [ ] })",
+    // Нет веса ребра.
+    R"({ "id": 10, "vertices": [ 1, 2 ], "source": 1,
+         "edges": [ { "start": 1, "end": 2 } ] })",
+    R"({ "id": 11, "vertices": [ 1 ], )"
+  };
+
+  for (const char* input : inputs) {
+    httplib::Result result = client->Post(
+      "/Dijkstra",
+      input,
+      "application/json"
+    );
+
+    REQUIRE_EQUAL(result->status, 400);
+  }
+}
+
+/**
+ * @brief Проверка очереди с приоритетами на случайных операциях.
+ *
+ * @tparam Heap Тип очереди.
+ *
+ * Ключи уменьшаются так же, как в алгоритме Дейкстры: новый ключ не меньше
+ * последнего извлечённого. Устаревшие записи (для поразрядной кучи)
+ * пропускаются.
+ */
+template<typename Heap>
+static void CheckHeap(std::mt19937* gen) {
+  // Число вершин.
+  const size_t numVertices = 1000;
+  std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+  std::uniform_int_distribution<uint64_t> step(0, 100);
+  std::vector<uint64_t> key(numVertices,
+                            std::numeric_limits<uint64_t>::max());
+  std::vector<bool> popped(numVertices, false);
+  uint64_t last = 0;
+  Heap heap;
+
+  heap.Reset(numVertices);
+
+  for (size_t it = 0; it < 10 * numVertices; it++) {
+    size_t id = vertex(*gen);
+
+    if (it % 3 != 2) {
+      uint64_t newKey = last + step(*gen);
+
+      if (!popped[id] && newKey < key[id]) {
+        key[id] = newKey;
+        heap.Push(id, newKey);
+      }
+
+      continue;
+    }
+
+    while (!heap.Empty()) {
+      std::pair<size_t, uint64_t> top = heap.Pop();
+
+      if (popped[top.first] || top.second != key[top.first]) {
+        continue;
+      }
+
+      REQUIRE(last <= top.second);
+
+      // Ключ извлечённой вершины минимален среди оставшихся.
+      for (size_t other = 0; other < numVertices; other++) {
+        REQUIRE(popped[other] || top.second <= key[other]);
+      }
+
+      popped[top.first] = true;
+      last = top.second;
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Тест для очередей с приоритетами.
+ */
+static void HeapsTest() {
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+
+  CheckHeap<graph::BinaryHeap<uint64_t>>(&gen);
+  CheckHeap<graph::QuaternaryHeap<uint64_t>>(&gen);
+  CheckHeap<graph::DaryHeap<uint64_t, 3>>(&gen);
+  CheckHeap<graph::PairingHeap<uint64_t>>(&gen);
+  CheckHeap<graph::RadixHeap<uint64_t>>(&gen);
+}
+
+/**
+ * @brief Тест для снимка с обращёнными рёбрами.
+ */
+static void TransposeTest() {
+  graph::WeightedOrientedGraph<int> graph;
+
+  graph.AddVertex(10);
+  graph.AddEdge(10, 30, 1);
+  graph.AddEdge(10, 20, 2);
+  graph.AddEdge(30, 20, 3);
+  graph.AddEdge(20, 20, 4);
+
+  graph::WeightedCsrGraph<int> snapshot(graph);
+  graph::WeightedCsrGraph<int> reverse;
+
+  reverse.AssignTranspose(snapshot);
+
+  REQUIRE_EQUAL(reverse.NumVertices(), 3UL);
+  REQUIRE_EQUAL(reverse.NumEdges(), 4UL);
+
+  for (size_t index : snapshot.Vertices()) {
+    REQUIRE_EQUAL(reverse.ExternalId(index), snapshot.ExternalId(index));
+
+    graph::Span<size_t> targets = snapshot.Edges(index);
+    graph::Span<int> weights = snapshot.EdgeWeights(index);
+
+    for (size_t k = 0; k < targets.size(); k++) {
+      size_t id1 = snapshot.ExternalId(index);
+      size_t id2 = snapshot.ExternalId(targets.data()[k]);
+
+      REQUIRE_EQUAL(weights.data()[k], graph.EdgeWeight(id1, id2));
+      REQUIRE(reverse.HasEdge(targets.data()[k], index));
+    }
+  }
+
+  // Вершина 20: входящие рёбра из 10, 20 и 30 (по возрастанию номеров).
+  graph::Span<int> weights = reverse.EdgeWeights(reverse.InternalId(20));
+
+  REQUIRE_EQUAL(weights.size(), 3UL);
+  REQUIRE_EQUAL(weights.data()[0], 2);
+  REQUIRE_EQUAL(weights.data()[1], 4);
+  REQUIRE_EQUAL(weights.data()[2], 3);
+}
+
+/**
+ * @brief Случайный тест: расстояния сравниваются с алгоритмом
+ *        Беллмана-Форда, пути всех очередей и направлений --- между собой.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void RandomTest(httplib::Client* client) {
+  // Число попыток.
+  const int numTries = 20;
+  // Число вершин.
+  const size_t numVertices = 300;
+  // Отсутствие пути.
+  const uint64_t infinity = std::numeric_limits<uint64_t>::max();
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для номеров вершин.
+  std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+  // Распределение для весов.
+  std::uniform_int_distribution<uint64_t> weight(0, 1000);
+
+  for (int it = 0; it < numTries; it++) {
+    nlohmann::json input;
+    graph::WeightedOrientedGraph<uint64_t> graph;
+    size_t source = vertex(gen);
+    size_t target = vertex(gen);
+
+    input["id"] = it;
+    input["source"] = source;
+    input["edges"] = nlohmann::json::array();
+
+    for (size_t i = 0; i < numVertices; i++) {
+      input["vertices"].push_back(i);
+      graph.AddVertex(i);
+    }
+
+    for (size_t i = 0; i < 3 * numVertices; i++) {
+      size_t start = vertex(gen);
+      size_t end = vertex(gen);
+      uint64_t edgeWeight = weight(gen);
+
+      if (graph.HasEdge(start, end)) {
+        continue;
+      }
+
+      graph.AddEdge(start, end, edgeWeight);
+      input["edges"].push_back({
+        { "start", start },
+        { "end", end },
+        { "weight", edgeWeight }
+      });
+    }
+
+    // Эталонные расстояния.
+    std::vector<uint64_t> distance(numVertices, infinity);
+
+    distance[source] = 0;
+
+    for (size_t round = 0; round < numVertices; round++) {
+      for (size_t start = 0; start < numVertices; start++) {
+        if (distance[start] == infinity) {
+          continue;
+        }
+
+        for (size_t end : graph.Edges(start)) {
+          distance[end] = std::min(distance[end], distance[start] +
+                                   graph.EdgeWeight(start, end));
+        }
+      }
+    }
+
+    for (const char* heap : heapNames) {
+      input["heap"] = heap;
+      input.erase("target");
+      input.erase("bidirectional");
+
+      httplib::Result result = client->Post(
+        "/Dijkstra",
+        input.dump(),
+        "application/json"
+      );
+
+      nlohmann::json output = nlohmann::json::parse(result->body);
+      size_t numReachable = 0;
+
+      REQUIRE_EQUAL(result->status, 200);
+
+      for (const nlohmann::json& item : output["distances"]) {
+        REQUIRE_EQUAL(item["distance"].get<uint64_t>(),
+                      distance[item["vertex"].get<size_t>()]);
+      }
+
+      for (uint64_t value : distance) {
+        numReachable += value != infinity;
+      }
+
+      REQUIRE_EQUAL(output["distances"].size(), numReachable);
+
+      for (bool bidirectional : { false, true }) {
+        input["target"] = target;
+        input["bidirectional"] = bidirectional;
+
+        result = client->Post("/Dijkstra", input.dump(), "application/json");
+        output = nlohmann::json::parse(result->body);
+
+        REQUIRE_EQUAL(result->status, 200);
+
+        if (distance[target] == infinity) {
+          REQUIRE(output["distance"].is_null());
+          continue;
+        }
+
+        std::vector<size_t> path = output["path"];
+        uint64_t length = 0;
+
+        REQUIRE_EQUAL(output["distance"].get<uint64_t>(), distance[target]);
+        REQUIRE_EQUAL(path.front(), source);
+        REQUIRE_EQUAL(path.back(), target);
+
+        for (size_t i = 0; i + 1 < path.size(); i++) {
+          length += graph.EdgeWeight(path[i], path[i + 1]);
+        }
+
+        REQUIRE_EQUAL(length, distance[target]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Тест для ограничения процессорного времени.
+ *
+ * Оба варианта поиска на длинной цепочке прерываются исключением, а после
+ * выхода из области ограничения выполняются до конца.
+ */
+static void CpuBudgetTest() {
+  const size_t length = 100'000;
+
+  graph::WeightedOrientedGraph<int64_t> graph;
+
+  for (size_t i = 0; i < length; i++) {
+    graph.AddVertex(i);
+  }
+
+  for (size_t i = 0; i + 1 < length; i++) {
+    graph.AddEdge(i, i + 1, 1);
+  }
+
+  graph::WeightedCsrGraph<int64_t> snapshot(graph);
+  graph::WeightedCsrGraph<int64_t> reverse;
+  graph::DijkstraWorkspace<int64_t> workspace;
+  std::vector<size_t> path;
+  int64_t distance = 0;
+  size_t first = snapshot.InternalId(0);
+  size_t last = snapshot.InternalId(length - 1);
+
+  reverse.AssignTranspose(snapshot);
+
+  {
+    graph::CpuBudget budget(std::chrono::nanoseconds(1));
+
+    REQUIRE_THROW(graph::Dijkstra(snapshot, first, graph::noVertex,
+                                  &workspace.forwardHeap,
+                                  &workspace.forward),
+                  graph::BudgetExceeded);
+    REQUIRE_THROW(graph::BidirectionalDijkstra(snapshot, reverse, first,
+                                               last, &workspace, &path,
+                                               &distance),
+                  graph::BudgetExceeded);
+  }
+
+  REQUIRE(graph::BidirectionalDijkstra(snapshot, reverse, first, last,
+                                       &workspace, &path, &distance));
+  REQUIRE_EQUAL(distance, static_cast<int64_t>(length - 1));
+  REQUIRE_EQUAL(path.size(), length);
+}
@@ -0,0 +1,231 @@
+/**
+ * @file dynamic_topological_order_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация набора тестов для поддерживаемого топологического порядка.
+ */
+
+#include <random>
+#include <vector>
+#include "dynamic_topological_order.hpp"
+#include "oriented_graph.hpp"
+#include "topological_sort.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+static void SimpleTest();
+static void CycleTest();
+static void RemoveTest();
+static void AssignTest();
+static void RandomTest();
+
+void TestDynamicTopologicalOrder() {
+  TestSuite suite("TestDynamicTopologicalOrder");
+
+  RUN_TEST(suite, SimpleTest);
+  RUN_TEST(suite, CycleTest);
+  RUN_TEST(suite, RemoveTest);
+  RUN_TEST(suite, AssignTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Проверить, что порядок согласован со всеми рёбрами графа.
+ *
+ * @param order Поддерживаемый порядок.
+ */
+static void CheckOrder(const graph::DynamicTopologicalOrder& order) {
+  const graph::OrientedGraph& graph = order.Graph();
+  std::vector<size_t> vertices = order.Order();
+
+  REQUIRE_EQUAL(vertices.size(), order.NumVertices());
+  REQUIRE_EQUAL(graph.NumVertices(), order.NumVertices());
+
+  for (size_t i = 0; i + 1 < vertices.size(); i++) {
+    REQUIRE(order.Precedes(vertices[i], vertices[i + 1]));
+  }
+
+  for (size_t id : graph.Vertices()) {
+    for (size_t neighbourId : graph.Edges(id)) {
+      REQUIRE(order.Precedes(id, neighbourId));
+    }
+  }
+}
+
+/**
+ * @brief Рёбра, идущие против текущего порядка, переставляют вершины.
+ */
+static void SimpleTest() {
+  graph::DynamicTopologicalOrder order;
+
+  for (size_t id = 1; id <= 5; id++) {
+    order.AddVertex(id);
+  }
+
+  REQUIRE(order.AddEdge(5, 1));
+  REQUIRE(order.AddEdge(4, 5));
+  REQUIRE(order.AddEdge(1, 2));
+  REQUIRE(order.AddEdge(3, 4));
+  // Ребро уже есть.
+  REQUIRE(order.AddEdge(3, 4));
+  CheckOrder(order);
+
+  REQUIRE(order.Order() == std::vector<size_t>({ 3, 4, 5, 1, 2 }));
+
+  // Новые вершины добавляются в конец порядка.
+  REQUIRE(order.AddEdge(7, 3));
+  CheckOrder(order);
+  REQUIRE(order.Precedes(7, 3));
+  REQUIRE_EQUAL(order.NumVertices(), 6U);
+}
+
+/**
+ * @brief Рёбра, замыкающие цикл, отклоняются, а цикл возвращается.
+ */
+static void CycleTest() {
+  graph::DynamicTopologicalOrder order;
+  std::vector<size_t> cycle;
+
+  REQUIRE(order.AddEdge(1, 2));
+  REQUIRE(order.AddEdge(2, 3));
+  REQUIRE(order.AddEdge(3, 4));
+  REQUIRE(order.AddEdge(2, 5));
+
+  REQUIRE(!order.AddEdge(4, 1, &cycle));
+  REQUIRE(cycle == std::vector<size_t>({ 4, 1, 2, 3 }));
+  REQUIRE(!order.HasEdge(4, 1));
+
+  REQUIRE(!order.AddEdge(6, 6, &cycle));
+  REQUIRE(cycle == std::vector<size_t>({ 6 }));
+  REQUIRE(order.HasVertex(6));
+  REQUIRE(!order.HasEdge(6, 6));
+
+  REQUIRE(order.AddEdge(5, 4));
+  CheckOrder(order);
+}
+
+/**
+ * @brief После удаления ребра или вершины можно добавить обратное ребро.
+ */
+static void RemoveTest() {
+  graph::DynamicTopologicalOrder order;
+
+  REQUIRE(order.AddEdge(1, 2));
+  REQUIRE(order.AddEdge(2, 3));
+  REQUIRE(!order.AddEdge(3, 1));
+
+  order.RemoveEdge(1, 2);
+  order.RemoveEdge(1, 2);
+  REQUIRE(order.AddEdge(3, 1));
+  CheckOrder(order);
+  REQUIRE(!order.AddEdge(1, 2));
+
+  order.RemoveVertex(3);
+  order.RemoveVertex(3);
+  REQUIRE(!order.HasVertex(3));
+  REQUIRE(order.AddEdge(1, 2));
+  CheckOrder(order);
+
+  // Много удалений подряд вызывают уплотнение позиций.
+  for (size_t id = 10; id < 100; id++) {
+    REQUIRE(order.AddEdge(id + 1, id));
+  }
+
+  for (size_t id = 10; id < 90; id++) {
+    order.RemoveVertex(id);
+  }
+
+  CheckOrder(order);
+  REQUIRE_EQUAL(order.NumVertices(), 13U);
+  REQUIRE(!order.AddEdge(90, 100));
+  REQUIRE(order.AddEdge(100, 1));
+  CheckOrder(order);
+}
+
+/**
+ * @brief Начальный порядок строится по готовому графу.
+ */
+static void AssignTest() {
+  graph::OrientedGraph graph;
+  graph::DynamicTopologicalOrder order;
+
+  graph.AddEdge(3, 2);
+  graph.AddEdge(2, 1);
+  graph.AddEdge(3, 5);
+
+  REQUIRE(order.Assign(graph));
+  REQUIRE_EQUAL(order.NumVertices(), 4U);
+  REQUIRE(order.HasEdge(3, 5));
+  CheckOrder(order);
+
+  graph.AddEdge(1, 3);
+
+  REQUIRE(!order.Assign(graph));
+  REQUIRE_EQUAL(order.NumVertices(), 0U);
+}
+
+/**
+ * @brief Случайный тест: ответ AddEdge() сравнивается с топологической
+ *        сортировкой графа с новым ребром, проверяются порядок и циклы.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 40;
+  // Число операций в одной попытке.
+  const int numOperations = 2000;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для числа вершин.
+  std::uniform_int_distribution<size_t> size(1, 200);
+  // Распределение для вида операции.
+  std::uniform_int_distribution<int> operation(0, 9);
+
+  for (int it = 0; it < numTries; it++) {
+    std::uniform_int_distribution<size_t> vertex(0, size(gen));
+    graph::DynamicTopologicalOrder order;
+    graph::TopologicalSortWorkspace workspace;
+    std::vector<size_t> sorted;
+    std::vector<size_t> cycle;
+
+    for (int i = 0; i < numOperations; i++) {
+      CheckOrder(order);
+
+      size_t id1 = vertex(gen);
+      size_t id2 = vertex(gen);
+      int kind = operation(gen);
+
+      if (kind == 0) {
+        order.RemoveVertex(id1);
+        continue;
+      }
+
+      if (kind <= 2) {
+        order.RemoveEdge(id1, id2);
+        continue;
+      }
+
+      graph::OrientedGraph expected = order.Graph();
+
+      expected.AddVertex(id1);
+      expected.AddEdge(id1, id2);
+
+      bool acyclic = graph::TopologicalSort(expected, &workspace, &sorted);
+
+      REQUIRE_EQUAL(order.AddEdge(id1, id2, &cycle), acyclic);
+
+      if (acyclic) {
+        continue;
+      }
+
+      REQUIRE_EQUAL(cycle[0], id1);
+
+      for (size_t j = 0; j < cycle.size(); j++) {
+        REQUIRE(expected.HasEdge(cycle[j], cycle[(j + 1) % cycle.size()]));
+      }
+    }
+
+    CheckOrder(order);
+  }
+}
@@ -0,0 +1,263 @@
+/**
+ * @file graph_builder_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Тесты для классов graph::GraphBuilder и graph::WeightedGraphBuilder.
+ */
+
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "test_core.hpp"
+#include <graph_builder.hpp>
+
+using std::pair;
+using std::tuple;
+using std::vector;
+using std::random_device;
+using std::mt19937;
+using std::uniform_int_distribution;
+
+using graph::Graph;
+using graph::GraphBuilder;
+using graph::OrientedGraph;
+using graph::WeightedGraph;
+using graph::WeightedGraphBuilder;
+using graph::WeightedOrientedGraph;
+
+static void SimpleTest();
+static void UndirectedTest();
+static void WeightedTest();
+static void MergeTest();
+static void RandomTest();
+
+template<typename GraphType>
+static void RequireSameGraph(const GraphType& left, const GraphType& right);
+
+/**
+ * @brief Основная функция для тестирования классов построения графов.
+ */
+void TestGraphBuilder() {
+  TestSuite suite("TestGraphBuilder");
+
+  RUN_TEST(suite, SimpleTest);
+  RUN_TEST(suite, UndirectedTest);
+  RUN_TEST(suite, WeightedTest);
+  RUN_TEST(suite, MergeTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Построение ориентированного графа с повторяющимися рёбрами.
+ */
+static void SimpleTest() {
+  vector<pair<size_t, size_t>> edges = { { 1, 2 }, { 2, 3 }, { 1, 2 },
+                                         { 3, 3 } };
+  GraphBuilder builder;
+  OrientedGraph graph;
+
+  builder.Reserve(4, edges.size());
+  builder.AddVertex(7);
+  builder.AddEdges(edges.begin(), edges.end());
+
+  REQUIRE_EQUAL(builder.NumEdges(), 4UL);
+
+  builder.Build(&graph);
+
+  REQUIRE_EQUAL(builder.NumEdges(), 0UL);
+  REQUIRE_EQUAL(graph.NumVertices(), 4UL);
+  REQUIRE(graph.HasVertex(7));
+  REQUIRE(graph.HasEdge(1, 2));
+  REQUIRE(graph.HasEdge(2, 3));
+  REQUIRE(graph.HasEdge(3, 3));
+  REQUIRE_EQUAL(graph.HasEdge(2, 1), false);
+  REQUIRE_EQUAL(graph.Edges(1).size(), 1UL);
+  REQUIRE_EQUAL(graph.IncomingEdges(3).size(), 2UL);
+  REQUIRE(graph.Edges(7).empty());
+  REQUIRE(graph.IncomingEdges(7).empty());
+}
+
+/**
+ * @brief Рёбра (a, b) и (b, a) неориентированного графа совпадают.
+ */
+static void UndirectedTest() {
+  GraphBuilder builder;
+  Graph graph;
+
+  builder.AddEdge(1, 2);
+  builder.AddEdge(2, 1);
+  builder.AddEdge(3, 3);
+  builder.Build(&graph);
+
+  REQUIRE_EQUAL(graph.NumVertices(), 3UL);
+  REQUIRE(graph.HasEdge(1, 2));
+  REQUIRE(graph.HasEdge(2, 1));
+  REQUIRE_EQUAL(graph.Edges(1).size(), 1UL);
+  REQUIRE_EQUAL(graph.Edges(2).size(), 1UL);
+  REQUIRE_EQUAL(graph.Edges(3).size(), 1UL);
+}
+
+/**
+ * @brief Из повторяющихся рёбер остаётся последний вес.
+ */
+static void WeightedTest() {
+  vector<tuple<size_t, size_t, int>> edges = { { 1, 2, 10 }, { 2, 1, 20 },
+                                               { 1, 2, 30 } };
+
+  {
+    WeightedGraphBuilder<int> builder;
+    WeightedOrientedGraph<int> graph;
+
+    builder.AddEdges(edges.begin(), edges.end());
+    builder.Build(&graph);
+
+    REQUIRE_EQUAL(graph.EdgeWeight(1, 2), 30);
+    REQUIRE_EQUAL(graph.EdgeWeight(2, 1), 20);
+    REQUIRE_EQUAL(graph.IncomingEdges(2).size(), 1UL);
+  }
+
+  {
+    WeightedGraphBuilder<int> builder;
+    WeightedGraph<int> graph;
+
+    builder.AddEdges(edges.begin(), edges.end());
+    builder.Build(&graph);
+
+    REQUIRE_EQUAL(graph.EdgeWeight(1, 2), 30);
+    REQUIRE_EQUAL(graph.EdgeWeight(2, 1), 30);
+    REQUIRE_EQUAL(graph.Edges(1).size(), 1UL);
+  }
+}
+
+/**
+ * @brief Построитель добавляет рёбра к уже имеющимся в графе.
+ */
+static void MergeTest() {
+  OrientedGraph graph;
+  GraphBuilder builder;
+
+  graph.Reserve(10);
+  graph.AddEdge(1, 2);
+
+  builder.AddEdge(1, 3);
+  builder.AddEdge(4, 1);
+  builder.Build(&graph);
+
+  // Как и OrientedGraph::AddEdge(), построитель добавляет в словарь
+  // вершин только начала рёбер.
+  REQUIRE_EQUAL(graph.NumVertices(), 2UL);
+  REQUIRE(graph.HasEdge(1, 2));
+  REQUIRE(graph.HasEdge(1, 3));
+  REQUIRE(graph.HasEdge(4, 1));
+  REQUIRE_EQUAL(graph.Edges(1).size(), 2UL);
+  REQUIRE_EQUAL(graph.IncomingEdges(1).size(), 1UL);
+
+  // Построитель можно использовать повторно.
+  builder.AddEdge(5, 6);
+  builder.Build(&graph);
+
+  REQUIRE_EQUAL(graph.NumVertices(), 3UL);
+  REQUIRE(graph.HasEdge(5, 6));
+}
+
+/**
+ * @brief Случайный тест: пакетное построение даёт тот же граф, что
+ *        и добавление рёбер по одному.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 20;
+  // Используется для инициализации генератора случайных чисел.
+  random_device rd;
+  // Генератор случайных чисел.
+  mt19937 gen(rd());
+  // Распределение для номеров вершин.
+  uniform_int_distribution<size_t> vertex(0, 300);
+  // Распределение для количества рёбер.
+  uniform_int_distribution<size_t> numEdges(0, 3000);
+  // Распределение для весов.
+  uniform_int_distribution<int> weight(-100, 100);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t count = numEdges(gen);
+    GraphBuilder builder;
+    WeightedGraphBuilder<int> weightedBuilder;
+    Graph graph1, graph2;
+    OrientedGraph orientedGraph1, orientedGraph2;
+    WeightedGraph<int> weightedGraph1, weightedGraph2;
+    WeightedOrientedGraph<int> weightedOrientedGraph1, weightedOrientedGraph2;
+
+    for (size_t i = 0; i < count; i++) {
+      size_t id1 = vertex(gen);
+      size_t id2 = vertex(gen);
+      int w = weight(gen);
+
+      if (i % 10 == 0) {
+        graph1.AddVertex(id1);
+        orientedGraph1.AddVertex(id1);
+        weightedGraph1.AddVertex(id1);
+        weightedOrientedGraph1.AddVertex(id1);
+        builder.AddVertex(id1);
+        weightedBuilder.AddVertex(id1);
+        continue;
+      }
+
+      graph1.AddEdge(id1, id2);
+      orientedGraph1.AddEdge(id1, id2);
+      weightedGraph1.AddEdge(id1, id2, w);
+      weightedOrientedGraph1.AddEdge(id1, id2, w);
+      builder.AddEdge(id1, id2);
+      weightedBuilder.AddEdge(id1, id2, w);
+    }
+
+    // Построители очищаются после Build(), поэтому рёбра добавляются
+    // в копии для каждого класса графа.
+    GraphBuilder builderCopy = builder;
+    WeightedGraphBuilder<int> weightedBuilderCopy = weightedBuilder;
+
+    builder.Build(&graph2);
+    builderCopy.Build(&orientedGraph2);
+    weightedBuilder.Build(&weightedGraph2);
+    weightedBuilderCopy.Build(&weightedOrientedGraph2);
+
+    RequireSameGraph(graph1, graph2);
+    RequireSameGraph(orientedGraph1, orientedGraph2);
+    RequireSameGraph(weightedGraph1, weightedGraph2);
+    RequireSameGraph(weightedOrientedGraph1, weightedOrientedGraph2);
+
+    for (size_t id : weightedGraph1.Vertices()) {
+      for (size_t neighbourId : weightedGraph1.Edges(id)) {
+        REQUIRE_EQUAL(weightedGraph1.EdgeWeight(id, neighbourId),
+                      weightedGraph2.EdgeWeight(id, neighbourId));
+        REQUIRE_EQUAL(weightedOrientedGraph1.HasEdge(id, neighbourId) ?
+                      weightedOrientedGraph1.EdgeWeight(id, neighbourId) : 0,
+                      weightedOrientedGraph2.HasEdge(id, neighbourId) ?
+                      weightedOrientedGraph2.EdgeWeight(id, neighbourId) : 0);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Проверить, что два графа содержат одни и те же вершины и рёбра.
+ *
+ * @tparam GraphType Тип графа.
+ *
+ * @param left Первый граф.
+ * @param right Второй граф.
+ */
+template<typename GraphType>
+static void RequireSameGraph(const GraphType& left, const GraphType& right) {
+  REQUIRE_EQUAL(left.NumVertices(), right.NumVertices());
+
+  for (size_t id : left.Vertices()) {
+    REQUIRE(right.HasVertex(id));
+    REQUIRE_EQUAL(left.Edges(id).size(), right.Edges(id).size());
+
+    for (size_t neighbourId : left.Edges(id)) {
+      REQUIRE(right.HasEdge(id, neighbourId));
+      REQUIRE(right.IncomingEdges(neighbourId).count(id) > 0);
+    }
+  }
+}
@@ -0,0 +1,396 @@
+/**
+ * @file graph_file_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Тесты для файлов с графами, отображаемых в память.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include "bfs.hpp"
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+#include "graph_file.hpp"
+#include "oriented_graph.hpp"
+#include "weighted_csr_graph.hpp"
+#include "weighted_oriented_graph.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+using std::runtime_error;
+using std::string;
+using std::vector;
+
+using graph::CsrGraph;
+using graph::GraphFile;
+using graph::OrientedGraph;
+using graph::ShortestPathTree;
+using graph::WeightedCsrGraph;
+using graph::WeightedOrientedGraph;
+using graph::WriteGraphFile;
+
+static void WeightedTest();
+static void UnweightedTest();
+static void LifetimeTest();
+static void InvalidTest();
+static void RandomTest();
+static void UnknownGraphTest(httplib::Client* client);
+
+//! Путь к временному файлу с графом.
+static const char* path = "graph_file_test.graph";
+
+void TestGraphFile(httplib::Client* client) {
+  TestSuite suite("TestGraphFile");
+
+  RUN_TEST(suite, WeightedTest);
+  RUN_TEST(suite, UnweightedTest);
+  RUN_TEST(suite, LifetimeTest);
+  RUN_TEST(suite, InvalidTest);
+  RUN_TEST(suite, RandomTest);
+  RUN_TEST_REMOTE(suite, client, UnknownGraphTest);
+
+  std::remove(path);
+}
+
+/**
+ * @brief Проверить, что два снимка состоят из одинаковых массивов.
+ *
+ * @param left Первый снимок.
+ * @param right Второй снимок.
+ */
+static bool SameArrays(const WeightedCsrGraph<double>& left,
+                       const WeightedCsrGraph<double>& right) {
+  vector<size_t> leftIds(left.Ids().begin(), left.Ids().end());
+  vector<size_t> rightIds(right.Ids().begin(), right.Ids().end());
+  vector<size_t> leftOffsets(left.Offsets().begin(), left.Offsets().end());
+  vector<size_t> rightOffsets(right.Offsets().begin(),
+                              right.Offsets().end());
+  vector<size_t> leftTargets(left.Targets().begin(), left.Targets().end());
+  vector<size_t> rightTargets(right.Targets().begin(),
+                              right.Targets().end());
+  vector<double> leftWeights(left.Weights().begin(), left.Weights().end());
+  vector<double> rightWeights(right.Weights().begin(),
+                              right.Weights().end());
+
+  return leftIds == rightIds && leftOffsets == rightOffsets &&
+         leftTargets == rightTargets && leftWeights == rightWeights;
+}
+
+/**
+ * @brief Прочитать файл целиком.
+ *
+ * @param name Путь к файлу.
+ */
+static string ReadBytes(const char* name) {
+  std::ifstream file(name, std::ios::binary);
+
+  return string(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Записать файл целиком.
+ *
+ * @param name Путь к файлу.
+ * @param bytes Содержимое файла.
+ */
+static void WriteBytes(const char* name, const string& bytes) {
+  std::ofstream file(name, std::ios::binary | std::ios::trunc);
+
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+/**
+ * @brief Взвешенный граф с обращёнными рёбрами.
+ */
+static void WeightedTest() {
+  WeightedOrientedGraph<double> graph;
+
+  graph.AddVertex(10);
+  graph.AddVertex(20);
+  graph.AddVertex(30);
+  graph.AddVertex(40);
+  graph.AddEdge(10, 20, 1.5);
+  graph.AddEdge(10, 30, 4);
+  graph.AddEdge(20, 30, 2);
+  graph.AddEdge(30, 10, 0.25);
+
+  WeightedCsrGraph<double> snapshot(graph);
+  WeightedCsrGraph<double> transposed;
+
+  transposed.AssignTranspose(snapshot);
+  WriteGraphFile(path, snapshot);
+
+  GraphFile file(path);
+
+  REQUIRE(file.HasWeights());
+  REQUIRE(file.HasReverse());
+  REQUIRE(file.Verify());
+  REQUIRE(file.Graph().Ids().data() != snapshot.Ids().data());
+  REQUIRE(SameArrays(file.Graph(), snapshot));
+  REQUIRE(SameArrays(file.Reverse(), transposed));
+  REQUIRE_EQUAL(file.Graph().NumVertices(), 4UL);
+  REQUIRE_EQUAL(file.Graph().NumEdges(), 4UL);
+  REQUIRE_EQUAL(file.Graph().InternalId(30), 2UL);
+  REQUIRE_EQUAL(file.Graph().ExternalId(3), 40UL);
+  REQUIRE(file.Graph().HasEdge(0, 2));
+  REQUIRE(!file.Graph().HasEdge(2, 1));
+  REQUIRE_EQUAL(file.Graph().EdgeWeights(0)[1], 4.0);
+
+  graph::DijkstraWorkspace<double> workspace;
+  vector<size_t> route;
+  double length = 0;
+
+  REQUIRE(graph::BidirectionalDijkstra(file.Graph(), file.Reverse(), 0, 2,
+                                       &workspace, &route, &length));
+  REQUIRE_EQUAL(length, 3.5);
+  REQUIRE_EQUAL(route.size(), 3UL);
+}
+
+/**
+ * @brief Невзвешенный граф без обращённых рёбер.
+ */
+static void UnweightedTest() {
+  OrientedGraph graph;
+
+  graph.AddVertex(1);
+  graph.AddVertex(2);
+  graph.AddVertex(5);
+  graph.AddEdge(1, 5);
+  graph.AddEdge(5, 2);
+  graph.AddEdge(5, 1);
+
+  CsrGraph snapshot(graph);
+
+  WriteGraphFile(path, snapshot, false);
+
+  GraphFile file(path);
+
+  REQUIRE(!file.HasWeights());
+  REQUIRE(!file.HasReverse());
+  REQUIRE(file.Verify());
+  REQUIRE(file.Graph().Weights().empty());
+  REQUIRE_EQUAL(file.Reverse().NumVertices(), 0UL);
+  REQUIRE_EQUAL(file.Graph().NumVertices(), 3UL);
+  REQUIRE_EQUAL(file.Graph().NumEdges(), 3UL);
+
+  for (size_t index : snapshot.Vertices()) {
+    vector<size_t> expected(snapshot.Edges(index).begin(),
+                            snapshot.Edges(index).end());
+    vector<size_t> edges(file.Graph().Edges(index).begin(),
+                         file.Graph().Edges(index).end());
+
+    REQUIRE(edges == expected);
+  }
+
+  // Пустой граф.
+  WriteGraphFile(path, CsrGraph());
+
+  GraphFile empty(path);
+
+  REQUIRE_EQUAL(empty.Graph().NumVertices(), 0UL);
+  REQUIRE_EQUAL(empty.Reverse().NumEdges(), 0UL);
+  REQUIRE(empty.Verify());
+}
+
+/**
+ * @brief Копии снимков переживают объект GraphFile, а изменение копии
+ *        не затрагивает отображённую память.
+ */
+static void LifetimeTest() {
+  WeightedOrientedGraph<double> graph;
+
+  graph.AddVertex(1);
+  graph.AddVertex(2);
+  graph.AddVertex(3);
+  graph.AddEdge(1, 2, 7);
+  graph.AddEdge(2, 3, 8);
+
+  WeightedCsrGraph<double> snapshot(graph);
+  WeightedCsrGraph<double> copy;
+  WeightedCsrGraph<double> other;
+
+  WriteGraphFile(path, snapshot);
+
+  {
+    GraphFile file(path);
+
+    copy = file.Graph();
+    other = file.Graph();
+  }
+
+  // Отображение ещё живо: на него указывают копии.
+  std::remove(path);
+  REQUIRE(SameArrays(copy, snapshot));
+
+  // Перестроение копии не меняет отображённую память другой копии.
+  WeightedOrientedGraph<double> another;
+
+  another.AddVertex(100);
+  another.AddEdge(100, 100, 1);
+  copy.Assign(another);
+
+  REQUIRE_EQUAL(copy.NumVertices(), 1UL);
+  REQUIRE_EQUAL(copy.ExternalId(0), 100UL);
+  REQUIRE(SameArrays(other, snapshot));
+
+  copy.AssignTranspose(other);
+  REQUIRE_EQUAL(copy.NumEdges(), 2UL);
+  REQUIRE(copy.HasEdge(2, 1));
+  REQUIRE(SameArrays(other, snapshot));
+}
+
+/**
+ * @brief Некорректные файлы отвергаются.
+ */
+static void InvalidTest() {
+  OrientedGraph graph;
+
+  graph.AddVertex(1);
+  graph.AddVertex(2);
+  graph.AddEdge(1, 2);
+
+  REQUIRE_THROW(GraphFile("graph_file_test.missing"), runtime_error);
+
+  WriteGraphFile(path, CsrGraph(graph));
+
+  string bytes = ReadBytes(path);
+  string broken = bytes;
+
+  // Короткий файл.
+  WriteBytes(path, bytes.substr(0, 16));
+  REQUIRE_THROW(GraphFile{path}, runtime_error);
+
+  // Неверная сигнатура.
+  broken[0] = 'X';
+  WriteBytes(path, broken);
+  REQUIRE_THROW(GraphFile{path}, runtime_error);
+
+  // Неизвестная версия и неизвестный флаг.
+  for (size_t offset : { 8, 12 }) {
+    broken = bytes;
+    broken[offset + 1] = 1;
+    WriteBytes(path, broken);
+    REQUIRE_THROW(GraphFile{path}, runtime_error);
+  }
+
+  // Обрезанный и удлинённый файл.
+  WriteBytes(path, bytes.substr(0, bytes.size() - 8));
+  REQUIRE_THROW(GraphFile{path}, runtime_error);
+  WriteBytes(path, bytes + string(8, '\0'));
+  REQUIRE_THROW(GraphFile{path}, runtime_error);
+
+  // Число рёбер не совпадает с последним смещением. Массивы идут после
+  // 32 байт заголовка: ids[2], offsets[3], targets[1].
+  uint64_t value = 2;
+
+  broken = bytes;
+  std::memcpy(&broken[32 + 4 * 8], &value, sizeof(value));
+  WriteBytes(path, broken);
+  REQUIRE_THROW(GraphFile{path}, runtime_error);
+
+  // Конец ребра вне графа находит только полная проверка.
+  value = 5;
+  broken = bytes;
+  std::memcpy(&broken[32 + 5 * 8], &value, sizeof(value));
+  WriteBytes(path, broken);
+  REQUIRE(!GraphFile(path).Verify());
+}
+
+/**
+ * @brief Случайный тест: алгоритмы на графе из файла дают те же ответы,
+ *        что и на снимке в памяти.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 30;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для номеров вершин.
+  std::uniform_int_distribution<size_t> vertex(0, 200);
+  // Распределение для числа рёбер.
+  std::uniform_int_distribution<size_t> count(0, 600);
+  // Распределение для весов.
+  std::uniform_real_distribution<double> weight(0, 10);
+
+  for (int it = 0; it < numTries; it++) {
+    WeightedOrientedGraph<double> graph;
+
+    for (size_t i = count(gen); i > 0; i--) {
+      size_t start = vertex(gen);
+      size_t end = vertex(gen);
+
+      graph.AddVertex(start);
+      graph.AddVertex(end);
+      graph.AddEdge(start, end, weight(gen));
+    }
+
+    WeightedCsrGraph<double> snapshot(graph);
+    WeightedCsrGraph<double> transposed;
+
+    if (snapshot.NumVertices() == 0) {
+      continue;
+    }
+
+    transposed.AssignTranspose(snapshot);
+    WriteGraphFile(path, snapshot);
+
+    GraphFile file(path);
+
+    REQUIRE(file.Verify());
+    REQUIRE(SameArrays(file.Graph(), snapshot));
+    REQUIRE(SameArrays(file.Reverse(), transposed));
+
+    size_t source = std::uniform_int_distribution<size_t>(
+        0, snapshot.NumVertices() - 1)(gen);
+    graph::BinaryHeap<double> heap;
+    ShortestPathTree<double> expected;
+    ShortestPathTree<double> tree;
+
+    graph::Dijkstra(snapshot, source, graph::noVertex, &heap, &expected);
+    graph::Dijkstra(file.Graph(), source, graph::noVertex, &heap, &tree);
+    REQUIRE(tree.distance == expected.distance);
+
+    ShortestPathTree<size_t> expectedLevels;
+    ShortestPathTree<size_t> levels;
+
+    graph::BreadthFirstSearch(snapshot, transposed, source,
+                              graph::BfsDirection::Auto, 2,
+                              &expectedLevels);
+    graph::BreadthFirstSearch(file.Graph(), file.Reverse(), source,
+                              graph::BfsDirection::Auto, 2, &levels);
+    REQUIRE(levels.distance == expectedLevels.distance);
+  }
+}
+
+/**
+ * @brief Запрос к графу, который сервер не загружал.
+ *
+ * @param client Клиент для отправки запросов.
+ */
+static void UnknownGraphTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{ "graph": "graph_file_test", "method": "BFS", "id": 1, "source": 0 }
+)"_json;
+  httplib::Result result = client->Post("/GraphFile/run", input.dump(),
+                                        "application/json");
+
+  REQUIRE_EQUAL(result->status, 400);
+  REQUIRE_EQUAL(nlohmann::json::parse(result->body)["error"],
+                "unknown graph");
+
+  input.erase("graph");
+  result = client->Post("/GraphFile/run", input.dump(), "application/json");
+  REQUIRE_EQUAL(result->status, 400);
+}
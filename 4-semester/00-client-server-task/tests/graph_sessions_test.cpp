@@ -0,0 +1,421 @@
+/**
+ * @file graph_sessions_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация набора тестов для графов, которые хранятся на сервере.
+ */
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include "graph_sessions.hpp"
+#include "oriented_graph.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+static void DeltaTest();
+static void SnapshotTest();
+static void EvictionTest();
+static void LimitTest();
+static void ExpirationTest();
+static void SessionTest(httplib::Client* client);
+static void UnknownSessionTest(httplib::Client* client);
+
+void TestGraphSessions(httplib::Client* client) {
+  TestSuite suite("TestGraphSessions");
+
+  RUN_TEST(suite, DeltaTest);
+  RUN_TEST(suite, SnapshotTest);
+  RUN_TEST(suite, EvictionTest);
+  RUN_TEST(suite, LimitTest);
+  RUN_TEST(suite, ExpirationTest);
+  RUN_TEST_REMOTE(suite, client, SessionTest);
+  RUN_TEST_REMOTE(suite, client, UnknownSessionTest);
+}
+
+/**
+ * @brief Граф-путь 0 -> 1 -> ... -> numVertices - 1.
+ *
+ * @param numVertices Число вершин.
+ */
+static graph::OrientedGraph Path(size_t numVertices) {
+  graph::OrientedGraph graph;
+
+  for (size_t i = 0; i < numVertices; i++) {
+    graph.AddVertex(i);
+
+    if (i > 0) {
+      graph.AddEdge(i - 1, i);
+    }
+  }
+
+  return graph;
+}
+
+/**
+ * @brief Случайный тест: пакеты изменений сравниваются с теми же
+ *        изменениями обычного графа.
+ */
+static void DeltaTest() {
+  // Число пакетов изменений.
+  const int numTries = 200;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для номеров вершин.
+  std::uniform_int_distribution<size_t> vertex(0, 30);
+  // Распределение для числа изменений каждого вида.
+  std::uniform_int_distribution<size_t> count(0, 10);
+  graph::GraphSession session("delta", Path(10));
+  graph::OrientedGraph expected = Path(10);
+
+  for (int it = 0; it < numTries; it++) {
+    graph::GraphDelta delta;
+
+    for (size_t i = count(gen); i > 0; i--) {
+      delta.removeEdges.emplace_back(vertex(gen), vertex(gen));
+    }
+
+    for (size_t i = count(gen) / 4; i > 0; i--) {
+      delta.removeVertices.push_back(vertex(gen));
+    }
+
+    for (size_t i = count(gen) / 4; i > 0; i--) {
+      delta.addVertices.push_back(vertex(gen));
+    }
+
+    for (size_t i = count(gen); i > 0; i--) {
+      delta.addEdges.emplace_back(vertex(gen), vertex(gen));
+    }
+
+    for (const auto& edge : delta.removeEdges) {
+      expected.RemoveEdge(edge.first, edge.second);
+    }
+
+    for (size_t id : delta.removeVertices) {
+      expected.RemoveVertex(id);
+    }
+
+    for (size_t id : delta.addVertices) {
+      expected.AddVertex(id);
+    }
+
+    for (const auto& edge : delta.addEdges) {
+      expected.AddVertex(edge.first);
+      expected.AddVertex(edge.second);
+      expected.AddEdge(edge.first, edge.second);
+    }
+
+    session.Apply(delta);
+
+    size_t numEdges = 0;
+
+    for (size_t id : expected.Vertices()) {
+      numEdges += expected.Edges(id).size();
+
+      for (size_t neighbourId : expected.Edges(id)) {
+        REQUIRE(session.Read([&](const graph::OrientedGraph& graph) {
+          return graph.HasEdge(id, neighbourId);
+        }));
+      }
+    }
+
+    REQUIRE_EQUAL(session.NumVertices(), expected.NumVertices());
+    REQUIRE_EQUAL(session.NumEdges(), numEdges);
+    REQUIRE_EQUAL(session.Version(), static_cast<size_t>(it) + 1);
+  }
+}
+
+/**
+ * @brief Снимок переиспользуется до изменения графа.
+ */
+static void SnapshotTest() {
+  graph::GraphSession session("snapshot", Path(5));
+  size_t bytes = session.Bytes();
+
+  std::shared_ptr<const graph::GraphSnapshot> first = session.Snapshot();
+
+  REQUIRE(session.Snapshot() == first);
+  REQUIRE(session.Bytes() > bytes);
+  REQUIRE_EQUAL(first->graph.NumEdges(), 4U);
+  REQUIRE(first->reverse.HasEdge(first->graph.InternalId(1),
+                                 first->graph.InternalId(0)));
+
+  graph::GraphDelta delta;
+
+  delta.addEdges.emplace_back(4, 5);
+  session.Apply(delta);
+
+  std::shared_ptr<const graph::GraphSnapshot> second = session.Snapshot();
+
+  REQUIRE(second != first);
+  REQUIRE_EQUAL(first->graph.NumEdges(), 4U);
+  REQUIRE_EQUAL(second->graph.NumEdges(), 5U);
+  REQUIRE_EQUAL(second->graph.NumVertices(), 6U);
+}
+
+/**
+ * @brief Сессии вытесняются в порядке давности обращений.
+ */
+static void EvictionTest() {
+  size_t sessionBytes = graph::GraphSession("a", Path(100)).Bytes();
+  graph::GraphSessionStore store(3 * sessionBytes,
+                                 graph::GraphSessionStore::Clock::duration(0));
+
+  REQUIRE(store.Create("a", Path(100)));
+  REQUIRE(store.Create("b", Path(100)));
+  REQUIRE(store.Create("c", Path(100)));
+  REQUIRE_EQUAL(store.NumSessions(), 3U);
+  REQUIRE_EQUAL(store.Bytes(), 3 * sessionBytes);
+
+  // Обращение к "a" делает самой старой сессию "b".
+  REQUIRE(store.Find("a"));
+  REQUIRE(store.Create("d", Path(100)));
+  REQUIRE(!store.Find("b"));
+  REQUIRE(store.Find("a"));
+  REQUIRE_EQUAL(store.NumSessions(), 3U);
+
+  // Рост графа учитывается функцией Account() и вытесняет другие сессии.
+  std::shared_ptr<graph::GraphSession> session = store.Find("c");
+  graph::GraphDelta delta;
+
+  for (size_t i = 100; i < 150; i++) {
+    delta.addEdges.emplace_back(i - 1, i);
+  }
+
+  session->Apply(delta);
+  REQUIRE(store.Account(session));
+  REQUIRE_EQUAL(store.NumSessions(), 2U);
+  REQUIRE(store.Find("c"));
+  REQUIRE(store.Bytes() <= 3 * sessionBytes);
+
+  // Слишком большой граф не помещается даже в пустое хранилище.
+  REQUIRE(!store.Create("e", Path(1000)));
+  REQUIRE(!store.Find("e"));
+
+  // Неудачное пересоздание не удаляет сессию с тем же именем.
+  REQUIRE(!store.Create("c", Path(1000)));
+  REQUIRE(store.Find("c"));
+
+  // Вытесненная сессия остаётся доступной тем, кто её уже получил.
+  REQUIRE(store.Remove("c"));
+  REQUIRE(!store.Remove("c"));
+  REQUIRE(!store.Account(session));
+  REQUIRE_EQUAL(session->NumEdges(), 149U);
+}
+
+/**
+ * @brief Изменения и снимок, которые не помещаются в ограничение памяти,
+ *        не удаляют сессию.
+ */
+static void LimitTest() {
+  size_t sessionBytes = graph::GraphSession("a", Path(100)).Bytes();
+  graph::GraphSessionStore store(sessionBytes,
+                                 graph::GraphSessionStore::Clock::duration(0));
+
+  REQUIRE(store.Create("a", Path(100)));
+
+  std::shared_ptr<graph::GraphSession> session = store.Find("a");
+  graph::GraphDelta delta;
+
+  // Пакет не применяется, хотя удаления уменьшили бы граф.
+  delta.removeVertices.push_back(0);
+  delta.addEdges.emplace_back(200, 201);
+  REQUIRE(!session->Apply(delta, store.MaxBytes()));
+  REQUIRE_EQUAL(session->NumVertices(), 100U);
+  REQUIRE_EQUAL(session->NumEdges(), 99U);
+  REQUIRE_EQUAL(session->Version(), 0U);
+
+  // Повторные рёбра и вершины не увеличивают оценку.
+  delta = graph::GraphDelta();
+  delta.addVertices.push_back(5);
+  delta.addEdges.emplace_back(0, 1);
+  delta.addEdges.emplace_back(0, 1);
+  REQUIRE(session->Apply(delta, store.MaxBytes()));
+  REQUIRE(store.Account(session));
+  REQUIRE_EQUAL(session->Version(), 1U);
+
+  // Снимок не помещается вместе с графом и удаляется, а сессия остаётся.
+  std::shared_ptr<const graph::GraphSnapshot> snapshot = session->Snapshot();
+
+  REQUIRE(session->Bytes() > sessionBytes);
+  REQUIRE(store.Account(session));
+  REQUIRE(store.Find("a") == session);
+  REQUIRE_EQUAL(session->Bytes(), sessionBytes);
+  REQUIRE_EQUAL(store.Bytes(), sessionBytes);
+  REQUIRE_EQUAL(snapshot->graph.NumEdges(), 99U);
+  REQUIRE(session->Snapshot() != snapshot);
+}
+
+/**
+ * @brief Сессии без обращений истекают.
+ */
+static void ExpirationTest() {
+  graph::GraphSessionStore store(size_t(1) << 30,
+                                 std::chrono::milliseconds(50));
+
+  REQUIRE(store.Create("a", Path(10)));
+  REQUIRE(store.Create("b", Path(10)));
+
+  for (int i = 0; i < 5; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(store.Find("a"));
+  }
+
+  REQUIRE(!store.Find("b"));
+  REQUIRE_EQUAL(store.NumSessions(), 1U);
+
+  store.SetLimits(size_t(1) << 30,
+                  graph::GraphSessionStore::Clock::duration(0));
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  REQUIRE(store.Find("a"));
+}
+
+/**
+ * @brief Отправить запрос на сервер.
+ *
+ * @param client Указатель на HTTP клиент.
+ * @param path Адрес метода.
+ * @param input Тело запроса.
+ * @param output Указатель, по которому записывается ответ.
+ *
+ * @return Функция возвращает код ответа.
+ */
+static int Post(httplib::Client* client, const char* path,
+                const nlohmann::json& input, nlohmann::json* output) {
+  httplib::Result result = client->Post(path, input.dump(),
+                                        "application/json");
+
+  *output = nlohmann::json::parse(result->body);
+
+  return result->status;
+}
+
+/**
+ * @brief Создание, изменение, запуск алгоритмов и удаление сессии.
+ *
+ * @param client Указатель на HTTP клиент.
+ */
+static void SessionTest(httplib::Client* client) {
+  nlohmann::json output;
+
+  REQUIRE_EQUAL(Post(client, "/Session/create", R"(
+{
+  "session": "test",
+  "vertices": [ 1, 2, 3 ],
+  "edges": [
+    { "start": 1, "end": 2 },
+    { "start": 2, "end": 3 },
+    { "start": 3, "end": 4 }
+  ]
+}
+)"_json, &output), 200);
+  REQUIRE_EQUAL(output, R"(
+{ "session": "test", "vertices": 4, "edges": 3, "version": 0 }
+)"_json);
+
+  REQUIRE_EQUAL(Post(client, "/Session/run", R"(
+{ "session": "test", "method": "TopologicalSort", "id": 1 }
+)"_json, &output), 200);
+  REQUIRE_EQUAL(output["result"], R"([ 1, 2, 3, 4 ])"_json);
+
+  REQUIRE_EQUAL(Post(client, "/Session/run", R"(
+{ "session": "test", "method": "TopologicalSort", "id": 1, "algorithm": "kahn" }
+)"_json, &output), 200);
+  REQUIRE_EQUAL(output["levels"], R"([ [ 1 ], [ 2 ], [ 3 ], [ 4 ] ])"_json);
+
+  REQUIRE_EQUAL(Post(client, "/Session/run", R"(
+{ "session": "test", "method": "BFS", "id": 2, "source": 1, "target": 4 }
+)"_json, &output), 200);
+  REQUIRE_EQUAL(output["distance"], 3);
+
+  REQUIRE_EQUAL(Post(client, "/Session/update", R"(
+{
+  "session": "test",
+  "remove": { "edges": [ { "start": 2, "end": 3 } ] },
+  "add": {
+    "vertices": [ 5 ],
+    "edges": [ { "start": 4, "end": 1 }, { "start": 2, "end": 4 } ]
+  }
+}
+)"_json, &output), 200);
+  REQUIRE_EQUAL(output, R"(
+{ "session": "test", "vertices": 5, "edges": 4, "version": 1 }
+)"_json);
+
+  // Снимок, построенный первым запросом BFS, должен обновиться.
+  REQUIRE_EQUAL(Post(client, "/Session/run", R"(
+{ "session": "test", "method": "BFS", "id": 3, "source": 1, "target": 4 }
+)"_json, &output), 200);
+  REQUIRE_EQUAL(output["distance"], 2);
+  REQUIRE_EQUAL(output["path"], R"([ 1, 2, 4 ])"_json);
+
+  REQUIRE_EQUAL(Post(client, "/Session/run", R"(
+{
+  "session": "test",
+  "method": "TopologicalSort",
+  "id": 4,
+  "algorithm": "tarjan"
+}
+)"_json, &output), 200);
+  REQUIRE_EQUAL(output["cycles"], R"([ [ 1, 2, 4 ] ])"_json);
+
+  REQUIRE_EQUAL(Post(client, "/Session/run", R"(
+{
+  "session": "test",
+  "method": "TopologicalSort",
+  "id": 5,
+  "algorithm": "forward-backward"
+}
+)"_json, &output), 200);
+  REQUIRE_EQUAL(output["cycles"], R"([ [ 1, 2, 4 ] ])"_json);
+
+  REQUIRE_EQUAL(Post(client, "/Session/delete", R"(
+{ "session": "test" }
+)"_json, &output), 200);
+  REQUIRE_EQUAL(output["deleted"], true);
+
+  REQUIRE_EQUAL(Post(client, "/Session/delete", R"(
+{ "session": "test" }
+)"_json, &output), 200);
+  REQUIRE_EQUAL(output["deleted"], false);
+}
+
+/**
+ * @brief Запросы к несуществующей сессии и некорректные запросы.
+ *
+ * @param client Указатель на HTTP клиент.
+ */
+static void UnknownSessionTest(httplib::Client* client) {
+  nlohmann::json output;
+
+  REQUIRE_EQUAL(Post(client, "/Session/run", R"(
+{ "session": "missing", "method": "BFS", "id": 1, "source": 1 }
+)"_json, &output), 400);
+  REQUIRE_EQUAL(output["error"], "unknown session");
+
+  REQUIRE_EQUAL(Post(client, "/Session/update", R"(
+{ "session": "missing", "add": { "vertices": [ 1 ] } }
+)"_json, &output), 400);
+  REQUIRE_EQUAL(output["error"], "unknown session");
+
+  REQUIRE_EQUAL(Post(client, "/Session/create", R"(
+{ "session": "bad", "vertices": [ 1 ], "edges": [ { "start": 1 } ] }
+)"_json, &output), 400);
+
+  REQUIRE_EQUAL(Post(client, "/Session/create", R"(
+{ "session": "bad", "vertices": [ 1 ], "edges": [] }
+)"_json, &output), 200);
+  REQUIRE_EQUAL(Post(client, "/Session/run", R"(
+{ "session": "bad", "method": "Dijkstra", "id": 1 }
+)"_json, &output), 400);
+  REQUIRE_EQUAL(output["session"], "bad");
+  REQUIRE_EQUAL(output["error"], "unknown method");
+  REQUIRE_EQUAL(Post(client, "/Session/delete", R"(
+{ "session": "bad" }
+)"_json, &output), 200);
+}
@@ -0,0 +1,655 @@
+/**
+ * @file graph_storage_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Тесты для политик хранения графов graph::HashStorage,
+ * graph::SmallStorage и graph::FlatStorage.
+ */
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include "test_core.hpp"
+#include <graph_builder.hpp>
+#include <graph_storage.hpp>
+#include <topological_sort.hpp>
+
+using std::map;
+using std::set;
+using std::unordered_map;
+using std::vector;
+using std::random_device;
+using std::mt19937;
+using std::uniform_int_distribution;
+
+using graph::BasicGraph;
+using graph::BasicOrientedGraph;
+using graph::CompactGraph;
+using graph::CompactOrientedGraph;
+using graph::CompactStorage;
+using graph::FlatMap;
+using graph::FlatOrientedGraph;
+using graph::FlatSet;
+using graph::FlatStorage;
+using graph::GraphBuilder;
+using graph::HashStorage;
+using graph::SmallMap;
+using graph::SmallSet;
+using graph::SmallStorage;
+using graph::SortedMap;
+using graph::WeightedGraph;
+using graph::WeightedGraphBuilder;
+using graph::WeightedOrientedGraph;
+
+static void FlatMapTest();
+static void FlatMapRandomTest();
+static void FlatSetRandomTest();
+static void SmallSetRandomTest();
+static void NeighbourMapRandomTest();
+static void FlatGraphRandomTest();
+static void SmallGraphRandomTest();
+static void CompactGraphRandomTest();
+static void CompactIdsTest();
+static void BuilderTest();
+static void TopologicalSortTest();
+
+template<typename GraphType, typename OtherGraphType>
+static void RequireSameGraph(const GraphType& left,
+                             const OtherGraphType& right);
+
+/**
+ * @brief Основная функция для тестирования политик хранения графов.
+ */
+void TestGraphStorage() {
+  TestSuite suite("TestGraphStorage");
+
+  RUN_TEST(suite, FlatMapTest);
+  RUN_TEST(suite, FlatMapRandomTest);
+  RUN_TEST(suite, FlatSetRandomTest);
+  RUN_TEST(suite, SmallSetRandomTest);
+  RUN_TEST(suite, NeighbourMapRandomTest);
+  RUN_TEST(suite, FlatGraphRandomTest);
+  RUN_TEST(suite, SmallGraphRandomTest);
+  RUN_TEST(suite, CompactGraphRandomTest);
+  RUN_TEST(suite, CompactIdsTest);
+  RUN_TEST(suite, BuilderTest);
+  RUN_TEST(suite, TopologicalSortTest);
+}
+
+/**
+ * @brief Простые операции со словарём graph::FlatMap.
+ */
+static void FlatMapTest() {
+  FlatMap<int> map;
+
+  REQUIRE(map.empty());
+  REQUIRE(map.find(1) == map.end());
+
+  map[1] = 10;
+  map[2] = 20;
+  map[1] += 5;
+
+  REQUIRE_EQUAL(map.size(), 2UL);
+  REQUIRE_EQUAL(map.at(1), 15);
+  REQUIRE_EQUAL(map.at(2), 20);
+  REQUIRE_EQUAL(map.count(3), 0UL);
+
+  bool thrown = false;
+
+  try {
+    map.at(3);
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+
+  REQUIRE(thrown);
+
+  REQUIRE_EQUAL(map.erase(1), 1UL);
+  REQUIRE_EQUAL(map.erase(1), 0UL);
+  REQUIRE_EQUAL(map.size(), 1UL);
+  REQUIRE(map.find(2) != map.end());
+  REQUIRE_EQUAL(map.find(2)->second, 20);
+
+  // Словарь после перемещения пуст и пригоден для использования.
+  FlatMap<int> other = std::move(map);
+
+  REQUIRE_EQUAL(other.size(), 1UL);
+  REQUIRE(map.empty());  // NOLINT(bugprone-use-after-move)
+
+  map[7] = 70;
+  REQUIRE_EQUAL(map.at(7), 70);
+
+  other.clear();
+  REQUIRE(other.empty());
+  REQUIRE(other.begin() == other.end());
+}
+
+/**
+ * @brief Случайный тест: graph::FlatMap ведёт себя так же,
+ *        как std::unordered_map.
+ */
+static void FlatMapRandomTest() {
+  // Число попыток.
+  const int numTries = 20;
+  // Используется для инициализации генератора случайных чисел.
+  random_device rd;
+  // Генератор случайных чисел.
+  mt19937 gen(rd());
+  // Распределение для ключей. Большие ключи проверяют хеширование.
+  uniform_int_distribution<size_t> key(0, 500);
+  // Распределение для количества операций.
+  uniform_int_distribution<size_t> numOperations(0, 5000);
+  // Распределение для выбора операции.
+  uniform_int_distribution<int> operation(0, 3);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t count = numOperations(gen);
+    FlatMap<size_t> map;
+    unordered_map<size_t, size_t> expected;
+
+    if (it % 2 == 0) {
+      map.reserve(count / 4);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      size_t k = key(gen) * (it % 3 == 0 ? 1024 : 1);
+
+      switch (operation(gen)) {
+        case 0:
+        case 1:
+          map[k] += i;
+          expected[k] += i;
+          break;
+        case 2:
+          REQUIRE_EQUAL(map.erase(k), expected.erase(k));
+          break;
+        default:
+          REQUIRE_EQUAL(map.count(k), expected.count(k));
+          break;
+      }
+    }
+
+    REQUIRE_EQUAL(map.size(), expected.size());
+
+    size_t numElements = 0;
+
+    for (const auto& [k, value] : map) {
+      REQUIRE_EQUAL(expected.at(k), value);
+      numElements++;
+    }
+
+    REQUIRE_EQUAL(numElements, expected.size());
+  }
+}
+
+/**
+ * @brief Случайный тест: graph::FlatSet ведёт себя так же, как std::set.
+ */
+static void FlatSetRandomTest() {
+  // Число попыток.
+  const int numTries = 20;
+  // Используется для инициализации генератора случайных чисел.
+  random_device rd;
+  // Генератор случайных чисел.
+  mt19937 gen(rd());
+  // Распределение для элементов.
+  uniform_int_distribution<size_t> element(0, 200);
+  // Распределение для количества операций.
+  uniform_int_distribution<size_t> numOperations(0, 2000);
+  // Распределение для выбора операции.
+  uniform_int_distribution<int> operation(0, 2);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t count = numOperations(gen);
+    FlatSet flatSet;
+    set<size_t> expected;
+
+    for (size_t i = 0; i < count; i++) {
+      size_t id = element(gen);
+
+      switch (operation(gen)) {
+        case 0:
+          REQUIRE_EQUAL(flatSet.insert(id).second, expected.insert(id).second);
+          REQUIRE_EQUAL(*flatSet.find(id), id);
+          break;
+        case 1:
+          REQUIRE_EQUAL(flatSet.erase(id), expected.erase(id));
+          break;
+        default:
+          REQUIRE_EQUAL(flatSet.count(id), expected.count(id));
+          break;
+      }
+    }
+
+    // Элементы перебираются по возрастанию.
+    REQUIRE(vector<size_t>(flatSet.begin(), flatSet.end()) ==
+            vector<size_t>(expected.begin(), expected.end()));
+  }
+}
+
+/**
+ * @brief Случайный тест: graph::SmallSet ведёт себя так же, как std::set,
+ *        в обеих формах и при переходах между ними.
+ */
+static void SmallSetRandomTest() {
+  // Число попыток.
+  const int numTries = 50;
+  // Используется для инициализации генератора случайных чисел.
+  random_device rd;
+  // Генератор случайных чисел.
+  mt19937 gen(rd());
+  // Распределение для количества операций.
+  uniform_int_distribution<size_t> numOperations(0, 500);
+  // Распределение для выбора операции.
+  uniform_int_distribution<int> operation(0, 3);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t count = numOperations(gen);
+    // Размер множества колеблется около размера встроенного буфера.
+    uniform_int_distribution<size_t> element(0, 4 + it % 20);
+    SmallSet<4> smallSet;
+    set<size_t> expected;
+
+    for (size_t i = 0; i < count; i++) {
+      size_t id = element(gen);
+
+      switch (operation(gen)) {
+        case 0:
+        case 1:
+          REQUIRE_EQUAL(smallSet.insert(id).second,
+                        expected.insert(id).second);
+          REQUIRE_EQUAL(*smallSet.find(id), id);
+          break;
+        case 2:
+          REQUIRE_EQUAL(smallSet.erase(id), expected.erase(id));
+          REQUIRE(smallSet.find(id) == smallSet.end());
+          break;
+        default:
+          REQUIRE_EQUAL(smallSet.count(id), expected.count(id));
+          break;
+      }
+
+      REQUIRE_EQUAL(smallSet.size(), expected.size());
+    }
+
+    SmallSet<4> copy = smallSet;
+    SmallSet<4> moved = std::move(smallSet);
+    set<size_t> elements(copy.begin(), copy.end());
+
+    REQUIRE(elements == expected);
+    REQUIRE(set<size_t>(moved.begin(), moved.end()) == expected);
+    REQUIRE(smallSet.empty());  // NOLINT(bugprone-use-after-move)
+
+    copy.clear();
+    REQUIRE(copy.begin() == copy.end());
+  }
+}
+
+/**
+ * @brief Случайный тест: словарь соседей MapType ведёт себя так же,
+ *        как std::map.
+ *
+ * @tparam MapType Проверяемый словарь соседей.
+ */
+template<typename MapType>
+static void NeighbourMapRandomTest() {
+  // Число попыток.
+  const int numTries = 50;
+  // Используется для инициализации генератора случайных чисел.
+  random_device rd;
+  // Генератор случайных чисел.
+  mt19937 gen(rd());
+  // Распределение для количества операций.
+  uniform_int_distribution<size_t> numOperations(0, 500);
+  // Распределение для выбора операции.
+  uniform_int_distribution<int> operation(0, 3);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t count = numOperations(gen);
+    // Размер словаря колеблется около размера встроенного буфера
+    // graph::SmallMap.
+    uniform_int_distribution<size_t> key(0, 4 + it % 20);
+    MapType neighbours;
+    map<size_t, size_t> expected;
+
+    for (size_t i = 0; i < count; i++) {
+      size_t k = key(gen);
+
+      switch (operation(gen)) {
+        case 0:
+        case 1:
+          neighbours[k] += i;
+          expected[k] += i;
+          REQUIRE_EQUAL(neighbours.at(k), expected.at(k));
+          break;
+        case 2:
+          REQUIRE_EQUAL(neighbours.erase(k), expected.erase(k));
+          REQUIRE(neighbours.find(k) == neighbours.end());
+          REQUIRE_THROW(neighbours.at(k), std::out_of_range);
+          break;
+        default:
+          REQUIRE_EQUAL(neighbours.count(k), expected.count(k));
+          break;
+      }
+
+      REQUIRE_EQUAL(neighbours.size(), expected.size());
+    }
+
+    MapType copy = neighbours;
+    MapType moved = std::move(neighbours);
+
+    map<size_t, size_t> elements(copy.begin(), copy.end());
+    map<size_t, size_t> movedElements(moved.begin(), moved.end());
+
+    REQUIRE(elements == expected);
+    REQUIRE(movedElements == expected);
+    REQUIRE(neighbours.empty());  // NOLINT(bugprone-use-after-move)
+
+    copy.clear();
+    REQUIRE(copy.begin() == copy.end());
+  }
+}
+
+/**
+ * @brief Случайный тест для словарей соседей graph::SmallMap
+ *        и graph::SortedMap.
+ */
+static void NeighbourMapRandomTest() {
+  NeighbourMapRandomTest<SmallMap<4, size_t>>();
+  NeighbourMapRandomTest<SortedMap<size_t>>();
+  NeighbourMapRandomTest<SortedMap<size_t, uint32_t>>();
+
+  // Элементы graph::SortedMap перебираются по возрастанию ключа.
+  SortedMap<int> sortedMap;
+
+  sortedMap[3] = 30;
+  sortedMap[1] = 10;
+  sortedMap[2] = 20;
+
+  REQUIRE_EQUAL(sortedMap.begin()->first, 1UL);
+  REQUIRE_EQUAL(sortedMap.begin()->second, 10);
+  REQUIRE_EQUAL((sortedMap.end() - 1)->first, 3UL);
+}
+
+/**
+ * @brief Случайный тест: графы с политикой хранения Storage содержат те же
+ *        вершины, рёбра и веса, что и графы на хеш-таблицах.
+ *
+ * @tparam Storage Проверяемая политика хранения.
+ */
+template<typename Storage>
+static void GraphRandomTest() {
+  // Число попыток.
+  const int numTries = 20;
+  // Используется для инициализации генератора случайных чисел.
+  random_device rd;
+  // Генератор случайных чисел.
+  mt19937 gen(rd());
+  // Распределение для номеров вершин.
+  uniform_int_distribution<size_t> vertex(0, 100);
+  // Распределение для количества операций. Степени вершин переходят
+  // через размер встроенного буфера graph::SmallSet в обе стороны.
+  uniform_int_distribution<size_t> numOperations(0, 2000);
+  // Распределение для выбора операции.
+  uniform_int_distribution<int> operation(0, 9);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t count = numOperations(gen);
+    BasicGraph<HashStorage> graph;
+    BasicGraph<Storage> otherGraph;
+    BasicOrientedGraph<HashStorage> orientedGraph;
+    BasicOrientedGraph<Storage> otherOrientedGraph;
+    WeightedGraph<int, HashStorage> weightedGraph;
+    WeightedGraph<int, Storage> otherWeightedGraph;
+    WeightedOrientedGraph<int, HashStorage> weightedOrientedGraph;
+    WeightedOrientedGraph<int, Storage> otherWeightedOrientedGraph;
+
+    for (size_t i = 0; i < count; i++) {
+      size_t id1 = vertex(gen);
+      size_t id2 = vertex(gen);
+      int weight = static_cast<int>(i);
+
+      switch (operation(gen)) {
+        case 0:
+          graph.RemoveVertex(id1);
+          otherGraph.RemoveVertex(id1);
+          orientedGraph.RemoveVertex(id1);
+          otherOrientedGraph.RemoveVertex(id1);
+          weightedGraph.RemoveVertex(id1);
+          otherWeightedGraph.RemoveVertex(id1);
+          weightedOrientedGraph.RemoveVertex(id1);
+          otherWeightedOrientedGraph.RemoveVertex(id1);
+          break;
+        case 1:
+        case 2:
+          graph.RemoveEdge(id1, id2);
+          otherGraph.RemoveEdge(id1, id2);
+          orientedGraph.RemoveEdge(id1, id2);
+          otherOrientedGraph.RemoveEdge(id1, id2);
+          weightedGraph.RemoveEdge(id1, id2);
+          otherWeightedGraph.RemoveEdge(id1, id2);
+          weightedOrientedGraph.RemoveEdge(id1, id2);
+          otherWeightedOrientedGraph.RemoveEdge(id1, id2);
+          break;
+        default:
+          graph.AddEdge(id1, id2);
+          otherGraph.AddEdge(id1, id2);
+          orientedGraph.AddEdge(id1, id2);
+          otherOrientedGraph.AddEdge(id1, id2);
+          weightedGraph.AddEdge(id1, id2, weight);
+          otherWeightedGraph.AddEdge(id1, id2, weight);
+          weightedOrientedGraph.AddEdge(id1, id2, weight);
+          otherWeightedOrientedGraph.AddEdge(id1, id2, weight);
+          break;
+      }
+    }
+
+    RequireSameGraph(graph, otherGraph);
+    RequireSameGraph(orientedGraph, otherOrientedGraph);
+    RequireSameGraph(weightedGraph, otherWeightedGraph);
+    RequireSameGraph(weightedOrientedGraph, otherWeightedOrientedGraph);
+
+    for (size_t id : weightedOrientedGraph.Vertices()) {
+      for (size_t neighbourId : weightedOrientedGraph.Edges(id)) {
+        REQUIRE_EQUAL(weightedOrientedGraph.EdgeWeight(id, neighbourId),
+                      otherWeightedOrientedGraph.EdgeWeight(id, neighbourId));
+      }
+
+      // Веса, перебираемые вместе с рёбрами, совпадают с EdgeWeight().
+      for (const auto& [neighbourId, weight] :
+           otherWeightedOrientedGraph.WeightedEdges(id)) {
+        REQUIRE_EQUAL(weight,
+                      weightedOrientedGraph.EdgeWeight(id, neighbourId));
+      }
+    }
+
+    for (size_t id : weightedGraph.Vertices()) {
+      for (size_t neighbourId : weightedGraph.Edges(id)) {
+        REQUIRE_EQUAL(weightedGraph.EdgeWeight(id, neighbourId),
+                      otherWeightedGraph.EdgeWeight(id, neighbourId));
+      }
+    }
+  }
+}
+
+/**
+ * @brief Случайный тест для политики хранения graph::FlatStorage.
+ */
+static void FlatGraphRandomTest() {
+  GraphRandomTest<FlatStorage>();
+}
+
+/**
+ * @brief Случайный тест для политики хранения graph::SmallStorage.
+ */
+static void SmallGraphRandomTest() {
+  GraphRandomTest<SmallStorage>();
+}
+
+/**
+ * @brief Случайный тест для политики хранения graph::CompactStorage.
+ */
+static void CompactGraphRandomTest() {
+  GraphRandomTest<CompactStorage>();
+}
+
+/**
+ * @brief Графы с 32-битными номерами вершин не принимают номера, которые
+ *        в них не помещаются, и при этом не меняются.
+ */
+static void CompactIdsTest() {
+  // Наибольший допустимый номер вершины.
+  const size_t maxId = 4294967295UL;
+  CompactOrientedGraph graph;
+  CompactGraph undirectedGraph;
+  WeightedOrientedGraph<int, CompactStorage> weightedGraph;
+
+  graph.AddEdge(maxId, 1);
+  undirectedGraph.AddEdge(maxId, 1);
+  weightedGraph.AddEdge(maxId, 1, 10);
+
+  REQUIRE(graph.HasEdge(maxId, 1));
+  REQUIRE(undirectedGraph.HasEdge(1, maxId));
+  REQUIRE_EQUAL(weightedGraph.EdgeWeight(maxId, 1), 10);
+  REQUIRE_EQUAL(*graph.Vertices().begin(), maxId);
+  REQUIRE_EQUAL(*graph.Edges(maxId).begin(), 1UL);
+
+  REQUIRE_THROW(graph.AddVertex(maxId + 1), std::out_of_range);
+  REQUIRE_THROW(graph.AddEdge(1, maxId + 1), std::out_of_range);
+  REQUIRE_THROW(graph.AddEdge(maxId + 1, 1), std::out_of_range);
+  REQUIRE_THROW(undirectedGraph.AddEdge(2, maxId + 1), std::out_of_range);
+  REQUIRE_THROW(weightedGraph.AddEdge(2, maxId + 1, 20), std::out_of_range);
+  REQUIRE_THROW(graph.Edges(maxId + 1), std::out_of_range);
+
+  // Номер не обрезается до младших 32 бит.
+  REQUIRE_EQUAL(graph.HasVertex(maxId + 2), false);
+  REQUIRE_EQUAL(graph.HasEdge(maxId, maxId + 2), false);
+  REQUIRE_EQUAL(graph.NumVertices(), 1UL);
+  REQUIRE_EQUAL(undirectedGraph.NumVertices(), 2UL);
+  REQUIRE_EQUAL(weightedGraph.NumVertices(), 1UL);
+
+  graph.RemoveEdge(maxId, maxId + 2);
+  graph.RemoveVertex(maxId + 1);
+
+  REQUIRE(graph.HasEdge(maxId, 1));
+
+  // Построитель проверяет номера до изменения графа.
+  GraphBuilder builder;
+
+  builder.AddEdge(2, 3);
+  builder.AddVertex(maxId + 1);
+
+  REQUIRE_THROW(builder.Build(&graph), std::out_of_range);
+  REQUIRE_EQUAL(graph.NumVertices(), 1UL);
+  REQUIRE_EQUAL(graph.HasVertex(2), false);
+
+  builder.Clear();
+  builder.AddEdge(2, 3);
+  builder.Build(&graph);
+
+  REQUIRE(graph.HasEdge(2, 3));
+}
+
+/**
+ * @brief Построители заполняют графы с компактным хранением.
+ */
+static void BuilderTest() {
+  GraphBuilder builder;
+  WeightedGraphBuilder<int> weightedBuilder;
+  FlatOrientedGraph graph;
+  WeightedGraph<int, FlatStorage> weightedGraph;
+  WeightedOrientedGraph<int, FlatStorage> weightedOrientedGraph;
+
+  builder.AddVertex(7);
+  builder.AddEdge(3, 1);
+  builder.AddEdge(1, 2);
+  builder.AddEdge(3, 1);
+  builder.Build(&graph);
+
+  REQUIRE_EQUAL(graph.NumVertices(), 3UL);
+  REQUIRE(graph.HasEdge(3, 1));
+  REQUIRE(graph.HasEdge(1, 2));
+  REQUIRE_EQUAL(graph.Edges(3).size(), 1UL);
+  REQUIRE_EQUAL(graph.IncomingEdges(1).size(), 1UL);
+  REQUIRE(graph.Edges(7).empty());
+
+  weightedBuilder.AddEdge(1, 2, 10);
+  weightedBuilder.AddEdge(2, 1, 20);
+  weightedBuilder.Build(&weightedGraph);
+
+  REQUIRE_EQUAL(weightedGraph.EdgeWeight(1, 2), 20);
+  REQUIRE_EQUAL(weightedGraph.Edges(1).size(), 1UL);
+
+  weightedOrientedGraph.AddEdge(1, 3, 5);
+  weightedBuilder.AddEdge(1, 3, 10);
+  weightedBuilder.AddEdge(1, 2, 20);
+  weightedBuilder.AddEdge(1, 3, 30);
+  weightedBuilder.AddVertex(4);
+  weightedBuilder.Build(&weightedOrientedGraph);
+
+  // Вес повторного ребра заменяется, соседи идут по возрастанию.
+  REQUIRE_EQUAL(weightedOrientedGraph.NumVertices(), 2UL);
+  REQUIRE_EQUAL(weightedOrientedGraph.EdgeWeight(1, 3), 30);
+  REQUIRE_EQUAL(weightedOrientedGraph.IncomingEdges(3).size(), 1UL);
+  REQUIRE(weightedOrientedGraph.Edges(4).empty());
+
+  vector<std::pair<size_t, int>> edges(
+      weightedOrientedGraph.WeightedEdges(1).begin(),
+      weightedOrientedGraph.WeightedEdges(1).end());
+
+  REQUIRE(edges == (vector<std::pair<size_t, int>>{ { 2, 20 }, { 3, 30 } }));
+}
+
+/**
+ * @brief Алгоритмы работают с графами с компактным хранением.
+ */
+static void TopologicalSortTest() {
+  FlatOrientedGraph graph;
+
+  graph.AddEdge(3, 2);
+  graph.AddEdge(2, 1);
+  graph.AddEdge(3, 1);
+  graph.AddVertex(1);
+  graph.AddVertex(4);
+
+  vector<size_t> order = graph::TopologicalSort(graph);
+  vector<size_t> position(5);
+
+  REQUIRE_EQUAL(order.size(), 4UL);
+
+  for (size_t i = 0; i < order.size(); i++) {
+    position[order[i]] = i;
+  }
+
+  REQUIRE(position[3] < position[2]);
+  REQUIRE(position[2] < position[1]);
+}
+
+/**
+ * @brief Проверить, что два графа с разными политиками хранения содержат
+ *        одни и те же вершины и рёбра.
+ *
+ * @tparam GraphType Тип первого графа.
+ * @tparam OtherGraphType Тип второго графа.
+ *
+ * @param left Первый граф.
+ * @param right Второй граф.
+ */
+template<typename GraphType, typename OtherGraphType>
+static void RequireSameGraph(const GraphType& left,
+                             const OtherGraphType& right) {
+  REQUIRE_EQUAL(left.NumVertices(), right.NumVertices());
+
+  for (size_t id : left.Vertices()) {
+    REQUIRE(right.HasVertex(id));
+    REQUIRE_EQUAL(left.Edges(id).size(), right.Edges(id).size());
+
+    for (size_t neighbourId : left.Edges(id)) {
+      REQUIRE(right.HasEdge(id, neighbourId));
+    }
+  }
+}
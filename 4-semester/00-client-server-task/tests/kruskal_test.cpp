@@ -0,0 +1,325 @@
+/**
+ * @file kruskal_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация набора тестов для алгоритма Краскала.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include "disjoint_set.hpp"
+#include "kruskal.hpp"
+#include "radix_sort.hpp"
+#include "weighted_graph.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+static void SimpleTest(httplib::Client* client);
+static void InvalidTest(httplib::Client* client);
+static void DisjointSetTest();
+static void SortTest();
+static void RandomTest();
+
+void TestKruskal(httplib::Client* client) {
+  TestSuite suite("TestKruskal");
+
+  RUN_TEST_REMOTE(suite, client, SimpleTest);
+  RUN_TEST_REMOTE(suite, client, InvalidTest);
+  RUN_TEST(suite, DisjointSetTest);
+  RUN_TEST(suite, SortTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Простой статический тест.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void SimpleTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 1,
+  "vertices": [ 1, 2, 3, 4, 5, 6 ],
+  "edges": [
+    { "start": 1, "end": 2, "weight": 3 },
+    { "start": 1, "end": 3, "weight": 1 },
+    { "start": 2, "end": 3, "weight": 7 },
+    { "start": 2, "end": 4, "weight": 5 },
+    { "start": 3, "end": 4, "weight": 2 },
+    { "start": 4, "end": 4, "weight": -9 },
+    { "start": 5, "end": 6, "weight": -1 }
+  ]
+}
+)"_json;
+
+  nlohmann::json expected = R"([
+    { "start": 5, "end": 6, "weight": -1 },
+    { "start": 1, "end": 3, "weight": 1 },
+    { "start": 3, "end": 4, "weight": 2 },
+    { "start": 1, "end": 2, "weight": 3 }
+  ])"_json;
+
+  for (const char* algorithm : { "kruskal", "filter-kruskal" }) {
+    input["algorithm"] = algorithm;
+
+    httplib::Result result = client->Post(
+      "/Kruskal",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+
+    REQUIRE_EQUAL(result->status, 200);
+    REQUIRE_EQUAL(1, output["id"]);
+    REQUIRE_EQUAL(output["edges"], expected);
+    REQUIRE_EQUAL(output["weight"], 5);
+  }
+}
+
+/**
+ * @brief Тест для некорректных запросов.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void InvalidTest(httplib::Client* client) {
+  const char* inputs[] = {
+    // Неизвестный алгоритм.
+    R"({ "id": 2, "vertices": [ 1 ], "edges": [ ],
+         "algorithm": "reverse-delete" })",
+    // Вес не является числом.
+    R"({ "id": 3, "vertices": [ 1, 2 ],
+         "edges": [ { "start": 1, "end": 2, "weight": null } ] })",
+    // Нет поля edges.
+    R"({ "id": 4, "vertices": [ 1 ] })"
+  };
+
+  for (const char* input : inputs) {
+    httplib::Result result = client->Post(
+      "/Kruskal",
+      input,
+      "application/json"
+    );
+
+    REQUIRE_EQUAL(result->status, 400);
+  }
+}
+
+/**
+ * @brief Случайные объединения сравниваются с наивной разметкой
+ *        компонент.
+ */
+static void DisjointSetTest() {
+  // Число элементов.
+  const size_t size = 1000;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для элементов.
+  std::uniform_int_distribution<size_t> element(0, size - 1);
+  graph::DisjointSet components(size);
+  std::vector<size_t> label(size);
+
+  for (size_t i = 0; i < size; i++) {
+    label[i] = i;
+  }
+
+  for (size_t it = 0; it < 2 * size; it++) {
+    size_t element1 = element(gen);
+    size_t element2 = element(gen);
+    size_t label1 = label[element1];
+    size_t label2 = label[element2];
+
+    REQUIRE_EQUAL(components.Union(element1, element2), label1 != label2);
+
+    std::replace(label.begin(), label.end(), label2, label1);
+
+    for (size_t check = 0; check < 10; check++) {
+      size_t element3 = element(gen);
+      size_t element4 = element(gen);
+
+      REQUIRE_EQUAL(components.Find(element3) == components.Find(element4),
+                    label[element3] == label[element4]);
+    }
+  }
+}
+
+/**
+ * @brief Проверить поразрядную сортировку чисел одного типа.
+ *
+ * @tparam Weight Тип чисел.
+ *
+ * @param values Числа.
+ * @param numThreads Число потоков.
+ *
+ * Результат сравнивается с std::stable_sort(): порядок равных чисел
+ * должен сохраниться.
+ */
+template<typename Weight>
+static void CheckSort(const std::vector<Weight>& values, size_t numThreads) {
+  std::vector<std::pair<Weight, size_t>> actual;
+
+  for (size_t i = 0; i < values.size(); i++) {
+    actual.emplace_back(values[i], i);
+  }
+
+  std::vector<std::pair<Weight, size_t>> expected = actual;
+
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const std::pair<Weight, size_t>& value1,
+                      const std::pair<Weight, size_t>& value2) {
+    return value1.first < value2.first;
+  });
+
+  graph::RadixSort(actual.data(), actual.size(),
+                   [](const std::pair<Weight, size_t>& value) {
+    return graph::RadixKey(value.first);
+  }, numThreads);
+
+  REQUIRE(actual == expected);
+}
+
+/**
+ * @brief Тест поразрядной сортировки для целых и вещественных чисел.
+ */
+static void SortTest() {
+  // Число элементов: достаточно, чтобы работали несколько потоков.
+  const size_t size = 300000;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937_64 gen(rd());
+  // Распределение для целых чисел во всём диапазоне.
+  std::uniform_int_distribution<int64_t> wide(INT64_MIN, INT64_MAX);
+  // Распределение для целых чисел с частыми повторами.
+  std::uniform_int_distribution<int> narrow(-100, 100);
+  // Распределение для вещественных чисел.
+  std::uniform_real_distribution<double> real(-1e6, 1e6);
+  std::vector<int64_t> int64Values(size);
+  std::vector<int> intValues(size);
+  std::vector<uint32_t> uint32Values(size);
+  std::vector<double> doubleValues(size);
+  std::vector<float> floatValues(size);
+
+  for (size_t i = 0; i < size; i++) {
+    int64Values[i] = wide(gen);
+    intValues[i] = narrow(gen);
+    uint32Values[i] = static_cast<uint32_t>(wide(gen));
+    doubleValues[i] = i % 10 == 0 ? narrow(gen) : real(gen);
+    floatValues[i] = static_cast<float>(real(gen));
+  }
+
+  doubleValues[0] = -0.0;
+  doubleValues[1] = 0.0;
+
+  for (size_t numThreads : { 1, 3, 8 }) {
+    CheckSort(int64Values, numThreads);
+    CheckSort(intValues, numThreads);
+    CheckSort(uint32Values, numThreads);
+    CheckSort(doubleValues, numThreads);
+    CheckSort(floatValues, numThreads);
+  }
+
+  CheckSort(std::vector<int>(), 4);
+  CheckSort(std::vector<int>(size, 7), 4);
+}
+
+/**
+ * @brief Случайный тест: вес леса сравнивается с наивным алгоритмом
+ *        Краскала, проверяется, что лес остовный.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 30;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для числа вершин.
+  std::uniform_int_distribution<size_t> size(1, 600);
+  // Распределение для весов.
+  std::uniform_int_distribution<int64_t> weight(-1000, 1000);
+  // Распределение для числа потоков.
+  std::uniform_int_distribution<size_t> threads(1, 8);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t numVertices = size(gen);
+    std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+    // Редкие графы несвязны, плотные проверяют отсечение тяжёлых рёбер.
+    size_t numEdges = it % 2 == 0 ? numVertices : 20 * numVertices;
+    graph::WeightedGraph<int64_t> graph;
+    std::vector<graph::MstEdge<int64_t>> edges;
+
+    for (size_t i = 0; i < numVertices; i++) {
+      graph.AddVertex(i);
+    }
+
+    for (size_t i = 0; i < numEdges; i++) {
+      size_t start = vertex(gen);
+      size_t end = vertex(gen);
+
+      if (start != end && !graph.HasEdge(start, end)) {
+        int64_t w = weight(gen);
+
+        graph.AddEdge(start, end, w);
+        edges.push_back(graph::MstEdge<int64_t>{start, end, w});
+      }
+    }
+
+    // Наивный алгоритм: рёбра сортируются сравнениями, компоненты хранятся
+    // метками вершин.
+    std::vector<size_t> label(numVertices);
+    int64_t expected = 0;
+    size_t numComponents = numVertices;
+
+    for (size_t i = 0; i < numVertices; i++) {
+      label[i] = i;
+    }
+
+    std::sort(edges.begin(), edges.end(),
+              [](const graph::MstEdge<int64_t>& edge1,
+                 const graph::MstEdge<int64_t>& edge2) {
+      return edge1.weight < edge2.weight;
+    });
+
+    for (const graph::MstEdge<int64_t>& edge : edges) {
+      size_t label1 = label[edge.start];
+      size_t label2 = label[edge.end];
+
+      if (label1 != label2) {
+        std::replace(label.begin(), label.end(), label2, label1);
+        expected += edge.weight;
+        numComponents--;
+      }
+    }
+
+    for (bool filter : { false, true }) {
+      std::vector<graph::MstEdge<int64_t>> forest;
+      graph::DisjointSet components(numVertices);
+      int64_t actual = 0;
+
+      graph::Kruskal(graph, filter, threads(gen), &forest);
+
+      REQUIRE_EQUAL(forest.size(), numVertices - numComponents);
+
+      for (size_t i = 0; i < forest.size(); i++) {
+        const graph::MstEdge<int64_t>& edge = forest[i];
+
+        REQUIRE(graph.HasEdge(edge.start, edge.end));
+        REQUIRE_EQUAL(graph.EdgeWeight(edge.start, edge.end), edge.weight);
+        REQUIRE(components.Union(edge.start, edge.end));
+        REQUIRE(i == 0 || forest[i - 1].weight <= edge.weight);
+
+        actual += edge.weight;
+      }
+
+      REQUIRE_EQUAL(actual, expected);
+    }
+  }
+}
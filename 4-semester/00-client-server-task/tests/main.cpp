@@ -21,6 +21,11 @@ int main(int argc, char* argv[]) {
   TestOrientedGraph();
   TestWeightedGraph();
   TestWeightedOrientedGraph();
+  TestCsrGraph();
+  TestWireFormat();
+  TestWorkerPool();
+  TestGraphBuilder();
+  TestGraphStorage();
 
   if (argc >= 2) {
     // Меняем хост, если предоставлен соответствующий аргумент командной строки.
@@ -42,6 +47,17 @@ int main(int argc, char* argv[]) {
   /* Сюда нужно вставить вызов набора тестов для алгоритма. */
 
   TestTopologicalSort(&cli);
+  TestDijkstra(&cli);
+  TestDeltaStepping(&cli);
+  TestBellmanFord(&cli);
+  TestKruskal(&cli);
+  TestPrim(&cli);
+  TestBoruvka(&cli);
+  TestBfs(&cli);
+  TestScc(&cli);
+  TestDynamicTopologicalOrder();
+  TestGraphSessions(&cli);
+  TestGraphFile(&cli);
 
   /* Конец вставки. */
 
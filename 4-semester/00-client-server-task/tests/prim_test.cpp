@@ -0,0 +1,237 @@
+/**
+ * @file prim_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация набора тестов для алгоритма Прима.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include "disjoint_set.hpp"
+#include "heaps.hpp"
+#include "kruskal.hpp"
+#include "prim.hpp"
+#include "weighted_csr_graph.hpp"
+#include "weighted_graph.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+static void SimpleTest(httplib::Client* client);
+static void InvalidTest(httplib::Client* client);
+static void DenseTest();
+static void RandomTest();
+
+void TestPrim(httplib::Client* client) {
+  TestSuite suite("TestPrim");
+
+  RUN_TEST_REMOTE(suite, client, SimpleTest);
+  RUN_TEST_REMOTE(suite, client, InvalidTest);
+  RUN_TEST(suite, DenseTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Простой статический тест.
+ *
+ * @param cli Указатель на HTTP клиент.
+ *
+ * Порядок рёбер в ответе зависит от порядка роста деревьев, поэтому
+ * сравниваются веса рёбер по возрастанию.
+ */
+static void SimpleTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 1,
+  "algorithm": "prim",
+  "vertices": [ 1, 2, 3, 4, 5, 6 ],
+  "edges": [
+    { "start": 1, "end": 2, "weight": 3 },
+    { "start": 1, "end": 3, "weight": 1 },
+    { "start": 2, "end": 3, "weight": 7 },
+    { "start": 2, "end": 4, "weight": 5 },
+    { "start": 3, "end": 4, "weight": 2 },
+    { "start": 4, "end": 4, "weight": -9 },
+    { "start": 5, "end": 6, "weight": -1 }
+  ]
+}
+)"_json;
+
+  for (const char* heap : { "auto", "indexed", "lazy", "dense" }) {
+    input["heap"] = heap;
+
+    httplib::Result result = client->Post(
+      "/Kruskal",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+    std::vector<double> weights;
+
+    REQUIRE_EQUAL(result->status, 200);
+    REQUIRE_EQUAL(1, output["id"]);
+    REQUIRE_EQUAL(output["weight"], 5);
+
+    for (const nlohmann::json& edge : output["edges"]) {
+      weights.push_back(edge["weight"]);
+    }
+
+    std::sort(weights.begin(), weights.end());
+
+    REQUIRE(weights == std::vector<double>({ -1, 1, 2, 3 }));
+  }
+}
+
+/**
+ * @brief Тест для некорректных запросов.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void InvalidTest(httplib::Client* client) {
+  const char* inputs[] = {
+    // Неизвестный вариант алгоритма Прима.
+    R"({ "id": 2, "vertices": [ 1 ], "edges": [ ],
+         "algorithm": "prim", "heap": "fibonacci" })",
+    // Вес не является числом.
+    R"({ "id": 3, "vertices": [ 1, 2 ], "algorithm": "prim",
+         "edges": [ { "start": 1, "end": 2, "weight": "1" } ] })"
+  };
+
+  for (const char* input : inputs) {
+    httplib::Result result = client->Post(
+      "/Kruskal",
+      input,
+      "application/json"
+    );
+
+    REQUIRE_EQUAL(result->status, 400);
+  }
+}
+
+/**
+ * @brief Проверка выбора варианта по плотности графа.
+ */
+static void DenseTest() {
+  // Число вершин.
+  const size_t numVertices = 100;
+  graph::WeightedGraph<int> path;
+  graph::WeightedGraph<int> complete;
+
+  for (size_t i = 0; i < numVertices; i++) {
+    path.AddVertex(i);
+    complete.AddVertex(i);
+  }
+
+  for (size_t i = 0; i + 1 < numVertices; i++) {
+    path.AddEdge(i, i + 1, 1);
+
+    for (size_t j = i + 1; j < numVertices; j++) {
+      complete.AddEdge(i, j, 1);
+    }
+  }
+
+  REQUIRE(!graph::IsDense(graph::WeightedCsrGraph<int>(path)));
+  REQUIRE(graph::IsDense(graph::WeightedCsrGraph<int>(complete)));
+  REQUIRE(!graph::IsDense(graph::WeightedCsrGraph<int>(
+      graph::WeightedGraph<int>())));
+}
+
+/**
+ * @brief Проверить, что лес остовный и его вес минимален.
+ *
+ * @param graph Граф.
+ * @param forest Рёбра леса с исходными номерами вершин.
+ * @param numEdges Ожидаемое число рёбер леса.
+ * @param expected Вес минимального остовного леса.
+ */
+static void CheckForest(const graph::WeightedGraph<int64_t>& graph,
+                        const std::vector<graph::MstEdge<int64_t>>& forest,
+                        size_t numEdges, int64_t expected) {
+  graph::DisjointSet components(graph.NumVertices());
+  int64_t actual = 0;
+
+  REQUIRE_EQUAL(forest.size(), numEdges);
+
+  for (const graph::MstEdge<int64_t>& edge : forest) {
+    REQUIRE(graph.HasEdge(edge.start, edge.end));
+    REQUIRE_EQUAL(graph.EdgeWeight(edge.start, edge.end), edge.weight);
+    REQUIRE(components.Union(edge.start, edge.end));
+
+    actual += edge.weight;
+  }
+
+  REQUIRE_EQUAL(actual, expected);
+}
+
+/**
+ * @brief Случайный тест: все варианты сравниваются с алгоритмом Краскала.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 30;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для числа вершин.
+  std::uniform_int_distribution<size_t> size(1, 300);
+  // Распределение для весов.
+  std::uniform_int_distribution<int64_t> weight(-1000, 1000);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t numVertices = size(gen);
+    std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+    // Редкие графы несвязны, на плотных вариант Auto выбирает перебор.
+    size_t numEdges = it % 2 == 0 ? numVertices : numVertices * numVertices;
+    graph::WeightedGraph<int64_t> graph;
+
+    for (size_t i = 0; i < numVertices; i++) {
+      graph.AddVertex(i);
+    }
+
+    for (size_t i = 0; i < numEdges; i++) {
+      size_t start = vertex(gen);
+      size_t end = vertex(gen);
+
+      // Петли не входят в лес.
+      graph.AddEdge(start, end, weight(gen));
+    }
+
+    std::vector<graph::MstEdge<int64_t>> expected;
+    int64_t expectedWeight = 0;
+
+    graph::Kruskal(graph, false, 1, &expected);
+
+    for (const graph::MstEdge<int64_t>& edge : expected) {
+      expectedWeight += edge.weight;
+    }
+
+    for (graph::PrimStrategy strategy : { graph::PrimStrategy::Auto,
+                                          graph::PrimStrategy::Indexed,
+                                          graph::PrimStrategy::Lazy,
+                                          graph::PrimStrategy::Dense }) {
+      std::vector<graph::MstEdge<int64_t>> forest;
+
+      graph::Prim(graph, strategy, &forest);
+      CheckForest(graph, forest, expected.size(), expectedWeight);
+    }
+
+    // Алгоритм с кучей на CSR снимке работает и с другими кучами.
+    graph::WeightedCsrGraph<int64_t> snapshot(graph);
+    graph::PairingHeap<int64_t> heap;
+    std::vector<graph::MstEdge<int64_t>> forest;
+
+    graph::Prim(snapshot, &heap, &forest);
+
+    for (graph::MstEdge<int64_t>& edge : forest) {
+      edge.start = snapshot.ExternalId(edge.start);
+      edge.end = snapshot.ExternalId(edge.end);
+    }
+
+    CheckForest(graph, forest, expected.size(), expectedWeight);
+  }
+}
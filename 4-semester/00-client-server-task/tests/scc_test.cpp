@@ -0,0 +1,364 @@
+/**
+ * @file scc_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Реализация набора тестов для поиска компонент сильной связности.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include "csr_graph.hpp"
+#include "oriented_graph.hpp"
+#include "scc.hpp"
+#include "trace.hpp"
+#include "test_core.hpp"
+#include "test.hpp"
+
+static void SimpleTest();
+static void CondensationTest(httplib::Client* client);
+static void AcyclicTest(httplib::Client* client);
+static void LongCycleTest();
+static void CpuBudgetTest();
+static void RandomTest();
+
+void TestScc(httplib::Client* client) {
+  TestSuite suite("TestScc");
+
+  RUN_TEST(suite, SimpleTest);
+  RUN_TEST_REMOTE(suite, client, CondensationTest);
+  RUN_TEST_REMOTE(suite, client, AcyclicTest);
+  RUN_TEST(suite, LongCycleTest);
+  RUN_TEST(suite, CpuBudgetTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Проверить, что номера компонент задают то же разбиение, что
+ *        и expected.
+ *
+ * @param graph Граф.
+ * @param component Номера компонент вершин.
+ * @param numComponents Число компонент.
+ * @param expected Эталонные номера компонент (в любом порядке).
+ * @param sorted Нужно ли проверять топологический порядок.
+ */
+static void CheckComponents(const graph::CsrGraph& graph,
+                            const std::vector<size_t>& component,
+                            size_t numComponents,
+                            const std::vector<size_t>& expected,
+                            bool sorted) {
+  const size_t none = graph.NumVertices();
+  // Соответствие номеров компонент эталонным номерам должно быть
+  // взаимно однозначным.
+  std::vector<size_t> forward(numComponents, none);
+  std::vector<size_t> backward(graph.NumVertices(), none);
+
+  REQUIRE_EQUAL(component.size(), graph.NumVertices());
+
+  for (size_t index : graph.Vertices()) {
+    REQUIRE(component[index] < numComponents);
+
+    if (forward[component[index]] == none) {
+      REQUIRE_EQUAL(backward[expected[index]], none);
+      forward[component[index]] = expected[index];
+      backward[expected[index]] = component[index];
+    }
+
+    REQUIRE_EQUAL(forward[component[index]], expected[index]);
+
+    if (!sorted) {
+      continue;
+    }
+
+    for (size_t neighbour : graph.Edges(index)) {
+      REQUIRE(component[index] <= component[neighbour]);
+    }
+  }
+
+  REQUIRE(std::find(forward.begin(), forward.end(), none) == forward.end());
+}
+
+/**
+ * @brief Простой статический тест для обоих алгоритмов.
+ */
+static void SimpleTest() {
+  graph::OrientedGraph graph;
+
+  // Два цикла 1 -> 2 -> 3 -> 1 и 4 <-> 5, петля у вершины 6.
+  graph.AddEdge(1, 2);
+  graph.AddEdge(2, 3);
+  graph.AddEdge(3, 1);
+  graph.AddEdge(3, 4);
+  graph.AddEdge(4, 5);
+  graph.AddEdge(5, 4);
+  graph.AddEdge(6, 6);
+  graph.AddEdge(6, 1);
+  graph.AddEdge(5, 7);
+
+  std::vector<std::vector<size_t>> expected = {
+    { 6 }, { 1, 2, 3 }, { 4, 5 }, { 7 }
+  };
+
+  for (graph::SccAlgorithm algorithm :
+       { graph::SccAlgorithm::Tarjan, graph::SccAlgorithm::ForwardBackward }) {
+    for (size_t numThreads : { 1, 3 }) {
+      std::vector<std::vector<size_t>> components;
+
+      REQUIRE_EQUAL(graph::StronglyConnectedComponents(graph, algorithm,
+                                                       numThreads,
+                                                       &components), 4U);
+      REQUIRE(components == expected);
+    }
+  }
+}
+
+/**
+ * @brief Тест режима топологической сортировки с компонентами.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void CondensationTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 1,
+  "vertices": [ 1, 2, 3, 4, 5, 6 ],
+  "edges": [
+    { "start": 1, "end": 2 },
+    { "start": 2, "end": 3 },
+    { "start": 3, "end": 2 },
+    { "start": 3, "end": 4 },
+    { "start": 5, "end": 5 },
+    { "start": 5, "end": 1 },
+    { "start": 6, "end": 4 }
+  ]
+}
+)"_json;
+
+  for (const char* algorithm : { "tarjan", "forward-backward" }) {
+    input["algorithm"] = algorithm;
+
+    httplib::Result result = client->Post(
+      "/TopologicalSort",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+
+    REQUIRE_EQUAL(result->status, 200);
+    REQUIRE_EQUAL(1, output["id"]);
+    REQUIRE_EQUAL(output["cycles"], R"([ [ 5 ], [ 2, 3 ] ])"_json);
+    REQUIRE_EQUAL(output["components"].size(), 5U);
+    REQUIRE_EQUAL(output["result"].size(), 6U);
+
+    std::vector<std::vector<size_t>> components = output["components"];
+    std::vector<size_t> position(7);
+
+    for (size_t i = 0; i < components.size(); i++) {
+      for (size_t vertex : components[i]) {
+        position[vertex] = i;
+      }
+    }
+
+    for (const nlohmann::json& edge : input["edges"]) {
+      REQUIRE(position[edge["start"]] <= position[edge["end"]]);
+    }
+  }
+}
+
+/**
+ * @brief Тест режима с компонентами для ациклического графа: порядок
+ *        вершин должен быть топологическим, а циклов не должно быть.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void AcyclicTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 2,
+  "vertices": [ 1, 2, 3, 4 ],
+  "edges": [
+    { "start": 4, "end": 3 },
+    { "start": 3, "end": 2 },
+    { "start": 2, "end": 1 }
+  ],
+  "algorithm": "tarjan"
+}
+)"_json;
+
+  httplib::Result result = client->Post(
+    "/TopologicalSort",
+    input.dump(),
+    "application/json"
+  );
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+
+  REQUIRE_EQUAL(result->status, 200);
+  REQUIRE_EQUAL(output["result"], R"([ 4, 3, 2, 1 ])"_json);
+  REQUIRE_EQUAL(output["cycles"], nlohmann::json::array());
+}
+
+/**
+ * @brief Длинный цикл: рекурсивная реализация переполнила бы стек, а
+ *        отсечение не удаляет ни одной вершины цикла.
+ */
+static void LongCycleTest() {
+  const size_t numVertices = 200000;
+  graph::OrientedGraph graph;
+
+  for (size_t i = 0; i < numVertices; i++) {
+    graph.AddEdge(i, (i + 1) % numVertices);
+  }
+
+  // Хвост, который отсекается в первой фазе.
+  graph.AddEdge(numVertices, 0);
+  graph.AddEdge(0, numVertices + 1);
+
+  graph::CsrGraph snapshot(graph);
+  graph::CsrGraph reverse;
+  std::vector<size_t> component;
+
+  reverse.AssignTranspose(snapshot);
+
+  REQUIRE_EQUAL(graph::TarjanScc(snapshot, &component), 3U);
+  REQUIRE_EQUAL(component[numVertices], 0U);
+  REQUIRE_EQUAL(component[0], 1U);
+  REQUIRE_EQUAL(component[numVertices + 1], 2U);
+
+  for (size_t numThreads : { 1, 4 }) {
+    REQUIRE_EQUAL(graph::ForwardBackwardScc(snapshot, reverse, numThreads,
+                                            &component), 3U);
+    REQUIRE_EQUAL(component[1], component[numVertices - 1]);
+    REQUIRE(component[0] != component[numVertices]);
+    REQUIRE(component[0] != component[numVertices + 1]);
+  }
+}
+
+/**
+ * @brief Случайный тест: маленькие графы сравниваются с транзитивным
+ *        замыканием, большие --- между алгоритмами.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 60;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для числа вершин.
+  std::uniform_int_distribution<size_t> size(1, 20000);
+  // Распределение для числа потоков.
+  std::uniform_int_distribution<size_t> threads(1, 8);
+  // Распределение для степени: от почти ациклических графов до графов
+  // с одной большой компонентой.
+  std::uniform_real_distribution<double> degree(0.5, 3.0);
+
+  for (int it = 0; it < numTries; it++) {
+    size_t numVertices = it % 3 == 0 ? size(gen) % 60 + 1 : size(gen);
+    std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+    size_t numEdges = static_cast<size_t>(numVertices * degree(gen));
+    graph::OrientedGraph graph;
+
+    for (size_t i = 0; i < numVertices; i++) {
+      graph.AddVertex(i);
+    }
+
+    for (size_t i = 0; i < numEdges; i++) {
+      graph.AddEdge(vertex(gen), vertex(gen));
+    }
+
+    graph::CsrGraph snapshot(graph);
+    graph::CsrGraph reverse;
+    std::vector<size_t> expected;
+    std::vector<size_t> component;
+
+    reverse.AssignTranspose(snapshot);
+
+    size_t numComponents = graph::TarjanScc(snapshot, &expected);
+
+    if (numVertices <= 60) {
+      // Транзитивное замыкание алгоритмом Флойда-Уоршелла.
+      std::vector<std::vector<bool>> reach(numVertices,
+                                           std::vector<bool>(numVertices));
+
+      for (size_t i = 0; i < numVertices; i++) {
+        reach[i][i] = true;
+
+        for (size_t j : snapshot.Edges(i)) {
+          reach[i][j] = true;
+        }
+      }
+
+      for (size_t k = 0; k < numVertices; k++) {
+        for (size_t i = 0; i < numVertices; i++) {
+          for (size_t j = 0; j < numVertices; j++) {
+            if (reach[i][k] && reach[k][j]) {
+              reach[i][j] = true;
+            }
+          }
+        }
+      }
+
+      for (size_t i = 0; i < numVertices; i++) {
+        for (size_t j = 0; j < numVertices; j++) {
+          REQUIRE_EQUAL(expected[i] == expected[j],
+                        reach[i][j] && reach[j][i]);
+        }
+      }
+    }
+
+    CheckComponents(snapshot, expected, numComponents, expected, true);
+
+    component.assign(numVertices, 0);
+    numComponents = graph::ForwardBackwardScc(snapshot, reverse,
+                                              threads(gen), &component);
+    CheckComponents(snapshot, component, numComponents, expected, false);
+
+    graph::SortComponents(snapshot, numComponents, &component);
+    CheckComponents(snapshot, component, numComponents, expected, true);
+  }
+}
+
+/**
+ * @brief Тест для ограничения процессорного времени.
+ *
+ * Длинный цикл требует длинного обхода у алгоритма Тарьяна и длинных
+ * поисков в ширину у forward-backward, поэтому оба алгоритма прерываются
+ * исключением.
+ */
+static void CpuBudgetTest() {
+  const size_t numVertices = 50'000;
+
+  graph::OrientedGraph graph;
+
+  for (size_t i = 0; i < numVertices; i++) {
+    graph.AddEdge(i, (i + 1) % numVertices);
+  }
+
+  graph::CsrGraph snapshot(graph);
+  graph::CsrGraph reverse;
+  std::vector<size_t> component;
+
+  reverse.AssignTranspose(snapshot);
+
+  {
+    graph::CpuBudget budget(std::chrono::nanoseconds(1));
+
+    REQUIRE_THROW(graph::TarjanScc(snapshot, &component),
+                  graph::BudgetExceeded);
+
+    for (size_t numThreads : { 1, 4 }) {
+      REQUIRE_THROW(graph::ForwardBackwardScc(snapshot, reverse, numThreads,
+                                              &component),
+                    graph::BudgetExceeded);
+    }
+  }
+
+  REQUIRE_EQUAL(graph::ForwardBackwardScc(snapshot, reverse, 4, &component),
+                1U);
+}
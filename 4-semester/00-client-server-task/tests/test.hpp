@@ -30,10 +30,59 @@ void TestWeightedGraph();
  */
 void TestWeightedOrientedGraph();
 
+/**
+ * @brief Набор тестов для класса graph::CsrGraph.
+ */
+void TestCsrGraph();
+
+/**
+ * @brief Набор тестов для двоичного формата передачи графов.
+ */
+void TestWireFormat();
+
+/**
+ * @brief Набор тестов для класса graph::WorkerPool.
+ */
+void TestWorkerPool();
+
+/**
+ * @brief Набор тестов для классов graph::GraphBuilder
+ *        и graph::WeightedGraphBuilder.
+ */
+void TestGraphBuilder();
+
+/**
+ * @brief Набор тестов для политик хранения графов graph::HashStorage
+ *        и graph::FlatStorage.
+ */
+void TestGraphStorage();
+
 /* Сюда нужно добавить объявления тестовых функций. */
 
 void TestTopologicalSort(httplib::Client* client);
 
+void TestDijkstra(httplib::Client* client);
+
+void TestDeltaStepping(httplib::Client* client);
+
+void TestBellmanFord(httplib::Client* client);
+
+void TestKruskal(httplib::Client* client);
+
+void TestPrim(httplib::Client* client);
+
+void TestBoruvka(httplib::Client* client);
+
+void TestBfs(httplib::Client* client);
+
+void TestScc(httplib::Client* client);
+
+void TestDynamicTopologicalOrder();
+
+void TestGraphSessions(httplib::Client* client);
+
+void TestGraphFile(httplib::Client* client);
+
 /* Конец вставки. */
 
 #endif  // TESTS_TEST_HPP_
@@ -5,11 +5,16 @@
  * Реализация набора тестов для алгоритма топологической сортировки.
  */
 
+#include <chrono>
+#include <string>
 #include <vector>
+#include <random>
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 #include "topological_sort.hpp"
 #include "oriented_graph.hpp"
+#include "trace.hpp"
+#include "wire_format.hpp"
 #include "test_core.hpp"
 #include "test.hpp"
 
@@ -18,7 +23,23 @@ static void EmptyTest(httplib::Client* client);
 static void LinearTest(httplib::Client* client);
 static void ReverseLinearTest(httplib::Client* client);
 static void CyclicTest(httplib::Client* client);
-// static void RandomTest(httplib::Client* cli);
+static void LongChainTest();
+static void WorkspaceReuseTest();
+static void KahnLevelsTest(httplib::Client* client);
+static void KahnCyclicTest(httplib::Client* client);
+static void UnknownAlgorithmTest(httplib::Client* client);
+static void RandomLevelsTest();
+static void TraceTest(httplib::Client* client);
+static void RingBufferTracerTest();
+static void MalformedTest(httplib::Client* client);
+static void ExtraFieldsTest(httplib::Client* client);
+static void RandomTest(httplib::Client* client);
+static void BinaryTest(httplib::Client* client);
+static void BinaryMalformedTest(httplib::Client* client);
+static void LargeIdTest(httplib::Client* client);
+static void CpuBudgetTest();
+static void BatchTest(httplib::Client* client);
+static void RandomBatchTest(httplib::Client* client);
 
 void TestTopologicalSort(httplib::Client* client) {
   TestSuite suite("TestTopologicalSort");
@@ -28,8 +49,25 @@ void TestTopologicalSort(httplib::Client* client) {
   RUN_TEST_REMOTE(suite, client, LinearTest);
   RUN_TEST_REMOTE(suite, client, ReverseLinearTest);
   RUN_TEST_REMOTE(suite, client, CyclicTest);
-  // RUN_TEST_REMOTE(suite, client, RandomTest); нельзя сделать, так как
-  // результат топологической сортировки неоднозначный.
+  RUN_TEST(suite, LongChainTest);
+  RUN_TEST(suite, WorkspaceReuseTest);
+  RUN_TEST_REMOTE(suite, client, KahnLevelsTest);
+  RUN_TEST_REMOTE(suite, client, KahnCyclicTest);
+  RUN_TEST_REMOTE(suite, client, UnknownAlgorithmTest);
+  RUN_TEST(suite, RandomLevelsTest);
+  RUN_TEST_REMOTE(suite, client, TraceTest);
+  RUN_TEST(suite, RingBufferTracerTest);
+  RUN_TEST_REMOTE(suite, client, MalformedTest);
+  RUN_TEST_REMOTE(suite, client, ExtraFieldsTest);
+  // Результат топологической сортировки неоднозначный, поэтому случайный
+  // тест проверяет только, что каждое ребро ведёт вперёд по порядку.
+  RUN_TEST_REMOTE(suite, client, RandomTest);
+  RUN_TEST_REMOTE(suite, client, BinaryTest);
+  RUN_TEST_REMOTE(suite, client, BinaryMalformedTest);
+  RUN_TEST_REMOTE(suite, client, LargeIdTest);
+  RUN_TEST(suite, CpuBudgetTest);
+  RUN_TEST_REMOTE(suite, client, BatchTest);
+  RUN_TEST_REMOTE(suite, client, RandomBatchTest);
 }
 
 /** 
@@ -242,4 +280,823 @@ static void CyclicTest(httplib::Client* client) {
   REQUIRE_EQUAL(5, output["id"]);
 
   REQUIRE_EQUAL(output["result"], empty_vector);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Тест для сортировки очень длинной цепочки.
+ *
+ * Рекурсивный обход в глубину на таком графе переполняет стек.
+ */
+static void LongChainTest() {
+  const size_t length = 1'000'000;
+
+  graph::OrientedGraph graph;
+
+  for (size_t i = 0; i < length; i++) {
+    graph.AddVertex(i);
+  }
+
+  for (size_t i = length - 1; i > 0; i--) {
+    graph.AddEdge(i, i - 1);
+  }
+
+  std::vector<size_t> order = graph::TopologicalSort(graph);
+
+  REQUIRE_EQUAL(order.size(), length);
+
+  for (size_t i = 0; i < length; i++) {
+    REQUIRE_EQUAL(order[i], length - 1 - i);
+  }
+}
+
+/**
+ * @brief Тест для повторного использования рабочей памяти.
+ */
+static void WorkspaceReuseTest() {
+  graph::TopologicalSortWorkspace workspace;
+  std::vector<size_t> order;
+
+  graph::OrientedGraph cyclic;
+
+  cyclic.AddVertex(1);
+  cyclic.AddVertex(2);
+  cyclic.AddEdge(1, 2);
+  cyclic.AddEdge(2, 1);
+
+  REQUIRE_EQUAL(graph::TopologicalSort(cyclic, &workspace, &order), false);
+  REQUIRE(order.empty());
+
+  graph::OrientedGraph linear;
+
+  linear.AddVertex(5);
+  linear.AddVertex(7);
+  linear.AddVertex(9);
+  linear.AddEdge(9, 5);
+  linear.AddEdge(5, 7);
+
+  REQUIRE(graph::TopologicalSort(linear, &workspace, &order));
+  REQUIRE_EQUAL(order, std::vector<size_t>({ 9, 5, 7 }));
+
+  const graph::DFSVertexState* stateData = workspace.state.data();
+  const size_t* orderData = order.data();
+
+  REQUIRE(graph::TopologicalSort(linear, &workspace, &order));
+  REQUIRE_EQUAL(order, std::vector<size_t>({ 9, 5, 7 }));
+
+  // Повторный запрос того же размера не перевыделяет память.
+  REQUIRE(stateData == workspace.state.data());
+  REQUIRE(orderData == order.data());
+}
+
+/**
+ * @brief Тест для разбиения графа на уровни алгоритмом Кана.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void KahnLevelsTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 6,
+  "algorithm": "kahn",
+  "vertices": [ 1, 2, 3, 4, 5 ],
+  "edges": [
+    { "start": 1, "end": 3 },
+    { "start": 1, "end": 2 },
+    { "start": 2, "end": 4 },
+    { "start": 3, "end": 4 }
+  ]
+}
+)"_json;
+
+  httplib::Result result = client->Post(
+    "/TopologicalSort",
+    input.dump(),
+    "application/json"
+  );
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+
+  REQUIRE_EQUAL(6, output["id"]);
+
+  std::vector<std::vector<size_t>> levels = output["levels"];
+
+  REQUIRE_EQUAL(levels.size(), 3UL);
+  REQUIRE_EQUAL(levels[0], std::vector<size_t>({ 1, 5 }));
+  REQUIRE_EQUAL(levels[1], std::vector<size_t>({ 2, 3 }));
+  REQUIRE_EQUAL(levels[2], std::vector<size_t>({ 4 }));
+
+  std::vector<size_t> order = output["result"];
+
+  REQUIRE_EQUAL(order, std::vector<size_t>({ 1, 5, 2, 3, 4 }));
+}
+
+/**
+ * @brief Тест для алгоритма Кана на графе с циклом.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void KahnCyclicTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 7,
+  "algorithm": "kahn",
+  "vertices": [ 1, 2, 3, 4 ],
+  "edges": [
+    { "start": 4, "end": 1 },
+    { "start": 1, "end": 2 },
+    { "start": 2, "end": 3 },
+    { "start": 3, "end": 1 }
+  ]
+}
+)"_json;
+
+  httplib::Result result = client->Post(
+    "/TopologicalSort",
+    input.dump(),
+    "application/json"
+  );
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+  std::vector<size_t> empty_vector;
+
+  REQUIRE_EQUAL(7, output["id"]);
+  REQUIRE_EQUAL(output["result"], empty_vector);
+  REQUIRE(output["levels"].empty());
+}
+
+/**
+ * @brief Тест для запроса с неизвестным алгоритмом.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void UnknownAlgorithmTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 8,
+  "algorithm": "bfs",
+  "vertices": [ 1 ],
+  "edges": [ ]
+}
+)"_json;
+
+  httplib::Result result = client->Post(
+    "/TopologicalSort",
+    input.dump(),
+    "application/json"
+  );
+
+  REQUIRE_EQUAL(result->status, 400);
+}
+
+/**
+ * @brief Случайный тест для многопоточного разбиения на уровни.
+ *
+ * Граф состоит из нескольких широких слоёв, рёбра ведут из каждого слоя
+ * в следующий. Результат многопоточного алгоритма должен совпадать
+ * с однопоточным, а каждое ребро должно вести в более поздний уровень.
+ */
+static void RandomLevelsTest() {
+  // Число слоёв.
+  const size_t numLayers = 5;
+  // Число вершин в слое.
+  const size_t layerSize = 20'000;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для номера вершины внутри слоя.
+  std::uniform_int_distribution<size_t> position(0, layerSize - 1);
+
+  graph::OrientedGraph graph;
+
+  for (size_t i = 0; i < numLayers * layerSize; i++) {
+    graph.AddVertex(i);
+  }
+
+  for (size_t layer = 0; layer + 1 < numLayers; layer++) {
+    for (size_t i = 0; i < 2 * layerSize; i++) {
+      graph.AddEdge(layer * layerSize + position(gen),
+                    (layer + 1) * layerSize + position(gen));
+    }
+  }
+
+  std::vector<std::vector<size_t>> serial;
+  std::vector<std::vector<size_t>> parallel;
+
+  REQUIRE(graph::TopologicalLevels(graph, &serial, 1));
+  REQUIRE(graph::TopologicalLevels(graph, &parallel, 4));
+  REQUIRE(serial == parallel);
+
+  std::vector<size_t> levelOf(numLayers * layerSize);
+  size_t total = 0;
+
+  for (size_t level = 0; level < parallel.size(); level++) {
+    for (size_t vertex : parallel[level]) {
+      levelOf[vertex] = level;
+    }
+
+    total += parallel[level].size();
+  }
+
+  REQUIRE_EQUAL(total, numLayers * layerSize);
+
+  for (size_t vertex : graph.Vertices()) {
+    for (size_t destination : graph.Edges(vertex)) {
+      REQUIRE(levelOf[vertex] < levelOf[destination]);
+    }
+  }
+}
+
+/**
+ * @brief Тест для трассировки алгоритма по запросу клиента.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void TraceTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "id": 9,
+  "trace": 100,
+  "vertices": [ 10, 20 ],
+  "edges": [
+    { "start": 10, "end": 20 }
+  ]
+}
+)"_json;
+
+  httplib::Result result = client->Post(
+    "/TopologicalSort",
+    input.dump(),
+    "application/json"
+  );
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+
+  REQUIRE_EQUAL(9, output["id"]);
+  REQUIRE_EQUAL(output["result"], std::vector<size_t>({ 10, 20 }));
+  REQUIRE_EQUAL(output["trace"]["dropped"], 0);
+
+  nlohmann::json expected = R"(
+[
+  { "event": "enter", "vertex": 10, "other": 0 },
+  { "event": "edge", "vertex": 10, "other": 20 },
+  { "event": "enter", "vertex": 20, "other": 0 },
+  { "event": "finish", "vertex": 20, "other": 0 },
+  { "event": "finish", "vertex": 10, "other": 0 }
+]
+)"_json;
+
+  REQUIRE_EQUAL(output["trace"]["events"], expected);
+
+  // Отрицательный и слишком большой размер буфера.
+  for (long long capacity : { -1LL, 1LL << 40 }) {
+    input["trace"] = capacity;
+    result = client->Post("/TopologicalSort", input.dump(),
+                          "application/json");
+
+    REQUIRE_EQUAL(result->status, 400);
+  }
+}
+
+/**
+ * @brief Тест для переполнения кольцевого буфера трассировки.
+ */
+static void RingBufferTracerTest() {
+  graph::OrientedGraph graph;
+
+  for (size_t i = 0; i < 10; i++) {
+    graph.AddVertex(i);
+  }
+
+  graph::TopologicalSortWorkspace workspace;
+  graph::RingBufferTracer tracer(3);
+  std::vector<size_t> order;
+
+  REQUIRE(graph::TopologicalSort(graph, &workspace, &order, &tracer));
+
+  // На каждую из 10 изолированных вершин приходится 2 события.
+  std::vector<graph::TraceRecord> events = tracer.Events();
+
+  REQUIRE_EQUAL(events.size(), 3UL);
+  REQUIRE_EQUAL(tracer.Dropped(), 17UL);
+  REQUIRE(events[0].event == graph::TraceEvent::FinishVertex);
+  REQUIRE_EQUAL(events[0].vertex, 8UL);
+  REQUIRE(events[1].event == graph::TraceEvent::EnterVertex);
+  REQUIRE_EQUAL(events[1].vertex, 9UL);
+  REQUIRE(events[2].event == graph::TraceEvent::FinishVertex);
+  REQUIRE_EQUAL(events[2].vertex, 9UL);
+
+  graph::RingBufferTracer empty(0);
+
+  REQUIRE(graph::TopologicalSort(graph, &workspace, &order, &empty));
+  REQUIRE(empty.Events().empty());
+  REQUIRE_EQUAL(empty.Dropped(), 20UL);
+}
+
+/**
+ * @brief Тест для некорректных запросов.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void MalformedTest(httplib::Client* client) {
+  const char* inputs[] = {
+    R"({ "id": 10, "vertices": [ 1, "two" ], "edges": [ ] })",
+    R"({ "id": 11, "vertices": [ 1, -2 ], "edges": [ ] })",
+    R"({ "id": 12, "vertices": [ 1, 2 ], "edges": [ { "start": 1 } ] })",
+    R"({ "id": 13, "vertices": [ 1, 2 ], "edges": [ [ 1, 2 ] ] })",
+    R"({ "id": 14, "vertices": [ 1, 2 ], "edges": [ )",
+    R"([ 1, 2, 3 ])",
+    R"({ "vertices": [ 1, 2 ], "edges": [ ] })"
+  };
+
+  for (const char* input : inputs) {
+    httplib::Result result = client->Post(
+      "/TopologicalSort",
+      input,
+      "application/json"
+    );
+
+    REQUIRE_EQUAL(result->status, 400);
+  }
+}
+
+/**
+ * @brief Тест для запроса с посторонними полями.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void ExtraFieldsTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "comment": { "author": "test", "tags": [ "a", [ 1, 2 ] ] },
+  "edges": [
+    { "start": 3, "end": 1, "label": "x" },
+    { "start": 1, "meta": { "x": 1, "y": [ { "z": null }, [ ] ] }, "end": 2 }
+  ],
+  "vertices": [ 1, 2, 3 ],
+  "id": "extra"
+}
+)"_json;
+
+  httplib::Result result = client->Post(
+    "/TopologicalSort",
+    input.dump(),
+    "application/json"
+  );
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+
+  REQUIRE_EQUAL(result->status, 200);
+  REQUIRE_EQUAL("extra", output["id"]);
+  REQUIRE_EQUAL(output["result"], std::vector<size_t>({ 3, 1, 2 }));
+
+  // Вложенное значение допустимо только в постороннем поле ребра.
+  input["edges"][1]["end"] = { { "vertex", 2 } };
+  result = client->Post("/TopologicalSort", input.dump(), "application/json");
+
+  REQUIRE_EQUAL(result->status, 400);
+}
+
+/**
+ * @brief Случайный тест для большого ациклического графа.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void RandomTest(httplib::Client* client) {
+  // Число попыток.
+  const int numTries = 10;
+  // Число вершин.
+  const size_t numVertices = 10'000;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для номеров вершин.
+  std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+
+  for (int it = 0; it < numTries; it++) {
+    nlohmann::json input;
+    std::vector<std::pair<size_t, size_t>> edges;
+
+    input["id"] = it;
+    input["algorithm"] = it % 2 == 0 ? "dfs" : "kahn";
+
+    for (size_t i = 0; i < numVertices; i++) {
+      input["vertices"].push_back(i);
+    }
+
+    // Ребро всегда ведёт из меньшей вершины в большую, поэтому цикла нет.
+    for (size_t i = 0; i < 3 * numVertices; i++) {
+      size_t start = vertex(gen);
+      size_t end = vertex(gen);
+
+      if (start == end) {
+        continue;
+      }
+
+      edges.emplace_back(std::min(start, end), std::max(start, end));
+      input["edges"].push_back({
+        { "start", edges.back().first },
+        { "end", edges.back().second }
+      });
+    }
+
+    httplib::Result result = client->Post(
+      "/TopologicalSort",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json output = nlohmann::json::parse(result->body);
+    std::vector<size_t> order = output["result"];
+    std::vector<size_t> position(numVertices, numVertices);
+
+    REQUIRE_EQUAL(it, output["id"]);
+    REQUIRE_EQUAL(order.size(), numVertices);
+
+    for (size_t i = 0; i < order.size(); i++) {
+      position[order[i]] = i;
+    }
+
+    for (const std::pair<size_t, size_t>& edge : edges) {
+      REQUIRE(position[edge.first] < position[edge.second]);
+    }
+  }
+}
+
+/**
+ * @brief Тест для запросов в двоичном формате.
+ *
+ * @param cli Указатель на HTTP клиент.
+ *
+ * Ответ в двоичном формате должен совпадать с ответом на тот же запрос
+ * в формате JSON.
+ */
+static void BinaryTest(httplib::Client* client) {
+  // Число вершин.
+  const size_t numVertices = 1000;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для номеров вершин.
+  std::uniform_int_distribution<size_t> vertex(0, numVertices - 1);
+
+  std::vector<size_t> vertices;
+  std::vector<std::pair<size_t, size_t>> edges;
+  nlohmann::json input;
+
+  for (size_t i = 0; i < numVertices; i++) {
+    vertices.push_back(i);
+    input["vertices"].push_back(i);
+  }
+
+  for (size_t i = 0; i < 2 * numVertices; i++) {
+    size_t start = vertex(gen);
+    size_t end = vertex(gen);
+
+    if (start < end) {
+      edges.emplace_back(start, end);
+      input["edges"].push_back({ { "start", start }, { "end", end } });
+    }
+  }
+
+  for (const char* algorithm : { "dfs", "kahn" }) {
+    input["id"] = 20;
+    input["algorithm"] = algorithm;
+
+    httplib::Result jsonResult = client->Post(
+      "/TopologicalSort",
+      input.dump(),
+      "application/json"
+    );
+
+    nlohmann::json expected = nlohmann::json::parse(jsonResult->body);
+
+    for (graph::WireEncoding encoding : { graph::WireEncoding::Fixed,
+                                          graph::WireEncoding::Varint }) {
+      graph::WireWriter writer(encoding);
+
+      writer.WriteNumber(21);
+      writer.WriteString(algorithm);
+      writer.WriteNumber(0);
+      writer.WriteArray(vertices);
+      writer.WriteEdges(edges);
+
+      httplib::Result result = client->Post(
+        "/TopologicalSort",
+        writer.Data(),
+        graph::WireContentType(encoding)
+      );
+
+      REQUIRE_EQUAL(result->status, 200);
+      REQUIRE_EQUAL(result->get_header_value("Content-Type"),
+                    std::string(graph::WireContentType(encoding)));
+
+      graph::WireReader reader(result->body, encoding);
+      uint64_t id;
+      std::vector<size_t> order;
+      std::vector<size_t> levelSizes;
+
+      REQUIRE(reader.ReadNumber(&id));
+      REQUIRE(reader.ReadArray([&order](size_t value) {
+        order.push_back(value);
+      }));
+      REQUIRE(reader.ReadArray([&levelSizes](size_t value) {
+        levelSizes.push_back(value);
+      }));
+      REQUIRE(reader.AtEnd());
+
+      REQUIRE_EQUAL(id, 21UL);
+      REQUIRE_EQUAL(expected["result"], order);
+
+      if (expected.contains("levels")) {
+        REQUIRE_EQUAL(levelSizes.size(), expected["levels"].size());
+
+        for (size_t i = 0; i < levelSizes.size(); i++) {
+          REQUIRE_EQUAL(levelSizes[i], expected["levels"][i].size());
+        }
+      } else {
+        REQUIRE(levelSizes.empty());
+      }
+    }
+  }
+}
+
+/**
+ * @brief Тест для некорректных запросов в двоичном формате.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void BinaryMalformedTest(httplib::Client* client) {
+  graph::WireWriter writer(graph::WireEncoding::Varint);
+
+  writer.WriteNumber(22);
+  writer.WriteString("dfs");
+  writer.WriteNumber(0);
+  writer.WriteArray({ 1, 2, 3 });
+  writer.WriteEdges({ { 1, 2 }, { 2, 3 } });
+
+  const std::string& data = writer.Data();
+  const char* contentType = graph::WireContentType(graph::WireEncoding::Varint);
+
+  // Обрезанный запрос.
+  httplib::Result result = client->Post(
+    "/TopologicalSort",
+    data.substr(0, data.size() - 1),
+    contentType
+  );
+
+  REQUIRE_EQUAL(result->status, 400);
+
+  // Лишние байты в конце запроса.
+  result = client->Post("/TopologicalSort", data + "x", contentType);
+
+  REQUIRE_EQUAL(result->status, 400);
+
+  // Неизвестный алгоритм.
+  graph::WireWriter unknown(graph::WireEncoding::Varint);
+
+  unknown.WriteNumber(23);
+  unknown.WriteString("bfs");
+  unknown.WriteNumber(0);
+  unknown.WriteArray({});
+  unknown.WriteEdges({});
+
+  result = client->Post("/TopologicalSort", unknown.Data(), contentType);
+
+  REQUIRE_EQUAL(result->status, 400);
+}
+
+/**
+ * @brief Тест для номеров вершин, которые не помещаются в 32 бита.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void LargeIdTest(httplib::Client* client) {
+  // Наибольший допустимый номер вершины.
+  const size_t maxId = 4294967295UL;
+
+  nlohmann::json input = {
+    { "id", 24 },
+    { "vertices", { 1, maxId } },
+    { "edges", { { { "start", maxId }, { "end", 1 } } } }
+  };
+
+  httplib::Result result = client->Post(
+    "/TopologicalSort",
+    input.dump(),
+    "application/json"
+  );
+
+  REQUIRE_EQUAL(result->status, 200);
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+
+  REQUIRE(output["result"] == nlohmann::json::array({ maxId, 1 }));
+
+  // Номер вершины и конец ребра на единицу больше допустимого.
+  input["vertices"] = { 1, maxId + 1 };
+  input["edges"] = nlohmann::json::array();
+
+  for (int i = 0; i < 2; i++) {
+    result = client->Post("/TopologicalSort", input.dump(),
+                          "application/json");
+
+    REQUIRE_EQUAL(result->status, 400);
+    REQUIRE_EQUAL(nlohmann::json::parse(result->body)["error"],
+                  "vertex id out of range");
+
+    input["vertices"] = { 1 };
+    input["edges"] = { { { "start", 1 }, { "end", maxId + 1 } } };
+  }
+
+  graph::WireWriter writer(graph::WireEncoding::Varint);
+
+  writer.WriteNumber(25);
+  writer.WriteString("dfs");
+  writer.WriteNumber(0);
+  writer.WriteArray({ 1, maxId + 1 });
+  writer.WriteEdges({});
+
+  result = client->Post("/TopologicalSort", writer.Data(),
+                        graph::WireContentType(graph::WireEncoding::Varint));
+
+  REQUIRE_EQUAL(result->status, 400);
+}
+
+/**
+ * @brief Тест для ограничения процессорного времени.
+ *
+ * Алгоритмы под исчерпанным ограничением прерываются исключением, после
+ * чего та же рабочая память используется для обычного запуска. Нулевое
+ * ограничение снимает объемлющее.
+ */
+static void CpuBudgetTest() {
+  const size_t length = 100'000;
+
+  graph::OrientedGraph graph;
+
+  for (size_t i = 0; i + 1 < length; i++) {
+    graph.AddEdge(i, i + 1);
+  }
+
+  graph::TopologicalSortWorkspace workspace;
+  std::vector<size_t> order;
+  std::vector<std::vector<size_t>> levels;
+
+  {
+    graph::CpuBudget budget(std::chrono::nanoseconds(1));
+
+    REQUIRE_THROW(graph::TopologicalSort(graph, &workspace, &order),
+                  graph::BudgetExceeded);
+    REQUIRE_THROW(graph::TopologicalLevels(graph, &levels, 1),
+                  graph::BudgetExceeded);
+
+    graph::CpuBudget unlimited(std::chrono::nanoseconds::zero());
+
+    REQUIRE(graph::CpuBudget::Current() == nullptr);
+    REQUIRE(graph::TopologicalLevels(graph, &levels, 1));
+    REQUIRE_EQUAL(levels.size(), length);
+  }
+
+  REQUIRE(graph::CpuBudget::Current() == nullptr);
+  REQUIRE(graph::TopologicalSort(graph, &workspace, &order));
+  REQUIRE_EQUAL(order.size(), length);
+
+  for (size_t i = 0; i < length; i++) {
+    REQUIRE_EQUAL(order[i], i);
+  }
+}
+
+/**
+ * @brief Тест для запроса с набором графов.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void BatchTest(httplib::Client* client) {
+  nlohmann::json input = R"(
+{
+  "graphs": [
+    { "id": 1, "vertices": [ 1, 2 ], "edges": [ { "start": 2, "end": 1 } ] },
+    { "id": 2, "vertices": [ 1, 2 ], "edges": [ { "start": 1, "end": 2 },
+                                                { "start": 2, "end": 1 } ] },
+    { "id": 3, "vertices": [ 1, 2 ], "edges": [ { "start": 1 } ] },
+    { "id": 4, "algorithm": "kahn", "vertices": [ 1, 2, 3 ],
+      "edges": [ { "start": 3, "end": 2 } ] },
+    { "id": 5, "algorithm": "bfs", "vertices": [ ], "edges": [ ] },
+    { "id": 6, "trace": -1, "vertices": [ 1 ], "edges": [ ] }
+  ]
+}
+)"_json;
+
+  httplib::Result result = client->Post(
+    "/TopologicalSort/batch",
+    input.dump(),
+    "application/json"
+  );
+
+  REQUIRE_EQUAL(result->status, 200);
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+  nlohmann::json results = output["results"];
+
+  REQUIRE_EQUAL(results.size(), 6UL);
+
+  for (size_t i = 0; i < results.size(); i++) {
+    REQUIRE_EQUAL(results[i]["id"], i + 1);
+  }
+
+  REQUIRE_EQUAL(results[0]["result"], std::vector<size_t>({ 2, 1 }));
+  REQUIRE_EQUAL(results[1]["result"], std::vector<size_t>());
+  REQUIRE_EQUAL(results[2]["error"], "malformed graph");
+  REQUIRE_EQUAL(results[3]["result"], std::vector<size_t>({ 1, 3, 2 }));
+  REQUIRE_EQUAL(results[4]["error"], "invalid graph");
+  // Ошибка в одном графе не прерывает обработку остальных.
+  REQUIRE(results[5].contains("error"));
+
+  const char* malformed[] = {
+    R"({ "graphs": 1 })",
+    R"([ ])",
+    R"({ "graphs": [ )"
+  };
+
+  for (const char* body : malformed) {
+    result = client->Post("/TopologicalSort/batch", body, "application/json");
+
+    REQUIRE_EQUAL(result->status, 400);
+  }
+}
+
+/**
+ * @brief Случайный тест для запроса с большим набором графов.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void RandomBatchTest(httplib::Client* client) {
+  // Число графов в запросе.
+  const size_t numGraphs = 1000;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для числа вершин.
+  std::uniform_int_distribution<size_t> numVertices(1, 20);
+
+  nlohmann::json input;
+  std::vector<std::vector<std::pair<size_t, size_t>>> edges(numGraphs);
+
+  for (size_t g = 0; g < numGraphs; g++) {
+    nlohmann::json graph;
+    size_t size = numVertices(gen);
+    std::uniform_int_distribution<size_t> vertex(0, size - 1);
+
+    graph["id"] = "graph" + std::to_string(g);
+    graph["vertices"] = nlohmann::json::array();
+    graph["edges"] = nlohmann::json::array();
+
+    for (size_t i = 0; i < size; i++) {
+      graph["vertices"].push_back(i);
+    }
+
+    // Ребро всегда ведёт из меньшей вершины в большую, поэтому цикла нет.
+    for (size_t i = 0; i < 2 * size; i++) {
+      size_t start = vertex(gen);
+      size_t end = vertex(gen);
+
+      if (start < end) {
+        edges[g].emplace_back(start, end);
+        graph["edges"].push_back({ { "start", start }, { "end", end } });
+      }
+    }
+
+    input["graphs"].push_back(graph);
+  }
+
+  httplib::Result result = client->Post(
+    "/TopologicalSort/batch",
+    input.dump(),
+    "application/json"
+  );
+
+  nlohmann::json output = nlohmann::json::parse(result->body);
+
+  REQUIRE_EQUAL(output["results"].size(), numGraphs);
+
+  for (size_t g = 0; g < numGraphs; g++) {
+    const nlohmann::json& answer = output["results"][g];
+    std::vector<size_t> order = answer["result"];
+    std::vector<size_t> position(order.size());
+
+    REQUIRE_EQUAL(answer["id"], "graph" + std::to_string(g));
+    REQUIRE_EQUAL(order.size(), input["graphs"][g]["vertices"].size());
+
+    for (size_t i = 0; i < order.size(); i++) {
+      position[order[i]] = i;
+    }
+
+    for (const std::pair<size_t, size_t>& edge : edges[g]) {
+      REQUIRE(position[edge.first] < position[edge.second]);
+    }
+  }
+}
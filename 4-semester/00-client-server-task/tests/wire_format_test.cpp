@@ -0,0 +1,229 @@
+/**
+ * @file wire_format_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Тесты для двоичного формата передачи графов.
+ */
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <random>
+#include "test_core.hpp"
+#include <wire_format.hpp>
+
+using std::string;
+using std::pair;
+using std::vector;
+using std::random_device;
+using std::mt19937;
+using std::uniform_int_distribution;
+
+using graph::WireEncoding;
+using graph::WireReader;
+using graph::WireWriter;
+
+static void ContentTypeTest();
+static void FixedTest();
+static void VarintTest();
+static void TruncatedTest();
+static void RandomTest();
+
+/**
+ * @brief Основная функция для тестирования двоичного формата.
+ */
+void TestWireFormat() {
+  TestSuite suite("TestWireFormat");
+
+  RUN_TEST(suite, ContentTypeTest);
+  RUN_TEST(suite, FixedTest);
+  RUN_TEST(suite, VarintTest);
+  RUN_TEST(suite, TruncatedTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Определение способа кодирования по MIME типу.
+ */
+static void ContentTypeTest() {
+  WireEncoding encoding = WireEncoding::Fixed;
+
+  REQUIRE(graph::WireEncodingFromContentType(
+      graph::WireContentType(WireEncoding::Varint), &encoding));
+  REQUIRE(encoding == WireEncoding::Varint);
+  REQUIRE(graph::WireEncodingFromContentType("application/x-graph",
+                                             &encoding));
+  REQUIRE(encoding == WireEncoding::Fixed);
+  REQUIRE_EQUAL(graph::WireEncodingFromContentType("application/json",
+                                                   &encoding), false);
+
+  // Параметры, регистр и пробелы по краям не учитываются.
+  REQUIRE(graph::WireEncodingFromContentType(
+      "application/x-graph-varint; charset=binary", &encoding));
+  REQUIRE(encoding == WireEncoding::Varint);
+  REQUIRE(graph::WireEncodingFromContentType(" Application/X-Graph ",
+                                             &encoding));
+  REQUIRE(encoding == WireEncoding::Fixed);
+  REQUIRE_EQUAL(graph::WireEncodingFromContentType("application/x-graphs",
+                                                   &encoding), false);
+}
+
+/**
+ * @brief Числа фиксированной длины записываются в порядке little-endian.
+ */
+static void FixedTest() {
+  WireWriter writer(WireEncoding::Fixed);
+
+  writer.WriteNumber(0x0102030405060708ULL);
+  writer.WriteString("ab");
+
+  const string& data = writer.Data();
+
+  REQUIRE_EQUAL(data.size(), 18UL);
+  REQUIRE_EQUAL(static_cast<int>(data[0]), 0x08);
+  REQUIRE_EQUAL(static_cast<int>(data[7]), 0x01);
+  REQUIRE_EQUAL(static_cast<int>(data[8]), 2);
+  REQUIRE_EQUAL(data.substr(16), string("ab"));
+
+  WireReader reader(data, WireEncoding::Fixed);
+  uint64_t value;
+  string text;
+
+  REQUIRE(reader.ReadNumber(&value));
+  REQUIRE_EQUAL(value, 0x0102030405060708ULL);
+  REQUIRE(reader.ReadString(&text));
+  REQUIRE_EQUAL(text, string("ab"));
+  REQUIRE(reader.AtEnd());
+}
+
+/**
+ * @brief Близкие номера вершин занимают по одному байту.
+ */
+static void VarintTest() {
+  WireWriter writer(WireEncoding::Varint);
+  vector<size_t> vertices = { 1'000'000, 1'000'001, 999'999, 1'000'050 };
+  vector<pair<size_t, size_t>> edges = { { 1'000'000, 1'000'001 },
+                                         { 1'000'001, 999'999 } };
+
+  writer.WriteArray(vertices);
+  writer.WriteEdges(edges);
+
+  // Размер массива, первый элемент (3 байта) и три разности.
+  // Размер массива рёбер, начало первого ребра (3 байта) и три разности.
+  REQUIRE_EQUAL(writer.Data().size(), 1UL + 3 + 3 + 1 + 3 + 3);
+
+  WireReader reader(writer.Data(), WireEncoding::Varint);
+  vector<size_t> readVertices;
+  vector<pair<size_t, size_t>> readEdges;
+
+  REQUIRE(reader.ReadArray([&readVertices](size_t vertex) {
+    readVertices.push_back(vertex);
+  }));
+  REQUIRE(reader.ReadEdges([&readEdges](size_t start, size_t end) {
+    readEdges.emplace_back(start, end);
+  }));
+  REQUIRE(reader.AtEnd());
+  REQUIRE_EQUAL(readVertices, vertices);
+  REQUIRE(readEdges == edges);
+
+  WireWriter big(WireEncoding::Varint);
+
+  big.WriteNumber(UINT64_MAX);
+
+  REQUIRE_EQUAL(big.Data().size(), 10UL);
+
+  WireReader bigReader(big.Data(), WireEncoding::Varint);
+  uint64_t value;
+
+  REQUIRE(bigReader.ReadNumber(&value));
+  REQUIRE_EQUAL(value, UINT64_MAX);
+}
+
+/**
+ * @brief Обрезанные и переполненные сообщения не читаются.
+ */
+static void TruncatedTest() {
+  for (WireEncoding encoding : { WireEncoding::Fixed,
+                                 WireEncoding::Varint }) {
+    WireWriter writer(encoding);
+
+    writer.WriteArray({ 1, 2, 3 });
+    writer.WriteString("text");
+
+    const string& data = writer.Data();
+
+    for (size_t size = 0; size < data.size(); size++) {
+      string prefix = data.substr(0, size);
+      WireReader reader(prefix, encoding);
+      string text;
+
+      bool success = reader.ReadArray([](size_t) {});
+
+      success = success && reader.ReadString(&text);
+
+      REQUIRE_EQUAL(success, false);
+    }
+  }
+
+  // Одиннадцать байт с битом продолжения не помещаются в 64 бита.
+  string overflow(10, static_cast<char>(0xFF));
+
+  overflow.push_back(0x01);
+
+  WireReader reader(overflow, WireEncoding::Varint);
+  uint64_t value;
+
+  REQUIRE_EQUAL(reader.ReadNumber(&value), false);
+}
+
+/**
+ * @brief Случайный тест: запись и чтение дают исходные данные.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 100;
+  // Используется для инициализации генератора случайных чисел.
+  random_device rd;
+  // Генератор случайных чисел.
+  mt19937 gen(rd());
+  // Распределение для размера массивов.
+  uniform_int_distribution<size_t> arraySize(0, 1000);
+  // Распределение для значений (в том числе очень больших).
+  uniform_int_distribution<size_t> value(0, SIZE_MAX);
+  // Распределение для номеров вершин.
+  uniform_int_distribution<size_t> vertex(0, 10'000);
+
+  for (int it = 0; it < numTries; it++) {
+    WireEncoding encoding = it % 2 == 0 ? WireEncoding::Fixed :
+                                          WireEncoding::Varint;
+    WireWriter writer(encoding);
+    vector<size_t> values(arraySize(gen));
+    vector<pair<size_t, size_t>> edges(arraySize(gen));
+
+    for (size_t& element : values) {
+      element = it % 4 < 2 ? value(gen) : vertex(gen);
+    }
+
+    for (pair<size_t, size_t>& edge : edges) {
+      edge = { vertex(gen), value(gen) };
+    }
+
+    writer.WriteArray(values);
+    writer.WriteEdges(edges);
+
+    WireReader reader(writer.Data(), encoding);
+    vector<size_t> readValues;
+    vector<pair<size_t, size_t>> readEdges;
+
+    REQUIRE(reader.ReadArray([&readValues](size_t element) {
+      readValues.push_back(element);
+    }));
+    REQUIRE(reader.ReadEdges([&readEdges](size_t start, size_t end) {
+      readEdges.emplace_back(start, end);
+    }));
+    REQUIRE(reader.AtEnd());
+    REQUIRE_EQUAL(readValues, values);
+    REQUIRE(readEdges == edges);
+  }
+}
@@ -0,0 +1,161 @@
+/**
+ * @file worker_pool_test.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Тесты для класса graph::WorkerPool.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "test_core.hpp"
+#include <worker_pool.hpp>
+
+using std::atomic;
+using std::vector;
+using std::random_device;
+using std::mt19937;
+using std::uniform_int_distribution;
+
+using graph::WorkerPool;
+
+static void ExecuteTest();
+static void SheddingTest();
+static void RandomTest();
+
+/**
+ * @brief Основная функция для тестирования класса graph::WorkerPool.
+ */
+void TestWorkerPool() {
+  TestSuite suite("TestWorkerPool");
+
+  RUN_TEST(suite, ExecuteTest);
+  RUN_TEST(suite, SheddingTest);
+  RUN_TEST(suite, RandomTest);
+}
+
+/**
+ * @brief Все поставленные задачи выполняются до остановки пула.
+ */
+static void ExecuteTest() {
+  atomic<size_t> numDone(0);
+  atomic<size_t> numShed(0);
+
+  {
+    WorkerPool pool(4, 1000, true);
+
+    for (size_t i = 0; i < 1000; i++) {
+      pool.enqueue([&numDone, &numShed]() {
+        if (WorkerPool::Shedding()) {
+          numShed++;
+        }
+
+        numDone++;
+      });
+    }
+
+    pool.shutdown();
+  }
+
+  REQUIRE_EQUAL(numDone.load(), 1000UL);
+  REQUIRE_EQUAL(numShed.load(), 0UL);
+  REQUIRE_EQUAL(WorkerPool::Shedding(), false);
+}
+
+/**
+ * @brief Задачи, для которых не хватило места в очереди, выполняются
+ *        в режиме сброса нагрузки.
+ */
+static void SheddingTest() {
+  std::promise<void> release;
+  std::shared_future<void> gate = release.get_future().share();
+  std::promise<void> started;
+  std::mutex mutex;
+  vector<bool> shed;
+  std::thread::id caller = std::this_thread::get_id();
+  bool onCaller = false;
+
+  WorkerPool pool(1, 1, false);
+
+  // Единственный рабочий поток занят, пока тест не откроет gate.
+  pool.enqueue([&started, gate]() {
+    started.set_value();
+    gate.wait();
+  });
+
+  started.get_future().wait();
+
+  auto record = [&mutex, &shed, &onCaller, caller]() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    shed.push_back(WorkerPool::Shedding());
+    onCaller = onCaller || std::this_thread::get_id() == caller;
+  };
+
+  // Первая задача помещается в очередь.
+  pool.enqueue(record);
+
+  REQUIRE_EQUAL(pool.QueueSize(), 1UL);
+
+  // Остальные выполняются потоком сброса нагрузки. Если и его очередь
+  // заполнена, то enqueue() ждёт места, а не выполняет задачу сам.
+  for (size_t i = 0; i < 10; i++) {
+    pool.enqueue(record);
+  }
+
+  release.set_value();
+  pool.shutdown();
+
+  REQUIRE_EQUAL(shed.size(), 11UL);
+
+  size_t numShed = 0;
+
+  for (bool value : shed) {
+    numShed += value ? 1 : 0;
+  }
+
+  REQUIRE_EQUAL(numShed, 10UL);
+  REQUIRE_EQUAL(onCaller, false);
+  REQUIRE_EQUAL(WorkerPool::Shedding(), false);
+}
+
+/**
+ * @brief Случайный тест: задачи из нескольких потоков не теряются.
+ */
+static void RandomTest() {
+  // Число попыток.
+  const int numTries = 20;
+  // Используется для инициализации генератора случайных чисел.
+  random_device rd;
+  // Генератор случайных чисел.
+  mt19937 gen(rd());
+  // Распределение для числа потоков и длины очереди.
+  uniform_int_distribution<size_t> size(1, 8);
+
+  for (int it = 0; it < numTries; it++) {
+    atomic<size_t> numDone(0);
+    size_t numProducers = size(gen);
+    WorkerPool pool(size(gen), size(gen), it % 2 == 0);
+    vector<std::thread> producers;
+
+    for (size_t i = 0; i < numProducers; i++) {
+      producers.emplace_back([&pool, &numDone]() {
+        for (size_t j = 0; j < 100; j++) {
+          pool.enqueue([&numDone]() { numDone++; });
+        }
+      });
+    }
+
+    for (std::thread& producer : producers) {
+      producer.join();
+    }
+
+    pool.shutdown();
+
+    REQUIRE_EQUAL(numDone.load(), 100 * numProducers);
+  }
+}
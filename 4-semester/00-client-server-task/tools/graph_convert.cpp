@@ -0,0 +1,204 @@
+/**
+ * @file tools/graph_convert.cpp
+ * @author Mikhail Lozhnikov
+ *
+ * Программа преобразует граф из JSON запроса в файл, который сервер
+ * отображает в память (@sa graph_file.hpp).
+ *
+ * Запуск:
+ * @code
+ * graph_convert input.json output.graph [--no-reverse]
+ * @endcode
+ * Входной файл имеет тот же вид, что и запросы к серверу:
+ * @code
+ * { "vertices": [ 1, 2, ... ],
+ *   "edges": [ { "start": 1, "end": 2, "weight": 0.5 }, ... ] }
+ * @endcode
+ * Если у рёбер есть поле weight, то в файл записываются веса типа double.
+ * Вес должен быть либо у всех рёбер, либо ни у одного. Веса не могут быть
+ * отрицательными: сервер запускает на графах из файлов алгоритм Дейкстры,
+ * который с отрицательными весами находит неверные пути. Ключ --no-reverse
+ * отключает запись графа с обращёнными рёбрами; без него файл занимает
+ * примерно вдвое меньше места, но поиск в ширину и двусторонний алгоритм
+ * Дейкстры на нём недоступны.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "graph_builder.hpp"
+#include "graph_file.hpp"
+#include "graph_sax.hpp"
+#include "weighted_csr_graph.hpp"
+#include "weighted_oriented_graph.hpp"
+
+using graph::GraphSaxHandler;
+using graph::WeightedCsrGraph;
+using graph::WeightedGraphBuilder;
+using graph::WeightedOrientedGraph;
+
+/**
+ * @brief Приёмник вершин и рёбер потокового разбора.
+ *
+ * Рёбра с весом и без веса складываются в один построитель графа
+ * (рёбра без веса получают вес 0), а число рёбер каждого вида
+ * подсчитывается, чтобы после разбора проверить, что веса заданы
+ * у всех рёбер или ни у одного и что среди них нет отрицательных.
+ */
+class ConvertBuilder {
+ public:
+  /**
+   * @brief Конструктор класса ConvertBuilder.
+   *
+   * @param builder Построитель графа.
+   */
+  explicit ConvertBuilder(WeightedGraphBuilder<double>* builder) :
+    builder(builder),
+    numEdges(0),
+    numWeighted(0),
+    numNegative(0) {
+  }
+
+  /**
+   * @brief Добавить вершину.
+   *
+   * @param id Номер вершины.
+   */
+  void AddVertex(size_t id) {
+    builder->AddVertex(id);
+  }
+
+  /**
+   * @brief Добавить ребро без веса.
+   *
+   * @param start Начало ребра.
+   * @param end Конец ребра.
+   */
+  void AddEdge(size_t start, size_t end) {
+    builder->AddEdge(start, end, 0.0);
+    numEdges++;
+  }
+
+  /**
+   * @brief Добавить ребро с весом.
+   *
+   * @param start Начало ребра.
+   * @param end Конец ребра.
+   * @param weight Вес ребра.
+   */
+  void AddEdge(size_t start, size_t end, double weight) {
+    builder->AddEdge(start, end, weight);
+    numEdges++;
+    numWeighted++;
+
+    if (weight < 0) {
+      numNegative++;
+    }
+  }
+
+  /**
+   * @brief Функция возвращает true, если у всех рёбер есть вес.
+   */
+  bool Weighted() const {
+    return numEdges > 0 && numWeighted == numEdges;
+  }
+
+  /**
+   * @brief Функция возвращает true, если вес есть только у части рёбер.
+   */
+  bool Mixed() const {
+    return numWeighted > 0 && numWeighted < numEdges;
+  }
+
+  /**
+   * @brief Функция возвращает true, если у какого-то ребра вес
+   * отрицательный.
+   */
+  bool Negative() const {
+    return numNegative > 0;
+  }
+
+ private:
+  //! Построитель графа.
+  WeightedGraphBuilder<double>* builder;
+  //! Число рёбер.
+  size_t numEdges;
+  //! Число рёбер с весом.
+  size_t numWeighted;
+  //! Число рёбер с отрицательным весом.
+  size_t numNegative;
+};
+
+int main(int argc, char* argv[]) {
+  if (argc < 3 || argc > 4 ||
+      (argc == 4 && std::strcmp(argv[3], "--no-reverse") != 0)) {
+    std::cerr << "Usage: " << argv[0]
+              << " input.json output.graph [--no-reverse]" << std::endl;
+    return 1;
+  }
+
+  std::ifstream input(argv[1], std::ios::binary);
+
+  if (!input) {
+    std::cerr << "cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  // Файл разбирается потоково: дерево nlohmann::json для графа размером
+  // в гигабайты заняло бы в несколько раз больше памяти, чем сам текст.
+  WeightedGraphBuilder<double> builder;
+  ConvertBuilder edges(&builder);
+  nlohmann::json fields;
+  GraphSaxHandler<ConvertBuilder> handler(&edges, &fields);
+
+  if (!nlohmann::json::sax_parse(input, &handler)) {
+    std::cerr << argv[1] << " is not a valid graph" << std::endl;
+    return 1;
+  }
+
+  if (edges.Mixed()) {
+    std::cerr << argv[1] << ": either all edges or none must have a weight"
+              << std::endl;
+    return 1;
+  }
+
+  if (edges.Negative()) {
+    std::cerr << argv[1] << ": edge weights must not be negative"
+              << std::endl;
+    return 1;
+  }
+
+  WeightedCsrGraph<double> snapshot;
+
+  {
+    WeightedOrientedGraph<double> graph;
+
+    // Память построителя и исходного графа освобождается до записи
+    // файла, который строит ещё и обращённый снимок.
+    builder.Build(&graph);
+    builder = WeightedGraphBuilder<double>();
+    snapshot.Assign(graph);
+  }
+
+  bool reverse = argc < 4;
+
+  try {
+    if (edges.Weighted()) {
+      WriteGraphFile(argv[2], snapshot, reverse);
+    } else {
+      WriteGraphFile(argv[2], static_cast<const graph::CsrGraph&>(snapshot),
+                     reverse);
+    }
+  } catch (const std::runtime_error& error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+
+  std::cerr << "Wrote " << snapshot.NumVertices() << " vertices and "
+            << snapshot.NumEdges() << " edges to " << argv[2] << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,387 @@
+/**
+ * @file include/wire_format.hpp
+ * @author Mikhail Lozhnikov
+ *
+ * Компактный двоичный формат для передачи массивов чисел между клиентом
+ * и сервером.
+ */
+
+#ifndef INCLUDE_WIRE_FORMAT_HPP_
+#define INCLUDE_WIRE_FORMAT_HPP_
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Способ кодирования целых чисел в двоичном формате.
+ *
+ * Сообщение состоит из чисел, строк и массивов, записанных подряд без
+ * разделителей. Строка и массив начинаются с числа элементов. Числа
+ * с плавающей точкой всегда записываются в формате IEEE 754 (4 байта для
+ * float и 8 байт для double) в порядке little-endian.
+ */
+enum class WireEncoding {
+  //! Каждое целое число занимает 8 байт в порядке little-endian.
+  Fixed,
+  /**
+   * Целые числа записываются в формате LEB128 (7 бит на байт). Элементы
+   * целочисленных массивов записываются как разность с предыдущим элементом
+   * (zigzag).
+   */
+  Varint
+};
+
+/**
+ * @brief Функция возвращает MIME тип для способа кодирования.
+ *
+ * @param encoding Способ кодирования.
+ */
+inline const char* WireContentType(WireEncoding encoding) {
+  return encoding == WireEncoding::Fixed ? "application/x-geometry" :
+                                           "application/x-geometry-varint";
+}
+
+/**
+ * @brief Получить тип носителя из значения заголовка Content-Type.
+ *
+ * @param contentType Значение заголовка Content-Type.
+ *
+ * Функция отбрасывает параметры после ';' (например, charset) и пробельные
+ * символы по краям и приводит тип к нижнему регистру, так как типы
+ * носителей не зависят от регистра.
+ */
+inline std::string WireMediaType(const std::string& contentType) {
+  size_t first = 0;
+  size_t last = std::min(contentType.find(';'), contentType.size());
+
+  while (first < last &&
+         std::isspace(static_cast<unsigned char>(contentType[first])))
+    first++;
+
+  while (last > first &&
+         std::isspace(static_cast<unsigned char>(contentType[last - 1])))
+    last--;
+
+  std::string mediaType = contentType.substr(first, last - first);
+
+  for (char& symbol : mediaType)
+    symbol = static_cast<char>(
+        std::tolower(static_cast<unsigned char>(symbol)));
+
+  return mediaType;
+}
+
+/**
+ * @brief Определить способ кодирования по MIME типу.
+ *
+ * @param contentType MIME тип (значение заголовка Content-Type).
+ * @param encoding Указатель, по которому записывается способ кодирования.
+ * @return Функция возвращает false, если MIME тип не относится
+ * к двоичному формату.
+ *
+ * Сравнивается только тип носителя (@sa WireMediaType()), поэтому
+ * параметры вроде "; charset=binary" и регистр букв не учитываются.
+ */
+inline bool WireEncodingFromContentType(const std::string& contentType,
+                                        WireEncoding* encoding) {
+  std::string mediaType = WireMediaType(contentType);
+
+  if (mediaType == WireContentType(WireEncoding::Fixed)) {
+    *encoding = WireEncoding::Fixed;
+    return true;
+  }
+
+  if (mediaType == WireContentType(WireEncoding::Varint)) {
+    *encoding = WireEncoding::Varint;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Класс для записи сообщения в двоичном формате.
+ */
+class WireWriter {
+ public:
+  /**
+   * @brief Конструктор класса WireWriter.
+   *
+   * @param encoding Способ кодирования.
+   */
+  explicit WireWriter(WireEncoding encoding) :
+    encoding(encoding) {
+  }
+
+  /**
+   * @brief Записать целое неотрицательное число.
+   *
+   * @param value Значение.
+   */
+  void WriteNumber(uint64_t value) {
+    if (encoding == WireEncoding::Fixed) {
+      WriteBytes(value, sizeof(value));
+      return;
+    }
+
+    while (value >= 0x80) {
+      data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+
+    data.push_back(static_cast<char>(value));
+  }
+
+  /**
+   * @brief Записать строку.
+   *
+   * @param value Строка.
+   */
+  void WriteString(const std::string& value) {
+    WriteNumber(value.size());
+    data.append(value);
+  }
+
+  /**
+   * @brief Записать массив чисел.
+   *
+   * @tparam T Тип элементов: целое число, float или double.
+   *
+   * @param values Массив.
+   * @param size Число элементов.
+   */
+  template<typename T>
+  void WriteArray(const T* values, size_t size) {
+    static_assert(std::is_integral_v<T> || sizeof(T) == sizeof(uint32_t) ||
+                  sizeof(T) == sizeof(uint64_t), "Unsupported element type");
+
+    uint64_t previous = 0;
+
+    WriteNumber(size);
+
+    for (size_t i = 0; i < size; i++) {
+      if constexpr (std::is_integral_v<T>) {
+        uint64_t value = static_cast<uint64_t>(static_cast<int64_t>(values[i]));
+
+        if (encoding == WireEncoding::Fixed) {
+          WriteNumber(value);
+        } else {
+          // Разность по модулю 2^64 как знаковое число, закодированное zigzag.
+          uint64_t delta = value - previous;
+
+          WriteNumber((delta << 1) ^ (0 - (delta >> 63)));
+        }
+
+        previous = value;
+      } else if constexpr (sizeof(T) == sizeof(uint32_t)) {
+        uint32_t bits;
+
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        WriteBytes(bits, sizeof(bits));
+      } else {
+        uint64_t bits;
+
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        WriteBytes(bits, sizeof(bits));
+      }
+    }
+  }
+
+  /**
+   * @brief Функция возвращает записанное сообщение.
+   */
+  const std::string& Data() const {
+    return data;
+  }
+
+ private:
+  /**
+   * @brief Записать младшие байты числа в порядке little-endian.
+   *
+   * @param value Значение.
+   * @param size Число байт.
+   */
+  void WriteBytes(uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; i++)
+      data.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+
+  //! Способ кодирования.
+  WireEncoding encoding;
+  //! Записанное сообщение.
+  std::string data;
+};
+
+/**
+ * @brief Класс для чтения сообщения в двоичном формате.
+ *
+ * Все функции возвращают false, если сообщение закончилось раньше времени
+ * или число не помещается в 64 бита.
+ */
+class WireReader {
+ public:
+  /**
+   * @brief Конструктор класса WireReader.
+   *
+   * @param data Сообщение. Должно существовать всё время чтения.
+   * @param encoding Способ кодирования.
+   */
+  WireReader(const std::string& data, WireEncoding encoding) :
+    data(data),
+    encoding(encoding),
+    position(0) {
+  }
+
+  /**
+   * @brief Прочитать целое неотрицательное число.
+   *
+   * @param value Указатель, по которому записывается значение.
+   */
+  bool ReadNumber(uint64_t* value) {
+    if (encoding == WireEncoding::Fixed)
+      return ReadBytes(value, sizeof(*value));
+
+    *value = 0;
+
+    for (size_t shift = 0; shift < 64; shift += 7) {
+      if (position == data.size())
+        return false;
+
+      uint64_t byte = static_cast<unsigned char>(data[position++]);
+
+      *value |= (byte & 0x7F) << shift;
+
+      if ((byte & 0x80) == 0)
+        return shift < 63 || byte <= 1;
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Прочитать строку.
+   *
+   * @param value Указатель, по которому записывается строка.
+   */
+  bool ReadString(std::string* value) {
+    uint64_t size;
+
+    if (!ReadNumber(&size) || size > data.size() - position)
+      return false;
+
+    value->assign(data, position, size);
+    position += size;
+
+    return true;
+  }
+
+  /**
+   * @brief Прочитать массив чисел.
+   *
+   * @tparam T Тип элементов: целое число, float или double.
+   *
+   * @param values Указатель, по которому записывается массив.
+   *
+   * Функция возвращает false, если целое число не помещается в тип T.
+   */
+  template<typename T>
+  bool ReadArray(std::vector<T>* values) {
+    uint64_t size;
+    uint64_t previous = 0;
+
+    // Каждый элемент занимает хотя бы один байт, поэтому размер больше
+    // оставшейся части сообщения заведомо неверен.
+    if (!ReadNumber(&size) || size > data.size() - position)
+      return false;
+
+    values->resize(size);
+
+    for (T& element : *values) {
+      if constexpr (std::is_integral_v<T>) {
+        uint64_t value;
+
+        if (!ReadNumber(&value))
+          return false;
+
+        if (encoding == WireEncoding::Varint)
+          value = previous + ((value >> 1) ^ (0 - (value & 1)));
+
+        int64_t signedValue = static_cast<int64_t>(value);
+
+        // Значение, которое не помещается в T, не обрезается молча:
+        // такое сообщение считается некорректным.
+        element = static_cast<T>(signedValue);
+
+        if (static_cast<int64_t>(element) != signedValue)
+          return false;
+
+        previous = value;
+      } else if constexpr (sizeof(T) == sizeof(uint32_t)) {
+        uint64_t bits;
+
+        if (!ReadBytes(&bits, sizeof(uint32_t)))
+          return false;
+
+        uint32_t narrow = static_cast<uint32_t>(bits);
+
+        std::memcpy(&element, &narrow, sizeof(element));
+      } else {
+        uint64_t bits;
+
+        if (!ReadBytes(&bits, sizeof(bits)))
+          return false;
+
+        std::memcpy(&element, &bits, sizeof(element));
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Функция возвращает true, если сообщение прочитано полностью.
+   */
+  bool AtEnd() const {
+    return position == data.size();
+  }
+
+ private:
+  /**
+   * @brief Прочитать число из size байт в порядке little-endian.
+   *
+   * @param value Указатель, по которому записывается значение.
+   * @param size Число байт.
+   */
+  bool ReadBytes(uint64_t* value, size_t size) {
+    if (data.size() - position < size)
+      return false;
+
+    *value = 0;
+
+    for (size_t i = 0; i < size; i++) {
+      *value |= static_cast<uint64_t>(
+          static_cast<unsigned char>(data[position++])) << (8 * i);
+    }
+
+    return true;
+  }
+
+  //! Сообщение.
+  const std::string& data;
+  //! Способ кодирования.
+  WireEncoding encoding;
+  //! Позиция следующего непрочитанного байта.
+  size_t position;
+};
+
+}  // namespace geometry
+
+#endif  // INCLUDE_WIRE_FORMAT_HPP_
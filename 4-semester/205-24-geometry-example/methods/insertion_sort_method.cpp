@@ -6,9 +6,13 @@
  * Функция принимает и возвращает данные в JSON формате.
  */
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include "insertion_sort.hpp"
+#include "wire_format.hpp"
+#include "methods.hpp"
 
 namespace geometry {
 
@@ -17,6 +21,16 @@ static int InsertionSortMethodHelper(const nlohmann::json& input,
                                      nlohmann::json* output,
                                      std::string type);
 
+template<typename T>
+static int InsertionSortBinaryHelper(WireReader* reader,
+                                     uint64_t id,
+                                     const std::string& type,
+                                     WireEncoding encoding,
+                                     std::string* output);
+
+template<typename T>
+static int Compare(T left, T right);
+
 int InsertionSortMethod(const nlohmann::json& input, nlohmann::json* output) {
   /*
   С классом nlohmann::json можно работать как со словарём.
@@ -39,6 +53,33 @@ int InsertionSortMethod(const nlohmann::json& input, nlohmann::json* output) {
   return -1;
 }
 
+int InsertionSortBinaryMethod(const std::string& input,
+                              WireEncoding encoding,
+                              std::string* output) {
+  WireReader reader(input, encoding);
+  uint64_t id;
+  std::string type;
+
+  /* Запрос: id, тип данных и массив элементов. */
+  if (!reader.ReadNumber(&id) || !reader.ReadString(&type))
+    return -1;
+
+  /* Представление long double зависит от платформы, поэтому в двоичном
+  формате этот тип не поддерживается. */
+  if (type == "int") {
+    return InsertionSortBinaryHelper<int>(&reader, id, type, encoding,
+                                          output);
+  } else if (type == "float") {
+    return InsertionSortBinaryHelper<float>(&reader, id, type, encoding,
+                                            output);
+  } else if (type == "double") {
+    return InsertionSortBinaryHelper<double>(&reader, id, type, encoding,
+                                             output);
+  }
+
+  return -1;
+}
+
 /**
  * @brief Метод сортировки вставками.
  *
@@ -71,14 +112,7 @@ static int InsertionSortMethodHelper(const nlohmann::json& input,
   }
 
   /* Здесь вызывается сам алгоритм сортировки вставками. */
-  InsertionSort(data, size, [](T left, T right) {
-    if (left < right)
-      return -1;
-    else if (left > right)
-      return 1;
-
-    return 0;
-  });
+  InsertionSort(data, size, Compare<T>);
 
   /* Сохраняем в ответе результат работы алгоритма. */
   (*output)["size"] = size;
@@ -92,4 +126,63 @@ static int InsertionSortMethodHelper(const nlohmann::json& input,
   return 0;
 }
 
+/**
+ * @brief Метод сортировки вставками для запроса в двоичном формате.
+ *
+ * @tparam T Тип данных сортируемых элементов.
+ *
+ * @param reader Объект для чтения запроса, из которого уже прочитаны
+ * id и тип данных.
+ * @param id Идентификатор запроса.
+ * @param type Строковое представление типа данных сортируемых элементов.
+ * @param encoding Способ кодирования ответа.
+ * @param output Указатель, по которому записывается ответ.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ */
+template<typename T>
+static int InsertionSortBinaryHelper(WireReader* reader,
+                                     uint64_t id,
+                                     const std::string& type,
+                                     WireEncoding encoding,
+                                     std::string* output) {
+  std::vector<T> data;
+
+  if (!reader->ReadArray(&data) || !reader->AtEnd())
+    return -1;
+
+  InsertionSort(data.data(), data.size(), Compare<T>);
+
+  /* Ответ: id, тип данных и отсортированный массив. */
+  WireWriter writer(encoding);
+
+  writer.WriteNumber(id);
+  writer.WriteString(type);
+  writer.WriteArray(data.data(), data.size());
+
+  *output = writer.Data();
+
+  return 0;
+}
+
+/**
+ * @brief Сравнение элементов для алгоритма сортировки вставками.
+ *
+ * @tparam T Тип данных сортируемых элементов.
+ *
+ * @param left Первый элемент.
+ * @param right Второй элемент.
+ * @return Функция возвращает -1, если первый элемент меньше второго,
+ * 1, если больше, и 0, если элементы равны.
+ */
+template<typename T>
+static int Compare(T left, T right) {
+  if (left < right)
+    return -1;
+  else if (left > right)
+    return 1;
+
+  return 0;
+}
+
 }  // namespace geometry
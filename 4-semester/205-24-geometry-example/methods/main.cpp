@@ -11,7 +11,11 @@
 #include "methods.hpp"
 
 
+using geometry::InsertionSortBinaryMethod;
 using geometry::InsertionSortMethod;
+using geometry::WireContentType;
+using geometry::WireEncoding;
+using geometry::WireEncodingFromContentType;
 
 
 int main(int argc, char* argv[]) {
@@ -41,6 +45,24 @@ int main(int argc, char* argv[]) {
   на сервере. */
   svr.Post("/InsertionSort", [&](const httplib::Request& req,
                                  httplib::Response& res) {
+    /*
+    Формат запроса определяется заголовком Content-Type. Для двоичного
+    формата (application/x-geometry и application/x-geometry-varint)
+    ответ кодируется так же, как запрос.
+    */
+    WireEncoding encoding;
+
+    if (WireEncodingFromContentType(req.get_header_value("Content-Type"),
+                                    &encoding)) {
+      std::string output;
+
+      if (InsertionSortBinaryMethod(req.body, encoding, &output) < 0)
+        res.status = 400;
+
+      res.set_content(output, WireContentType(encoding));
+      return;
+    }
+
     /*
     Поле body структуры httplib::Request содержит текст запроса.
     Функция nlohmann::json::parse() используется для того,
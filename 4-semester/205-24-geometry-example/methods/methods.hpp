@@ -10,6 +10,9 @@
 #ifndef METHODS_METHODS_HPP_
 #define METHODS_METHODS_HPP_
 
+#include <string>
+#include "wire_format.hpp"
+
 namespace geometry {
 
 /* Сюда нужно вставить объявление серверной части алгоритма. */
@@ -27,6 +30,23 @@ namespace geometry {
  */
 int InsertionSortMethod(const nlohmann::json& input, nlohmann::json* output);
 
+/**
+ * @brief Метод сортировки вставками для запросов в двоичном формате.
+ *
+ * @param input Текст запроса в двоичном формате (@sa wire_format.hpp).
+ * @param encoding Способ кодирования целых чисел в запросе и ответе.
+ * @param output Указатель, по которому записывается ответ в двоичном
+ * формате.
+ * @return Функция возвращает 0 в случае успеха и отрицательное число
+ * если входные данные заданы некорректно.
+ *
+ * Запрос содержит id, тип данных ("int", "float" или "double") и массив
+ * элементов. Ответ содержит id, тип данных и отсортированный массив.
+ */
+int InsertionSortBinaryMethod(const std::string& input,
+                              WireEncoding encoding,
+                              std::string* output);
+
 
 /* Конец вставки. */
 
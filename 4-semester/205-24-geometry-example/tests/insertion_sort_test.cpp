@@ -5,7 +5,13 @@
  * Реализация набора тестов для алгоритма сортировки вставками.
  */
 
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
 #include <insertion_sort.hpp>
+#include <wire_format.hpp>
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 #include "test_core.hpp"
@@ -14,6 +20,8 @@
 
 static void SimpleTest(httplib::Client* cli);
 static void RandomTest(httplib::Client* cli);
+static void BinaryTest(httplib::Client* cli);
+static void BinaryMalformedTest(httplib::Client* cli);
 
 template<typename T>
 static void RandomIntegerHelperTest(httplib::Client* cli, std::string type);
@@ -22,11 +30,17 @@ template<typename T>
 static void RandomFloatingPointHelperTest(httplib::Client* cli,
                                           std::string type);
 
+template<typename T, typename Distribution>
+static void BinaryHelperTest(httplib::Client* cli, std::string type,
+                             Distribution elem);
+
 void TestInsertionSort(httplib::Client* cli) {
   TestSuite suite("TestInsertionSort");
 
   RUN_TEST_REMOTE(suite, cli, SimpleTest);
   RUN_TEST_REMOTE(suite, cli, RandomTest);
+  RUN_TEST_REMOTE(suite, cli, BinaryTest);
+  RUN_TEST_REMOTE(suite, cli, BinaryMalformedTest);
 }
 
 /** 
@@ -232,3 +246,131 @@ static void RandomFloatingPointHelperTest(httplib::Client* cli,
   }
 }
 
+/**
+ * @brief Случайный тест для запросов в двоичном формате.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void BinaryTest(httplib::Client* cli) {
+  BinaryHelperTest<int>(cli, "int",
+      std::uniform_int_distribution<int>(-10'000, 10'000));
+  BinaryHelperTest<float>(cli, "float",
+      std::uniform_real_distribution<float>(-10'000, 10'000));
+  BinaryHelperTest<double>(cli, "double",
+      std::uniform_real_distribution<double>(-10'000, 10'000));
+}
+
+/**
+ * @brief Случайный тест для запросов в двоичном формате.
+ *
+ * @tparam T Тип данных сортируемых элементов.
+ * @tparam Distribution Тип распределения для элементов массива.
+ *
+ * @param cli Указатель на HTTP клиент.
+ * @param type Строковое представление типа данных сортируемых элементов.
+ * @param elem Распределение для элементов массива.
+ *
+ * Двоичный формат передаёт числа без потери точности, поэтому результат
+ * сравнивается точно.
+ */
+template<typename T, typename Distribution>
+static void BinaryHelperTest(httplib::Client* cli, std::string type,
+                             Distribution elem) {
+  // Число попыток.
+  const int numTries = 20;
+  // Используется для инициализации генератора случайных чисел.
+  std::random_device rd;
+  // Генератор случайных чисел.
+  std::mt19937 gen(rd());
+  // Распределение для количества элементов массива.
+  std::uniform_int_distribution<size_t> arraySize(10, 50);
+
+  for (int it = 0; it < numTries; it++) {
+    geometry::WireEncoding encoding = it % 2 == 0 ?
+        geometry::WireEncoding::Fixed : geometry::WireEncoding::Varint;
+    std::vector<T> data(arraySize(gen));
+
+    for (T& value : data)
+      value = elem(gen);
+
+    geometry::WireWriter writer(encoding);
+
+    writer.WriteNumber(it);
+    writer.WriteString(type);
+    writer.WriteArray(data.data(), data.size());
+
+    /* Тип MIME выбирает формат запроса и ответа. */
+    httplib::Result res = cli->Post("/InsertionSort", writer.Data(),
+        geometry::WireContentType(encoding));
+
+    REQUIRE_EQUAL(res->status, 200);
+
+    geometry::WireReader reader(res->body, encoding);
+    uint64_t id;
+    std::string outputType;
+    std::vector<T> output;
+
+    REQUIRE(reader.ReadNumber(&id));
+    REQUIRE(reader.ReadString(&outputType));
+    REQUIRE(reader.ReadArray(&output));
+    REQUIRE(reader.AtEnd());
+
+    /* Проверка результатов сортировки. */
+
+    std::sort(data.begin(), data.end());
+
+    REQUIRE_EQUAL(static_cast<uint64_t>(it), id);
+    REQUIRE_EQUAL(type, outputType);
+    REQUIRE_EQUAL(data.size(), output.size());
+
+    for (size_t i = 0; i < data.size(); i++) {
+      REQUIRE_EQUAL(data[i], output[i]);
+    }
+  }
+}
+
+/**
+ * @brief Тест для некорректных запросов в двоичном формате.
+ *
+ * @param cli Указатель на HTTP клиент.
+ */
+static void BinaryMalformedTest(httplib::Client* cli) {
+  const char* contentType =
+      geometry::WireContentType(geometry::WireEncoding::Varint);
+  int data[] = { 3, 1, 2 };
+
+  geometry::WireWriter writer(geometry::WireEncoding::Varint);
+
+  writer.WriteNumber(1);
+  writer.WriteString("int");
+  writer.WriteArray(data, 3);
+
+  /* Обрезанный запрос. */
+  httplib::Result res = cli->Post("/InsertionSort",
+      writer.Data().substr(0, writer.Data().size() - 1), contentType);
+
+  REQUIRE_EQUAL(res->status, 400);
+
+  /* Тип long double в двоичном формате не поддерживается. */
+  geometry::WireWriter longDouble(geometry::WireEncoding::Varint);
+
+  longDouble.WriteNumber(2);
+  longDouble.WriteString("long double");
+  longDouble.WriteNumber(0);
+
+  res = cli->Post("/InsertionSort", longDouble.Data(), contentType);
+
+  REQUIRE_EQUAL(res->status, 400);
+
+  /* Число, которое не помещается в int. */
+  int64_t wide[] = { 1, int64_t(1) << 40 };
+  geometry::WireWriter overflow(geometry::WireEncoding::Varint);
+
+  overflow.WriteNumber(3);
+  overflow.WriteString("int");
+  overflow.WriteArray(wide, 2);
+
+  res = cli->Post("/InsertionSort", overflow.Data(), contentType);
+
+  REQUIRE_EQUAL(res->status, 400);
+}